@@ -28,4 +28,20 @@ StringSetting CloudProjectsSavePath {
 IntSetting DaysToKeepFiles {
    "/cloud/audiocom/DaysToKeepFiles", 30
 };
+
+BoolSetting FastMixdownPreviews {
+   "/cloud/audiocom/FastMixdownPreviews", false
+};
+
+IntSetting SyncCompressionThreads {
+   "/cloud/audiocom/SyncCompressionThreads", 0
+};
+
+IntSetting SyncConcurrentUploads {
+   "/cloud/audiocom/SyncConcurrentUploads", 6
+};
+
+IntSetting SyncPendingUploadMegabytes {
+   "/cloud/audiocom/SyncPendingUploadMegabytes", 32
+};
 } // namespace audacity::cloud::audiocom
@@ -16,4 +16,14 @@ namespace audacity::cloud::audiocom
 {
 CLOUD_AUDIOCOM_API extern StringSetting CloudProjectsSavePath;
 CLOUD_AUDIOCOM_API extern IntSetting DaysToKeepFiles;
+//! Whether audio previews of projects are mixed quickly, at a lower rate
+CLOUD_AUDIOCOM_API extern BoolSetting FastMixdownPreviews;
+
+//! Threads that read and compress blocks for upload; 0 for one fewer than
+//! the cores
+CLOUD_AUDIOCOM_API extern IntSetting SyncCompressionThreads;
+//! Blocks uploaded at once
+CLOUD_AUDIOCOM_API extern IntSetting SyncConcurrentUploads;
+//! Megabytes of compressed blocks waiting for upload, or uploading
+CLOUD_AUDIOCOM_API extern IntSetting SyncPendingUploadMegabytes;
 } // namespace audacity::cloud::audiocom
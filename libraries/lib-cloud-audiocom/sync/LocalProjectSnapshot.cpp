@@ -516,6 +516,8 @@ void LocalProjectSnapshot::OnSnapshotCreated(
                if (!completed)
                   return;
 
+               LogUploadStats(result.Stats);
+
                if (succeeded)
                   MarkSnapshotSynced();
                else
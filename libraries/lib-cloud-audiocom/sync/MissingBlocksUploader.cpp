@@ -11,26 +11,81 @@
 
 #include "MissingBlocksUploader.h"
 
+#include <algorithm>
+
+#include <wx/log.h>
+
+#include "CloudLibrarySettings.h"
 #include "DataUploader.h"
 
 #include "WavPackCompressor.h"
 
 namespace audacity::cloud::audiocom::sync
 {
+namespace
+{
+double SecondsBetween(
+   std::chrono::steady_clock::time_point start,
+   std::chrono::steady_clock::time_point end)
+{
+   return std::chrono::duration<double>(end - start).count();
+}
+
+double MegabytesPerSecond(int64_t bytes, double seconds)
+{
+   return seconds > 0 ? bytes / (1024.0 * 1024.0) / seconds : 0;
+}
+} // namespace
+
+void LogUploadStats(const MissingBlocksUploadStats& stats)
+{
+   wxLogMessage(
+      "Block upload stats after %f secs: "
+      "read %lld bytes in %f thread-secs (%f MB/s per thread), "
+      "compressed them to %lld bytes in %f thread-secs "
+      "(%f MB/s of input per thread), "
+      "uploaded %lld bytes in %f upload-secs (%f MB/s per upload), "
+      "%f MB/s overall",
+      stats.ElapsedSeconds,
+      static_cast<long long>(stats.ReadBytes), stats.ReadSeconds,
+      MegabytesPerSecond(stats.ReadBytes, stats.ReadSeconds),
+      static_cast<long long>(stats.CompressedBytes), stats.CompressSeconds,
+      MegabytesPerSecond(stats.ReadBytes, stats.CompressSeconds),
+      static_cast<long long>(stats.UploadedBytes), stats.UploadSeconds,
+      MegabytesPerSecond(stats.UploadedBytes, stats.UploadSeconds),
+      MegabytesPerSecond(stats.UploadedBytes, stats.ElapsedSeconds));
+}
+
+MissingBlocksUploaderOptions MissingBlocksUploaderOptions::FromSettings()
+{
+   MissingBlocksUploaderOptions options;
+
+   options.CompressionThreads =
+      std::max(0, SyncCompressionThreads.Read());
+   options.ConcurrentUploads =
+      std::max(1, SyncConcurrentUploads.Read());
+   options.MaxPendingBytes =
+      size_t(std::max(1, SyncPendingUploadMegabytes.Read())) * 1024 * 1024;
+
+   return options;
+}
 
 MissingBlocksUploader::MissingBlocksUploader(
-   Tag, const ServiceConfig& serviceConfig)
+   Tag, const ServiceConfig& serviceConfig,
+   MissingBlocksUploaderOptions options)
     : mServiceConfig { serviceConfig }
+    , mOptions { std::move(options) }
 {
 }
 
 std::shared_ptr<MissingBlocksUploader> MissingBlocksUploader::Create(
    CancellationContextPtr cancellationContex, const ServiceConfig& serviceConfig,
    std::vector<BlockUploadTask> uploadTasks,
-   MissingBlocksUploadProgressCallback progressCallback)
+   MissingBlocksUploadProgressCallback progressCallback,
+   MissingBlocksUploaderOptions options)
 {
-   auto uploader =
-      std::make_shared<MissingBlocksUploader>(Tag {}, serviceConfig);
+   auto uploader = std::make_shared<MissingBlocksUploader>(
+      Tag {}, serviceConfig, std::move(options));
 
    if (!cancellationContex)
       cancellationContex = concurrency::CancellationContext::Create();
@@ -61,9 +116,19 @@ void MissingBlocksUploader::Start(
       mProgressCallback = [](auto...) {};
 
    mProgressData.TotalBlocks = mUploadTasks.size();
+   mStartTime = std::chrono::steady_clock::now();
+
+   auto numProducers = mOptions.CompressionThreads;
+   if (numProducers == 0)
+      numProducers = std::max(2u, std::thread::hardware_concurrency()) - 1;
+   // Each thread takes the next block as soon as it is done with its own.
+   // Each also reads blocks from the project, so the connection caches its
+   // prepared statements once more for every producer
+   numProducers =
+      std::max<size_t>(1, std::min(numProducers, mUploadTasks.size()));
 
-   for (auto& thread : mProducerThread)
-      thread = std::thread([this] { ProducerThread(); });
+   for (size_t i = 0; i < numProducers; ++i)
+      mProducerThreads.emplace_back([this] { ProducerThread(); });
 
    mConsumerThread = std::thread([this] { ConsumerThread(); });
 }
@@ -73,11 +138,11 @@ void MissingBlocksUploader::Cancel()
    if (!mIsRunning.exchange(false))
       return;
 
-   mRingBufferNotEmpty.notify_all();
-   mRingBufferNotFull.notify_all();
+   mQueueNotEmpty.notify_all();
+   mQueueNotFull.notify_all();
    mUploadsNotFull.notify_all();
 
-   for (auto& thread : mProducerThread)
+   for (auto& thread : mProducerThreads)
       thread.join();
 
    mConsumerThread.join();
@@ -101,7 +166,7 @@ void MissingBlocksUploader::ConsumeBlock(ProducedItem item)
          lock,
          [this]
          {
-            return mConcurrentUploads < NUM_UPLOADERS ||
+            return mConcurrentUploads < mOptions.ConcurrentUploads ||
                    !mIsRunning.load(std::memory_order_consume);
          });
 
@@ -111,10 +176,13 @@ void MissingBlocksUploader::ConsumeBlock(ProducedItem item)
       ++mConcurrentUploads;
    }
 
+   const auto compressedSize = item.CompressedData.size();
+   const auto uploadStart = std::chrono::steady_clock::now();
+
    DataUploader::Get().Upload(
       mCancellationContext, mServiceConfig, item.Task.BlockUrls,
       std::move(item.CompressedData),
-      [this, task = item.Task,
+      [this, task = item.Task, compressedSize, uploadStart,
        weakThis = weak_from_this()](ResponseResult result)
       {
          auto lock = weakThis.lock();
@@ -122,63 +190,89 @@ void MissingBlocksUploader::ConsumeBlock(ProducedItem item)
          if (!lock)
             return;
 
+         const auto uploadSeconds =
+            SecondsBetween(uploadStart, std::chrono::steady_clock::now());
          if (result.Code != SyncResultCode::Success)
-            HandleFailedBlock(result, task);
+            HandleFailedBlock(result, task, compressedSize, uploadSeconds);
          else
-            ConfirmBlock(task);
+            ConfirmBlock(task, compressedSize, uploadSeconds);
       });
 }
 
 void MissingBlocksUploader::PushBlockToQueue(ProducedItem item)
 {
-   std::unique_lock<std::mutex> lock(mRingBufferMutex);
-   mRingBufferNotFull.wait(
+   const auto size = item.CompressedData.size();
+
+   std::unique_lock<std::mutex> lock(mQueueMutex);
+   mQueueNotFull.wait(
       lock,
-      [this]
+      [this, size]
       {
-         return ((mRingBufferWriteIndex + 1) % RING_BUFFER_SIZE) !=
-                   mRingBufferReadIndex ||
+         return mPendingBytes == 0 ||
+                mPendingBytes + size <= mOptions.MaxPendingBytes ||
                 !mIsRunning.load(std::memory_order_consume);
       });
 
    if (!mIsRunning.load(std::memory_order_relaxed))
       return;
 
-   mRingBuffer[mRingBufferWriteIndex] = std::move(item);
-   mRingBufferWriteIndex = (mRingBufferWriteIndex + 1) % RING_BUFFER_SIZE;
+   mQueue.push_back(std::move(item));
+   mPendingBytes += size;
 
-   mRingBufferNotEmpty.notify_one();
+   mQueueNotEmpty.notify_one();
 }
 
 MissingBlocksUploader::ProducedItem MissingBlocksUploader::PopBlockFromQueue()
 {
-   std::unique_lock<std::mutex> lock(mRingBufferMutex);
-   mRingBufferNotEmpty.wait(
+   std::unique_lock<std::mutex> lock(mQueueMutex);
+   mQueueNotEmpty.wait(
       lock,
       [this]
       {
-         return mRingBufferWriteIndex != mRingBufferReadIndex ||
+         return !mQueue.empty() ||
                 !mIsRunning.load(std::memory_order_consume);
       });
 
    if (!mIsRunning.load(std::memory_order_relaxed))
       return {};
 
-   auto item            = std::move(mRingBuffer[mRingBufferReadIndex]);
-   mRingBufferReadIndex = (mRingBufferReadIndex + 1) % RING_BUFFER_SIZE;
-
-   mRingBufferNotFull.notify_one();
+   auto item = std::move(mQueue.front());
+   mQueue.pop_front();
 
+   // The bytes are pending until the upload ends
    return std::move(item);
 }
 
-void MissingBlocksUploader::ConfirmBlock(BlockUploadTask item)
+void MissingBlocksUploader::ReleasePendingBytes(size_t compressedSize)
+{
+   {
+      std::lock_guard<std::mutex> lock(mQueueMutex);
+      mPendingBytes -= compressedSize;
+   }
+
+   mQueueNotFull.notify_all();
+}
+
+MissingBlocksUploadProgress MissingBlocksUploader::GetProgressData() const
 {
+   auto progressData = mProgressData;
+   progressData.Stats.ElapsedSeconds =
+      SecondsBetween(mStartTime, std::chrono::steady_clock::now());
+   return progressData;
+}
+
+void MissingBlocksUploader::ConfirmBlock(
+   BlockUploadTask item, size_t compressedSize, double uploadSeconds)
+{
+   ReleasePendingBytes(compressedSize);
+
    MissingBlocksUploadProgress progressData;
    {
       std::lock_guard<std::mutex> lock(mProgressDataMutex);
       mProgressData.UploadedBlocks++;
-      progressData = mProgressData;
+      mProgressData.Stats.UploadedBytes += compressedSize;
+      mProgressData.Stats.UploadSeconds += uploadSeconds;
+      progressData = GetProgressData();
    }
 
    mProgressCallback(progressData, item.Block, {});
@@ -191,15 +285,19 @@ void MissingBlocksUploader::ConfirmBlock(BlockUploadTask item)
 }
 
 void MissingBlocksUploader::HandleFailedBlock(
-   const ResponseResult& result, BlockUploadTask task)
+   const ResponseResult& result, BlockUploadTask task, size_t compressedSize,
+   double uploadSeconds)
 {
+   ReleasePendingBytes(compressedSize);
+
    MissingBlocksUploadProgress progressData;
    {
       std::lock_guard<std::mutex> lock(mProgressDataMutex);
 
       mProgressData.FailedBlocks++;
+      mProgressData.Stats.UploadSeconds += uploadSeconds;
       mProgressData.UploadErrors.push_back(result);
-      progressData = mProgressData;
+      progressData = GetProgressData();
    }
 
    mProgressCallback(progressData, task.Block, result);
@@ -229,7 +327,22 @@ void MissingBlocksUploader::ProducerThread()
          task = std::move(mUploadTasks[index]);
       }
 
-      auto compressedData = CompressBlock(task.Block);
+      // Reading and compressing other blocks overlap these, on the other
+      // producers, and uploads overlap all of them
+      const auto readStart = std::chrono::steady_clock::now();
+      const auto samples = ReadBlockSamples(task.Block);
+      const auto compressStart = std::chrono::steady_clock::now();
+      auto compressedData = CompressBlock(task.Block, samples);
+      const auto compressEnd = std::chrono::steady_clock::now();
+
+      {
+         std::lock_guard<std::mutex> lock(mProgressDataMutex);
+         auto& stats = mProgressData.Stats;
+         stats.ReadBytes += samples.size();
+         stats.ReadSeconds += SecondsBetween(readStart, compressStart);
+         stats.CompressedBytes += compressedData.size();
+         stats.CompressSeconds += SecondsBetween(compressStart, compressEnd);
+      }
 
       if (compressedData.empty())
       {
@@ -237,7 +350,7 @@ void MissingBlocksUploader::ProducerThread()
          {
             std::lock_guard<std::mutex> lock(mProgressDataMutex);
             mProgressData.FailedBlocks++;
-            progressData = mProgressData;
+            progressData = GetProgressData();
          }
 
          mProgressCallback(
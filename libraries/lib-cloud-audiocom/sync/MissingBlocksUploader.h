@@ -10,12 +10,14 @@
 **********************************************************************/
 #pragma once
 
-#include <array>
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <cstdint>
+#include <deque>
 #include <mutex>
 #include <thread>
+#include <vector>
 
 #include <functional>
 
@@ -41,6 +43,27 @@ namespace audacity::cloud::audiocom::sync
 {
 using concurrency::CancellationContextPtr;
 
+//! Throughput of each stage of the upload, for tuning
+/*!
+ Times of reading and compressing are summed over the producer threads, and
+ times of uploads over the concurrent uploads, so that each stage's rate is
+ that of one thread or one upload; ElapsedSeconds is the wall time of all
+ stages, which overlap
+ */
+struct MissingBlocksUploadStats final
+{
+   int64_t ReadBytes       = 0;
+   double ReadSeconds      = 0;
+   int64_t CompressedBytes = 0;
+   double CompressSeconds  = 0;
+   int64_t UploadedBytes   = 0;
+   double UploadSeconds    = 0;
+   double ElapsedSeconds   = 0;
+};
+
+//! Writes the stats, and the rate of each stage, to the log
+void LogUploadStats(const MissingBlocksUploadStats& stats);
+
 struct MissingBlocksUploadProgress final
 {
    int64_t TotalBlocks    = 0;
@@ -48,6 +71,21 @@ struct MissingBlocksUploadProgress final
    int64_t FailedBlocks   = 0;
 
    std::vector<ResponseResult> UploadErrors;
+
+   MissingBlocksUploadStats Stats;
+};
+
+struct MissingBlocksUploaderOptions final
+{
+   //! 0 for one fewer than the cores
+   size_t CompressionThreads = 0;
+   size_t ConcurrentUploads  = 6;
+   //! Ceiling of compressed data waiting for upload, or uploading; one block
+   //! may exceed it
+   size_t MaxPendingBytes = 32 * 1024 * 1024;
+
+   //! Options from the preferences
+   static MissingBlocksUploaderOptions FromSettings();
 };
 
 struct BlockUploadTask final
@@ -69,16 +107,16 @@ class MissingBlocksUploader final :
    };
 
 public:
-   static constexpr auto NUM_PRODUCERS    = 3;
-   static constexpr auto NUM_UPLOADERS    = 6;
-   static constexpr auto RING_BUFFER_SIZE = 16;
-
-   MissingBlocksUploader(Tag, const ServiceConfig& serviceConfig);
+   MissingBlocksUploader(
+      Tag, const ServiceConfig& serviceConfig,
+      MissingBlocksUploaderOptions options);
 
    static std::shared_ptr<MissingBlocksUploader> Create(
       CancellationContextPtr cancellationContex, const ServiceConfig& serviceConfig,
       std::vector<BlockUploadTask> uploadTasks,
-      MissingBlocksUploadProgressCallback progress);
+      MissingBlocksUploadProgressCallback progress,
+      MissingBlocksUploaderOptions options =
+         MissingBlocksUploaderOptions::FromSettings());
 
    ~MissingBlocksUploader();
 
@@ -102,20 +140,28 @@ private:
    void PushBlockToQueue(ProducedItem item);
    ProducedItem PopBlockFromQueue();
 
-   void ConfirmBlock(BlockUploadTask task);
-   void HandleFailedBlock(const ResponseResult& result, BlockUploadTask task);
+   void ConfirmBlock(
+      BlockUploadTask task, size_t compressedSize, double uploadSeconds);
+   void HandleFailedBlock(
+      const ResponseResult& result, BlockUploadTask task,
+      size_t compressedSize, double uploadSeconds);
+   //! Let producers queue more once an upload ends
+   void ReleasePendingBytes(size_t compressedSize);
+   //! @pre mProgressDataMutex is locked
+   MissingBlocksUploadProgress GetProgressData() const;
 
    void ProducerThread();
    void ConsumerThread();
 
    const ServiceConfig& mServiceConfig;
+   const MissingBlocksUploaderOptions mOptions;
 
    std::vector<BlockUploadTask> mUploadTasks;
    MissingBlocksUploadProgressCallback mProgressCallback;
 
    std::atomic_bool mIsRunning { true };
 
-   std::thread mProducerThread[NUM_PRODUCERS];
+   std::vector<std::thread> mProducerThreads;
    std::thread mConsumerThread;
 
    std::mutex mBlocksMutex;
@@ -125,17 +171,18 @@ private:
    std::condition_variable mUploadsNotFull;
    size_t mConcurrentUploads { 0 };
 
-   std::mutex mRingBufferMutex;
+   std::mutex mQueueMutex;
 
-   std::condition_variable mRingBufferNotEmpty;
-   std::condition_variable mRingBufferNotFull;
+   std::condition_variable mQueueNotEmpty;
+   std::condition_variable mQueueNotFull;
 
-   std::array<ProducedItem, RING_BUFFER_SIZE> mRingBuffer;
-   size_t mRingBufferWriteIndex { 0 };
-   size_t mRingBufferReadIndex { 0 };
+   std::deque<ProducedItem> mQueue;
+   //! Compressed bytes in the queue and in uploads
+   size_t mPendingBytes { 0 };
 
    std::mutex mProgressDataMutex;
    MissingBlocksUploadProgress mProgressData;
+   std::chrono::steady_clock::time_point mStartTime;
 
    CancellationContextPtr mCancellationContext;
 };
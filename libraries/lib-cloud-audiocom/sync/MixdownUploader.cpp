@@ -17,6 +17,7 @@
 
 #include "CodeConversions.h"
 
+#include "CloudLibrarySettings.h"
 #include "ServiceConfig.h"
 
 #include "Export.h"
@@ -33,6 +34,10 @@ namespace audacity::cloud::audiocom::sync
 {
 namespace
 {
+//! Highest rate of fast previews.  Tracks at multiples of it are decimated as
+//! they are read, so the mixer handles fewer samples and need not resample
+constexpr double FastPreviewRate = 22050;
+
 std::string GenerateTempPath(FileExtension extension)
 {
    const auto tempPath = GetUploadTempPath();
@@ -339,6 +344,13 @@ void MixdownUploader::ExportProject()
 
    const int nChannels = CalculateChannels(tracks);
 
+   // A fast preview mixes from a decimated read of each track, and has fewer
+   // samples to encode
+   const auto fastPreview = FastMixdownPreviews.Read();
+   auto sampleRate = ProjectRate::Get(mProject).GetRate();
+   if (fastPreview)
+      sampleRate = std::min(sampleRate, FastPreviewRate);
+
    auto hasMimeType = [](const auto&& mimeTypes, const std::string& mimeType)
    {
       return std::find(mimeTypes.begin(), mimeTypes.end(), mimeType) !=
@@ -378,10 +390,11 @@ void MixdownUploader::ExportProject()
       auto builder = ExportTaskBuilder {}
                         .SetParameters(parameters)
                         .SetNumChannels(nChannels)
-                        .SetSampleRate(ProjectRate::Get(mProject).GetRate())
+                        .SetSampleRate(sampleRate)
                         .SetPlugin(plugin)
                         .SetFileName(audacity::ToWXString(path))
-                        .SetRange(t0, t1, false);
+                        .SetRange(t0, t1, false)
+                        .SetDraftQuality(fastPreview);
 
       mExportedFilePath = path;
 
@@ -267,6 +267,8 @@ private:
             if (!completed)
                return;
 
+            LogUploadStats(progress.Stats);
+
             if (succeeded)
                MarkSnapshotSynced();
             else
@@ -68,17 +68,10 @@ struct Exporter final
          WavpackCloseFile(Context);
    }
 
-   std::vector<uint8_t> Compress()
+   std::vector<uint8_t> Compress(const BlockSamples& sampleData)
    {
       const auto sampleFormat = Block.Format;
-      const auto sampleCount = Block.Block->GetSampleCount();
-      const auto dataSize = sampleCount * SAMPLE_SIZE(sampleFormat);
-
-      std::vector<std::remove_pointer_t<samplePtr>> sampleData;
-      sampleData.resize(dataSize);
-
-      const size_t samplesRead = Block.Block->GetSamples(
-         sampleData.data(), Block.Format, 0, sampleCount, false);
+      const size_t samplesRead = sampleData.size() / SAMPLE_SIZE(sampleFormat);
 
       // Reserve 1.5 times the size of the original data
       // The compressed data will be smaller than the original data,
@@ -485,10 +478,30 @@ void UpdateRMS (DecompressedBlock& block, const std::vector<T>& data)
  }
 } // namespace
 
-std::vector<uint8_t> CompressBlock(const LockedBlock& block)
+BlockSamples ReadBlockSamples(const LockedBlock& block)
+{
+   const auto sampleCount = block.Block->GetSampleCount();
+
+   BlockSamples sampleData;
+   sampleData.resize(sampleCount * SAMPLE_SIZE(block.Format));
+
+   const size_t samplesRead = block.Block->GetSamples(
+      sampleData.data(), block.Format, 0, sampleCount, false);
+   sampleData.resize(samplesRead * SAMPLE_SIZE(block.Format));
+
+   return sampleData;
+}
+
+std::vector<uint8_t>
+CompressBlock(const LockedBlock& block, const BlockSamples& samples)
 {
    Exporter exporter { block };
-   return exporter.Compress();
+   return exporter.Compress(samples);
+}
+
+std::vector<uint8_t> CompressBlock(const LockedBlock& block)
+{
+   return CompressBlock(block, ReadBlockSamples(block));
 }
 
 std::optional<DecompressedBlock>
@@ -13,6 +13,7 @@
 #include <cstdint>
 #include <limits>
 #include <optional>
+#include <type_traits>
 #include <vector>
 
 #include "CloudSyncDTO.h"
@@ -21,6 +22,13 @@ class AudacityProject;
 
 namespace audacity::cloud::audiocom::sync
 {
+using BlockSamples = std::vector<std::remove_pointer_t<samplePtr>>;
+
+//! Read the samples of a block from the project, for CompressBlock()
+BlockSamples ReadBlockSamples(const LockedBlock& block);
+
+std::vector<uint8_t>
+CompressBlock(const LockedBlock& block, const BlockSamples& samples);
 std::vector<uint8_t> CompressBlock(const LockedBlock& block);
 
 struct MinMaxRMS final
@@ -0,0 +1,192 @@
+/*  SPDX-License-Identifier: GPL-2.0-or-later */
+/*!********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  CompressorProcessor.cpp
+
+**********************************************************************/
+#include "CompressorProcessor.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <utility>
+
+namespace {
+// Floor of the detector, avoiding log of zero
+constexpr float minLevel = 1e-10f;
+constexpr float log2ToDb = 20.0f / 3.321928094887362f;
+
+float MsToCoef(double ms, double sampleRate)
+{
+   // Time constant to reach 1 - 1/e of a step
+   const auto samples = std::max(ms, 0.0) * sampleRate / 1000.0;
+   return samples < 1.0 ? 0.0f : static_cast<float>(std::exp(-1.0 / samples));
+}
+} // namespace
+
+bool operator==(const CompressorSettings& a, const CompressorSettings& b)
+{
+   return a.thresholdDb == b.thresholdDb &&
+          a.makeupGainDb == b.makeupGainDb &&
+          a.kneeWidthDb == b.kneeWidthDb && a.ratio == b.ratio &&
+          a.lookaheadMs == b.lookaheadMs && a.attackMs == b.attackMs &&
+          a.releaseMs == b.releaseMs;
+}
+
+CompressorProcessor::CompressorProcessor(const CompressorSettings& settings)
+    : mSettings { settings }
+{
+}
+
+CompressorProcessor::~CompressorProcessor() = default;
+
+void CompressorProcessor::Init(double sampleRate, int numChannels)
+{
+   assert(sampleRate > 0);
+   assert(numChannels > 0);
+   mSampleRate = sampleRate;
+   mNumChannels = numChannels;
+   mEnvelope.assign(maxBlockSize, 0.0f);
+   mInPointers.resize(numChannels);
+   mOutPointers.resize(numChannels);
+   // Enough for the longest lookahead, so that a change of lookahead in
+   // realtime does not allocate
+   mDelayLineSize =
+      static_cast<int>(std::lround(maxLookaheadMs * sampleRate / 1000)) +
+      maxBlockSize;
+   mDelayLines.assign(numChannels, std::vector<float>(mDelayLineSize));
+   ApplySettings();
+   Reset();
+}
+
+void CompressorProcessor::Reset()
+{
+   for (auto& line : mDelayLines)
+      std::fill(line.begin(), line.end(), 0.0f);
+   mWritePos = 0;
+   mGainDb = 0;
+   mMinGain = 1;
+}
+
+void CompressorProcessor::SetSettings(const CompressorSettings& settings)
+{
+   const auto lookaheadChanged = settings.lookaheadMs != mSettings.lookaheadMs;
+   mSettings = settings;
+   if (mSampleRate <= 0)
+      // Not yet initialized; Init() will apply them
+      return;
+   ApplySettings();
+   if (lookaheadChanged)
+      Reset();
+}
+
+void CompressorProcessor::ApplySettings()
+{
+   mAttackCoef = MsToCoef(mSettings.attackMs, mSampleRate);
+   mReleaseCoef = MsToCoef(mSettings.releaseMs, mSampleRate);
+   mMakeupGainDb = static_cast<float>(mSettings.makeupGainDb);
+   const auto lookaheadMs =
+      std::clamp(mSettings.lookaheadMs, 0.0, maxLookaheadMs);
+   mLookahead = static_cast<int>(std::lround(lookaheadMs * mSampleRate / 1000));
+}
+
+float CompressorProcessor::ComputeStaticGainDb(
+   float levelDb, const CompressorSettings& settings)
+{
+   const auto threshold = static_cast<float>(settings.thresholdDb);
+   const auto knee = static_cast<float>(std::max(settings.kneeWidthDb, 0.0));
+   const auto slope =
+      1.0f / static_cast<float>(std::max(settings.ratio, 1.0)) - 1.0f;
+   const auto over = levelDb - threshold;
+   // Quadratic interpolation inside the knee, written without branches so the
+   // loop calling this vectorizes; `knee` may be zero
+   const auto inKnee = std::clamp(over + knee / 2, 0.0f, knee);
+   const auto kneeGain =
+      knee > 0 ? slope * inKnee * inKnee / (2 * knee) : 0.0f;
+   const auto aboveKnee = std::max(over - knee / 2, 0.0f);
+   return kneeGain + slope * aboveKnee;
+}
+
+float CompressorProcessor::GetMinGainSinceLastQuery()
+{
+   return std::exchange(mMinGain, 1.0f);
+}
+
+void CompressorProcessor::Process(
+   const float* const* inBlock, float* const* outBlock, int blockLen)
+{
+   assert(mNumChannels > 0);
+   auto& in = mInPointers;
+   auto& out = mOutPointers;
+   for (int offset = 0; offset < blockLen; offset += maxBlockSize) {
+      const auto len = std::min(maxBlockSize, blockLen - offset);
+      for (int ch = 0; ch < mNumChannels; ++ch) {
+         in[ch] = inBlock[ch] + offset;
+         out[ch] = outBlock[ch] + offset;
+      }
+      ProcessSubBlock(in.data(), out.data(), len);
+   }
+}
+
+void CompressorProcessor::ProcessSubBlock(
+   const float* const* in, float* const* out, int len)
+{
+   const auto env = mEnvelope.data();
+
+   // Append the input to the delay lines, before any output is written, since
+   // processing may be in place; meanwhile detect the peak over channels
+   // The delay line is a ring, so each of these copies is in at most two
+   // pieces
+   const auto writeLen = std::min(len, mDelayLineSize - mWritePos);
+   std::fill(env, env + len, 0.0f);
+   for (int ch = 0; ch < mNumChannels; ++ch) {
+      const auto src = in[ch];
+      const auto line = mDelayLines[ch].data();
+      std::copy(src, src + writeLen, line + mWritePos);
+      std::copy(src + writeLen, src + len, line);
+      for (int i = 0; i < len; ++i)
+         env[i] = std::max(env[i], std::abs(src[i]));
+   }
+
+   // Level and static gain in dB
+   for (int i = 0; i < len; ++i)
+      env[i] = log2ToDb * std::log2(std::max(env[i], minLevel));
+   for (int i = 0; i < len; ++i)
+      env[i] = ComputeStaticGainDb(env[i], mSettings);
+
+   // Ballistics: attack while the gain falls, release while it rises
+   auto state = mGainDb;
+   for (int i = 0; i < len; ++i) {
+      const auto target = env[i];
+      const auto coef = target < state ? mAttackCoef : mReleaseCoef;
+      state = target + coef * (state - target);
+      env[i] = state;
+   }
+   mGainDb = state;
+
+   // To linear with makeup
+   auto minGain = mMinGain;
+   for (int i = 0; i < len; ++i) {
+      env[i] = std::exp2((env[i] + mMakeupGainDb) / log2ToDb);
+      minGain = std::min(minGain, env[i]);
+   }
+   mMinGain = minGain;
+
+   // Apply to the input of `mLookahead` samples ago; the size of the ring
+   // exceeds the lookahead by a sub-block, so that input is not yet
+   // overwritten
+   const auto readPos =
+      (mWritePos + mDelayLineSize - mLookahead) % mDelayLineSize;
+   const auto readLen = std::min(len, mDelayLineSize - readPos);
+   for (int ch = 0; ch < mNumChannels; ++ch) {
+      const auto line = mDelayLines[ch].data();
+      const auto dst = out[ch];
+      for (int i = 0; i < readLen; ++i)
+         dst[i] = line[readPos + i] * env[i];
+      for (int i = readLen; i < len; ++i)
+         dst[i] = line[i - readLen] * env[i];
+   }
+   mWritePos = (mWritePos + len) % mDelayLineSize;
+}
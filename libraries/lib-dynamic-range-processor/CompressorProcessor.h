@@ -0,0 +1,126 @@
+/*  SPDX-License-Identifier: GPL-2.0-or-later */
+/*!********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  CompressorProcessor.h
+
+**********************************************************************/
+#pragma once
+
+#include <vector>
+
+struct DYNAMIC_RANGE_PROCESSOR_API CompressorSettings
+{
+   static constexpr double thresholdDbDefault = -10.0;
+   static constexpr double makeupGainDbDefault = 0.0;
+   static constexpr double kneeWidthDbDefault = 5.0;
+   static constexpr double ratioDefault = 4.0;
+   static constexpr double lookaheadMsDefault = 1.0;
+   static constexpr double attackMsDefault = 30.0;
+   static constexpr double releaseMsDefault = 150.0;
+
+   double thresholdDb{ thresholdDbDefault };
+   double makeupGainDb{ makeupGainDbDefault };
+   double kneeWidthDb{ kneeWidthDbDefault };
+   double ratio{ ratioDefault };
+   double lookaheadMs{ lookaheadMsDefault };
+   double attackMs{ attackMsDefault };
+   double releaseMs{ releaseMsDefault };
+
+   friend bool
+   operator==(const CompressorSettings& a, const CompressorSettings& b);
+   friend bool
+   operator!=(const CompressorSettings& a, const CompressorSettings& b)
+   { return !(a == b); }
+};
+
+/*!
+ * @brief Feed-forward compressor processing blocks of samples.
+ *
+ * @details Each block goes through stages that are separate loops, so that
+ * all but the ballistics can be vectorized by the compiler:
+ * - envelope detection, as the peak over channels of each frame;
+ * - the static gain computer with soft knee, in dB;
+ * - attack and release smoothing of the gain, the only recursive stage;
+ * - conversion to linear gain with makeup;
+ * - application of the gain to input delayed by the lookahead.
+ *
+ * Channels are linked: the same gain applies to all.
+ *
+ * The latency equals the lookahead and changes only when the lookahead does.
+ */
+class DYNAMIC_RANGE_PROCESSOR_API CompressorProcessor final
+{
+public:
+   //! Processing happens in sub-blocks of at most this many frames
+   static constexpr int maxBlockSize = 512;
+   static constexpr double maxLookaheadMs = 1000.0;
+
+   explicit CompressorProcessor(const CompressorSettings& settings = {});
+   ~CompressorProcessor();
+
+   /*!
+    * @brief Allocate and clear all state; must precede Process()
+    * @pre `sampleRate > 0`
+    * @pre `numChannels > 0`
+    */
+   void Init(double sampleRate, int numChannels);
+
+   //! Clear signal history, keeping settings and allocations; does not
+   //! allocate
+   void Reset();
+
+   //! Takes effect for the next Process(); a change of lookahead clears the
+   //! delay line
+   void SetSettings(const CompressorSettings& settings);
+   const CompressorSettings& GetSettings() const { return mSettings; }
+
+   //! Delay of output relative to input, in samples
+   int GetLatencySamples() const { return mLookahead; }
+
+   /*!
+    * @brief Process any number of frames; in-place processing is allowed.
+    * @pre `Init()` was called
+    */
+   void Process(const float* const* inBlock, float* const* outBlock,
+      int blockLen);
+
+   //! The static characteristic: gain in dB (not positive) for a level in dB,
+   //! without makeup
+   static float ComputeStaticGainDb(float levelDb,
+      const CompressorSettings& settings);
+
+   //! Smallest linear gain, including makeup, applied since the last call
+   float GetMinGainSinceLastQuery();
+
+private:
+   void ApplySettings();
+   void ProcessSubBlock(const float* const* in, float* const* out, int len);
+
+   CompressorSettings mSettings;
+   double mSampleRate{ 0 };
+   int mNumChannels{ 0 };
+
+   // Derived from the settings and sample rate
+   float mAttackCoef{ 0 };
+   float mReleaseCoef{ 0 };
+   float mMakeupGainDb{ 0 };
+   int mLookahead{ 0 };
+
+   //! Smoothed gain in dB carried between blocks
+   float mGainDb{ 0 };
+   float mMinGain{ 1 };
+
+   //! Per frame scratch of the sub-block: levels, then gains
+   std::vector<float> mEnvelope;
+   //! Per channel: ring of input, sized for the longest lookahead and a
+   //! sub-block
+   std::vector<std::vector<float>> mDelayLines;
+   int mDelayLineSize{ 0 };
+   //! Where the next input goes in each ring
+   int mWritePos{ 0 };
+   //! Preallocated so that Process() does not allocate
+   std::vector<const float*> mInPointers;
+   std::vector<float*> mOutPointers;
+};
@@ -0,0 +1,161 @@
+/*  SPDX-License-Identifier: GPL-2.0-or-later */
+/*!********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  CompressorProcessorTests.cpp
+
+**********************************************************************/
+#include "CompressorProcessor.h"
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace {
+float DbToLinear(float db)
+{
+   return std::pow(10.0f, db / 20.0f);
+}
+} // namespace
+
+TEST_CASE("CompressorProcessor static characteristic")
+{
+   CompressorSettings settings;
+   settings.thresholdDb = -20;
+   settings.ratio = 4;
+   settings.kneeWidthDb = 10;
+
+   // Below the knee, no gain change
+   REQUIRE(
+      CompressorProcessor::ComputeStaticGainDb(-40, settings) ==
+      Approx(0).margin(1e-6));
+   REQUIRE(
+      CompressorProcessor::ComputeStaticGainDb(-25, settings) ==
+      Approx(0).margin(1e-6));
+   // Above the knee, the ratio applies
+   REQUIRE(
+      CompressorProcessor::ComputeStaticGainDb(0, settings) ==
+      Approx(-15).margin(1e-4));
+   // At the threshold, half way through the knee
+   REQUIRE(
+      CompressorProcessor::ComputeStaticGainDb(-20, settings) ==
+      Approx(-0.75 * 5 * 5 / 20).margin(1e-4));
+   // Continuous at the upper edge of the knee
+   REQUIRE(
+      CompressorProcessor::ComputeStaticGainDb(-15, settings) ==
+      Approx(-3.75).margin(1e-4));
+
+   // Hard knee
+   settings.kneeWidthDb = 0;
+   REQUIRE(
+      CompressorProcessor::ComputeStaticGainDb(-21, settings) ==
+      Approx(0).margin(1e-6));
+   REQUIRE(
+      CompressorProcessor::ComputeStaticGainDb(-10, settings) ==
+      Approx(-7.5).margin(1e-4));
+}
+
+TEST_CASE("CompressorProcessor latency equals lookahead")
+{
+   constexpr auto sampleRate = 44100.0;
+   CompressorSettings settings;
+   settings.lookaheadMs = 10;
+   CompressorProcessor processor { settings };
+   processor.Init(sampleRate, 1);
+   const auto latency = processor.GetLatencySamples();
+   REQUIRE(latency == 441);
+
+   // Quiet impulse, below threshold so that the gain is unity
+   std::vector<float> buffer(2000, 0.0f);
+   buffer[0] = 0.01f;
+   float* channels[] { buffer.data() };
+   // Lengths that are not multiples of the sub-block size
+   processor.Process(channels, channels, 1000);
+   float* rest[] { buffer.data() + 1000 };
+   processor.Process(rest, rest, 1000);
+   for (int i = 0; i < 2000; ++i)
+      REQUIRE(buffer[i] == Approx(i == latency ? 0.01f : 0.0f).margin(1e-7));
+
+   SECTION("Changing the lookahead changes the latency")
+   {
+      settings.lookaheadMs = 0;
+      processor.SetSettings(settings);
+      REQUIRE(processor.GetLatencySamples() == 0);
+   }
+}
+
+TEST_CASE("CompressorProcessor delays by the lookahead across the ring")
+{
+   constexpr auto sampleRate = 8000.0;
+   // Lookaheads shorter and longer than a sub-block, and the longest
+   const auto lookaheadMs = GENERATE(10.0, 200.0,
+      CompressorProcessor::maxLookaheadMs);
+   CompressorSettings settings;
+   settings.lookaheadMs = lookaheadMs;
+   CompressorProcessor processor { settings };
+   processor.Init(sampleRate, 1);
+   const auto latency = processor.GetLatencySamples();
+
+   // A quiet ramp, below threshold, several times the length of the ring, in
+   // blocks of varying length
+   constexpr auto total = 40000;
+   std::vector<float> input(total);
+   for (int i = 0; i < total; ++i)
+      input[i] = 1e-4f * (i % 97);
+   auto output = input;
+   for (int offset = 0, len = 1; offset < total;
+        offset += len, len = len * 7 % 1013)
+   {
+      len = std::min(len, total - offset);
+      float* channels[] { output.data() + offset };
+      processor.Process(channels, channels, len);
+   }
+   for (int i = 0; i < total; ++i)
+      REQUIRE(output[i] == (i < latency ? 0.0f : input[i - latency]));
+}
+
+TEST_CASE("CompressorProcessor steady state gain")
+{
+   constexpr auto sampleRate = 48000.0;
+   constexpr auto numChannels = 2;
+   CompressorSettings settings;
+   settings.thresholdDb = -20;
+   settings.ratio = 2;
+   settings.kneeWidthDb = 0;
+   settings.makeupGainDb = 3;
+   settings.attackMs = 1;
+   settings.releaseMs = 10;
+   CompressorProcessor processor { settings };
+   processor.Init(sampleRate, numChannels);
+
+   // A DC level of -6 dB on one channel only; channels are linked
+   constexpr auto len = 48000;
+   std::vector<float> left(len, DbToLinear(-6)), right(len, 0.0f);
+   float* channels[] { left.data(), right.data() };
+   processor.Process(channels, channels, len);
+
+   // 14 dB over threshold, compressed to 7, plus makeup
+   const auto expectedGain = DbToLinear(-7 + 3);
+   REQUIRE(left.back() == Approx(DbToLinear(-6) * expectedGain).epsilon(1e-3));
+   REQUIRE(right.back() == 0.0f);
+   REQUIRE(
+      processor.GetMinGainSinceLastQuery() ==
+      Approx(expectedGain).epsilon(1e-3));
+   // Reset by the query
+   REQUIRE(processor.GetMinGainSinceLastQuery() == 1.0f);
+
+   SECTION("Release recovers the gain after the signal stops")
+   {
+      std::fill(left.begin(), left.end(), 0.0f);
+      processor.Process(channels, channels, len);
+      std::vector<float> probe(64, DbToLinear(-40)), silence(64, 0.0f);
+      float* probeChannels[] { probe.data(), silence.data() };
+      processor.Process(probeChannels, probeChannels, 64);
+      // Only the makeup remains, once the lookahead delay has passed
+      REQUIRE(
+         probe.back() == Approx(DbToLinear(-40) * DbToLinear(3)).epsilon(1e-3));
+   }
+}
@@ -0,0 +1,155 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  PrefetchingChannelReader.cpp
+
+**********************************************************************/
+#include "PrefetchingChannelReader.h"
+#include "WaveTrack.h"
+
+#include <cassert>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace {
+//! The one thread that reads ahead for all readers
+/*!
+ Not a new thread for each block:  the database connection caches prepared
+ statements for each thread that reads from it, until the connection closes
+ */
+class PrefetchThread final
+{
+public:
+   static PrefetchThread &Get()
+   {
+      static PrefetchThread instance;
+      return instance;
+   }
+
+   ~PrefetchThread()
+   {
+      {
+         std::lock_guard<std::mutex> lock{ mMutex };
+         mStopping = true;
+      }
+      mCondition.notify_one();
+      if (mThread.joinable())
+         mThread.join();
+   }
+
+   std::future<void> Submit(std::function<void()> function)
+   {
+      std::packaged_task<void()> task{ move(function) };
+      auto result = task.get_future();
+      {
+         std::lock_guard<std::mutex> lock{ mMutex };
+         if (!mThread.joinable())
+            mThread = std::thread{ [this]{ Run(); } };
+         mTasks.push_back(move(task));
+      }
+      mCondition.notify_one();
+      return result;
+   }
+
+private:
+   void Run()
+   {
+      while (true) {
+         std::packaged_task<void()> task;
+         {
+            std::unique_lock<std::mutex> lock{ mMutex };
+            mCondition.wait(lock,
+               [this]{ return mStopping || !mTasks.empty(); });
+            if (mTasks.empty())
+               return;
+            task = move(mTasks.front());
+            mTasks.pop_front();
+         }
+         // Exceptions go to the future
+         task();
+      }
+   }
+
+   std::mutex mMutex;
+   std::condition_variable mCondition;
+   std::deque<std::packaged_task<void()>> mTasks;
+   bool mStopping{ false };
+   std::thread mThread;
+};
+}
+
+PrefetchingChannelReader::PrefetchingChannelReader(
+   std::vector<const WaveChannel *> channels,
+   sampleCount start, sampleCount end, size_t blockSize
+)  : mChannels{ move(channels) }
+   , mEnd{ end }
+   , mBlockSize{ blockSize }
+   , mNextStart{ start }
+{
+   assert(!mChannels.empty());
+   assert(start <= end);
+   mCapacity = limitSampleBufferSize(
+      mBlockSize > 0 ? mBlockSize : mChannels[0]->GetMaxBlockSize(),
+      std::max<sampleCount>(1, end - start));
+   for (auto &slot : mSlots)
+      for (size_t ii = 0; ii < mChannels.size(); ++ii)
+         slot.buffers.emplace_back(mCapacity);
+   Schedule();
+}
+
+PrefetchingChannelReader::~PrefetchingChannelReader()
+{
+   if (mPending.valid())
+      mPending.wait();
+}
+
+void PrefetchingChannelReader::Schedule()
+{
+   if (mNextStart >= mEnd)
+      return;
+
+   const auto start = mNextStart;
+   const auto length = limitSampleBufferSize(
+      std::min(mCapacity, mBlockSize > 0
+         ? mBlockSize : mChannels[0]->GetBestBlockSize(start)),
+      mEnd - start);
+   mNextStart += length;
+
+   mPendingSlot = 1 - mCurrent;
+   auto &slot = mSlots[mPendingSlot];
+   slot.start = start;
+   slot.length = length;
+   slot.numWithinClips = 0;
+   // The block sequences of the channels must not change until Wait()
+   mPending = PrefetchThread::Get().Submit([this, &slot]{
+      for (size_t ii = 0; ii < mChannels.size(); ++ii)
+         mChannels[ii]->GetFloats(slot.buffers[ii].get(),
+            slot.start, slot.length, FillFormat::fillZero, true,
+            ii == 0 ? &slot.numWithinClips : nullptr);
+   });
+}
+
+void PrefetchingChannelReader::Wait()
+{
+   if (mPending.valid()) {
+      // Unset mPending before get() may rethrow
+      auto pending = move(mPending);
+      pending.get();
+      mReady = true;
+   }
+}
+
+bool PrefetchingChannelReader::Next()
+{
+   Wait();
+   if (!mReady)
+      return false;
+   mReady = false;
+   mCurrent = mPendingSlot;
+   Schedule();
+   return true;
+}
@@ -0,0 +1,119 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  PrefetchingChannelReader.h
+
+  Block reader shared by the analysis and render passes of effects that
+  make more than one pass over the selection
+
+**********************************************************************/
+#ifndef __AUDACITY_PREFETCHING_CHANNEL_READER__
+#define __AUDACITY_PREFETCHING_CHANNEL_READER__
+
+#include "MemoryX.h"
+#include "SampleCount.h"
+
+#include <future>
+#include <vector>
+
+class WaveChannel;
+
+//! Reads consecutive blocks from one or more channels, decoding the next
+//! block on a worker thread, shared by all readers, while the caller computes
+//! on the current one
+/*!
+ Replaces the hand-written loops of GetFloats() calls sized by
+ GetBestBlockSize() or GetMaxBlockSize() in effects.
+
+ The read of block N+1 overlaps only the caller's computation on block N.
+ A caller that writes the channels must call Wait() before doing so, so that
+ no read is in flight while the sequence is modified.  The next block begins
+ reading again only on the following call to Next().
+
+ The channels are read in lockstep, and must have the same rate.
+ */
+class EFFECTS_API PrefetchingChannelReader final
+{
+public:
+   /*!
+    @param blockSize if zero, blocks follow GetBestBlockSize() of the first
+    channel, else all blocks but the last have this size
+    @pre `!channels.empty()`
+    @pre `start <= end`
+    */
+   PrefetchingChannelReader(std::vector<const WaveChannel *> channels,
+      sampleCount start, sampleCount end, size_t blockSize = 0);
+   PrefetchingChannelReader(const PrefetchingChannelReader&) = delete;
+   PrefetchingChannelReader &operator=(const PrefetchingChannelReader&)
+      = delete;
+   //! Waits for a read in flight, discarding any exception from it
+   ~PrefetchingChannelReader();
+
+   //! Make the next block current and start reading the one after it
+   /*!
+    Rethrows any exception from the background read
+    @return false when the range is exhausted
+    */
+   bool Next();
+
+   //! Wait for the read in flight, if any
+   /*!
+    Rethrows any exception from the background read
+    */
+   void Wait();
+
+   size_t NChannels() const { return mChannels.size(); }
+   //! Maximum of Length()
+   size_t Capacity() const { return mCapacity; }
+
+   //! Where the current block starts
+   /*!
+    @pre `Next()` returned true
+    */
+   sampleCount Position() const { return mSlots[mCurrent].start; }
+   //! Length of the current block
+   /*!
+    @pre `Next()` returned true
+    */
+   size_t Length() const { return mSlots[mCurrent].length; }
+   //! Samples of the current block that came from within clips of the
+   //! first channel
+   sampleCount NumWithinClips() const
+   { return mSlots[mCurrent].numWithinClips; }
+
+   //! Samples of the current block, which the caller may modify in place
+   /*!
+    @pre `iChannel < NChannels()`
+    */
+   float *GetBuffer(size_t iChannel)
+   { return mSlots[mCurrent].buffers[iChannel].get(); }
+   const float *GetBuffer(size_t iChannel) const
+   { return mSlots[mCurrent].buffers[iChannel].get(); }
+
+private:
+   struct Slot {
+      std::vector<Floats> buffers;
+      sampleCount start{};
+      size_t length{};
+      sampleCount numWithinClips{};
+   };
+
+   void Schedule();
+
+   const std::vector<const WaveChannel *> mChannels;
+   const sampleCount mEnd;
+   const size_t mBlockSize;
+   size_t mCapacity{};
+
+   Slot mSlots[2];
+   //! Index into mSlots of the block given to the caller
+   size_t mCurrent{ 1 };
+   //! Index into mSlots of the block being read, or already read
+   size_t mPendingSlot{ 0 };
+   std::future<void> mPending;
+   bool mReady{ false };
+   sampleCount mNextStart;
+};
+
+#endif
@@ -0,0 +1,224 @@
+/*  SPDX-License-Identifier: GPL-2.0-or-later */
+/*!********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  PartitionedConvolver.cpp
+
+**********************************************************************/
+#include "PartitionedConvolver.h"
+
+#include <algorithm>
+#include <cassert>
+#include <pffft.h>
+
+namespace {
+//! Partitions per stage, except the last, which takes what remains
+constexpr size_t partitionsPerStage = 4;
+//! Ratio of partition sizes of successive stages
+constexpr size_t growth = 4;
+
+bool IsPowerOfTwo(size_t n)
+{
+   return n > 0 && (n & (n - 1)) == 0;
+}
+}
+
+//! Uniformly partitioned overlap-save convolution with one segment of the
+//! impulse response
+struct PartitionedConvolver::Stage
+{
+   Stage(const float *impulse, size_t impulseLength,
+      size_t partitionSize, size_t offset, size_t nPartitions);
+
+   void Reset();
+
+   //! Append a block of input; when a whole partition has accumulated,
+   //! add the convolution to the ring of output
+   /*!
+    @param time count of input samples, including the block
+    */
+   void Feed(const float *block, size_t blockSize, size_t time,
+      std::vector<float> &accumulator);
+
+   const size_t mPartitionSize;
+   const size_t mFftSize;
+   const size_t mOffset;
+   const size_t mNPartitions;
+   PffftSetupHolder mSetup;
+
+   //! Spectra of the partitions of the impulse response
+   PffftFloatVector mSpectra;
+   //! Spectra of past input, newest at mHead
+   PffftFloatVector mDelayLine;
+   size_t mHead{ 0 };
+
+   //! Previous partition of input, then the one being collected
+   PffftFloatVector mInput;
+   size_t mFill{ 0 };
+
+   PffftFloatVector mSum;
+   PffftFloatVector mWork;
+};
+
+PartitionedConvolver::Stage::Stage(const float *impulse, size_t impulseLength,
+   size_t partitionSize, size_t offset, size_t nPartitions
+)  : mPartitionSize{ partitionSize }
+   , mFftSize{ 2 * partitionSize }
+   , mOffset{ offset }
+   , mNPartitions{ nPartitions }
+   , mSetup{ pffft_new_setup(mFftSize, PFFFT_REAL) }
+   , mSpectra(mFftSize * nPartitions)
+   , mDelayLine(mFftSize * nPartitions)
+   , mInput(mFftSize)
+   , mSum(mFftSize)
+   , mWork(mFftSize)
+{
+   // Transform each zero-padded partition of the impulse response
+   PffftFloatVector segment(mFftSize);
+   for (size_t ii = 0; ii < nPartitions; ++ii) {
+      std::fill(segment.begin(), segment.end(), 0.0f);
+      const auto start = std::min(impulseLength, offset + ii * partitionSize);
+      const auto end = std::min(impulseLength, start + partitionSize);
+      std::copy(impulse + start, impulse + end, segment.begin());
+      pffft_transform(mSetup.get(), segment.data(),
+         mSpectra.data() + ii * mFftSize, mWork.data(), PFFFT_FORWARD);
+   }
+}
+
+void PartitionedConvolver::Stage::Reset()
+{
+   std::fill(mDelayLine.begin(), mDelayLine.end(), 0.0f);
+   std::fill(mInput.begin(), mInput.end(), 0.0f);
+   mHead = 0;
+   mFill = 0;
+}
+
+void PartitionedConvolver::Stage::Feed(const float *block, size_t blockSize,
+   size_t time, std::vector<float> &accumulator)
+{
+   assert(mFill + blockSize <= mPartitionSize);
+   std::copy(block, block + blockSize,
+      mInput.begin() + mPartitionSize + mFill);
+   mFill += blockSize;
+   if (mFill < mPartitionSize)
+      return;
+   mFill = 0;
+
+   // Push the spectrum of the last two partitions of input
+   mHead = (mHead + mNPartitions - 1) % mNPartitions;
+   pffft_transform(mSetup.get(), mInput.data(),
+      mDelayLine.data() + mHead * mFftSize, mWork.data(), PFFFT_FORWARD);
+   std::copy(mInput.begin() + mPartitionSize, mInput.end(), mInput.begin());
+
+   // Multiply and accumulate input spectra with impulse spectra of
+   // corresponding age
+   std::fill(mSum.begin(), mSum.end(), 0.0f);
+   const auto scaling = 1.0f / mFftSize;
+   for (size_t ii = 0; ii < mNPartitions; ++ii) {
+      const auto age = (mHead + ii) % mNPartitions;
+      pffft_zconvolve_accumulate(mSetup.get(),
+         mDelayLine.data() + age * mFftSize, mSpectra.data() + ii * mFftSize,
+         mSum.data(), scaling);
+   }
+   pffft_transform(mSetup.get(), mSum.data(), mSum.data(), mWork.data(),
+      PFFFT_BACKWARD);
+
+   // The second half is free of circular aliasing.  It is output for the
+   // partition of input ending at `time`, delayed by the offset of this
+   // segment of the impulse response
+   const auto size = accumulator.size();
+   auto position = (time - mPartitionSize + mOffset) % size;
+   for (size_t ii = 0; ii < mPartitionSize; ++ii) {
+      accumulator[position] += mSum[mPartitionSize + ii];
+      if (++position == size)
+         position = 0;
+   }
+}
+
+PartitionedConvolver::PartitionedConvolver(const float *impulse,
+   size_t impulseLength, size_t blockSize, size_t maxPartitionSize
+)  : mBlockSize{ blockSize }
+   , mInput(blockSize)
+   , mOutput(blockSize)
+{
+   assert(IsPowerOfTwo(blockSize) && blockSize >= 32);
+   assert(IsPowerOfTwo(maxPartitionSize) && maxPartitionSize >= blockSize);
+
+   // Stage k must start no earlier than its partition size less the block
+   // size, so that its output is ready before it is due.  Four partitions in
+   // each stage before the last satisfy that for the next stage.
+   size_t offset = 0;
+   size_t partitionSize = blockSize;
+   size_t reach = blockSize;
+   while (offset < impulseLength) {
+      const auto remaining = impulseLength - offset;
+      const auto needed = (remaining + partitionSize - 1) / partitionSize;
+      const auto nPartitions = partitionSize < maxPartitionSize
+         ? std::min(needed, partitionsPerStage)
+         : needed;
+      mStages.push_back(std::make_unique<Stage>(
+         impulse, impulseLength, partitionSize, offset, nPartitions));
+      reach = std::max(reach, offset + partitionSize + blockSize);
+      offset += nPartitions * partitionSize;
+      partitionSize = std::min(partitionSize * growth, maxPartitionSize);
+   }
+
+   // Ring size must exceed the farthest write ahead of the emitted samples
+   size_t ringSize = blockSize;
+   while (ringSize < reach)
+      ringSize *= 2;
+   mAccumulator.resize(ringSize);
+}
+
+PartitionedConvolver::~PartitionedConvolver() = default;
+
+size_t PartitionedConvolver::NPartitions() const
+{
+   size_t result = 0;
+   for (const auto &pStage : mStages)
+      result += pStage->mNPartitions;
+   return result;
+}
+
+void PartitionedConvolver::Process(const float *in, float *out, size_t len)
+{
+   for (size_t ii = 0; ii < len; ++ii) {
+      // Read before write, in case in == out
+      mInput[mPosition] = in[ii];
+      out[ii] = mOutput[mPosition];
+      if (++mPosition == mBlockSize) {
+         ProcessBlock();
+         mPosition = 0;
+      }
+   }
+}
+
+void PartitionedConvolver::ProcessBlock()
+{
+   ++mBlockCount;
+   const auto time = mBlockCount * mBlockSize;
+   for (auto &pStage : mStages)
+      pStage->Feed(mInput.data(), mBlockSize, time, mAccumulator);
+
+   // Emit and clear the block of the ring that is now complete
+   const auto size = mAccumulator.size();
+   auto position = (time - mBlockSize) % size;
+   for (size_t ii = 0; ii < mBlockSize; ++ii) {
+      mOutput[ii] = mAccumulator[position];
+      mAccumulator[position] = 0;
+      if (++position == size)
+         position = 0;
+   }
+}
+
+void PartitionedConvolver::Reset()
+{
+   for (auto &pStage : mStages)
+      pStage->Reset();
+   std::fill(mInput.begin(), mInput.end(), 0.0f);
+   std::fill(mOutput.begin(), mOutput.end(), 0.0f);
+   std::fill(mAccumulator.begin(), mAccumulator.end(), 0.0f);
+   mPosition = 0;
+   mBlockCount = 0;
+}
@@ -0,0 +1,82 @@
+/*  SPDX-License-Identifier: GPL-2.0-or-later */
+/*!********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  PartitionedConvolver.h
+
+**********************************************************************/
+#pragma once
+
+#include "PowerSpectrumGetter.h"
+
+#include <memory>
+#include <vector>
+
+/*!
+ * @brief Streaming convolution with a long impulse response, in constant
+ * latency and with cost per sample growing only logarithmically with the
+ * impulse length.
+ *
+ * @details The impulse response is cut into non-uniform partitions.  The
+ * head uses partitions of `blockSize` samples, which is also the latency.
+ * Following stages use partitions four times as long as those of the
+ * previous stage, up to `maxPartitionSize`, and start late enough in the
+ * impulse response that their own longer block delay is hidden.
+ *
+ * Each stage is a uniformly partitioned overlap-save convolver with a
+ * frequency domain delay line; spectra are multiplied and accumulated with
+ * the vectorized `pffft_zconvolve_accumulate`.
+ *
+ * Not thread safe, but the immutable spectra of the impulse response could be
+ * shared by several instances.
+ */
+class FFT_API PartitionedConvolver final
+{
+public:
+   /*!
+    * @param blockSize partition size of the head, and the latency
+    * @param maxPartitionSize largest partition size of the tail
+    * @pre `blockSize` is a power of two, at least 32
+    * @pre `maxPartitionSize` is a power of two, at least `blockSize`
+    */
+   PartitionedConvolver(const float *impulse, size_t impulseLength,
+      size_t blockSize = 256, size_t maxPartitionSize = 16384);
+   ~PartitionedConvolver();
+
+   //! Delay of output relative to input, in samples
+   size_t Latency() const { return mBlockSize; }
+
+   //! Number of partitions of the impulse response over all stages
+   size_t NPartitions() const;
+
+   /*!
+    * @brief Consume `len` input samples and produce `len` output samples.
+    * The first `Latency()` output samples after construction or Reset() are
+    * silence.
+    * @pre `in` and `out` do not overlap, unless they are equal
+    */
+   void Process(const float *in, float *out, size_t len);
+
+   //! Discard all history, so the next Process() starts from silence
+   void Reset();
+
+private:
+   struct Stage;
+
+   void ProcessBlock();
+
+   const size_t mBlockSize;
+   std::vector<std::unique_ptr<Stage>> mStages;
+
+   //! Input samples of the block being collected
+   std::vector<float> mInput;
+   //! Output samples of the previous block, being emitted
+   std::vector<float> mOutput;
+   size_t mPosition{ 0 };
+
+   //! Ring of accumulated output from all stages, indexed by sample time
+   std::vector<float> mAccumulator;
+   //! Number of blocks processed since the last Reset()
+   size_t mBlockCount{ 0 };
+};
@@ -0,0 +1,95 @@
+/*  SPDX-License-Identifier: GPL-2.0-or-later */
+/*!********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  PartitionedConvolverTests.cpp
+
+**********************************************************************/
+#include "PartitionedConvolver.h"
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <random>
+
+namespace {
+std::vector<float> Noise(size_t length, unsigned seed)
+{
+   std::mt19937 engine{ seed };
+   std::uniform_real_distribution<float> distribution{ -1.0f, 1.0f };
+   std::vector<float> result(length);
+   std::generate(result.begin(), result.end(),
+      [&]{ return distribution(engine); });
+   return result;
+}
+
+std::vector<double> DirectConvolution(
+   const std::vector<float> &x, const std::vector<float> &h)
+{
+   std::vector<double> result(x.size());
+   for (size_t n = 0; n < x.size(); ++n)
+      for (size_t k = 0; k < h.size() && k <= n; ++k)
+         result[n] += double(x[n - k]) * h[k];
+   return result;
+}
+}
+
+TEST_CASE("PartitionedConvolver")
+{
+   SECTION("matches direct convolution after the latency")
+   {
+      const size_t blockSize = GENERATE(32, 64, 256);
+      const size_t impulseLength = GENERATE(1, 100, 1000, 5000);
+      const auto impulse = Noise(impulseLength, 1);
+      const auto input = Noise(12000, 2);
+      const auto expected = DirectConvolution(input, impulse);
+
+      PartitionedConvolver convolver{
+         impulse.data(), impulse.size(), blockSize, 1024 };
+      const auto latency = convolver.Latency();
+      REQUIRE(latency == blockSize);
+
+      // Feed in irregular chunks
+      std::vector<float> output(input.size());
+      size_t pos = 0, chunk = 1;
+      while (pos < input.size()) {
+         const auto len = std::min(chunk, input.size() - pos);
+         convolver.Process(input.data() + pos, output.data() + pos, len);
+         pos += len;
+         chunk = (chunk * 7) % 333 + 1;
+      }
+
+      for (size_t ii = 0; ii < latency; ++ii)
+         REQUIRE(output[ii] == 0.0f);
+      double maxError = 0;
+      for (size_t ii = latency; ii < output.size(); ++ii)
+         maxError = std::max(maxError,
+            std::abs(output[ii] - expected[ii - latency]));
+      REQUIRE(maxError < 1e-3);
+   }
+
+   SECTION("Reset restarts from silence")
+   {
+      const auto impulse = Noise(3000, 3);
+      const auto input = Noise(4096, 4);
+      PartitionedConvolver convolver{ impulse.data(), impulse.size(), 64 };
+      std::vector<float> first(input.size()), second(input.size());
+      convolver.Process(input.data(), first.data(), input.size());
+      convolver.Reset();
+      convolver.Process(input.data(), second.data(), input.size());
+      REQUIRE(first == second);
+   }
+
+   SECTION("processes in place")
+   {
+      const auto impulse = Noise(700, 5);
+      auto input = Noise(3000, 6);
+      PartitionedConvolver a{ impulse.data(), impulse.size(), 32 };
+      PartitionedConvolver b{ impulse.data(), impulse.size(), 32 };
+      std::vector<float> output(input.size());
+      a.Process(input.data(), output.data(), input.size());
+      b.Process(input.data(), input.data(), input.size());
+      REQUIRE(output == input);
+   }
+}
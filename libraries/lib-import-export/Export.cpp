@@ -81,6 +81,12 @@ ExportTaskBuilder& ExportTaskBuilder::SetTags(const Tags *tags) noexcept
    return *this;
 }
 
+ExportTaskBuilder& ExportTaskBuilder::SetDraftQuality(bool draftQuality) noexcept
+{
+   mDraftQuality = draftQuality;
+   return *this;
+}
+
 ExportTask ExportTaskBuilder::Build(AudacityProject& project)
 {
    //File rename stuff should be moved out to somewhere else...
@@ -96,6 +102,8 @@ ExportTask ExportTaskBuilder::Build(AudacityProject& project)
    }
 
    auto processor = mPlugin->CreateProcessor(mFormat);
+   // Processors make their mixers in Initialize()
+   processor->SetDraftQuality(mDraftQuality);
    if(!processor->Initialize(project,
       mParameters,
       mFileName.GetFullPath(),
@@ -44,6 +44,9 @@ public:
    ExportTaskBuilder& SetTags(const Tags* tags) noexcept;
    ExportTaskBuilder& SetSampleRate(double sampleRate) noexcept;
    ExportTaskBuilder& SetMixerSpec(MixerOptions::Downmix* mixerSpec) noexcept;
+   //! Trade quality of mixing for speed, as for previews; the processor's
+   //! mixers decimate tracks and resample and dither faster
+   ExportTaskBuilder& SetDraftQuality(bool draftQuality) noexcept;
    
    ExportTask Build(AudacityProject& project);
    
@@ -59,6 +62,7 @@ private:
    int mFormat{};
    MixerOptions::Downmix* mMixerSpec{};//Should be const
    const Tags* mTags{};
+   bool mDraftQuality{};
 };
 
 void IMPORT_EXPORT_API ShowExportErrorDialog(const TranslatableString& message,
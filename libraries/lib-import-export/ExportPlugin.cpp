@@ -66,6 +66,16 @@ ExportProcessorDelegate::~ExportProcessorDelegate() = default;
 
 ExportProcessor::~ExportProcessor() = default;
 
+void ExportProcessor::SetDraftQuality(bool draftQuality) noexcept
+{
+   mDraftQuality = draftQuality;
+}
+
+bool ExportProcessor::IsDraftQuality() const noexcept
+{
+   return mDraftQuality;
+}
+
 ExportPlugin::ExportPlugin() = default;
 ExportPlugin::~ExportPlugin() = default;
 
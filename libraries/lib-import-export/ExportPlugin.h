@@ -120,6 +120,15 @@ public:
       const Tags* tags = nullptr) = 0;
    
    virtual ExportResult Process(ExportProcessorDelegate& delegate) = 0;
+
+   //! Set before Initialize(); implementations pass `!IsDraftQuality()` as
+   //! the quality of the mixers they make
+   void SetDraftQuality(bool draftQuality) noexcept;
+   //! Whether to trade quality of mixing for speed, as for previews
+   bool IsDraftQuality() const noexcept;
+
+private:
+   bool mDraftQuality{};
 };
 
 //----------------------------------------------------------------------------
@@ -17,6 +17,8 @@
 #include "MixAndRender.h"
 #include "ExportUtils.h"
 #include "ExportPlugin.h"
+#include "PipelinedMixer.h"
+#include "DecimatingSequence.h"
 #include "StretchingSequence.h"
 
 //Create a mixer by computing the time warp factor
@@ -25,14 +27,21 @@ std::unique_ptr<Mixer> ExportPluginHelpers::CreateMixer(const TrackList &tracks,
          double startTime, double stopTime,
          unsigned numOutChannels, size_t outBufferSize, bool outInterleaved,
          double outRate, sampleFormat outFormat,
-         MixerOptions::Downmix *mixerSpec)
+         bool highQuality, MixerOptions::Downmix *mixerSpec)
 {
    Mixer::Inputs inputs;
 
    for (auto pTrack: ExportUtils::FindExportWaveTracks(tracks, selectionOnly))
-      inputs.emplace_back(
-         StretchingSequence::Create(*pTrack, pTrack->GetClipInterfaces()),
-         GetEffectStages(*pTrack));
+   {
+      std::shared_ptr<const WideSampleSequence> pSequence =
+         StretchingSequence::Create(*pTrack, pTrack->GetClipInterfaces());
+      // Mix fewer samples, and resample less or not at all
+      if (const auto factor = static_cast<size_t>(pTrack->GetRate() / outRate);
+          !highQuality && factor > 1)
+         pSequence =
+            std::make_shared<DecimatingSequence>(move(pSequence), factor);
+      inputs.emplace_back(move(pSequence), GetEffectStages(*pTrack));
+   }
    // MB: the stop time should not be warped, this was a bug.
    return std::make_unique<Mixer>(move(inputs),
                   // Throw, to stop exporting, if read fails:
@@ -41,28 +50,38 @@ std::unique_ptr<Mixer> ExportPluginHelpers::CreateMixer(const TrackList &tracks,
                   startTime, stopTime,
                   numOutChannels, outBufferSize, outInterleaved,
                   outRate, outFormat,
-                  true, mixerSpec,
+                  highQuality, mixerSpec,
                   mixerSpec ? Mixer::ApplyGain::MapChannels : Mixer::ApplyGain::Mixdown);
 }
 
 namespace
 {
-   double EvalExportProgress(Mixer &mixer, double t0, double t1)
+   double EvalExportProgress(double time, double t0, double t1)
    {
       const auto duration = t1 - t0;
       if(duration > 0)
-         return std::clamp(mixer.MixGetCurrentTime() - t0, .0, duration) / duration;
+         return std::clamp(time - t0, .0, duration) / duration;
       return .0;
    }
+
+   ExportResult DoUpdateProgress(ExportProcessorDelegate& delegate, double time, double t0, double t1)
+   {
+      delegate.OnProgress(EvalExportProgress(time, t0, t1));
+      if(delegate.IsStopped())
+         return ExportResult::Stopped;
+      if(delegate.IsCancelled())
+         return ExportResult::Cancelled;
+      return ExportResult::Success;
+   }
 }
 
 ExportResult ExportPluginHelpers::UpdateProgress(ExportProcessorDelegate& delegate, Mixer &mixer, double t0, double t1)
 {
-   delegate.OnProgress(EvalExportProgress(mixer, t0, t1));
-   if(delegate.IsStopped())
-      return ExportResult::Stopped;
-   if(delegate.IsCancelled())
-      return ExportResult::Cancelled;
-   return ExportResult::Success;
+   return DoUpdateProgress(delegate, mixer.MixGetCurrentTime(), t0, t1);
+}
+
+ExportResult ExportPluginHelpers::UpdateProgress(ExportProcessorDelegate& delegate, const PipelinedMixer &mixer, double t0, double t1)
+{
+   return DoUpdateProgress(delegate, mixer.MixGetCurrentTime(), t0, t1);
 }
 
@@ -21,6 +21,7 @@
 class TrackList;
 class WaveTrack;
 class Mixer;
+class PipelinedMixer;
 
 namespace MixerOptions
 {
@@ -32,16 +33,22 @@ class IMPORT_EXPORT_API ExportPluginHelpers final
 {
 public:
 
+   /*!
+    @param highQuality if false, tracks at a multiple of `outRate` are read
+    through a DecimatingSequence, and the mixer resamples and dithers
+    faster, as for previews
+    */
    static std::unique_ptr<Mixer> CreateMixer(const TrackList &tracks,
          bool selectionOnly,
          double startTime, double stopTime,
          unsigned numOutChannels, size_t outBufferSize, bool outInterleaved,
          double outRate, sampleFormat outFormat,
-         MixerOptions::Downmix *mixerSpec);
+         bool highQuality, MixerOptions::Downmix *mixerSpec);
 
    ///\brief Sends progress update to delegate and retrieves state update from it.
    ///Typically used inside each export iteration.
    static ExportResult UpdateProgress(ExportProcessorDelegate& delegate, Mixer& mixer, double t0, double t1);
+   static ExportResult UpdateProgress(ExportProcessorDelegate& delegate, const PipelinedMixer& mixer, double t0, double t1);
 
    template<typename T>
    static T GetParameterValue(const ExportProcessor::Parameters& parameters, int id, T defaultValue = T())
@@ -100,3 +100,32 @@ ExportResult ExportProgressUI::Show(ExportTask exportTask)
 
    return result;
 }
+
+size_t ExportProgressUI::ShowParallel(size_t first, size_t last,
+   const ParallelExport::TaskFactory& makeTask,
+   const ParallelExport::ResultHandler& onResult, size_t maxWorkers)
+{
+   DialogExportProgressDelegate delegate;
+   auto next = last;
+   auto anyError = false;
+
+   ExceptionWrappedCall([&] {
+      next = ParallelExport::Run(first, last, makeTask,
+         [&](size_t index, ExportResult result) {
+            anyError = anyError || result == ExportResult::Error;
+            if(onResult)
+               onResult(index, result);
+         },
+         delegate, [&] { delegate.UpdateUI(); }, maxWorkers);
+   });
+
+   if(anyError)
+   {
+      BasicUI::ShowErrorDialog(
+         {}, XO("Export error"),
+         XO("Export completed with error."), {},
+         BasicUI::ErrorDialogOptions { BasicUI::ErrorDialogType::ModalError });
+   }
+
+   return next;
+}
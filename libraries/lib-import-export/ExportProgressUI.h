@@ -16,6 +16,7 @@
 #include "ExportTypes.h"
 #include "BasicUI.h"
 #include "ExportPlugin.h"
+#include "ParallelExport.h"
 #include "wxFileNameWrapper.h"
 
 class ExportProcessorDelegate;
@@ -25,6 +26,14 @@ namespace ExportProgressUI
 {
 IMPORT_EXPORT_API ExportResult Show(ExportTask exportTask);
 
+//! Like Show(), for the tasks with indices in [first, last), running several
+//! at once under one progress dialog
+/*! See ParallelExport::Run()
+ @return the index after the last task made */
+IMPORT_EXPORT_API size_t ShowParallel(size_t first, size_t last,
+   const ParallelExport::TaskFactory& makeTask,
+   const ParallelExport::ResultHandler& onResult, size_t maxWorkers = 0);
+
 template <typename Callable>
 void ExceptionWrappedCall(Callable callable)
 {
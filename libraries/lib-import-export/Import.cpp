@@ -37,11 +37,19 @@ ImportFileHandle
 #include "ImportPlugin.h"
 
 #include <algorithm>
+#include <atomic>
+#include <future>
+#include <thread>
 #include <unordered_set>
 
 #include <wx/log.h>
+#include "BasicUI.h"
 #include "FileNames.h"
+#include "MemorySampleBlockFactory.h"
+#include "OnDemandImport.h"
 #include "Project.h"
+#include "ProjectRate.h"
+#include "Tags.h"
 #include "WaveTrack.h"
 
 #include "Prefs.h"
@@ -90,6 +98,66 @@ public:
    }
 };
 
+//! Records the progress and result of a file imported on a worker thread
+class TaskListener final : public ImportProgressListener
+{
+   std::atomic<double> mProgress{};
+   std::atomic<ImportResult> mResult{ ImportResult::Error };
+public:
+   bool OnImportFileOpened(ImportFileHandle&) override
+   {
+      // Streams were chosen before the worker started
+      return true;
+   }
+
+   void OnImportProgress(double progress) override
+   {
+      mProgress = progress;
+   }
+
+   void OnImportResult(ImportResult result) override
+   {
+      mResult = result;
+   }
+
+   double GetProgress() const
+   {
+      return std::clamp(mProgress.load(), .0, 1.0);
+   }
+
+   ImportResult GetResult() const
+   {
+      return mResult;
+   }
+};
+
+bool IsNotAudio(const FilePath& fName, TranslatableString& errorMessage)
+{
+   // Bug #2647: Peter has a Word 2000 .doc file that is recognized and imported by FFmpeg.
+   if (wxFileName(fName).GetExt() == wxT("doc")) {
+      errorMessage =
+         XO("\"%s\" \nis a not an audio file. \nAudacity cannot open this type of file.")
+         .Format( fName );
+      return true;
+   }
+   return false;
+}
+
+//! Make the tracks at once and decode in the background, if so preferred and
+//! the file allows it
+bool ImportOnDemand(AudacityProject& project, ImportFileHandle& handle,
+   WaveTrackFactory* trackFactory, TrackHolders& tracks, Tags* tags)
+{
+   if (!trackFactory || !OnDemandImporting.Read())
+      return false;
+   auto pDecoder = handle.MakeOnDemandDecoder(tags);
+   if (!pDecoder)
+      return false;
+   OnDemandImports::Get(project).Start(
+      std::move(pDecoder), *trackFactory, tracks);
+   return !tracks.empty();
+}
+
 }
 
 // ============================================================================
@@ -493,24 +561,22 @@ bool Importer::Import(
    AudacityProject *pProj = &project;
    auto cleanup = valueRestorer( pProj->mbBusyImporting, true );
 
-   const FileExtension extension{ fName.AfterLast(wxT('.')) };
-
-   // Bug #2647: Peter has a Word 2000 .doc file that is recognized and imported by FFmpeg.
-   if (wxFileName(fName).GetExt() == wxT("doc")) {
-      errorMessage =
-         XO("\"%s\" \nis a not an audio file. \nAudacity cannot open this type of file.")
-         .Format( fName );
+   if (IsNotAudio(fName, errorMessage))
       return false;
-   }
 
-   using ImportPluginPtrs = std::vector< ImportPlugin* >;
+   const auto importPlugins = SortPlugins(fName);
+   return ImportWith(project, fName, importPlugins.begin(), importPlugins.end(),
+      importProgressListener, trackFactory, tracks, tags, outAcidTags,
+      errorMessage);
+}
+
+auto Importer::SortPlugins(const FilePath& fName) -> ImportPluginPtrs
+{
+   const FileExtension extension{ fName.AfterLast(wxT('.')) };
 
    // This list is used to call plugins in correct order
    ImportPluginPtrs importPlugins;
 
-   // This list is used to remember plugins that should have been compatible with the file.
-   ImportPluginPtrs compatiblePlugins;
-
    // Not implemented (yet?)
    wxString mime_type = wxT("*");
 
@@ -622,11 +688,30 @@ bool Importer::Import(
       }
    }
 
+   return importPlugins;
+}
+
+bool Importer::ImportWith(
+   AudacityProject& project, const FilePath& fName,
+   ImportPluginPtrs::const_iterator first,
+   ImportPluginPtrs::const_iterator last,
+   ImportProgressListener* importProgressListener,
+   WaveTrackFactory* trackFactory, TrackHolders& tracks, Tags* tags,
+   std::optional<LibFileFormats::AcidizerTags>& outAcidTags,
+   TranslatableString& errorMessage)
+{
+   AudacityProject *pProj = &project;
+   const FileExtension extension{ fName.AfterLast(wxT('.')) };
+
+   // This list is used to remember plugins that should have been compatible with the file.
+   ImportPluginPtrs compatiblePlugins;
+
    ImportProgressResultProxy importResultProxy(importProgressListener);
 
    // Try the import plugins, in the permuted sequences just determined
-   for (const auto plugin : importPlugins)
+   for (auto iter = first; iter != last; ++iter)
    {
+      const auto plugin = *iter;
       // Try to open the file with this plugin (probe it)
       wxLogMessage(wxT("Opening with %s"),plugin->GetPluginStringID());
       auto inFile = plugin->Open(fName, pProj);
@@ -636,6 +721,13 @@ bool Importer::Import(
          if(!importResultProxy.OnImportFileOpened(*inFile))
             return false;
 
+         if (ImportOnDemand(project, *inFile, trackFactory, tracks, tags))
+         {
+            importResultProxy.OnImportResult(
+               ImportProgressListener::ImportResult::Success);
+            return true;
+         }
+
          inFile->Import(
             importResultProxy, trackFactory, tracks, tags, outAcidTags);
          const auto importResult = importResultProxy.GetResult();
@@ -834,4 +926,226 @@ bool Importer::Import(
    return false;
 }
 
+namespace {
+struct RunningImport
+{
+   size_t index;
+   std::unique_ptr<ImportFileHandle> handle;
+   //! Plugins to try after a failure to decode
+   std::vector<ImportPlugin*> otherPlugins;
+   std::unique_ptr<TaskListener> listener;
+   //! Makes the tracks of the worker, with blocks in memory
+   std::unique_ptr<WaveTrackFactory> memoryFactory;
+   std::future<void> future;
+   std::thread thread;
+};
+}
+
+auto Importer::ImportFiles(
+   AudacityProject& project, const FilePaths& fileNames,
+   ImportProgressListener* importProgressListener,
+   WaveTrackFactory* trackFactory, const Tags& tags,
+   const ProgressPoll& poll, size_t maxWorkers) -> std::vector<ImportedFile>
+{
+   using namespace std::chrono_literals;
+   using BasicUI::ProgressResult;
+   using ImportResult = ImportProgressListener::ImportResult;
+
+   AudacityProject *pProj = &project;
+   auto busy = valueRestorer( pProj->mbBusyImporting, true );
+
+   if (maxWorkers == 0)
+      maxWorkers = std::max(1u, std::thread::hardware_concurrency());
+   const auto nFiles = fileNames.size();
+   std::vector<ImportedFile> results(nFiles);
+   for (auto& result : results)
+      result.tags = tags.Duplicate();
+
+   std::vector<RunningImport> running;
+   // So that a started thread is never lost to a failure of push_back
+   running.reserve(std::min(maxWorkers, nFiles));
+   auto cleanup = finally([&] {
+      // Only if a plugin, the listener, or poll threw
+      for (auto& task : running)
+      {
+         task.handle->Cancel();
+         task.thread.join();
+      }
+   });
+
+   size_t next = 0;
+   size_t nFinished = 0;
+   // Least index of a file that failed or was cancelled
+   auto failed = nFiles;
+   auto progressResult = ProgressResult::Success;
+   std::exception_ptr exception;
+   auto exceptionIndex = nFiles;
+
+   // Running files of greater index are cancelled at the next pass
+   const auto fail = [&](size_t index) {
+      failed = std::min(failed, index);
+   };
+
+   // Probe as Import() does, and decode with the first plugin that opens
+   // the file
+   const auto start = [&](size_t index) {
+      auto& result = results[index];
+      const auto& fName = fileNames[index];
+      if (IsNotAudio(fName, result.errorMessage))
+         return fail(index);
+
+      auto plugins = SortPlugins(fName);
+      for (auto iter = plugins.cbegin(); iter != plugins.cend(); ++iter)
+      {
+         wxLogMessage(wxT("Opening with %s"), (*iter)->GetPluginStringID());
+         auto handle = (*iter)->Open(fName, pProj);
+         if (!handle || handle->GetStreamCount() <= 0)
+            continue;
+         wxLogMessage(wxT("Open(%s) succeeded"), fName);
+         if (importProgressListener &&
+             !importProgressListener->OnImportFileOpened(*handle))
+            return fail(index);
+
+         if (ImportOnDemand(project, *handle, trackFactory,
+            result.tracks, result.tags.get()))
+         {
+            result.success = true;
+            ++nFinished;
+            return;
+         }
+
+         // The worker decodes into blocks in memory; only this thread makes
+         // blocks in the project, whose database connection must not insert
+         // from several threads at once
+         auto listener = std::make_unique<TaskListener>();
+         auto memoryFactory = trackFactory
+            ? std::make_unique<WaveTrackFactory>(ProjectRate::Get(project),
+               std::make_shared<MemorySampleBlockFactory>())
+            : nullptr;
+         std::packaged_task<void()> task { [&result,
+            &handle = *handle, &listener = *listener,
+            pMemoryFactory = memoryFactory.get()]
+         {
+            handle.Import(listener, pMemoryFactory,
+               result.tracks, result.tags.get(), result.acidTags);
+         } };
+         auto future = task.get_future();
+         std::vector<ImportPlugin*> otherPlugins(iter + 1, plugins.cend());
+         std::thread thread(std::move(task));
+         running.push_back({ index, std::move(handle), std::move(otherPlugins),
+            std::move(listener), std::move(memoryFactory), std::move(future),
+            std::move(thread) });
+         return;
+      }
+
+      // No plugin opened the file; explain why
+      ImportWith(project, fName, plugins.cend(), plugins.cend(),
+         importProgressListener, trackFactory, result.tracks,
+         result.tags.get(), result.acidTags, result.errorMessage);
+      fail(index);
+   };
+
+   const auto finish = [&](RunningImport& task) {
+      task.thread.join();
+      ++nFinished;
+      auto& result = results[task.index];
+      try
+      {
+         task.future.get();
+      }
+      catch(...)
+      {
+         if (task.index < exceptionIndex)
+         {
+            exceptionIndex = task.index;
+            exception = std::current_exception();
+         }
+         return fail(task.index);
+      }
+
+      const auto importResult = task.listener->GetResult();
+      if ((importResult == ImportResult::Success ||
+           importResult == ImportResult::Stopped) &&
+          !result.tracks.empty())
+      {
+         // Store the samples in the project, on this thread
+         if (task.memoryFactory)
+            for (auto& pTrack : result.tracks)
+               if (const auto pWaveTrack =
+                      dynamic_cast<const WaveTrack*>(pTrack.get()))
+                  pTrack = pWaveTrack->DuplicateWithFactory(
+                     trackFactory->GetSampleBlockFactory());
+         result.success = true;
+      }
+      else if (importResult == ImportResult::Cancelled ||
+         progressResult != ProgressResult::Success || task.index > failed)
+         fail(task.index);
+      else
+      {
+         // Try the remaining plugins on this thread, as Import() would
+         const auto message = task.handle->GetErrorMessage();
+         result.tracks.clear();
+         result.tags = tags.Duplicate();
+         result.acidTags.reset();
+         const auto& others = task.otherPlugins;
+         result.success = ImportWith(project, fileNames[task.index],
+            others.cbegin(), others.cend(), importProgressListener,
+            trackFactory, result.tracks, result.tags.get(), result.acidTags,
+            result.errorMessage);
+         if (!result.success)
+         {
+            if (!message.empty())
+               result.errorMessage = message;
+            fail(task.index);
+         }
+      }
+   };
+
+   while (true)
+   {
+      while (running.size() < maxWorkers && next < failed &&
+         progressResult == ProgressResult::Success)
+         start(next++);
+      if (running.empty())
+         break;
+
+      // Wait a while, or until the earliest file is done
+      running.front().future.wait_for(50ms);
+      for (auto iter = running.begin(); iter != running.end();)
+      {
+         if (iter->future.wait_for(0ms) == std::future_status::ready)
+         {
+            auto task = std::move(*iter);
+            iter = running.erase(iter);
+            finish(task);
+         }
+         else
+            ++iter;
+      }
+
+      double done = nFinished;
+      for (auto& task : running)
+         done += task.listener->GetProgress();
+      if (poll)
+      {
+         const auto pollResult = poll(nFiles > 0 ? done / nFiles : 1.0);
+         if (progressResult == ProgressResult::Success)
+            progressResult = pollResult;
+      }
+      // Repeated at each pass, in case a worker had not yet begun its import
+      for (auto& task : running)
+      {
+         if (progressResult == ProgressResult::Stopped)
+            task.handle->Stop();
+         else if (progressResult != ProgressResult::Success ||
+            task.index > failed)
+            task.handle->Cancel();
+      }
+   }
+
+   if (exception)
+      std::rethrow_exception(exception);
+   return results;
+}
+
 BoolSetting NewImportingSession{ L"/NewImportingSession", false };
@@ -12,7 +12,12 @@
 #define _IMPORT_
 
 #include "ImportForwards.h"
+#include "AcidizerTags.h"
 #include "Identifier.h"
+#include "TranslatableString.h"
+#include <functional>
+#include <memory>
+#include <optional>
 #include <vector>
 #include <wx/tokenzr.h> // for enum wxStringTokenizerMode
 
@@ -34,9 +39,9 @@ typedef bool (*progress_callback_t)( void *userData, float percent );
 class ExtImportItem;
 class WaveTrack;
 
-namespace LibFileFormats
+namespace BasicUI
 {
-struct AcidizerTags;
+enum class ProgressResult : unsigned;
 }
 
 using ExtImportItems = std::vector<std::unique_ptr<ExtImportItem>>;
@@ -182,7 +187,70 @@ public:
        std::optional<LibFileFormats::AcidizerTags>& outAcidTags,
        TranslatableString& errorMessage);
 
+    //! What ImportFiles() gives for each file
+    struct ImportedFile
+    {
+       TrackHolders tracks;
+       //! Starts as a copy of the tags given to ImportFiles()
+       std::shared_ptr<Tags> tags;
+       std::optional<LibFileFormats::AcidizerTags> acidTags;
+       TranslatableString errorMessage;
+       bool success{ false };
+    };
+
+    //! Receives, about every 50 ms, the fraction of all the files that is
+    //! imported, and says whether to go on, stop or cancel
+    using ProgressPoll = std::function<BasicUI::ProgressResult(double)>;
+
+    //! Like Import() for each file, but several files are decoded at once, on
+    //! worker threads, each into its own tracks
+    /*!
+     Files are probed, and the listener told of each opened file so that it
+     may choose streams, on this thread, in order of the files, as workers
+     become free.  The listener is not told of progress or results of the
+     decoding on workers; poll is, instead.  If a file fails to decode, the
+     plugins not yet tried for it are tried here, as by Import(), with the
+     listener.
+
+     Workers decode into sample blocks in memory; this thread copies each
+     finished file into blocks of trackFactory, so that only this thread
+     stores blocks in the project.
+
+     No more files are started after a cancellation, a stop, or a failure;
+     running files with greater indices are then cancelled, so that the
+     successes make a prefix of the files, as when imported one at a time.
+
+     @pre none of the files is a project or a list of files, whose import
+     changes the project
+     @param tags copied for each file
+     @param maxWorkers 0 for the number of hardware threads
+     @return a result for each file, in the same order
+     @throws the exception from the file of least index that threw, after the
+     others finish
+     */
+    std::vector<ImportedFile> ImportFiles(
+       AudacityProject& project, const FilePaths& fileNames,
+       ImportProgressListener* importProgressListener,
+       WaveTrackFactory* trackFactory, const Tags& tags,
+       const ProgressPoll& poll, size_t maxWorkers = 0);
+
  private:
+    using ImportPluginPtrs = std::vector<ImportPlugin*>;
+
+    //! Plugins to try for the file, in order of preference
+    ImportPluginPtrs SortPlugins(const FilePath& fName);
+
+    //! Try the plugins in [first, last), then explain the failure if none
+    //! succeeded
+    bool ImportWith(
+       AudacityProject& project, const FilePath& fName,
+       ImportPluginPtrs::const_iterator first,
+       ImportPluginPtrs::const_iterator last,
+       ImportProgressListener* importProgressListener,
+       WaveTrackFactory* trackFactory, TrackHolders& tracks, Tags* tags,
+       std::optional<LibFileFormats::AcidizerTags>& outAcidTags,
+       TranslatableString& errorMessage);
+
     struct Traits : Registry::DefaultTraits
     {
        using LeafTypes = List<ImporterItem>;
@@ -9,6 +9,7 @@ Paul Licameli split from Import.cpp
 **********************************************************************/
 
 #include "ImportPlugin.h"
+#include "OnDemandImport.h"
 
 #include <wx/filename.h>
 
@@ -80,3 +81,9 @@ TranslatableString ImportFileHandle::GetErrorMessage() const
 {
    return {};
 }
+
+std::unique_ptr<OnDemandDecoder>
+ImportFileHandle::MakeOnDemandDecoder(Tags*)
+{
+   return nullptr;
+}
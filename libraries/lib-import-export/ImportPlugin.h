@@ -49,6 +49,7 @@ but little else.
 #include "Identifier.h"
 #include "Internat.h"
 #include "wxArrayStringEx.h"
+#include <atomic>
 #include <memory>
 #include <optional>
 
@@ -62,6 +63,7 @@ class Tags;
 class ImportFileHandle;
 
 class ImportProgressListener;
+class OnDemandDecoder;
 
 class IMPORT_EXPORT_API ImportPlugin /* not final */
 {
@@ -150,6 +152,15 @@ public:
       TrackHolders& outTracks, Tags* tags,
       std::optional<LibFileFormats::AcidizerTags>& acidTags) = 0;
 
+   //! Instead of Import(), make a decoder for import on demand, if the format
+   //! allows exact seeking; see OnDemandImports
+   /*!
+    Called on the main thread, after the choice of streams.  Default returns
+    null.
+    @param tags receives the tags of the file, if the result is not null
+    */
+   virtual std::unique_ptr<OnDemandDecoder> MakeOnDemandDecoder(Tags* tags);
+
    virtual void Cancel() = 0;
 
    virtual void Stop() = 0;
@@ -158,8 +169,9 @@ public:
 class IMPORT_EXPORT_API ImportFileHandleEx : public ImportFileHandle
 {
    FilePath mFilename;
-   bool mCancelled{false};
-   bool mStopped{false};
+   // Cancel() and Stop() may come from another thread than Import()
+   std::atomic<bool> mCancelled{false};
+   std::atomic<bool> mStopped{false};
 public:
    ImportFileHandleEx(const FilePath& filename);
 
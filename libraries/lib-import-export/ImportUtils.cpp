@@ -42,6 +42,12 @@ ImportUtils::NewWaveTrack(WaveTrackFactory &trackFactory,
 
 void ImportUtils::ShowMessageBox(const TranslatableString &message, const TranslatableString& caption)
 {
+   // Files may be imported on worker threads; see Importer::ImportFiles()
+   if (!BasicUI::IsUiThread())
+   {
+      BasicUI::CallAfter([message, caption] { ShowMessageBox(message, caption); });
+      return;
+   }
    BasicUI::ShowMessageBox(message,
                            BasicUI::MessageBoxOptions().Caption(caption));
 }
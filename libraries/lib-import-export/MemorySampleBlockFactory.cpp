@@ -0,0 +1,164 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  MemorySampleBlockFactory.cpp
+
+**********************************************************************/
+#include "MemorySampleBlockFactory.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "Dither.h"
+#include "InconsistencyException.h"
+
+namespace {
+class MemorySampleBlock final : public SampleBlock
+{
+public:
+   MemorySampleBlock(SampleBlockID id,
+      constSamplePtr src, size_t count, sampleFormat format)
+      : mID { id }
+      , mCount { count }
+      , mFormat { format }
+      , mSamples { count, format }
+   {
+      if (src)
+         CopySamples(src, format, mSamples.ptr(), format, count,
+            DitherType::none);
+      else
+         ClearSamples(mSamples.ptr(), format, 0, count);
+   }
+
+   void CloseLock() noexcept override
+   {
+   }
+
+   SampleBlockID GetBlockID() const override
+   {
+      return mID;
+   }
+
+   BlockSampleView GetFloatSampleView(bool) override
+   {
+      auto result = std::make_shared<std::vector<float>>(mCount);
+      SamplesToFloats(mSamples.ptr(), mFormat, result->data(), mCount);
+      return result;
+   }
+
+   sampleFormat GetSampleFormat() const override
+   {
+      return mFormat;
+   }
+
+   size_t GetSampleCount() const override
+   {
+      return mCount;
+   }
+
+   bool GetSummary256(float* dest, size_t, size_t numframes) override
+   {
+      std::fill(dest, dest + 3 * numframes, 0.f);
+      return false;
+   }
+
+   bool GetSummary64k(float* dest, size_t, size_t numframes) override
+   {
+      std::fill(dest, dest + 3 * numframes, 0.f);
+      return false;
+   }
+
+   size_t GetSpaceUsage() const override
+   {
+      // Not in the project file
+      return 0;
+   }
+
+   void SaveXML(XMLWriter&) override
+   {
+      // Tracks with these blocks are copied before they join a project
+      THROW_INCONSISTENCY_EXCEPTION;
+   }
+
+protected:
+   size_t DoGetSamples(samplePtr dest, sampleFormat destformat,
+      size_t sampleoffset, size_t numsamples) override
+   {
+      CopySamples(mSamples.ptr() + sampleoffset * SAMPLE_SIZE(mFormat),
+         mFormat, dest, destformat, numsamples, DitherType::none);
+      return numsamples;
+   }
+
+   MinMaxRMS DoGetMinMaxRMS(size_t start, size_t len) override
+   {
+      return MinMaxRMSOf(start, len);
+   }
+
+   MinMaxRMS DoGetMinMaxRMS() const override
+   {
+      return MinMaxRMSOf(0, mCount);
+   }
+
+private:
+   MinMaxRMS MinMaxRMSOf(size_t start, size_t len) const
+   {
+      MinMaxRMS result;
+      if (len == 0)
+         return result;
+      std::vector<float> floats(len);
+      SamplesToFloats(mSamples.ptr() + start * SAMPLE_SIZE(mFormat), mFormat,
+         floats.data(), len);
+      const auto [min, max] = std::minmax_element(floats.begin(), floats.end());
+      double sumsq = 0;
+      for (const auto sample : floats)
+         sumsq += sample * sample;
+      result.min = *min;
+      result.max = *max;
+      result.RMS = std::sqrt(sumsq / len);
+      return result;
+   }
+
+   const SampleBlockID mID;
+   const size_t mCount;
+   const sampleFormat mFormat;
+   SampleBuffer mSamples;
+};
+}
+
+MemorySampleBlockFactory::MemorySampleBlockFactory() = default;
+
+MemorySampleBlockFactory::~MemorySampleBlockFactory() = default;
+
+auto MemorySampleBlockFactory::GetActiveBlockIDs() -> SampleBlockIDs
+{
+   // None is in the project file
+   return {};
+}
+
+SampleBlockPtr MemorySampleBlockFactory::DoCreate(
+   constSamplePtr src, size_t numsamples, sampleFormat srcformat)
+{
+   return std::make_shared<MemorySampleBlock>(
+      ++mLastID, src, numsamples, srcformat);
+}
+
+SampleBlockPtr MemorySampleBlockFactory::DoCreateSilent(
+   size_t numsamples, sampleFormat srcformat)
+{
+   return std::make_shared<MemorySampleBlock>(
+      ++mLastID, nullptr, numsamples, srcformat);
+}
+
+SampleBlockPtr MemorySampleBlockFactory::DoCreateFromXML(
+   sampleFormat, const AttributesList&)
+{
+   return nullptr;
+}
+
+SampleBlockPtr MemorySampleBlockFactory::DoCreateFromId(
+   sampleFormat, SampleBlockID)
+{
+   return nullptr;
+}
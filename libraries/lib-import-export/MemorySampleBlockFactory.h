@@ -0,0 +1,46 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  MemorySampleBlockFactory.h
+
+**********************************************************************/
+
+#pragma once
+
+#include "SampleBlock.h" // to inherit
+
+//! Makes sample blocks that keep their samples in memory, not in a project
+/*!
+ For a worker thread that decodes a file while the project's own factory is
+ used only on the main thread; the main thread copies the finished tracks
+ into the project, as by WaveTrack::DuplicateWithFactory().  Not thread-safe;
+ use one factory for each thread.
+
+ The blocks cannot be saved, or made from XML or ids.
+ */
+class IMPORT_EXPORT_API MemorySampleBlockFactory final
+   : public SampleBlockFactory
+{
+public:
+   MemorySampleBlockFactory();
+   ~MemorySampleBlockFactory() override;
+
+   SampleBlockIDs GetActiveBlockIDs() override;
+
+protected:
+   SampleBlockPtr DoCreate(constSamplePtr src,
+      size_t numsamples, sampleFormat srcformat) override;
+
+   SampleBlockPtr DoCreateSilent(
+      size_t numsamples, sampleFormat srcformat) override;
+
+   SampleBlockPtr DoCreateFromXML(
+      sampleFormat srcformat, const AttributesList &attrs) override;
+
+   SampleBlockPtr DoCreateFromId(
+      sampleFormat srcformat, SampleBlockID id) override;
+
+private:
+   SampleBlockID mLastID { 0 };
+};
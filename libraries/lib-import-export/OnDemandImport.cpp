@@ -0,0 +1,677 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  OnDemandImport.cpp
+
+**********************************************************************/
+
+#include "OnDemandImport.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include <wx/log.h>
+
+#include "BasicUI.h"
+#include "Dither.h"
+#include "ImportUtils.h"
+#include "Prefs.h"
+#include "Project.h"
+#include "SampleBlock.h"
+#include "TransactionScope.h"
+#include "WaveClip.h"
+#include "WaveTrack.h"
+
+OnDemandDecoder::~OnDemandDecoder() = default;
+
+BoolSetting OnDemandImporting{ L"/FileFormats/OnDemandImporting", false };
+
+namespace
+{
+class PendingBlock;
+
+//! What the worker thread of a job shares with the blocks of its file
+/*!
+ The worker only decodes, into memory.  The main thread stores the samples
+ in the project file, when no transaction is open that a cancelled effect
+ might roll back.
+ */
+struct JobState
+{
+   JobState(SampleBlockFactoryPtr pFactory, size_t nBlocks)
+      : pFactory { move(pFactory) }
+      , blocks(nBlocks)
+      , made(nBlocks, false)
+   {}
+
+   const SampleBlockFactoryPtr pFactory;
+
+   std::mutex mutex;
+   //! Notified when a block is decoded or stored, and when the worker
+   //! finishes
+   std::condition_variable condition;
+
+   //! For each index, the blocks of the channels; once none of them remains,
+   //! the index is skipped
+   std::vector<std::vector<std::weak_ptr<PendingBlock>>> blocks;
+   std::vector<bool> made;
+   size_t nMade { 0 };
+   //! Indices of blocks that were asked for, the most recent last
+   std::vector<size_t> wanted;
+   //! Blocks decoded but not yet stored
+   std::vector<std::weak_ptr<PendingBlock>> decoded;
+   bool stopping { false };
+   //! Whether decoding is done
+   bool finished { false };
+   //! Whether the worker thread is done, after the storing of the blocks
+   bool done { false };
+   //! From decoding a block
+   std::exception_ptr exception;
+
+   //! @pre mutex is locked
+   void Want(size_t index)
+   {
+      if (made[index])
+         return;
+      const auto end = wanted.end();
+      if (const auto iter = std::find(wanted.begin(), end, index); iter != end)
+         wanted.erase(iter);
+      wanted.push_back(index);
+   }
+};
+
+//! Stands for a block of a file imported on demand, and serves the samples
+//! from memory once the worker decoded them, then delegates to the real
+//! block once the main thread stored them
+class PendingBlock final : public SampleBlock
+{
+public:
+   using Samples = std::shared_ptr<const SampleBuffer>;
+
+   PendingBlock(std::shared_ptr<JobState> pState,
+      size_t index, size_t count, sampleFormat format)
+      : mpState { move(pState) }
+      , mIndex { index }
+      , mCount { count }
+      , mFormat { format }
+   {}
+
+   //! @pre the mutex of the job is locked
+   void SetDecoded(Samples pDecoded)
+   {
+      mpDecoded = move(pDecoded);
+   }
+
+   //! Store the decoded samples in the project file, if not done already
+   /*! Call on the main thread, outside of transactions */
+   void Store()
+   {
+      auto& state = *mpState;
+      Samples pDecoded;
+      {
+         std::lock_guard<std::mutex> lock { state.mutex };
+         if (mpReal || !mpDecoded)
+            return;
+         pDecoded = mpDecoded;
+      }
+      auto pReal = state.pFactory->Create(pDecoded->ptr(), mCount, mFormat);
+      {
+         std::lock_guard<std::mutex> lock { state.mutex };
+         mpReal = move(pReal);
+         mpDecoded.reset();
+      }
+      state.condition.notify_all();
+   }
+
+   void CloseLock() noexcept override
+   {
+      if (const auto pReal = GetReal())
+         pReal->CloseLock();
+   }
+
+   SampleBlockID GetBlockID() const override
+   {
+      if (const auto pReal = GetReal())
+         return pReal->GetBlockID();
+      // As for silence, which SaveXML() may write in place of this block
+      return -static_cast<SampleBlockID>(mCount);
+   }
+
+   BlockSampleView GetFloatSampleView(bool mayThrow) override
+   {
+      const auto [pReal, pDecoded] = Decoded(mayThrow);
+      if (pReal)
+         return pReal->GetFloatSampleView(mayThrow);
+      auto result = std::make_shared<std::vector<float>>(mCount);
+      SamplesToFloats(pDecoded->ptr(), mFormat, result->data(), mCount);
+      return result;
+   }
+
+   sampleFormat GetSampleFormat() const override
+   {
+      return mFormat;
+   }
+
+   size_t GetSampleCount() const override
+   {
+      return mCount;
+   }
+
+   bool GetSummary256(
+      float* dest, size_t frameoffset, size_t numframes) override
+   {
+      if (const auto pReal = GetReal())
+         return pReal->GetSummary256(dest, frameoffset, numframes);
+      std::fill(dest, dest + 3 * numframes, 0.f);
+      return false;
+   }
+
+   bool GetSummary64k(
+      float* dest, size_t frameoffset, size_t numframes) override
+   {
+      if (const auto pReal = GetReal())
+         return pReal->GetSummary64k(dest, frameoffset, numframes);
+      std::fill(dest, dest + 3 * numframes, 0.f);
+      return false;
+   }
+
+   size_t GetSpaceUsage() const override
+   {
+      if (const auto pReal = GetReal())
+         return pReal->GetSpaceUsage();
+      return 0;
+   }
+
+   void SaveXML(XMLWriter& xmlFile) override
+   {
+      if (!GetReal() && StandInScope::InEffect())
+         mpState->pFactory->CreateSilent(mCount, mFormat)->SaveXML(xmlFile);
+      else
+      {
+         Decoded(true);
+         Store();
+         Real()->SaveXML(xmlFile);
+      }
+   }
+
+   bool IsPending(bool prefer) const noexcept override
+   {
+      auto& state = *mpState;
+      std::lock_guard<std::mutex> lock { state.mutex };
+      if (mpReal || (state.finished && !mpDecoded))
+         return false;
+      if (prefer && !mpDecoded)
+         state.Want(mIndex);
+      return true;
+   }
+
+protected:
+   size_t DoGetSamples(samplePtr dest, sampleFormat destformat,
+      size_t sampleoffset, size_t numsamples) override
+   {
+      const auto [pReal, pDecoded] = Decoded(true);
+      if (pReal)
+         return pReal->GetSamples(dest, destformat, sampleoffset, numsamples);
+      CopySamples(pDecoded->ptr() + sampleoffset * SAMPLE_SIZE(mFormat),
+         mFormat, dest, destformat, numsamples, DitherType::none);
+      return numsamples;
+   }
+
+   MinMaxRMS DoGetMinMaxRMS(size_t start, size_t len) override
+   {
+      const auto [pReal, pDecoded] = Decoded(true);
+      if (pReal)
+         return pReal->GetMinMaxRMS(start, len);
+      return MinMaxRMSOf(*pDecoded, start, len);
+   }
+
+   MinMaxRMS DoGetMinMaxRMS() const override
+   {
+      const auto [pReal, pDecoded] = Decoded(true);
+      if (pReal)
+         return pReal->GetMinMaxRMS();
+      return MinMaxRMSOf(*pDecoded, 0, mCount);
+   }
+
+private:
+   SampleBlockPtr GetReal() const
+   {
+      std::lock_guard<std::mutex> lock { mpState->mutex };
+      return mpReal;
+   }
+
+   //! The stored block, or else silence
+   SampleBlockPtr Real() const
+   {
+      if (const auto pReal = GetReal())
+         return pReal;
+      return mpState->pFactory->CreateSilent(mCount, mFormat);
+   }
+
+   //! Wait for the worker to decode this block first
+   /*!
+    @return the real block, or else the decoded samples, or else silence if
+    decoding was abandoned, or failed and !mayThrow
+    */
+   std::pair<SampleBlockPtr, Samples> Decoded(bool mayThrow) const
+   {
+      auto& state = *mpState;
+      {
+         std::unique_lock<std::mutex> lock { state.mutex };
+         if (!mpReal && !mpDecoded && !state.finished)
+         {
+            state.Want(mIndex);
+            state.condition.wait(lock,
+               [&] { return mpReal || mpDecoded || state.finished; });
+         }
+         if (mpReal || mpDecoded)
+            return { mpReal, mpDecoded };
+         if (state.exception && mayThrow)
+            std::rethrow_exception(state.exception);
+      }
+      return { state.pFactory->CreateSilent(mCount, mFormat), nullptr };
+   }
+
+   MinMaxRMS MinMaxRMSOf(
+      const SampleBuffer& samples, size_t start, size_t len) const
+   {
+      std::vector<float> floats(len);
+      SamplesToFloats(samples.ptr() + start * SAMPLE_SIZE(mFormat), mFormat,
+         floats.data(), len);
+      MinMaxRMS result;
+      if (len == 0)
+         return result;
+      const auto [min, max] = std::minmax_element(floats.begin(), floats.end());
+      double sumsq = 0;
+      for (const auto sample : floats)
+         sumsq += sample * sample;
+      result.min = *min;
+      result.max = *max;
+      result.RMS = std::sqrt(sumsq / len);
+      return result;
+   }
+
+   const std::shared_ptr<JobState> mpState;
+   const size_t mIndex;
+   const size_t mCount;
+   const sampleFormat mFormat;
+   //! Guarded by the mutex of the job
+   Samples mpDecoded;
+   //! Guarded by the mutex of the job
+   SampleBlockPtr mpReal;
+};
+}
+
+//! Decodes one file on a worker thread, making the blocks of its track
+class OnDemandImports::Job
+{
+public:
+   Job(std::unique_ptr<OnDemandDecoder> pDecoder,
+      std::shared_ptr<JobState> pState, sampleFormat format, size_t blockSize,
+      std::function<void()> notify)
+      : mpDecoder { move(pDecoder) }
+      , mpState { move(pState) }
+      , mFormat { format }
+      , mBlockSize { blockSize }
+      , mNotify { move(notify) }
+      , mThread { [this] { Run(); } }
+   {}
+
+   ~Job()
+   {
+      {
+         std::lock_guard<std::mutex> lock { mpState->mutex };
+         mpState->stopping = true;
+      }
+      mpState->condition.notify_all();
+      mThread.join();
+   }
+
+   //! Whether all blocks are decoded and stored
+   bool IsDone() const
+   {
+      std::lock_guard<std::mutex> lock { mpState->mutex };
+      return mpState->done;
+   }
+
+   //! Store the blocks decoded so far in the project file
+   /*! Call on the main thread, outside of transactions */
+   void Store()
+   {
+      std::vector<std::weak_ptr<PendingBlock>> decoded;
+      {
+         std::lock_guard<std::mutex> lock { mpState->mutex };
+         decoded.swap(mpState->decoded);
+      }
+      for (const auto& wBlock : decoded)
+         if (const auto pBlock = wBlock.lock())
+            pBlock->Store();
+      // Let the worker finish
+      mpState->condition.notify_all();
+   }
+
+   //! @return numbers of blocks made and of all blocks
+   std::pair<size_t, size_t> GetCounts() const
+   {
+      std::lock_guard<std::mutex> lock { mpState->mutex };
+      return { mpState->nMade, mpState->made.size() };
+   }
+
+private:
+   void Run();
+   //! Decode the frames of one index, and convert them to the stored format;
+   //! fill with silence after an error
+   void Decode(size_t index, size_t count);
+
+   const std::unique_ptr<OnDemandDecoder> mpDecoder;
+   const std::shared_ptr<JobState> mpState;
+   //! Stored format of the track
+   const sampleFormat mFormat;
+   const size_t mBlockSize;
+   const std::function<void()> mNotify;
+
+   std::vector<SampleBuffer> mDecoded;
+   std::vector<SampleBuffer> mStored;
+   //! Where the decoder is, or negative when unknown after an error
+   sampleCount mPosition { 0 };
+
+   //! Started last
+   std::thread mThread;
+};
+
+void OnDemandImports::Job::Decode(size_t index, size_t count)
+{
+   auto& decoder = *mpDecoder;
+   const auto decodedFormat = decoder.Format();
+   const auto nChannels = decoder.NumChannels();
+   const auto start = sampleCount { index } * mBlockSize;
+
+   std::vector<samplePtr> buffers;
+   for (auto& buffer : mDecoded)
+      buffers.push_back(buffer.ptr());
+
+   size_t decoded = 0;
+   if (mPosition == start || decoder.Seek(start))
+      decoded = decoder.Decode(buffers.data(), count);
+   mPosition = decoded == count ? start + count : sampleCount { -1 };
+   if (decoded < count)
+   {
+      wxLogWarning(
+         wxT("Import on demand: could not decode %lld samples at %lld; using silence"),
+         static_cast<long long>(count - decoded), start.as_long_long());
+      for (auto buffer : buffers)
+         ClearSamples(buffer, decodedFormat, decoded, count - decoded);
+   }
+
+   // The track is never narrower than the file; see ImportUtils::ChooseFormat
+   if (decodedFormat != mFormat)
+      for (size_t iChannel = 0; iChannel < nChannels; ++iChannel)
+         CopySamples(mDecoded[iChannel].ptr(), decodedFormat,
+            mStored[iChannel].ptr(), mFormat, count, DitherType::none);
+}
+
+void OnDemandImports::Job::Run()
+{
+   using namespace std::chrono;
+   auto& state = *mpState;
+   auto& decoder = *mpDecoder;
+   const auto nChannels = decoder.NumChannels();
+   const auto nFrames = decoder.NumFrames();
+   const auto nBlocks = state.made.size();
+
+   for (size_t iChannel = 0; iChannel < nChannels; ++iChannel)
+   {
+      mDecoded.emplace_back(mBlockSize, decoder.Format());
+      if (decoder.Format() != mFormat)
+         mStored.emplace_back(mBlockSize, mFormat);
+   }
+   auto& stored = mStored.empty() ? mDecoded : mStored;
+
+   size_t next = 0;
+   auto lastNotice = steady_clock::now();
+   try
+   {
+      while (true)
+      {
+         size_t index = nBlocks;
+         std::vector<std::shared_ptr<PendingBlock>> pBlocks;
+         {
+            std::lock_guard<std::mutex> lock { state.mutex };
+            if (state.stopping)
+               break;
+            if (!state.wanted.empty())
+            {
+               index = state.wanted.back();
+               state.wanted.pop_back();
+               if (state.made[index])
+                  continue;
+            }
+            else
+            {
+               // Continue after the last block made, where the decoder is
+               for (size_t ii = 0; ii < nBlocks; ++ii)
+               {
+                  const auto candidate = (next + ii) % nBlocks;
+                  if (!state.made[candidate])
+                  {
+                     index = candidate;
+                     break;
+                  }
+               }
+               if (index == nBlocks)
+                  break;
+            }
+            for (const auto& wBlock : state.blocks[index])
+               pBlocks.push_back(wBlock.lock());
+         }
+         next = index + 1;
+
+         // Not stored in the project file here, because an effect may have
+         // opened a transaction on the same connection, and rolling it back
+         // would delete the rows
+         std::vector<PendingBlock::Samples> samples(nChannels);
+         if (std::any_of(pBlocks.begin(), pBlocks.end(),
+                [](const auto& pBlock) { return pBlock != nullptr; }))
+         {
+            const auto count = limitSampleBufferSize(
+               mBlockSize, nFrames - sampleCount { index } * mBlockSize);
+            Decode(index, count);
+            for (size_t iChannel = 0; iChannel < nChannels; ++iChannel)
+               if (pBlocks[iChannel])
+               {
+                  samples[iChannel] = std::make_shared<const SampleBuffer>(
+                     std::move(stored[iChannel]));
+                  stored[iChannel].Allocate(mBlockSize, mFormat);
+               }
+         }
+         // else the blocks were all deleted, as by undoing the import
+
+         {
+            std::lock_guard<std::mutex> lock { state.mutex };
+            for (size_t iChannel = 0; iChannel < nChannels; ++iChannel)
+               if (pBlocks[iChannel])
+               {
+                  pBlocks[iChannel]->SetDecoded(move(samples[iChannel]));
+                  state.decoded.push_back(pBlocks[iChannel]);
+               }
+            state.made[index] = true;
+            ++state.nMade;
+         }
+         state.condition.notify_all();
+
+         if (const auto now = steady_clock::now();
+             now - lastNotice > milliseconds { 250 })
+         {
+            lastNotice = now;
+            mNotify();
+         }
+      }
+   }
+   catch (...)
+   {
+      std::lock_guard<std::mutex> lock { state.mutex };
+      state.exception = std::current_exception();
+   }
+
+   {
+      std::unique_lock<std::mutex> lock { state.mutex };
+      state.finished = true;
+      state.condition.notify_all();
+      // Remind the main thread until it stores the rest, which it may not
+      // do while an effect is in progress
+      while (!state.stopping && !state.decoded.empty())
+      {
+         lock.unlock();
+         mNotify();
+         lock.lock();
+         state.condition.wait_for(lock, milliseconds { 250 },
+            [&] { return state.stopping || state.decoded.empty(); });
+      }
+      state.done = true;
+   }
+   mNotify();
+}
+
+static const AudacityProject::AttachedObjects::RegisteredFactory sKey {
+   [](AudacityProject& project)
+   {
+      return std::make_shared<OnDemandImports>(project);
+   }
+};
+
+OnDemandImports& OnDemandImports::Get(AudacityProject& project)
+{
+   return project.AttachedObjects::Get<OnDemandImports>(sKey);
+}
+
+const OnDemandImports& OnDemandImports::Get(const AudacityProject& project)
+{
+   return Get(const_cast<AudacityProject&>(project));
+}
+
+OnDemandImports::OnDemandImports(AudacityProject& project)
+    : mProject { project }
+{
+}
+
+OnDemandImports::~OnDemandImports() = default;
+
+void OnDemandImports::Start(std::unique_ptr<OnDemandDecoder> pDecoder,
+   WaveTrackFactory& trackFactory, TrackHolders& outTracks)
+{
+   const auto nChannels = pDecoder->NumChannels();
+   const auto effectiveFormat = pDecoder->Format();
+   const auto track = ImportUtils::NewWaveTrack(
+      trackFactory, nChannels, effectiveFormat, pDecoder->Rate());
+   const auto format = track->GetSampleFormat();
+   const auto blockSize = track->GetMaxBlockSize();
+   const auto nFrames = pDecoder->NumFrames();
+   const auto nBlocks = static_cast<size_t>(
+      (nFrames.as_long_long() + blockSize - 1) / blockSize);
+
+   auto pState = std::make_shared<JobState>(
+      trackFactory.GetSampleBlockFactory(), nBlocks);
+   const auto pClip = track->RightmostOrNewClip();
+   for (size_t index = 0; index < nBlocks; ++index)
+   {
+      const auto count = limitSampleBufferSize(
+         blockSize, nFrames - sampleCount { index } * blockSize);
+      std::vector<SampleBlockPtr> blocks;
+      for (size_t iChannel = 0; iChannel < nChannels; ++iChannel)
+      {
+         auto pBlock =
+            std::make_shared<PendingBlock>(pState, index, count, format);
+         pState->blocks[index].push_back(pBlock);
+         blocks.push_back(move(pBlock));
+      }
+      pClip->AppendSharedBlocks(blocks, effectiveFormat);
+   }
+   ImportUtils::FinalizeImport(outTracks, *track);
+   if (nBlocks == 0)
+      return;
+
+   mJobs.push_back(std::make_unique<Job>(move(pDecoder), move(pState), format,
+      blockSize, [wThis = weak_from_this()] {
+         BasicUI::CallAfter([wThis] {
+            if (const auto pThis = wThis.lock())
+               pThis->OnJobProgress();
+         });
+      }));
+}
+
+bool OnDemandImports::IsBusy() const
+{
+   return std::any_of(mJobs.begin(), mJobs.end(),
+      [](const auto& pJob) { return !pJob->IsDone(); });
+}
+
+double OnDemandImports::GetProgress() const
+{
+   size_t made = 0;
+   size_t total = 0;
+   for (const auto& pJob : mJobs)
+   {
+      const auto [jobMade, jobTotal] = pJob->GetCounts();
+      made += jobMade;
+      total += jobTotal;
+   }
+   return total > 0 ? static_cast<double>(made) / total : 1.0;
+}
+
+bool OnDemandImports::Finish()
+{
+   using namespace std::chrono_literals;
+   if (mJobs.empty())
+      return true;
+   if (IsBusy())
+   {
+      const auto progress = BasicUI::MakeProgress(XO("Import"),
+         XO("Decoding imported files..."), BasicUI::ProgressShowCancel);
+      while (IsBusy())
+      {
+         StoreDecoded();
+         if (progress &&
+             progress->Poll(GetProgress() * 1000, 1000) !=
+                BasicUI::ProgressResult::Success)
+            return false;
+         std::this_thread::sleep_for(50ms);
+      }
+   }
+   OnJobProgress();
+   return true;
+}
+
+void OnDemandImports::Abandon()
+{
+   // Each job stops its thread
+   mJobs.clear();
+   // Ignore notifications still queued
+   mAbandoned = true;
+}
+
+bool OnDemandImports::StoreDecoded()
+{
+   if (TransactionScope::InProgress(mProject))
+      return false;
+   for (const auto& pJob : mJobs)
+      pJob->Store();
+   return true;
+}
+
+void OnDemandImports::OnJobProgress()
+{
+   if (mAbandoned)
+      return;
+   StoreDecoded();
+   // Join the threads of finished jobs
+   mJobs.erase(std::remove_if(mJobs.begin(), mJobs.end(),
+      [](const auto& pJob) { return pJob->IsDone(); }), mJobs.end());
+   Publish({ mJobs.empty() });
+}
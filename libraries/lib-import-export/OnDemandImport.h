@@ -0,0 +1,131 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  OnDemandImport.h
+
+**********************************************************************/
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "ClientData.h"
+#include "Observer.h"
+#include "SampleCount.h"
+#include "SampleFormat.h"
+
+class AudacityProject;
+class BoolSetting;
+class Track;
+class WaveTrackFactory;
+
+using TrackHolders = std::vector<std::shared_ptr<Track>>;
+
+//! Decodes a compressed file from any position, for import on demand
+/*!
+ Made by ImportFileHandle::MakeOnDemandDecoder() on the main thread, then
+ used only by the worker thread of OnDemandImports
+ */
+class IMPORT_EXPORT_API OnDemandDecoder /* not final */
+{
+public:
+   virtual ~OnDemandDecoder();
+
+   virtual unsigned NumChannels() const = 0;
+   //! Format of the decoded samples
+   virtual sampleFormat Format() const = 0;
+   virtual double Rate() const = 0;
+   //! Must be exact, because the blocks are laid out before decoding
+   virtual sampleCount NumFrames() const = 0;
+
+   //! Move to the given frame, so that Decode() continues from there
+   /*! @return false on failure */
+   virtual bool Seek(sampleCount frame) = 0;
+
+   //! Decode frames at the current position, one buffer for each channel
+   /*!
+    @return number of frames decoded, less than len only at the end of the
+    file or at an error
+    */
+   virtual size_t Decode(const samplePtr buffers[], size_t len) = 0;
+};
+
+struct OnDemandImportMessage
+{
+   //! Whether no file is left to decode
+   bool finished;
+};
+
+//! Decodes, in the background, the files of a project imported on demand
+/*!
+ Tracks appear at once, with blocks of the right lengths, and the samples of
+ each block are decoded later, from the start of the file.  A block that is
+ read before it is decoded is decoded next, and the reader waits for it; a
+ block that is only drawn is also decoded next, but drawing does not wait.
+
+ Decoded samples are kept in memory until the main thread stores them in the
+ project file.  It does not while a transaction is open, as for an effect,
+ because a rollback would delete the rows.
+
+ Messages are published on the main thread, as blocks are decoded, and when
+ the last file is decoded and stored.
+ */
+class IMPORT_EXPORT_API OnDemandImports final
+   : public ClientData::Base
+   , public Observer::Publisher<OnDemandImportMessage>
+   , public std::enable_shared_from_this<OnDemandImports>
+{
+public:
+   static OnDemandImports& Get(AudacityProject& project);
+   static const OnDemandImports& Get(const AudacityProject& project);
+
+   explicit OnDemandImports(AudacityProject& project);
+   OnDemandImports(const OnDemandImports&) = delete;
+   OnDemandImports& operator=(const OnDemandImports&) = delete;
+   ~OnDemandImports() override;
+
+   //! Make a track for the decoder's file and begin decoding it
+   /*! @param outTracks receives the track */
+   void Start(std::unique_ptr<OnDemandDecoder> pDecoder,
+      WaveTrackFactory& trackFactory, TrackHolders& outTracks);
+
+   //! Whether some file is not yet decoded and stored
+   bool IsBusy() const;
+
+   //! Fraction of the blocks of all files that are decoded
+   double GetProgress() const;
+
+   //! Wait for all files, showing progress, and store them
+   /*!
+    Must not be called while a transaction is open
+    @return false if the user cancelled the wait
+    */
+   bool Finish();
+
+   //! Stop decoding, as when closing the project
+   /*!
+    Blocks not yet decoded are then read as silence, and those not yet stored
+    are not.  Must be called before the project's sample block factory is
+    released.
+    */
+   void Abandon();
+
+private:
+   class Job;
+
+   //! Store the decoded blocks in the project file, unless a transaction is
+   //! open; return whether stored
+   bool StoreDecoded();
+
+   //! Called on the main thread when a job progresses or is done
+   void OnJobProgress();
+
+   AudacityProject& mProject;
+   std::vector<std::unique_ptr<Job>> mJobs;
+   bool mAbandoned { false };
+};
+
+//! Whether compressed files that support it are imported on demand
+extern IMPORT_EXPORT_API BoolSetting OnDemandImporting;
@@ -0,0 +1,182 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  ParallelExport.cpp
+
+**********************************************************************/
+
+#include "ParallelExport.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <thread>
+
+#include "ExportPlugin.h"
+#include "MemoryX.h"
+
+namespace
+{
+   //! Gives one task its own cancellation and progress, and forwards the
+   //! requests of the delegate of all tasks
+   class TaskDelegate final : public ExportProcessorDelegate
+   {
+      ExportProcessorDelegate& mOuter;
+      std::atomic<bool> mCancelled {false};
+      std::atomic<double> mProgress {};
+   public:
+      explicit TaskDelegate(ExportProcessorDelegate& outer)
+         : mOuter { outer }
+      {}
+
+      bool IsCancelled() const override
+      {
+         return mCancelled || mOuter.IsCancelled();
+      }
+
+      bool IsStopped() const override
+      {
+         return mOuter.IsStopped();
+      }
+
+      void SetStatusString(const TranslatableString&) override
+      {
+         // Run() reports the status of all tasks
+      }
+
+      void OnProgress(double progress) override
+      {
+         mProgress = progress;
+      }
+
+      void Cancel()
+      {
+         mCancelled = true;
+      }
+
+      double GetProgress() const
+      {
+         return std::clamp(mProgress.load(), .0, 1.0);
+      }
+   };
+
+   struct RunningTask
+   {
+      size_t index;
+      std::unique_ptr<TaskDelegate> delegate;
+      std::future<ExportResult> future;
+      std::thread thread;
+   };
+}
+
+size_t ParallelExport::DefaultWorkerCount()
+{
+   return std::max(1u, std::thread::hardware_concurrency());
+}
+
+size_t ParallelExport::Run(size_t first, size_t last,
+   const TaskFactory& makeTask, const ResultHandler& onResult,
+   ExportProcessorDelegate& delegate,
+   const std::function<void()>& idle, size_t maxWorkers)
+{
+   using namespace std::chrono_literals;
+
+   if(maxWorkers == 0)
+      maxWorkers = DefaultWorkerCount();
+   const auto nTasks = std::max(first, last) - first;
+
+   std::vector<RunningTask> running;
+   // So that a started thread is never lost to a failure of push_back
+   running.reserve(std::min(maxWorkers, nTasks));
+   auto cleanup = finally([&] {
+      // Only if makeTask or idle threw
+      for(auto& task : running)
+      {
+         task.delegate->Cancel();
+         task.thread.join();
+      }
+   });
+
+   auto next = first;
+   size_t nFinished = 0;
+   // Least index of a task that failed or was cancelled
+   auto failed = last;
+   std::exception_ptr exception;
+   auto exceptionIndex = last;
+
+   const auto finish = [&](RunningTask& task) {
+      task.thread.join();
+      auto result = ExportResult::Error;
+      try
+      {
+         result = task.future.get();
+      }
+      catch(...)
+      {
+         if(task.index < exceptionIndex)
+         {
+            exceptionIndex = task.index;
+            exception = std::current_exception();
+         }
+      }
+      ++nFinished;
+      // A stop request reaches all tasks already, and their partial files
+      // are kept
+      if(result != ExportResult::Success && result != ExportResult::Stopped &&
+         task.index < failed)
+      {
+         failed = task.index;
+         for(auto& other : running)
+            if(other.index > failed)
+               other.delegate->Cancel();
+      }
+      if(onResult)
+         onResult(task.index, result);
+   };
+
+   while(true)
+   {
+      while(running.size() < maxWorkers && next < last && failed == last &&
+         !delegate.IsStopped() && !delegate.IsCancelled())
+      {
+         auto task = makeTask(next);
+         auto taskDelegate = std::make_unique<TaskDelegate>(delegate);
+         auto future = task.get_future();
+         std::thread thread(std::move(task), std::ref(*taskDelegate));
+         running.push_back({
+            next++, std::move(taskDelegate), std::move(future), std::move(thread)
+         });
+      }
+      if(running.empty())
+         break;
+
+      // Wait a while, or until the earliest task is done
+      running.front().future.wait_for(50ms);
+      for(auto iter = running.begin(); iter != running.end();)
+      {
+         if(iter->future.wait_for(0ms) == std::future_status::ready)
+         {
+            auto task = std::move(*iter);
+            iter = running.erase(iter);
+            finish(task);
+         }
+         else
+            ++iter;
+      }
+
+      double done = nFinished;
+      for(auto& task : running)
+         done += task.delegate->GetProgress();
+      delegate.SetStatusString(XO("Exported %lld of %lld files")
+         .Format(static_cast<long long>(nFinished),
+            static_cast<long long>(nTasks)));
+      delegate.OnProgress(nTasks > 0 ? done / nTasks : 1.0);
+      if(idle)
+         idle();
+   }
+
+   if(exception)
+      std::rethrow_exception(exception);
+   return next;
+}
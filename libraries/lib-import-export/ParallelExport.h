@@ -0,0 +1,53 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  ParallelExport.h
+
+**********************************************************************/
+
+#pragma once
+
+#include <functional>
+
+#include "ExportTypes.h"
+
+class ExportProcessorDelegate;
+
+//! Runs independent export tasks, such as the files of a split export, at
+//! the same time
+namespace ParallelExport
+{
+//! Makes the task with the given index; called on the thread of Run(), in
+//! order of index, and only when a worker is free for it
+using TaskFactory = std::function<ExportTask(size_t index)>;
+
+//! Receives the result of each task that was made, on the thread of Run(),
+//! in order of completion
+using ResultHandler = std::function<void(size_t index, ExportResult result)>;
+
+//! Number of tasks to run at once when none is given
+IMPORT_EXPORT_API size_t DefaultWorkerCount();
+
+//! Run the tasks with indices in [first, last), at most maxWorkers at once
+/*!
+ Each task has its own processor and thread, so that the results are those
+ of running them one after another.
+
+ The delegate receives the fraction of all the work that is done, and its
+ requests to stop or cancel reach all running tasks.  No more tasks are made
+ after such a request, or after a task fails or is cancelled; running tasks
+ with greater indices are then cancelled too, as if they had not started.
+
+ @param idle called on this thread about every 50 ms while tasks run
+ @param maxWorkers 0 for DefaultWorkerCount()
+ @return the index after the last task made
+ @post all threads are joined
+ @throws the exception from the task of least index that threw, after the
+ others finish; its result is reported as an error
+ */
+IMPORT_EXPORT_API size_t Run(size_t first, size_t last,
+   const TaskFactory& makeTask, const ResultHandler& onResult,
+   ExportProcessorDelegate& delegate,
+   const std::function<void()>& idle = {}, size_t maxWorkers = 0);
+}
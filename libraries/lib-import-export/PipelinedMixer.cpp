@@ -0,0 +1,148 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  PipelinedMixer.cpp
+
+**********************************************************************/
+
+#include "PipelinedMixer.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "Mix.h"
+
+PipelinedMixer::PipelinedMixer(std::unique_ptr<Mixer> mixer, size_t queueSize)
+   : mMixer { std::move(mixer) }
+   , mCurrentTime { mMixer->MixGetCurrentTime() }
+{
+   const auto nBuffers = mMixer->Interleaved() ? 1 : mMixer->NumChannels();
+   const auto bufferSize = mMixer->BufferSize() *
+      (mMixer->Interleaved() ? mMixer->NumChannels() : 1);
+   // One block more than the queue, for the consumer to hold
+   mBlocks.resize(std::max<size_t>(queueSize, 1) + 1);
+   for(auto& block : mBlocks)
+   {
+      block.buffers.resize(nBuffers);
+      for(auto& buffer : block.buffers)
+         buffer.Allocate(bufferSize, mMixer->Format());
+   }
+}
+
+PipelinedMixer::~PipelinedMixer()
+{
+   mCancelled.store(true, std::memory_order_relaxed);
+   mNotFull.notify_one();
+   if(mThread.joinable())
+      mThread.join();
+}
+
+void PipelinedMixer::Park(std::condition_variable& condition)
+{
+   using namespace std::chrono_literals;
+   // The other thread signals without the mutex, so the signal may come just
+   // before this wait; the timeout bounds the delay then
+   std::unique_lock<std::mutex> lock { mParkMutex };
+   condition.wait_for(lock, 1ms);
+}
+
+void PipelinedMixer::Produce()
+{
+   const auto nBlocks = mBlocks.size();
+   const auto bytesPerSample = SAMPLE_SIZE(mMixer->Format()) *
+      (mMixer->Interleaved() ? mMixer->NumChannels() : 1);
+   try
+   {
+      // Only this thread changes mWritten
+      auto written = mWritten.load(std::memory_order_relaxed);
+      while(true)
+      {
+         // Acquire, so that the consumer is done reading a block before it
+         // is overwritten
+         while(written - mReleased.load(std::memory_order_acquire) == nBlocks)
+         {
+            if(mCancelled.load(std::memory_order_relaxed))
+               return;
+            Park(mNotFull);
+         }
+         if(mCancelled.load(std::memory_order_relaxed))
+            return;
+
+         auto& block = mBlocks[written % nBlocks];
+         const auto samples = mMixer->Process();
+         for(size_t i = 0; i < block.buffers.size(); ++i)
+            memcpy(block.buffers[i].ptr(), mMixer->GetBuffer(int(i)),
+               samples * bytesPerSample);
+         block.samples = samples;
+         block.time = mMixer->MixGetCurrentTime();
+
+         // Release, so that the consumer sees the contents of the block
+         mWritten.store(++written, std::memory_order_release);
+         if(samples == 0)
+            mFinished.store(true, std::memory_order_release);
+         mNotEmpty.notify_one();
+         if(samples == 0)
+            return;
+      }
+   }
+   catch(...)
+   {
+      mException = std::current_exception();
+      mFinished.store(true, std::memory_order_release);
+      mNotEmpty.notify_one();
+   }
+}
+
+size_t PipelinedMixer::Process()
+{
+   if(!mThread.joinable())
+      mThread = std::thread { [this] { Produce(); } };
+
+   // Only this thread changes mReleased
+   auto released = mReleased.load(std::memory_order_relaxed);
+   if(mHasCurrent)
+   {
+      // Give the previous block back to the mixing thread
+      mReleased.store(++released, std::memory_order_release);
+      mHasCurrent = false;
+      mNotFull.notify_one();
+   }
+
+   while(true)
+   {
+      // Load the flag first; when it is set, all blocks are written
+      const auto finished = mFinished.load(std::memory_order_acquire);
+      if(released != mWritten.load(std::memory_order_acquire))
+         break;
+      if(finished)
+      {
+         if(mException)
+            std::rethrow_exception(mException);
+         // After the last, empty block, as Mixer::Process() would
+         return 0;
+      }
+      Park(mNotEmpty);
+   }
+
+   const auto& block = mBlocks[released % mBlocks.size()];
+   mHasCurrent = true;
+   mCurrentTime = block.time;
+   return block.samples;
+}
+
+constSamplePtr PipelinedMixer::GetBuffer() const
+{
+   return GetBuffer(0);
+}
+
+constSamplePtr PipelinedMixer::GetBuffer(int channel) const
+{
+   const auto released = mReleased.load(std::memory_order_relaxed);
+   return mBlocks[released % mBlocks.size()].buffers[channel].ptr();
+}
+
+double PipelinedMixer::MixGetCurrentTime() const
+{
+   return mCurrentTime;
+}
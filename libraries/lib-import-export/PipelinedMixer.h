@@ -0,0 +1,99 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  PipelinedMixer.h
+
+**********************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "MemoryX.h"
+#include "SampleFormat.h"
+
+class Mixer;
+
+//! Wraps a Mixer for an export processor, so that mixing of later blocks
+//! proceeds on another thread while the processor encodes earlier ones
+/*!
+ The blocks are those of the Mixer, in the same sequence, so the output of
+ the encoder does not change.  Mixing can get ahead by a bounded number of
+ blocks.
+
+ The threads pass blocks through a ring of preallocated buffers, with one
+ writer and one reader, which they coordinate with atomic counters and no
+ lock.  A thread that finds the ring full or empty sleeps until the other
+ signals, or for at most a millisecond.
+ */
+class IMPORT_EXPORT_API PipelinedMixer final : public NonInterferingBase
+{
+public:
+   //! Number of blocks that mixing may get ahead
+   static constexpr size_t DefaultQueueSize = 4;
+
+   //! Mixing starts at the first Process()
+   explicit PipelinedMixer(
+      std::unique_ptr<Mixer> mixer, size_t queueSize = DefaultQueueSize);
+   PipelinedMixer(const PipelinedMixer&) = delete;
+   PipelinedMixer& operator=(const PipelinedMixer&) = delete;
+   //! Stops mixing and waits for its thread
+   ~PipelinedMixer();
+
+   //! Like Mixer::Process(), waiting for the next block if need be
+   /*!
+    @return 0 when there are no more samples
+    @throws what the Mixer threw, after the blocks before the failure
+    */
+   size_t Process();
+
+   //! Retrieve the main buffer or the interleaved buffer of the last block
+   constSamplePtr GetBuffer() const;
+
+   //! Retrieve one of the non-interleaved buffers of the last block
+   constSamplePtr GetBuffer(int channel) const;
+
+   //! Like Mixer::MixGetCurrentTime(), as of the end of the last block
+   double MixGetCurrentTime() const;
+
+private:
+   struct Block
+   {
+      std::vector<SampleBuffer> buffers;
+      size_t samples {};
+      double time {};
+   };
+
+   void Produce();
+   //! Sleep until signalled, or briefly
+   void Park(std::condition_variable& condition);
+
+   const std::unique_ptr<Mixer> mMixer;
+   std::vector<Block> mBlocks;
+
+   //! Counts of blocks mixed and released; the block at index `count %
+   //! mBlocks.size()` is next to be written or read
+   NonInterfering<std::atomic<size_t>> mWritten { 0 }, mReleased { 0 };
+   //! Set after the last block is written, or mException is assigned
+   std::atomic<bool> mFinished { false };
+   std::atomic<bool> mCancelled { false };
+   std::exception_ptr mException;
+
+   //! Used only to sleep; not held while blocks are written or read
+   std::mutex mParkMutex;
+   std::condition_variable mNotEmpty;
+   std::condition_variable mNotFull;
+
+   // Touched only by the consuming thread
+   //! Whether the block last returned by Process() is not yet released
+   bool mHasCurrent { false };
+   double mCurrentTime;
+   std::thread mThread;
+};
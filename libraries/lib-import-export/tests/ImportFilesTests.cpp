@@ -0,0 +1,265 @@
+/*  SPDX-License-Identifier: GPL-2.0-or-later */
+/*!********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  ImportFilesTests.cpp
+
+**********************************************************************/
+#include "Import.h"
+
+#include "ImportPlugin.h"
+#include "ImportProgressListener.h"
+#include "Project.h"
+#include "ProjectRate.h"
+#include "SampleBlock.h"
+#include "Tags.h"
+#include "WaveTrack.h"
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <mutex>
+#include <set>
+#include <thread>
+
+namespace
+{
+float Ramp(long long frame)
+{
+   return (frame % 1000) / 1000.0f;
+}
+
+constexpr long long NumFrames = 1 << 20;
+
+class FloatBlock final : public SampleBlock
+{
+public:
+   FloatBlock(SampleBlockID id, const float* src, size_t count)
+       : mID { id }
+       , mSamples(src, src + count)
+   {
+   }
+   void CloseLock() noexcept override
+   {
+   }
+   SampleBlockID GetBlockID() const override
+   {
+      return mID;
+   }
+   BlockSampleView GetFloatSampleView(bool) override
+   {
+      return std::make_shared<std::vector<float>>(mSamples);
+   }
+   sampleFormat GetSampleFormat() const override
+   {
+      return floatSample;
+   }
+   size_t GetSampleCount() const override
+   {
+      return mSamples.size();
+   }
+   bool GetSummary256(float* dest, size_t, size_t numframes) override
+   {
+      std::fill(dest, dest + 3 * numframes, 0.f);
+      return true;
+   }
+   bool GetSummary64k(float* dest, size_t, size_t numframes) override
+   {
+      std::fill(dest, dest + 3 * numframes, 0.f);
+      return true;
+   }
+   size_t GetSpaceUsage() const override
+   {
+      return mSamples.size() * sizeof(float);
+   }
+   void SaveXML(XMLWriter&) override
+   {
+   }
+
+protected:
+   size_t DoGetSamples(samplePtr dest, sampleFormat destformat,
+      size_t sampleoffset, size_t numsamples) override
+   {
+      CopySamples(
+         reinterpret_cast<constSamplePtr>(mSamples.data() + sampleoffset),
+         floatSample, dest, destformat, numsamples, DitherType::none);
+      return numsamples;
+   }
+   MinMaxRMS DoGetMinMaxRMS(size_t, size_t) override
+   {
+      return {};
+   }
+   MinMaxRMS DoGetMinMaxRMS() const override
+   {
+      return {};
+   }
+
+private:
+   const SampleBlockID mID;
+   const std::vector<float> mSamples;
+};
+
+//! Imitates the project file: gives each block the next ID, without locking,
+//! and notes the threads that made blocks
+class FakeBlockFactory final : public SampleBlockFactory
+{
+public:
+   SampleBlockIDs GetActiveBlockIDs() override
+   {
+      return {};
+   }
+   SampleBlockPtr DoCreate(
+      constSamplePtr src, size_t numsamples, sampleFormat srcformat) override
+   {
+      NoteThread();
+      return std::make_shared<FloatBlock>(
+         nextID++, reinterpret_cast<const float*>(src), numsamples);
+   }
+   SampleBlockPtr DoCreateSilent(size_t numsamples, sampleFormat) override
+   {
+      NoteThread();
+      std::vector<float> silence(numsamples);
+      return std::make_shared<FloatBlock>(
+         -static_cast<SampleBlockID>(numsamples), silence.data(), numsamples);
+   }
+   SampleBlockPtr DoCreateFromXML(sampleFormat, const AttributesList&) override
+   {
+      return nullptr;
+   }
+   SampleBlockPtr DoCreateFromId(sampleFormat, SampleBlockID) override
+   {
+      return nullptr;
+   }
+
+   void NoteThread()
+   {
+      std::lock_guard<std::mutex> lock { mutex };
+      threads.insert(std::this_thread::get_id());
+   }
+
+   SampleBlockID nextID { 1 };
+   std::mutex mutex;
+   std::set<std::thread::id> threads;
+};
+
+//! Decodes a ramp, in several blocks, into a mono track
+class RampImportFileHandle final : public ImportFileHandleEx
+{
+public:
+   using ImportFileHandleEx::ImportFileHandleEx;
+
+   TranslatableString GetFileDescription() override
+   {
+      return XO("Ramp");
+   }
+   ByteCount GetFileUncompressedBytes() override
+   {
+      return NumFrames * sizeof(float);
+   }
+   wxInt32 GetStreamCount() override
+   {
+      return 1;
+   }
+   const TranslatableStrings& GetStreamInfo() override
+   {
+      static const TranslatableStrings empty;
+      return empty;
+   }
+   void SetStreamUsage(wxInt32, bool) override
+   {
+   }
+   void Import(ImportProgressListener& progressListener,
+      WaveTrackFactory* trackFactory, TrackHolders& outTracks, Tags*,
+      std::optional<LibFileFormats::AcidizerTags>&) override
+   {
+      BeginImport();
+      auto track = trackFactory->Create(floatSample, 44100);
+      std::vector<float> buffer(track->GetMaxBlockSize());
+      for (long long frame = 0; frame < NumFrames;)
+      {
+         const auto len = std::min<long long>(buffer.size(), NumFrames - frame);
+         for (long long ii = 0; ii < len; ++ii)
+            buffer[ii] = Ramp(frame + ii);
+         track->Append(
+            0, reinterpret_cast<constSamplePtr>(buffer.data()), floatSample,
+            len);
+         frame += len;
+      }
+      track->Flush();
+      outTracks.push_back(track);
+      progressListener.OnImportResult(
+         ImportProgressListener::ImportResult::Success);
+   }
+};
+
+class RampImportPlugin final : public ImportPlugin
+{
+public:
+   RampImportPlugin()
+       : ImportPlugin { FileExtensions { wxT("ramp") } }
+   {
+   }
+   wxString GetPluginStringID() override
+   {
+      return wxT("ramp");
+   }
+   TranslatableString GetPluginFormatDescription() override
+   {
+      return XO("Ramp");
+   }
+   std::unique_ptr<ImportFileHandle>
+   Open(const FilePath& filename, AudacityProject*) override
+   {
+      return std::make_unique<RampImportFileHandle>(filename);
+   }
+};
+
+Importer::RegisteredImportPlugin registered {
+   wxT("Ramp"), std::make_unique<RampImportPlugin>()
+};
+} // namespace
+
+TEST_CASE("ImportFiles stores the blocks of all files on the calling thread")
+{
+   Importer::Get().Initialize();
+   const auto project = AudacityProject::Create();
+   const auto pBlockFactory = std::make_shared<FakeBlockFactory>();
+   WaveTrackFactory trackFactory { ProjectRate::Get(*project), pBlockFactory };
+   Tags tags;
+
+   const FilePaths fileNames { wxT("a.ramp"), wxT("b.ramp"), wxT("c.ramp"),
+                               wxT("d.ramp"), wxT("e.ramp") };
+   const auto results = Importer::Get().ImportFiles(
+      *project, fileNames, nullptr, &trackFactory, tags, {}, 3);
+
+   REQUIRE(results.size() == fileNames.size());
+   REQUIRE(pBlockFactory->threads.size() == 1);
+   REQUIRE(*pBlockFactory->threads.begin() == std::this_thread::get_id());
+
+   std::set<SampleBlockID> ids;
+   size_t nBlocks = 0;
+   std::vector<float> buffer(NumFrames);
+   float* const buffers[] { buffer.data() };
+   for (const auto& result : results)
+   {
+      REQUIRE(result.success);
+      REQUIRE(result.tracks.size() == 1);
+      const auto& track = static_cast<const WaveTrack&>(*result.tracks[0]);
+      REQUIRE(track.GetSampleBlockFactory() == pBlockFactory);
+      for (const auto& pClip : track.Intervals())
+         for (const auto& block : pClip->GetSequence(0)->GetBlockArray())
+         {
+            REQUIRE(block.sb->GetBlockID() > 0);
+            ids.insert(block.sb->GetBlockID());
+            ++nBlocks;
+         }
+      REQUIRE(track.GetFloats(0, 1, buffers, 0, NumFrames));
+      long long ii = 0;
+      while (ii < NumFrames && buffer[ii] == Ramp(ii))
+         ++ii;
+      REQUIRE(ii == NumFrames);
+   }
+   REQUIRE(nBlocks > fileNames.size());
+   REQUIRE(ids.size() == nBlocks);
+}
@@ -0,0 +1,309 @@
+/*  SPDX-License-Identifier: GPL-2.0-or-later */
+/*!********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  OnDemandImportTests.cpp
+
+**********************************************************************/
+#include "OnDemandImport.h"
+
+#include "BasicUI.h"
+#include "Project.h"
+#include "ProjectRate.h"
+#include "SampleBlock.h"
+#include "TransactionScope.h"
+#include "WaveTrack.h"
+
+#include <catch2/catch.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <limits>
+#include <mutex>
+#include <thread>
+
+namespace
+{
+float Ramp(long long frame)
+{
+   return (frame % 1000) / 1000.0f;
+}
+
+//! Imitates the savepoints of a project file, and which blocks a rollback
+//! deletes
+struct FakeDatabase
+{
+   int depth { 0 };
+   std::vector<SampleBlockID> inTransaction;
+   std::vector<SampleBlockID> rolledBack;
+   SampleBlockID nextID { 1 };
+};
+
+struct FakeTransaction final : TransactionScopeImpl
+{
+   explicit FakeTransaction(FakeDatabase& database)
+       : database { database }
+   {
+   }
+   bool TransactionStart(const wxString&) override
+   {
+      ++database.depth;
+      return true;
+   }
+   bool TransactionCommit(const wxString&) override
+   {
+      if (--database.depth == 0)
+         database.inTransaction.clear();
+      return true;
+   }
+   bool TransactionRollback(const wxString&) override
+   {
+      database.rolledBack.insert(database.rolledBack.end(),
+         database.inTransaction.begin(), database.inTransaction.end());
+      database.inTransaction.clear();
+      --database.depth;
+      return true;
+   }
+   bool InTransaction() const override
+   {
+      return database.depth > 0;
+   }
+   FakeDatabase& database;
+};
+
+class FloatBlock final : public SampleBlock
+{
+public:
+   FloatBlock(SampleBlockID id, const float* src, size_t count)
+       : mID { id }
+       , mSamples(src, src + count)
+   {
+   }
+   void CloseLock() noexcept override
+   {
+   }
+   SampleBlockID GetBlockID() const override
+   {
+      return mID;
+   }
+   BlockSampleView GetFloatSampleView(bool) override
+   {
+      return std::make_shared<std::vector<float>>(mSamples);
+   }
+   sampleFormat GetSampleFormat() const override
+   {
+      return floatSample;
+   }
+   size_t GetSampleCount() const override
+   {
+      return mSamples.size();
+   }
+   bool GetSummary256(float* dest, size_t, size_t numframes) override
+   {
+      std::fill(dest, dest + 3 * numframes, 0.f);
+      return true;
+   }
+   bool GetSummary64k(float* dest, size_t, size_t numframes) override
+   {
+      std::fill(dest, dest + 3 * numframes, 0.f);
+      return true;
+   }
+   size_t GetSpaceUsage() const override
+   {
+      return mSamples.size() * sizeof(float);
+   }
+   void SaveXML(XMLWriter&) override
+   {
+   }
+
+protected:
+   size_t DoGetSamples(samplePtr dest, sampleFormat destformat,
+      size_t sampleoffset, size_t numsamples) override
+   {
+      CopySamples(
+         reinterpret_cast<constSamplePtr>(mSamples.data() + sampleoffset),
+         floatSample, dest, destformat, numsamples, DitherType::none);
+      return numsamples;
+   }
+   MinMaxRMS DoGetMinMaxRMS(size_t, size_t) override
+   {
+      return {};
+   }
+   MinMaxRMS DoGetMinMaxRMS() const override
+   {
+      return {};
+   }
+
+private:
+   const SampleBlockID mID;
+   const std::vector<float> mSamples;
+};
+
+//! Notes the blocks made while a transaction is open
+class FakeBlockFactory final : public SampleBlockFactory
+{
+public:
+   explicit FakeBlockFactory(FakeDatabase& database)
+       : database { database }
+   {
+   }
+   SampleBlockIDs GetActiveBlockIDs() override
+   {
+      return {};
+   }
+   SampleBlockPtr DoCreate(
+      constSamplePtr src, size_t numsamples, sampleFormat srcformat) override
+   {
+      REQUIRE(srcformat == floatSample);
+      const auto id = database.nextID++;
+      if (database.depth > 0)
+         database.inTransaction.push_back(id);
+      return std::make_shared<FloatBlock>(
+         id, reinterpret_cast<const float*>(src), numsamples);
+   }
+   SampleBlockPtr DoCreateSilent(size_t numsamples, sampleFormat) override
+   {
+      std::vector<float> silence(numsamples);
+      return std::make_shared<FloatBlock>(
+         -static_cast<SampleBlockID>(numsamples), silence.data(), numsamples);
+   }
+   SampleBlockPtr DoCreateFromXML(sampleFormat, const AttributesList&) override
+   {
+      return nullptr;
+   }
+   SampleBlockPtr DoCreateFromId(sampleFormat, SampleBlockID) override
+   {
+      return nullptr;
+   }
+   FakeDatabase& database;
+};
+
+//! Decodes a ramp, but only as many times as the test allows
+class GatedDecoder final : public OnDemandDecoder
+{
+public:
+   struct Gate
+   {
+      std::mutex mutex;
+      std::condition_variable condition;
+      size_t allowed { 0 };
+
+      void Allow(size_t count)
+      {
+         {
+            std::lock_guard<std::mutex> lock { mutex };
+            allowed += count;
+         }
+         condition.notify_all();
+      }
+   };
+
+   GatedDecoder(Gate& gate, long long numFrames)
+       : mGate { gate }
+       , mNumFrames { numFrames }
+   {
+   }
+   unsigned NumChannels() const override
+   {
+      return 1;
+   }
+   sampleFormat Format() const override
+   {
+      return floatSample;
+   }
+   double Rate() const override
+   {
+      return 44100;
+   }
+   sampleCount NumFrames() const override
+   {
+      return mNumFrames;
+   }
+   bool Seek(sampleCount frame) override
+   {
+      mPosition = frame.as_long_long();
+      return true;
+   }
+   size_t Decode(const samplePtr buffers[], size_t len) override
+   {
+      {
+         std::unique_lock<std::mutex> lock { mGate.mutex };
+         mGate.condition.wait(lock, [&] { return mGate.allowed > 0; });
+         --mGate.allowed;
+      }
+      const auto buffer = reinterpret_cast<float*>(buffers[0]);
+      for (size_t ii = 0; ii < len; ++ii)
+         buffer[ii] = Ramp(mPosition++);
+      return len;
+   }
+
+private:
+   Gate& mGate;
+   const long long mNumFrames;
+   long long mPosition { 0 };
+};
+
+void RequireRamp(const WaveTrack& track, long long numFrames)
+{
+   std::vector<float> buffer(numFrames);
+   float* const buffers[] { buffer.data() };
+   REQUIRE(track.GetFloats(0, 1, buffers, 0, numFrames));
+   for (long long ii = 0; ii < numFrames; ++ii)
+      REQUIRE(buffer[ii] == Ramp(ii));
+}
+} // namespace
+
+TEST_CASE("Import on demand stores no blocks in a cancelled effect")
+{
+   FakeDatabase database;
+   TransactionScope::Factory::Scope transactionScope {
+      [&](AudacityProject&) -> std::unique_ptr<TransactionScopeImpl> {
+         return std::make_unique<FakeTransaction>(database);
+      }
+   };
+   const auto project = AudacityProject::Create();
+   const auto pBlockFactory = std::make_shared<FakeBlockFactory>(database);
+   WaveTrackFactory trackFactory { ProjectRate::Get(*project), pBlockFactory };
+   auto& imports = OnDemandImports::Get(*project);
+
+   GatedDecoder::Gate gate;
+   // Allow decoding of the first block only, before the effect
+   gate.Allow(1);
+   TrackHolders tracks;
+   const auto blockSize = trackFactory.Create()->GetMaxBlockSize();
+   const auto numFrames = static_cast<long long>(3 * blockSize + 100);
+   imports.Start(std::make_unique<GatedDecoder>(gate, numFrames),
+      trackFactory, tracks);
+   REQUIRE(tracks.size() == 1);
+   const auto& track = static_cast<const WaveTrack&>(*tracks[0]);
+   while (imports.GetProgress() == 0)
+      std::this_thread::sleep_for(std::chrono::milliseconds { 1 });
+
+   {
+      TransactionScope trans { *project, "Effect" };
+      gate.Allow(std::numeric_limits<size_t>::max() / 2);
+      // The effect reads the samples, which are decoded meanwhile
+      RequireRamp(track, numFrames);
+      // Notifications from the decoder do not store blocks during the effect
+      BasicUI::Yield();
+      REQUIRE(database.inTransaction.empty());
+      REQUIRE(imports.IsBusy());
+      // Cancelled, without Commit()
+   }
+   REQUIRE(database.rolledBack.empty());
+
+   // Stores the rest outside of the transaction
+   REQUIRE(imports.Finish());
+   REQUIRE(!imports.IsBusy());
+   REQUIRE(database.rolledBack.empty());
+   REQUIRE(database.nextID == 5);
+   RequireRamp(track, numFrames);
+   for (const auto& pClip : track.Intervals())
+      for (const auto& block : pClip->GetSequence(0)->GetBlockArray())
+      {
+         REQUIRE(!block.sb->IsPending());
+         REQUIRE(block.sb->GetBlockID() > 0);
+      }
+   imports.Abandon();
+}
@@ -0,0 +1,145 @@
+/*  SPDX-License-Identifier: GPL-2.0-or-later */
+/*!********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  ParallelExportTests.cpp
+
+**********************************************************************/
+#include "ParallelExport.h"
+#include "ExportPlugin.h"
+
+#include <atomic>
+#include <catch2/catch.hpp>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+namespace
+{
+class TestDelegate final : public ExportProcessorDelegate
+{
+public:
+   bool IsCancelled() const override { return cancelled; }
+   bool IsStopped() const override { return false; }
+   void SetStatusString(const TranslatableString&) override {}
+   void OnProgress(double value) override { progress = value; }
+
+   std::atomic<bool> cancelled { false };
+   double progress {};
+};
+
+//! Runs until cancelled, or for about the given milliseconds, then gives the
+//! result
+ExportTask MakeTask(
+   std::atomic<int>& nRunning, std::atomic<int>& maxRunning,
+   ExportResult result = ExportResult::Success, int duration = 5)
+{
+   return ExportTask { [&, result, duration](
+                          ExportProcessorDelegate& delegate) {
+      const auto n = ++nRunning;
+      auto max = maxRunning.load();
+      while (n > max && !maxRunning.compare_exchange_weak(max, n))
+         ;
+      for (auto i = 0; i < duration; ++i)
+      {
+         if (delegate.IsCancelled())
+         {
+            --nRunning;
+            return ExportResult::Cancelled;
+         }
+         delegate.OnProgress(double(i) / duration);
+         std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+      --nRunning;
+      return result;
+   } };
+}
+} // namespace
+
+TEST_CASE("ParallelExport")
+{
+   constexpr size_t nTasks = 12;
+   TestDelegate delegate;
+   std::atomic<int> nRunning { 0 };
+   std::atomic<int> maxRunning { 0 };
+   std::vector<ExportResult> results(nTasks, ExportResult::Error);
+   std::vector<size_t> made;
+   const auto onResult = [&](size_t index, ExportResult result) {
+      results[index] = result;
+   };
+
+   SECTION("runs each task once, with at most the given number at once")
+   {
+      const auto next = ParallelExport::Run(
+         0, nTasks,
+         [&](size_t index) {
+            made.push_back(index);
+            return MakeTask(nRunning, maxRunning);
+         },
+         onResult, delegate, {}, 3);
+      REQUIRE(next == nTasks);
+      REQUIRE(maxRunning <= 3);
+      REQUIRE(made == std::vector<size_t> { 0, 1, 2, 3, 4,  5,
+                                            6, 7, 8, 9, 10, 11 });
+      REQUIRE(
+         results == std::vector<ExportResult>(nTasks, ExportResult::Success));
+      REQUIRE(delegate.progress == 1.0);
+   }
+
+   SECTION("makes no more tasks after one fails, and cancels later ones")
+   {
+      const auto next = ParallelExport::Run(
+         0, nTasks,
+         [&](size_t index) {
+            made.push_back(index);
+            if (index == 1)
+               return MakeTask(nRunning, maxRunning, ExportResult::Error, 0);
+            return MakeTask(nRunning, maxRunning, ExportResult::Success,
+                            index == 0 ? 100 : 1000);
+         },
+         onResult, delegate, {}, 4);
+      REQUIRE(next == 4);
+      REQUIRE(made == std::vector<size_t> { 0, 1, 2, 3 });
+      REQUIRE(results[0] == ExportResult::Success);
+      REQUIRE(results[1] == ExportResult::Error);
+      REQUIRE(results[2] == ExportResult::Cancelled);
+      REQUIRE(results[3] == ExportResult::Cancelled);
+   }
+
+   SECTION("cancels all tasks when the delegate is cancelled")
+   {
+      const auto next = ParallelExport::Run(
+         0, nTasks,
+         [&](size_t) {
+            return MakeTask(
+               nRunning, maxRunning, ExportResult::Success, 1000);
+         },
+         onResult, delegate, [&] { delegate.cancelled = true; }, 2);
+      REQUIRE(next == 2);
+      REQUIRE(results[0] == ExportResult::Cancelled);
+      REQUIRE(results[1] == ExportResult::Cancelled);
+      REQUIRE(nRunning == 0);
+   }
+
+   SECTION("rethrows the exception of a task after all finish")
+   {
+      REQUIRE_THROWS_AS(
+         ParallelExport::Run(
+            0, nTasks,
+            [&](size_t index) {
+               if (index == 0)
+                  return ExportTask { [](ExportProcessorDelegate&) {
+                     throw std::runtime_error { "failed" };
+                     return ExportResult::Success;
+                  } };
+               return MakeTask(
+                  nRunning, maxRunning, ExportResult::Success, 1000);
+            },
+            onResult, delegate, {}, 2),
+         std::runtime_error);
+      REQUIRE(nRunning == 0);
+      REQUIRE(results[0] == ExportResult::Error);
+      REQUIRE(results[1] == ExportResult::Cancelled);
+   }
+}
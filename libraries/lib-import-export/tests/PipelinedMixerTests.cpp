@@ -0,0 +1,108 @@
+/*  SPDX-License-Identifier: GPL-2.0-or-later */
+/*!********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  PipelinedMixerTests.cpp
+
+**********************************************************************/
+#include "PipelinedMixer.h"
+
+#include "Mix.h"
+#include "WideSampleSequence.h"
+
+#include <catch2/catch.hpp>
+#include <vector>
+
+namespace
+{
+constexpr auto rate = 100;
+constexpr auto duration = 10.0;
+
+//! Mono sequence of samples equal to their positions
+class RampSequence final : public WideSampleSequence
+{
+public:
+   bool DoGet(
+      size_t, size_t nBuffers, const samplePtr buffers[], sampleFormat format,
+      sampleCount start, size_t len, bool, fillFormat, bool,
+      sampleCount*) const override
+   {
+      // Called on the mixing thread, so no REQUIRE here
+      for (size_t i = 0; i < nBuffers; ++i)
+         for (size_t j = 0; j < len; ++j)
+            reinterpret_cast<float*>(buffers[i])[j] =
+               (start + sampleCount { j }).as_float();
+      return true;
+   }
+
+   size_t NChannels() const override { return 1; }
+   float GetChannelGain(int) const override { return 1.f; }
+   double GetStartTime() const override { return 0.; }
+   double GetEndTime() const override { return duration; }
+   double GetRate() const override { return rate; }
+   sampleFormat WidestEffectiveFormat() const override { return floatSample; }
+   bool HasTrivialEnvelope() const override { return true; }
+   void GetEnvelopeValues(double* buffer, size_t bufferLen, double, bool)
+      const override
+   {
+      std::fill(buffer, buffer + bufferLen, 1.0);
+   }
+   AudioGraph::ChannelType GetChannelType() const override
+   {
+      return AudioGraph::MonoChannel;
+   }
+};
+
+std::unique_ptr<Mixer> MakeMixer()
+{
+   Mixer::Inputs inputs;
+   inputs.emplace_back(std::make_shared<RampSequence>());
+   return std::make_unique<Mixer>(
+      move(inputs), true, Mixer::WarpOptions { 1.0, 1.0 }, 0.0, duration, 1,
+      64, false, rate, floatSample, false, nullptr,
+      Mixer::ApplyGain::Discard);
+}
+
+struct Block
+{
+   std::vector<float> samples;
+   double time;
+   bool operator==(const Block& other) const
+   {
+      return samples == other.samples && time == other.time;
+   }
+};
+
+template <typename M> std::vector<Block> MixAll(M& mixer)
+{
+   std::vector<Block> blocks;
+   while (const auto n = mixer.Process())
+   {
+      const auto buffer = reinterpret_cast<const float*>(mixer.GetBuffer(0));
+      blocks.push_back({ { buffer, buffer + n }, mixer.MixGetCurrentTime() });
+   }
+   return blocks;
+}
+} // namespace
+
+TEST_CASE("PipelinedMixer")
+{
+   auto mixer = MakeMixer();
+   const auto expected = MixAll(*mixer);
+   REQUIRE(expected.size() > 1);
+
+   for (const size_t queueSize : { 1, 4 })
+   {
+      PipelinedMixer pipelined { MakeMixer(), queueSize };
+      REQUIRE(MixAll(pipelined) == expected);
+      // Continues to report the end, as Mixer does
+      REQUIRE(pipelined.Process() == 0);
+   }
+
+   SECTION("can be destroyed before the end")
+   {
+      PipelinedMixer pipelined { MakeMixer(), 2 };
+      REQUIRE(pipelined.Process() > 0);
+   }
+}
@@ -37,6 +37,7 @@
 #include "SampleFormat.h"
 #include "Dither.h" // CYCLE
 
+#include <algorithm>
 #include <math.h>
 #include <stdlib.h>
 #include <string.h>
@@ -44,6 +45,15 @@
 #include "Prefs.h"
 #include "Internat.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || \
+   (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define DEINTERLEAVE_SSE2
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define DEINTERLEAVE_NEON
+#endif
+
 DitherType gLowQualityDither = DitherType::none;
 DitherType gHighQualityDither = DitherType::shaped;
 static Dither gDitherAlgorithm;
@@ -71,6 +81,101 @@ TranslatableString GetSampleFormatStr(sampleFormat format)
    return XO("Unknown format"); // compiler food
 }
 
+namespace {
+template<typename T>
+void Deinterleave(const T *src, T *const dsts[], size_t nChannels, size_t len)
+{
+   for (size_t c = 0; c < nChannels; ++c) {
+      auto pSrc = src + c;
+      const auto dst = dsts[c];
+      for (size_t j = 0; j < len; ++j, pSrc += nChannels)
+         dst[j] = *pSrc;
+   }
+}
+
+//! @return how many frames were copied; the rest are left to the caller
+size_t DeinterleaveStereo16(const int16_t *src, int16_t *left, int16_t *right,
+   size_t len)
+{
+   size_t j = 0;
+#if defined(DEINTERLEAVE_SSE2)
+   for (; j + 8 <= len; j += 8, src += 16) {
+      const auto a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+      const auto b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 8));
+      // Sign-extend each half of the 32 bit lanes, then pack, which does not
+      // saturate values that fit
+      const auto l = _mm_packs_epi32(
+         _mm_srai_epi32(_mm_slli_epi32(a, 16), 16),
+         _mm_srai_epi32(_mm_slli_epi32(b, 16), 16));
+      const auto r = _mm_packs_epi32(_mm_srai_epi32(a, 16), _mm_srai_epi32(b, 16));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(left + j), l);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(right + j), r);
+   }
+#elif defined(DEINTERLEAVE_NEON)
+   for (; j + 8 <= len; j += 8, src += 16) {
+      const auto lr = vld2q_s16(src);
+      vst1q_s16(left + j, lr.val[0]);
+      vst1q_s16(right + j, lr.val[1]);
+   }
+#endif
+   return j;
+}
+
+//! For float and for int24 (which is stored in 32 bits)
+size_t DeinterleaveStereo32(const float *src, float *left, float *right,
+   size_t len)
+{
+   size_t j = 0;
+#if defined(DEINTERLEAVE_SSE2)
+   for (; j + 4 <= len; j += 4, src += 8) {
+      const auto a = _mm_loadu_ps(src);
+      const auto b = _mm_loadu_ps(src + 4);
+      _mm_storeu_ps(left + j, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+      _mm_storeu_ps(right + j, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+   }
+#elif defined(DEINTERLEAVE_NEON)
+   for (; j + 4 <= len; j += 4, src += 8) {
+      const auto lr = vld2q_f32(src);
+      vst1q_f32(left + j, lr.val[0]);
+      vst1q_f32(right + j, lr.val[1]);
+   }
+#endif
+   return j;
+}
+
+template<typename T>
+void DeinterleaveSamples(const void *src, const samplePtr dsts[],
+   size_t nChannels, size_t len)
+{
+   auto pSrc = static_cast<const T*>(src);
+   T *const pDsts[2] { reinterpret_cast<T*>(dsts[0]),
+      nChannels > 1 ? reinterpret_cast<T*>(dsts[1]) : nullptr };
+   size_t done = 0;
+   if (nChannels == 2) {
+      if constexpr (sizeof(T) == 2)
+         done = DeinterleaveStereo16(pSrc, pDsts[0], pDsts[1], len);
+      else
+         done = DeinterleaveStereo32(pSrc, pDsts[0], pDsts[1], len);
+      T *const rest[2] { pDsts[0] + done, pDsts[1] + done };
+      Deinterleave(pSrc + 2 * done, rest, 2, len - done);
+   }
+   else if (nChannels == 1)
+      std::copy(pSrc, pSrc + len, pDsts[0]);
+   else
+      Deinterleave(pSrc, reinterpret_cast<T *const *>(dsts), nChannels, len);
+}
+}
+
+void DeinterleaveSamples(constSamplePtr src, sampleFormat format,
+   const samplePtr dsts[], size_t nChannels, size_t len)
+{
+   if (format == int16Sample)
+      DeinterleaveSamples<int16_t>(src, dsts, nChannels, len);
+   else
+      // Copy int24 as if float, bits unchanged
+      DeinterleaveSamples<float>(src, dsts, nChannels, len);
+}
+
 // TODO: Risky?  Assumes 0.0f is represented by 0x00000000;
 void ClearSamples(samplePtr dst, sampleFormat format,
                   size_t start, size_t len)
@@ -232,6 +232,16 @@ void CopySamples(constSamplePtr src, sampleFormat srcFormat,
    DitherType ditherType = gHighQualityDither, //!< default is loaded from a global variable
    unsigned int srcStride=1, unsigned int dstStride=1);
 
+MATH_API
+//! Copy interleaved samples into one buffer for each channel, in the same format
+/*!
+ Vectorized for two channels, which is the usual case
+ @param src address of interleaved samples, `len * nChannels` of them
+ @param dsts addresses of `nChannels` buffers, each to receive `len` samples
+ */
+void DeinterleaveSamples(constSamplePtr src, sampleFormat format,
+   const samplePtr dsts[], size_t nChannels, size_t len);
+
 MATH_API
 void      ClearSamples(samplePtr buffer, sampleFormat format,
                        size_t start, size_t len);
@@ -0,0 +1,52 @@
+/*  SPDX-License-Identifier: GPL-2.0-or-later */
+/*!********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  SampleFormatTests.cpp
+
+**********************************************************************/
+#include "SampleFormat.h"
+
+#include <catch2/catch.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace
+{
+template<typename T>
+void TestDeinterleave(sampleFormat format, size_t nChannels, size_t len)
+{
+   std::vector<T> src(nChannels * len);
+   for (size_t i = 0; i < src.size(); ++i)
+      // Include negative values, to check for sign extension
+      src[i] = static_cast<T>(static_cast<int>(i) - 1000);
+
+   std::vector<std::vector<T>> dsts(nChannels, std::vector<T>(len));
+   std::vector<samplePtr> pDsts;
+   for (auto& dst : dsts)
+      pDsts.push_back(reinterpret_cast<samplePtr>(dst.data()));
+
+   DeinterleaveSamples(reinterpret_cast<constSamplePtr>(src.data()), format,
+      pDsts.data(), nChannels, len);
+
+   for (size_t c = 0; c < nChannels; ++c)
+      for (size_t j = 0; j < len; ++j)
+         REQUIRE(dsts[c][j] == src[j * nChannels + c]);
+}
+}
+
+TEST_CASE("DeinterleaveSamples")
+{
+   // Lengths that are and are not multiples of the vector widths
+   for (size_t len : { 0, 1, 3, 4, 8, 13, 1024 })
+   {
+      for (size_t nChannels : { 1, 2, 3, 6 })
+      {
+         TestDeinterleave<int16_t>(int16Sample, nChannels, len);
+         TestDeinterleave<int32_t>(int24Sample, nChannels, len);
+         TestDeinterleave<float>(floatSample, nChannels, len);
+      }
+   }
+}
@@ -0,0 +1,216 @@
+/*  SPDX-License-Identifier: GPL-2.0-or-later */
+/*!********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  @file DecimatingSequence.cpp
+
+**********************************************************************/
+#include "DecimatingSequence.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <numeric>
+
+namespace
+{
+//! Right half of a Hann-windowed sinc, with cutoff at the Nyquist frequency
+//! of the output, and unit gain at DC; element 0 is the center
+std::vector<float> MakeCoefficients(size_t factor, size_t halfTaps)
+{
+   std::vector<float> result(halfTaps + 1);
+   const auto pi = 4 * std::atan(1.0);
+   for (size_t m = 0; m <= halfTaps; ++m)
+   {
+      const auto x = pi * m / factor;
+      const auto sinc = m == 0 ? 1.0 : std::sin(x) / x;
+      const auto window = 0.5 * (1 + std::cos(pi * m / (halfTaps + 1)));
+      result[m] = sinc * window;
+   }
+   // Sum of both halves, counting the center once
+   const auto sum =
+      2 * std::accumulate(result.begin(), result.end(), 0.0) - result[0];
+   for (auto& coefficient : result)
+      coefficient /= sum;
+   return result;
+}
+
+//! Offsets from the center of the taps that are not zero, as at every
+//! factor-th sample of the sinc
+std::vector<size_t> NonZeroTaps(const std::vector<float>& coefficients)
+{
+   std::vector<size_t> result;
+   for (size_t m = 1; m < coefficients.size(); ++m)
+      if (std::abs(coefficients[m]) > 1e-6f)
+         result.push_back(m);
+   return result;
+}
+} // namespace
+
+DecimatingSequence::DecimatingSequence(
+   std::shared_ptr<const WideSampleSequence> pSequence, size_t factor)
+    : mpSequence { move(pSequence) }
+    , mFactor { factor }
+    , mHalfTaps { HalfTapsPerFactor * factor }
+    , mCoefficients { MakeCoefficients(mFactor, mHalfTaps) }
+    , mTaps { NonZeroTaps(mCoefficients) }
+{
+   assert(mpSequence);
+   assert(mFactor > 0);
+}
+
+DecimatingSequence::~DecimatingSequence() = default;
+
+AudioGraph::ChannelType DecimatingSequence::GetChannelType() const
+{
+   return mpSequence->GetChannelType();
+}
+
+size_t DecimatingSequence::NChannels() const
+{
+   return mpSequence->NChannels();
+}
+
+float DecimatingSequence::GetChannelGain(int channel) const
+{
+   return mpSequence->GetChannelGain(channel);
+}
+
+bool DecimatingSequence::Fetch(size_t iChannel, size_t nBuffers,
+   sampleCount start, size_t len, fillFormat fill, bool mayThrow,
+   sampleCount* pNumWithinClips) const
+{
+   const auto spanLen = len * mFactor + 2 * mHalfTaps;
+   const auto follows = mNextStart == start && mFetchedChannel == iChannel &&
+                        mFetchedChannels == nBuffers;
+   mNextStart.reset();
+   mInput.resize(std::max(mInput.size(), nBuffers));
+   std::vector<float*> pointers(nBuffers);
+   for (size_t ii = 0; ii < nBuffers; ++ii)
+   {
+      auto& input = mInput[ii];
+      if (follows)
+         std::copy(input.begin() + mTail,
+            input.begin() + mTail + 2 * mHalfTaps, input.begin());
+      if (input.size() < spanLen)
+         input.resize(spanLen);
+   }
+
+   // Input positions of the samples not kept from the last fetch
+   const auto kept = follows ? 2 * mHalfTaps : 0;
+   auto pos = start * mFactor - mHalfTaps + kept;
+   auto offset = kept;
+   auto count = spanLen - kept;
+   if (pos < 0)
+   {
+      const auto zeroes =
+         std::min(count, static_cast<size_t>((-pos).as_long_long()));
+      for (size_t ii = 0; ii < nBuffers; ++ii)
+         std::fill_n(mInput[ii].begin() + offset, zeroes, 0.0f);
+      pos += zeroes;
+      offset += zeroes;
+      count -= zeroes;
+   }
+   if (pNumWithinClips)
+      *pNumWithinClips = 0;
+   if (count > 0)
+   {
+      for (size_t ii = 0; ii < nBuffers; ++ii)
+         pointers[ii] = mInput[ii].data() + offset;
+      if (!mpSequence->GetFloats(iChannel, nBuffers, pointers.data(), pos,
+             count, false, fill, mayThrow, pNumWithinClips))
+         return false;
+      if (pNumWithinClips)
+         *pNumWithinClips = *pNumWithinClips / mFactor;
+   }
+
+   mNextStart = start + len;
+   mTail = len * mFactor;
+   mFetchedChannel = iChannel;
+   mFetchedChannels = nBuffers;
+   return true;
+}
+
+bool DecimatingSequence::DoGet(
+   size_t iChannel, size_t nBuffers, const samplePtr buffers[],
+   sampleFormat format, sampleCount start, size_t len, bool backward,
+   fillFormat fill, bool mayThrow, sampleCount* pNumWithinClips) const
+{
+   if (len == 0)
+      return true;
+   // Read backward as forward, from the other end, then reverse
+   if (backward)
+   {
+      mNextStart.reset();
+      start -= len;
+   }
+   if (!Fetch(
+          iChannel, nBuffers, start, len, fill, mayThrow, pNumWithinClips))
+      return false;
+   if (backward)
+      mNextStart.reset();
+
+   const auto coefficients = mCoefficients.data();
+   if (format != floatSample)
+      mOutput.resize(len);
+   for (size_t ii = 0; ii < nBuffers; ++ii)
+   {
+      const auto output = format == floatSample ?
+                             reinterpret_cast<float*>(buffers[ii]) :
+                             mOutput.data();
+      // The filter is symmetrical about each factor-th input sample
+      auto center = mInput[ii].data() + mHalfTaps;
+      for (size_t jj = 0; jj < len; ++jj, center += mFactor)
+      {
+         auto sum = coefficients[0] * center[0];
+         for (const auto m : mTaps)
+            sum += coefficients[m] * (*(center - m) + center[m]);
+         output[jj] = sum;
+      }
+      if (backward)
+         std::reverse(output, output + len);
+      if (format != floatSample)
+         CopySamples(reinterpret_cast<constSamplePtr>(output), floatSample,
+            buffers[ii], format, len, gLowQualityDither);
+   }
+   return true;
+}
+
+double DecimatingSequence::GetStartTime() const
+{
+   return mpSequence->GetStartTime();
+}
+
+double DecimatingSequence::GetEndTime() const
+{
+   return mpSequence->GetEndTime();
+}
+
+double DecimatingSequence::GetRate() const
+{
+   return mpSequence->GetRate() / mFactor;
+}
+
+sampleFormat DecimatingSequence::WidestEffectiveFormat() const
+{
+   return mpSequence->WidestEffectiveFormat();
+}
+
+bool DecimatingSequence::HasTrivialEnvelope() const
+{
+   return mpSequence->HasTrivialEnvelope();
+}
+
+void DecimatingSequence::GetEnvelopeValues(
+   double* buffer, size_t bufferLen, double t0, bool backwards) const
+{
+   if (bufferLen == 0)
+      return;
+   // Every factor-th value at the rate of the wrapped sequence
+   mEnvelope.resize((bufferLen - 1) * mFactor + 1);
+   mpSequence->GetEnvelopeValues(
+      mEnvelope.data(), mEnvelope.size(), t0, backwards);
+   for (size_t ii = 0; ii < bufferLen; ++ii)
+      buffer[ii] = mEnvelope[ii * mFactor];
+}
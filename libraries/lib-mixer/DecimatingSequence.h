@@ -0,0 +1,87 @@
+/*  SPDX-License-Identifier: GPL-2.0-or-later */
+/*!********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  @file DecimatingSequence.h
+  @brief Adapter of WideSampleSequence that lowers the rate by an integer
+
+**********************************************************************/
+#ifndef __AUDACITY_DECIMATING_SEQUENCE__
+#define __AUDACITY_DECIMATING_SEQUENCE__
+
+#include "WideSampleSequence.h" // to inherit
+#include <memory>
+#include <optional>
+#include <vector>
+
+//! Presents another sequence at 1 / factor of its rate, for fast previews
+/*!
+ Each output sample is a short windowed-sinc low-pass filter evaluated at
+ every factor-th input sample only, so a mixer downstream mixes and resamples
+ factor times fewer samples.  Forward reads that follow on from the previous
+ one fetch only the new input samples, keeping the tail of the last read for
+ the filter.
+ Not thread-safe, like the sequences that Mixer reads.
+ */
+class MIXER_API DecimatingSequence final : public WideSampleSequence
+{
+public:
+   //! Number of input samples on each side of the center of the filter,
+   //! per unit of the factor
+   static constexpr size_t HalfTapsPerFactor = 2;
+
+   /*!
+    @pre `pSequence != nullptr`
+    @pre `factor > 0`
+    */
+   DecimatingSequence(
+      std::shared_ptr<const WideSampleSequence> pSequence, size_t factor);
+   ~DecimatingSequence() override;
+
+   // AudioGraph::Channel
+   AudioGraph::ChannelType GetChannelType() const override;
+
+   // WideSampleSequence
+   size_t NChannels() const override;
+   float GetChannelGain(int channel) const override;
+   bool DoGet(
+      size_t iChannel, size_t nBuffers, const samplePtr buffers[],
+      sampleFormat format, sampleCount start, size_t len, bool backward,
+      fillFormat fill = FillFormat::fillZero, bool mayThrow = true,
+      sampleCount* pNumWithinClips = nullptr) const override;
+   double GetStartTime() const override;
+   double GetEndTime() const override;
+   double GetRate() const override;
+   sampleFormat WidestEffectiveFormat() const override;
+   bool HasTrivialEnvelope() const override;
+   void GetEnvelopeValues(
+      double* buffer, size_t bufferLen, double t0,
+      bool backwards) const override;
+
+private:
+   //! Fill mInput with the input samples for outputs [start, start + len)
+   bool Fetch(size_t iChannel, size_t nBuffers, sampleCount start,
+      size_t len, fillFormat fill, bool mayThrow,
+      sampleCount* pNumWithinClips) const;
+
+   const std::shared_ptr<const WideSampleSequence> mpSequence;
+   const size_t mFactor;
+   const size_t mHalfTaps;
+   //! Right half of the symmetrical filter
+   const std::vector<float> mCoefficients;
+   //! Indices of mCoefficients, other than 0, that are not zero
+   const std::vector<size_t> mTaps;
+
+   // Input samples, from mHalfTaps before the first output, for each channel
+   mutable std::vector<std::vector<float>> mInput;
+   mutable std::vector<double> mEnvelope;
+   mutable std::vector<float> mOutput;
+   // Where the next forward read may continue, keeping the 2 * mHalfTaps
+   // samples of mInput that begin at mTail
+   mutable std::optional<sampleCount> mNextStart;
+   mutable size_t mTail{};
+   mutable size_t mFetchedChannel{};
+   mutable size_t mFetchedChannels{};
+};
+#endif
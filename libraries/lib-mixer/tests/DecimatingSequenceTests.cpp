@@ -0,0 +1,205 @@
+/*  SPDX-License-Identifier: GPL-2.0-or-later */
+/*!********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  DecimatingSequenceTests.cpp
+
+**********************************************************************/
+#include "DecimatingSequence.h"
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+namespace
+{
+//! Sequence of the samples in vectors, one for each channel, and zeroes
+//! outside of them; counts the samples fetched
+class VectorSequence final : public WideSampleSequence
+{
+public:
+   VectorSequence(std::vector<std::vector<float>> channels, double rate)
+       : mChannels { move(channels) }
+       , mRate { rate }
+   {
+   }
+
+   bool DoGet(
+      size_t iChannel, size_t nBuffers, const samplePtr buffers[],
+      sampleFormat, sampleCount start, size_t len, bool backward, fillFormat,
+      bool, sampleCount* pNumWithinClips) const override
+   {
+      fetched += len;
+      for (size_t ii = 0; ii < nBuffers; ++ii)
+      {
+         const auto& samples = mChannels[iChannel + ii];
+         const auto size = static_cast<long long>(samples.size());
+         const auto buffer = reinterpret_cast<float*>(buffers[ii]);
+         for (size_t jj = 0; jj < len; ++jj)
+         {
+            const auto offset = static_cast<long long>(jj);
+            const auto pos = backward ? start.as_long_long() - 1 - offset :
+                                        start.as_long_long() + offset;
+            buffer[jj] = pos >= 0 && pos < size ? samples[pos] : 0;
+         }
+      }
+      if (pNumWithinClips)
+         *pNumWithinClips = len;
+      return true;
+   }
+
+   size_t NChannels() const override { return mChannels.size(); }
+   float GetChannelGain(int) const override { return 1.f; }
+   double GetStartTime() const override { return 0.; }
+   double GetEndTime() const override
+   {
+      return mChannels[0].size() / mRate;
+   }
+   double GetRate() const override { return mRate; }
+   sampleFormat WidestEffectiveFormat() const override { return floatSample; }
+   bool HasTrivialEnvelope() const override { return true; }
+   void GetEnvelopeValues(double* buffer, size_t bufferLen, double, bool)
+      const override
+   {
+      std::fill(buffer, buffer + bufferLen, 1.0);
+   }
+   AudioGraph::ChannelType GetChannelType() const override
+   {
+      return mChannels.size() == 1 ? AudioGraph::MonoChannel :
+                                     AudioGraph::LeftChannel;
+   }
+
+   mutable size_t fetched { 0 };
+
+private:
+   const std::vector<std::vector<float>> mChannels;
+   const double mRate;
+};
+
+//! Stereo, with channels that differ, and not periodic
+std::shared_ptr<VectorSequence> MakeNoise(size_t length)
+{
+   std::vector<std::vector<float>> channels(2, std::vector<float>(length));
+   unsigned state = 1;
+   for (auto& channel : channels)
+      for (auto& sample : channel)
+      {
+         state = state * 1103515245u + 12345u;
+         sample = static_cast<float>((state >> 8) & 0xffff) / 0x10000 - 0.5f;
+      }
+   return std::make_shared<VectorSequence>(move(channels), 44100);
+}
+
+std::vector<float> Read(const DecimatingSequence& sequence, size_t iChannel,
+   long long start, size_t len, bool backward = false)
+{
+   std::vector<float> result(len);
+   float* const buffers[] { result.data() };
+   REQUIRE(sequence.GetFloats(iChannel, 1, buffers, start, len, backward));
+   return result;
+}
+} // namespace
+
+TEST_CASE("DecimatingSequence reads in pieces as in one read")
+{
+   const auto pSequence = MakeNoise(50000);
+   const size_t len = 20000;
+   const auto whole = Read(DecimatingSequence { pSequence, 2 }, 0, 0, len);
+
+   // Follow-on reads of varying lengths, both channels at once
+   DecimatingSequence pieces { pSequence, 2 };
+   std::vector<float> left(len), right(len);
+   for (size_t start = 0, count = 1; start < len;
+        start += count, count = count * 7 % 1013 + 1)
+   {
+      count = std::min(count, len - start);
+      float* const buffers[] { left.data() + start, right.data() + start };
+      REQUIRE(pieces.GetFloats(0, 2, buffers, start, count));
+   }
+   REQUIRE(left == whole);
+   REQUIRE(right == Read(DecimatingSequence { pSequence, 2 }, 1, 0, len));
+}
+
+TEST_CASE("DecimatingSequence reads backward as the reverse of forward")
+{
+   const auto pSequence = MakeNoise(5000);
+   const auto forward = Read(DecimatingSequence { pSequence, 3 }, 0, 0, 700);
+   DecimatingSequence sequence { pSequence, 3 };
+   // Backward from 600 is 599, 598, ...; then forward again from scratch
+   const auto backward = Read(sequence, 0, 600, 100, true);
+   for (size_t ii = 0; ii < backward.size(); ++ii)
+      REQUIRE(backward[ii] == forward[599 - ii]);
+   const auto after = Read(sequence, 0, 500, 200);
+   REQUIRE(std::equal(after.begin(), after.end(), forward.begin() + 500));
+}
+
+TEST_CASE("DecimatingSequence has unit gain at DC")
+{
+   const auto pSequence = std::make_shared<VectorSequence>(
+      std::vector<std::vector<float>> { std::vector<float>(10000, 0.25f) },
+      48000);
+   DecimatingSequence sequence { pSequence, 3 };
+   REQUIRE(sequence.GetRate() == 16000);
+   for (const auto sample : Read(sequence, 0, 100, 1000))
+      REQUIRE(sample == Approx(0.25f).margin(1e-5));
+}
+
+TEST_CASE("DecimatingSequence rejects tones above the output Nyquist")
+{
+   // 18 kHz at 44.1 kHz, above the 11025 Hz Nyquist frequency of the output;
+   // the short filter attenuates it by 44.9 dB
+   const size_t length = 44100;
+   std::vector<float> tone(length);
+   const auto pi = 4 * std::atan(1.0);
+   for (size_t ii = 0; ii < length; ++ii)
+      tone[ii] = std::sin(2 * pi * 18000 * ii / 44100.0);
+   const auto pSequence = std::make_shared<VectorSequence>(
+      std::vector<std::vector<float>> { move(tone) }, 44100);
+
+   const auto output =
+      Read(DecimatingSequence { pSequence, 2 }, 0, 1000, 10000);
+   double sumSquares = 0;
+   for (const auto sample : output)
+      sumSquares += sample * sample;
+   const auto rms = std::sqrt(sumSquares / output.size());
+   REQUIRE(20 * std::log10(rms / std::sqrt(0.5)) < -44.5);
+}
+
+TEST_CASE("DecimatingSequence fetches only new samples for follow-on reads")
+{
+   const auto pSequence = MakeNoise(50000);
+   const size_t factor = 4;
+   const size_t len = 500;
+   const auto span = 2 * DecimatingSequence::HalfTapsPerFactor * factor;
+   DecimatingSequence sequence { pSequence, factor };
+   // What a new sequence reads, fetching all it needs
+   const auto fresh = [&](size_t iChannel, long long start) {
+      return Read(
+         DecimatingSequence { pSequence, factor }, iChannel, start, len);
+   };
+
+   // The first read fetches the filter's span on both sides
+   Read(sequence, 0, 1000, len);
+   REQUIRE(pSequence->fetched == len * factor + span);
+
+   // A read that follows on keeps the tail of the last
+   pSequence->fetched = 0;
+   const auto second = Read(sequence, 0, 1000 + len, len);
+   REQUIRE(pSequence->fetched == len * factor);
+   REQUIRE(second == fresh(0, 1000 + len));
+
+   // Not for another channel, nor for a gap
+   pSequence->fetched = 0;
+   const auto other = Read(sequence, 1, 1000 + 2 * len, len);
+   REQUIRE(pSequence->fetched == len * factor + span);
+   REQUIRE(other == fresh(1, 1000 + 2 * len));
+
+   pSequence->fetched = 0;
+   const auto gap = Read(sequence, 1, 1000 + 4 * len, len);
+   REQUIRE(pSequence->fetched == len * factor + span);
+   REQUIRE(gap == fresh(1, 1000 + 4 * len));
+}
@@ -0,0 +1,221 @@
+/*  SPDX-License-Identifier: GPL-2.0-or-later */
+/*!********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  BatchMeterDetection.cpp
+
+**********************************************************************/
+#include "BatchMeterDetection.h"
+#include "MusicInformationRetrieval.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace MIR
+{
+namespace
+{
+void WriteJsonString(std::ostream& out, const std::string& str)
+{
+   out << '"';
+   for (const auto c : str)
+      switch (c)
+      {
+      case '"':
+         out << "\\\"";
+         break;
+      case '\\':
+         out << "\\\\";
+         break;
+      case '\n':
+         out << "\\n";
+         break;
+      case '\r':
+         out << "\\r";
+         break;
+      case '\t':
+         out << "\\t";
+         break;
+      default:
+         if (static_cast<unsigned char>(c) < 0x20)
+            out << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+                << static_cast<int>(c) << std::dec << std::setfill(' ');
+         else
+            // UTF-8 passes through
+            out << c;
+      }
+   out << '"';
+}
+
+std::string GetJsonLine(
+   const std::string& filename, const std::optional<MusicalMeter>& meter)
+{
+   std::ostringstream line;
+   line << "{\"file\":";
+   WriteJsonString(line, filename);
+   line << ",\"bpm\":";
+   if (meter)
+      line << std::setprecision(10) << meter->bpm;
+   else
+      line << "null";
+   line << ",\"timeSignature\":";
+   if (meter && meter->timeSignature)
+      line << '"' << GetNumerator(*meter->timeSignature) << '/'
+           << GetDenominator(*meter->timeSignature) << '"';
+   else
+      line << "null";
+   line << '}';
+   return line.str();
+}
+
+std::string GetJsonErrorLine(const std::string& filename, const char* error)
+{
+   std::ostringstream line;
+   line << "{\"file\":";
+   WriteJsonString(line, filename);
+   line << ",\"error\":";
+   WriteJsonString(line, error);
+   line << '}';
+   return line.str();
+}
+} // namespace
+
+size_t DetectMetersInFiles(
+   const std::vector<std::string>& filenames, const AudioFileOpener& open,
+   FalsePositiveTolerance tolerance, std::ostream& out, size_t numWorkers)
+{
+   if (numWorkers == 0)
+      numWorkers = std::max(std::thread::hardware_concurrency(), 1u);
+   const auto maxWaiting = 2 * numWorkers;
+
+   using Job = std::pair<std::string, std::unique_ptr<MirAudioReader>>;
+   std::mutex mutex;
+   std::condition_variable changed;
+   // Guarded by `mutex`, as are `out`, `numDetected`, `opened`, `finished`
+   // and `numRunning`
+   std::deque<Job> jobs;
+   size_t numDetected = 0;
+   auto opened = false;
+   // Readers that were analyzed, to be destroyed on the calling thread too
+   std::vector<std::unique_ptr<MirAudioReader>> finished;
+   auto numRunning = numWorkers;
+
+   const auto write = [&](const std::string& line) {
+      std::lock_guard lock { mutex };
+      out << line << '\n';
+   };
+
+   // Destroys the finished readers, with `mutex` unlocked meanwhile
+   const auto release = [&](std::unique_lock<std::mutex>& lock) {
+      auto readers = std::move(finished);
+      finished.clear();
+      lock.unlock();
+      readers.clear();
+      lock.lock();
+   };
+
+   const auto work = [&] {
+      while (true)
+      {
+         Job job;
+         {
+            std::unique_lock lock { mutex };
+            changed.wait(lock, [&] { return !jobs.empty() || opened; });
+            if (jobs.empty())
+            {
+               --numRunning;
+               changed.notify_all();
+               return;
+            }
+            job = std::move(jobs.front());
+            jobs.pop_front();
+         }
+         changed.notify_all();
+         std::string line;
+         auto detected = false;
+         try
+         {
+            const auto meter =
+               GetMusicalMeterFromSignal(*job.second, tolerance, {});
+            line = GetJsonLine(job.first, meter);
+            detected = meter.has_value();
+         }
+         catch (const std::exception& e)
+         {
+            line = GetJsonErrorLine(job.first, e.what());
+         }
+         catch (...)
+         {
+            // As AudacityException from reading, which is not a
+            // std::exception; escaping the thread would terminate all
+            line = GetJsonErrorLine(job.first, "cannot read audio");
+         }
+         {
+            std::lock_guard lock { mutex };
+            out << line << '\n';
+            if (detected)
+               ++numDetected;
+            finished.push_back(std::move(job.second));
+         }
+         changed.notify_all();
+      }
+   };
+
+   std::vector<std::thread> workers;
+   for (size_t i = 0; i < numWorkers; ++i)
+      workers.emplace_back(work);
+
+   for (const auto& filename : filenames)
+   {
+      std::unique_ptr<MirAudioReader> reader;
+      try
+      {
+         reader = open(filename);
+      }
+      catch (...)
+      {
+      }
+      if (!reader)
+      {
+         write(GetJsonErrorLine(filename, "cannot read audio"));
+         continue;
+      }
+      {
+         std::unique_lock lock { mutex };
+         release(lock);
+         while (jobs.size() >= maxWaiting)
+         {
+            changed.wait(lock, [&] {
+               return jobs.size() < maxWaiting || !finished.empty();
+            });
+            release(lock);
+         }
+         jobs.emplace_back(filename, std::move(reader));
+      }
+      changed.notify_all();
+   }
+   {
+      std::unique_lock lock { mutex };
+      opened = true;
+      changed.notify_all();
+      release(lock);
+      while (numRunning > 0 || !finished.empty())
+      {
+         changed.wait(
+            lock, [&] { return numRunning == 0 || !finished.empty(); });
+         release(lock);
+      }
+   }
+   for (auto& worker : workers)
+      worker.join();
+   out.flush();
+   return numDetected;
+}
+} // namespace MIR
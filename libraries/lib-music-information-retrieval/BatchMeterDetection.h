@@ -0,0 +1,44 @@
+/*  SPDX-License-Identifier: GPL-2.0-or-later */
+/*!********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  BatchMeterDetection.h
+
+**********************************************************************/
+#pragma once
+
+#include "MirTypes.h"
+
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace MIR
+{
+//! @return the audio of the file, or null if it cannot be read
+using AudioFileOpener =
+   std::function<std::unique_ptr<MirAudioReader>(const std::string& filename)>;
+
+/*!
+ * @brief Detects the tempo and meter of many audio files, writing one JSON
+ * object per line to `out`, in order of completion.
+ *
+ * @details Each line has a "file" member, and either "bpm" and
+ * "timeSignature", null if the file does not seem to be a loop, or "error".
+ *
+ * `open` is called on the calling thread, in the order of `filenames`, so that
+ * it may use facilities that are not thread-safe; the analyses run meanwhile
+ * on `numWorkers` threads, which hand the readers back to the calling thread
+ * to be destroyed. At most twice as many opened files as workers wait for
+ * analysis.
+ *
+ * @param numWorkers if 0, the hardware concurrency
+ * @return the number of files for which a meter was detected
+ */
+MUSIC_INFORMATION_RETRIEVAL_API size_t DetectMetersInFiles(
+   const std::vector<std::string>& filenames, const AudioFileOpener& open,
+   FalsePositiveTolerance tolerance, std::ostream& out, size_t numWorkers = 0);
+} // namespace MIR
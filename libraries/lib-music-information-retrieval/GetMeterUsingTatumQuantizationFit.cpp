@@ -305,11 +305,11 @@ double GetBeatSelfSimilarityScore(
 
 size_t GetBestBarDivisionIndex(
    const std::vector<BarDivision>& possibleBarDivisions,
-   double audioFileDuration, int numTatums, const std::vector<float>& odf,
+   double audioFileDuration, int numTatums,
+   const std::vector<float>& odfAutoCorr,
    QuantizationFitDebugOutput* debugOutput)
 
 {
-   const auto odfAutoCorr = GetNormalizedCircularAutocorr(odf);
    if (debugOutput)
       debugOutput->odfAutoCorr = odfAutoCorr;
    const auto odfAutocorrFullSize = 2 * (odfAutoCorr.size() - 1);
@@ -341,7 +341,7 @@ size_t GetBestBarDivisionIndex(
 }
 
 MusicalMeter GetMostLikelyMeterFromQuantizationExperiment(
-   const std::vector<float>& odf, int numTatums,
+   const std::vector<float>& odfAutoCorr, int numTatums,
    std::vector<BarDivision> possibleBarDivisions, double audioFileDuration,
    QuantizationFitDebugOutput* debugOutput)
 {
@@ -362,7 +362,8 @@ MusicalMeter GetMostLikelyMeterFromQuantizationExperiment(
       std::swap(possibleBarDivisions, fourFourDivs);
 
    const auto winnerIndex = GetBestBarDivisionIndex(
-      possibleBarDivisions, audioFileDuration, numTatums, odf, debugOutput);
+      possibleBarDivisions, audioFileDuration, numTatums, odfAutoCorr,
+      debugOutput);
 
    const auto& barDivision = possibleBarDivisions[winnerIndex];
    const auto numBeats = barDivision.numBars * barDivision.beatsPerBar;
@@ -390,16 +391,12 @@ bool IsSingleEvent(
 } // namespace
 
 std::optional<MusicalMeter> GetMeterUsingTatumQuantizationFit(
-   const MirAudioReader& audio, FalsePositiveTolerance tolerance,
-   const std::function<void(double)>& progressCallback,
+   const OnsetAnalysis& analysis, FalsePositiveTolerance tolerance,
    QuantizationFitDebugOutput* debugOutput)
 {
-   const auto odf =
-      GetOnsetDetectionFunction(audio, progressCallback, debugOutput);
-   const auto odfSr =
-      1. * audio.GetSampleRate() * odf.size() / audio.GetNumSamples();
-   const auto audioFileDuration =
-      1. * audio.GetNumSamples() / audio.GetSampleRate();
+   const auto& odf = analysis.odf;
+   const auto audioFileDuration = analysis.audioFileDuration;
+   const auto odfSr = odf.size() / audioFileDuration;
 
    const auto peakIndices = GetPeakIndices(odf);
    if (debugOutput)
@@ -437,8 +434,8 @@ std::optional<MusicalMeter> GetMeterUsingTatumQuantizationFit(
       odf, peakIndices, peakValues, possibleNumTatums, debugOutput);
 
    const auto winnerMeter = GetMostLikelyMeterFromQuantizationExperiment(
-      odf, experiment.numDivisions, possibleDivs.at(experiment.numDivisions),
-      audioFileDuration, debugOutput);
+      analysis.odfAutoCorr, experiment.numDivisions,
+      possibleDivs.at(experiment.numDivisions), audioFileDuration, debugOutput);
 
    const auto score = 1 - experiment.error;
 
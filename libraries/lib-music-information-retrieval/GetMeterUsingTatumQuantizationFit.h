@@ -58,20 +58,18 @@ was faster than all others""
 
 #include "MirTypes.h"
 
-#include <functional>
 #include <optional>
 
 namespace MIR
 {
-class MirAudioReader;
+struct OnsetAnalysis;
 
 /*!
- * @brief Get the BPM of the given audio file, using the Tatum Quantization Fit
- * method.
+ * @brief Get the BPM of an audio file, using the Tatum Quantization Fit
+ * method, from the analysis of its onsets.
  */
 std::optional<MusicalMeter> GetMeterUsingTatumQuantizationFit(
-   const MirAudioReader& audio, FalsePositiveTolerance tolerance,
-   const std::function<void(double)>& progressCallback,
+   const OnsetAnalysis& analysis, FalsePositiveTolerance tolerance,
    QuantizationFitDebugOutput* debugOutput);
 
 } // namespace MIR
@@ -173,4 +173,18 @@ std::vector<float> GetOnsetDetectionFunction(
 
    return odf;
 }
+
+OnsetAnalysis GetOnsetAnalysis(
+   const MirAudioReader& audio,
+   const std::function<void(double)>& progressCallback,
+   QuantizationFitDebugOutput* debugOutput)
+{
+   OnsetAnalysis analysis;
+   analysis.audioFileDuration =
+      1. * audio.GetNumSamples() / audio.GetSampleRate();
+   analysis.odf =
+      GetOnsetDetectionFunction(audio, progressCallback, debugOutput);
+   analysis.odfAutoCorr = GetNormalizedCircularAutocorr(analysis.odf);
+   return analysis;
+}
 } // namespace MIR
@@ -38,4 +38,21 @@ std::vector<float> GetOnsetDetectionFunction(
    const MirAudioReader& audio,
    const std::function<void(double)>& progressCallback,
    QuantizationFitDebugOutput* debugInfo);
+
+/*!
+ * @brief What the tatum quantization fit needs of the signal, and which
+ * depends on nothing else.
+ */
+struct OnsetAnalysis
+{
+   double audioFileDuration = 0.;
+   std::vector<float> odf;
+   //! `GetNormalizedCircularAutocorr(odf)`
+   std::vector<float> odfAutoCorr;
+};
+
+OnsetAnalysis GetOnsetAnalysis(
+   const MirAudioReader& audio,
+   const std::function<void(double)>& progressCallback,
+   QuantizationFitDebugOutput* debugInfo);
 } // namespace MIR
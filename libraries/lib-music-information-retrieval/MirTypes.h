@@ -110,6 +110,12 @@ struct ProjectSyncInfo
    const double excessDurationInQuarternotes = 0.;
 };
 
+/*!
+ * Identifies the samples delivered by a reader, so that analyses of them may
+ * be reused. Empty means the samples cannot be identified.
+ */
+using AudioContentKey = std::vector<long long>;
+
 class MirAudioReader
 {
 public:
@@ -117,6 +123,14 @@ public:
    virtual long long GetNumSamples() const = 0;
    virtual void
    ReadFloats(float* buffer, long long where, size_t numFrames) const = 0;
+   /*!
+    * Readers returning equal, non-empty keys must deliver the same samples at
+    * the same rate.
+    */
+   virtual AudioContentKey GetContentKey() const
+   {
+      return {};
+   }
    double GetDuration() const
    {
       return GetSampleRate() == 0 ? 0. : GetNumSamples() / GetSampleRate();
@@ -14,6 +14,7 @@
 #include "MirProjectInterface.h"
 #include "MirTypes.h"
 #include "MirUtils.h"
+#include "OnsetAnalysisCache.h"
 #include "StftFrameProvider.h"
 
 #include "MemoryX.h"
@@ -43,6 +44,10 @@ auto RemovePathPrefix(const std::string& filename)
 // has 1.5 quarter notes per beat.
 constexpr std::array<double, numTimeSignatures> quarternotesPerBeat { 2., 1.,
                                                                       1., 1.5 };
+
+// A 60-second signal yields an ODF of 8192 samples, and as much again of
+// autocorrelation, so this is at most a few megabytes.
+OnsetAnalysisCache onsetAnalysisCache { 64 };
 } // namespace
 
 std::optional<ProjectSyncInfo>
@@ -141,9 +146,18 @@ std::optional<MusicalMeter> GetMusicalMeterFromSignal(
       // A file longer than 1 minute is most likely not a loop, and processing
       // it would be costly.
       return {};
-   DecimatingMirAudioReader decimatedAudio { audio };
-   return GetMeterUsingTatumQuantizationFit(
-      decimatedAudio, tolerance, progressCallback, debugOutput);
+   // Debug output is filled during the analysis, so don't bypass it then.
+   const auto key = debugOutput ? AudioContentKey {} : audio.GetContentKey();
+   auto analysis = onsetAnalysisCache.Find(key);
+   if (!analysis)
+   {
+      DecimatingMirAudioReader decimatedAudio { audio };
+      analysis = std::make_shared<const OnsetAnalysis>(
+         GetOnsetAnalysis(decimatedAudio, progressCallback, debugOutput));
+      if (!key.empty())
+         onsetAnalysisCache.Insert(key, analysis);
+   }
+   return GetMeterUsingTatumQuantizationFit(*analysis, tolerance, debugOutput);
 }
 
 void SynchronizeProject(
@@ -0,0 +1,46 @@
+/*  SPDX-License-Identifier: GPL-2.0-or-later */
+/*!********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  OnsetAnalysisCache.cpp
+
+**********************************************************************/
+#include "OnsetAnalysisCache.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace MIR
+{
+OnsetAnalysisCache::OnsetAnalysisCache(size_t capacity)
+    : mCapacity { std::max<size_t>(capacity, 1) }
+{
+}
+
+std::shared_ptr<const OnsetAnalysis>
+OnsetAnalysisCache::Find(const AudioContentKey& key)
+{
+   if (key.empty())
+      return nullptr;
+   std::lock_guard lock { mMutex };
+   const auto it = std::find_if(
+      mEntries.begin(), mEntries.end(),
+      [&](const Entry& entry) { return entry.first == key; });
+   if (it == mEntries.end())
+      return nullptr;
+   mEntries.splice(mEntries.begin(), mEntries, it);
+   return it->second;
+}
+
+void OnsetAnalysisCache::Insert(
+   AudioContentKey key, std::shared_ptr<const OnsetAnalysis> analysis)
+{
+   assert(!key.empty());
+   std::lock_guard lock { mMutex };
+   mEntries.remove_if([&](const Entry& entry) { return entry.first == key; });
+   mEntries.emplace_front(std::move(key), std::move(analysis));
+   if (mEntries.size() > mCapacity)
+      mEntries.pop_back();
+}
+} // namespace MIR
@@ -0,0 +1,56 @@
+/*  SPDX-License-Identifier: GPL-2.0-or-later */
+/*!********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  OnsetAnalysisCache.h
+
+**********************************************************************/
+#pragma once
+
+#include "MirDsp.h"
+#include "MirTypes.h"
+
+#include <list>
+#include <memory>
+#include <mutex>
+
+namespace MIR
+{
+/*!
+ * @brief Keeps the onset analyses of the most recently analyzed audio, by the
+ * content keys of their readers, so that analyzing the same samples again,
+ * e.g. with another tolerance, does not read and transform them again.
+ *
+ * @details The analysis frames the whole signal in a power-of-two number of
+ * frames, so it depends on the exact extent of the audio: any change of the
+ * samples, trimming included, must change the key.
+ *
+ * May be used from any thread.
+ */
+class OnsetAnalysisCache final
+{
+public:
+   explicit OnsetAnalysisCache(size_t capacity);
+   OnsetAnalysisCache(const OnsetAnalysisCache&) = delete;
+   OnsetAnalysisCache& operator=(const OnsetAnalysisCache&) = delete;
+
+   //! @return the analysis for `key`, or null
+   std::shared_ptr<const OnsetAnalysis> Find(const AudioContentKey& key);
+
+   //! Replaces any analysis for the same key, discarding the least recently
+   //! used one if full
+   //! @pre `!key.empty()`
+   void Insert(
+      AudioContentKey key, std::shared_ptr<const OnsetAnalysis> analysis);
+
+private:
+   using Entry =
+      std::pair<AudioContentKey, std::shared_ptr<const OnsetAnalysis>>;
+
+   const size_t mCapacity;
+   std::mutex mMutex;
+   //! Most recently used first
+   std::list<Entry> mEntries;
+};
+} // namespace MIR
@@ -0,0 +1,120 @@
+/*  SPDX-License-Identifier: GPL-2.0-or-later */
+/*!********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  BatchMeterDetectionTests.cpp
+
+**********************************************************************/
+#include "BatchMeterDetection.h"
+#include "MirFakes.h"
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace MIR
+{
+namespace
+{
+//! Throws what is not a std::exception, as AudacityException
+class ThrowingMirAudioReader final : public ClickTrackMirAudioReader
+{
+public:
+   ThrowingMirAudioReader()
+       : ClickTrackMirAudioReader { AudioContentKey {} }
+   {
+   }
+
+private:
+   struct Failure
+   {
+   };
+   void ReadFloats(float*, long long, size_t) const override
+   {
+      throw Failure {};
+   }
+};
+
+//! Records the threads that destroy it
+class ThreadRecordingMirAudioReader final : public ClickTrackMirAudioReader
+{
+public:
+   explicit ThreadRecordingMirAudioReader(
+      std::mutex& mutex, std::vector<std::thread::id>& ids)
+       : ClickTrackMirAudioReader { AudioContentKey {} }
+       , mMutex { mutex }
+       , mIds { ids }
+   {
+   }
+
+   ~ThreadRecordingMirAudioReader() override
+   {
+      std::lock_guard lock { mMutex };
+      mIds.push_back(std::this_thread::get_id());
+   }
+
+private:
+   std::mutex& mMutex;
+   std::vector<std::thread::id>& mIds;
+};
+} // namespace
+
+TEST_CASE("DetectMetersInFiles")
+{
+   const std::vector<std::string> filenames { "a.wav", "missing.wav",
+                                              "b \"quoted\".wav", "c.wav",
+                                              "corrupt.wav" };
+   const auto open =
+      [](const std::string& filename) -> std::unique_ptr<MirAudioReader> {
+      if (filename == "missing.wav")
+         return nullptr;
+      if (filename == "corrupt.wav")
+         return std::make_unique<ThrowingMirAudioReader>();
+      return std::make_unique<ClickTrackMirAudioReader>(AudioContentKey {});
+   };
+   const auto numWorkers = GENERATE(1u, 3u);
+   std::ostringstream out;
+   DetectMetersInFiles(
+      filenames, open, FalsePositiveTolerance::Lenient, out, numWorkers);
+
+   std::vector<std::string> lines;
+   std::istringstream in { out.str() };
+   for (std::string line; std::getline(in, line);)
+      lines.push_back(line);
+   REQUIRE(lines.size() == filenames.size());
+   const auto count = [&](const std::string& text) {
+      return std::count_if(lines.begin(), lines.end(), [&](const auto& line) {
+         return line.find(text) != std::string::npos;
+      });
+   };
+   REQUIRE(count(R"({"file":"a.wav","bpm":)") == 1);
+   REQUIRE(count(R"({"file":"c.wav","bpm":)") == 1);
+   REQUIRE(count(R"({"file":"b \"quoted\".wav","bpm":)") == 1);
+   REQUIRE(count(R"({"file":"missing.wav","error":)") == 1);
+   REQUIRE(count(R"({"file":"corrupt.wav","error":)") == 1);
+}
+
+TEST_CASE("DetectMetersInFiles destroys readers on the calling thread")
+{
+   const std::vector<std::string> filenames(8, "a.wav");
+   std::mutex mutex;
+   std::vector<std::thread::id> ids;
+   const auto open = [&](const std::string&) {
+      return std::make_unique<ThreadRecordingMirAudioReader>(mutex, ids);
+   };
+   const auto numWorkers = GENERATE(1u, 3u);
+   std::ostringstream out;
+   DetectMetersInFiles(
+      filenames, open, FalsePositiveTolerance::Lenient, out, numWorkers);
+
+   REQUIRE(ids.size() == filenames.size());
+   REQUIRE(std::all_of(ids.begin(), ids.end(), [](const auto& id) {
+      return id == std::this_thread::get_id();
+   }));
+}
+} // namespace MIR
@@ -52,6 +52,41 @@ class SquareWaveMirAudioReader : public MirAudioReader
    }
 };
 
+class ClickTrackMirAudioReader : public MirAudioReader
+{
+public:
+   explicit ClickTrackMirAudioReader(AudioContentKey key)
+       : key { std::move(key) }
+   {
+   }
+
+   const AudioContentKey key;
+   mutable long long numSamplesRead = 0;
+
+private:
+   const int period = 11025;
+
+   double GetSampleRate() const override
+   {
+      return 44100;
+   }
+   long long GetNumSamples() const override
+   {
+      return 44100 * 4;
+   }
+   void
+   ReadFloats(float* buffer, long long where, size_t numFrames) const override
+   {
+      for (size_t i = 0; i < numFrames; ++i)
+         buffer[i] = (where + i) % period < 100 ? 1.f : 0.f;
+      numSamplesRead += numFrames;
+   }
+   AudioContentKey GetContentKey() const override
+   {
+      return key;
+   }
+};
+
 class FakeProjectInterface final : public ProjectInterface
 {
 public:
@@ -173,6 +173,38 @@ TEST_CASE("GetProjectSyncInfo")
    }
 }
 
+TEST_CASE("GetMusicalMeterFromSignal")
+{
+   constexpr auto tolerance = FalsePositiveTolerance::Lenient;
+
+   SECTION("reuses the analysis of readers with the same content key")
+   {
+      const ClickTrackMirAudioReader first { { 36, 1 } };
+      const auto expected = GetMusicalMeterFromSignal(first, tolerance, {});
+      REQUIRE(first.numSamplesRead > 0);
+
+      const ClickTrackMirAudioReader second { first.key };
+      const auto actual = GetMusicalMeterFromSignal(second, tolerance, {});
+      REQUIRE(second.numSamplesRead == 0);
+      REQUIRE(actual.has_value() == expected.has_value());
+      if (expected)
+         REQUIRE(actual->bpm == expected->bpm);
+
+      const ClickTrackMirAudioReader other { { 36, 2 } };
+      GetMusicalMeterFromSignal(other, tolerance, {});
+      REQUIRE(other.numSamplesRead > 0);
+   }
+
+   SECTION("does not cache without a content key")
+   {
+      const ClickTrackMirAudioReader reader { {} };
+      GetMusicalMeterFromSignal(reader, tolerance, {});
+      const auto numSamplesRead = reader.numSamplesRead;
+      GetMusicalMeterFromSignal(reader, tolerance, {});
+      REQUIRE(reader.numSamplesRead == 2 * numSamplesRead);
+   }
+}
+
 TEST_CASE("SynchronizeProject")
 {
    constexpr auto initialProjectTempo = 100.;
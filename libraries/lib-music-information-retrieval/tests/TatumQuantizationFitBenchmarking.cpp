@@ -1,3 +1,4 @@
+#include "BatchMeterDetection.h"
 #include "MirFakes.h"
 #include "MirTestUtils.h"
 #include "MusicInformationRetrieval.h"
@@ -300,4 +301,32 @@ TEST_CASE("TatumQuantizationFitBenchmarking")
    // inadvertent bug, and if it is deliberate, should be well justified.
    REQUIRE(!classifierQualityHasChanged);
 }
+
+TEST_CASE("DetectMetersInFilesBenchmarking")
+{
+   // Measures the throughput of batch detection over the benchmarking files,
+   // with one worker and with as many as the hardware allows. The files are
+   // decoded on the calling thread, as import plugins would be.
+   if (!runLocally)
+      return;
+
+   const auto audioFiles = GetBenchmarkingAudioFiles();
+   const AudioFileOpener open = [](const std::string& filename) {
+      return std::make_unique<WavMirAudioReader>(filename);
+   };
+   std::ofstream timeMeasurementFile { "./batchTimeMeasurement.txt" };
+   for (const auto numWorkers : { 1u, 0u })
+   {
+      std::ostringstream jsonLines;
+      const auto now = std::chrono::steady_clock::now();
+      DetectMetersInFiles(
+         audioFiles, open, FalsePositiveTolerance::Lenient, jsonLines,
+         numWorkers);
+      const std::chrono::duration<double> elapsed =
+         std::chrono::steady_clock::now() - now;
+      timeMeasurementFile << (numWorkers ? "1 worker: " : "all workers: ")
+                          << audioFiles.size() / elapsed.count()
+                          << " files/s\n";
+   }
+}
 } // namespace MIR
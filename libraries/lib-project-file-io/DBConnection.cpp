@@ -19,11 +19,14 @@ Paul Licameli -- split from ProjectFileIO.cpp
 #include "BasicUI.h"
 #include "FileNames.h"
 #include "Internat.h"
+#include "MemoryX.h"
 #include "Project.h"
 #include "FileException.h"
 #include "wxFileNameWrapper.h"
 #include "SentryHelper.h"
 
+#include <algorithm>
+
 #define AUDACITY_PROJECT_PAGE_SIZE 65536
 
 #define xstr(a) str(a)
@@ -285,6 +288,8 @@ bool DBConnection::Close()
       mCheckpointThread.join();
    }
 
+   ClearSampleBlockMetadata();
+
    // We're done with the prepared statements
    {
       std::lock_guard<std::mutex> guard(mStatementMutex);
@@ -490,6 +495,71 @@ sqlite3_stmt *DBConnection::Prepare(enum StatementID id, const char *sql)
    return stmt;
 }
 
+bool DBConnection::PreloadSampleBlockMetadata()
+{
+   ClearSampleBlockMetadata();
+
+   // length() of a blob is found from the record header; the samples and the
+   // summaries are not read.  Rows come in rowid order, which is block id
+   // order, so the result needs no sorting.
+   static const char *sql =
+      "SELECT blockid, sampleformat, summin, summax, sumrms,"
+      "       length(samples)"
+      "  FROM sampleblocks ORDER BY blockid;";
+
+   sqlite3_stmt *stmt = nullptr;
+   auto rc = sqlite3_prepare_v2(mDB, sql, -1, &stmt, nullptr);
+   if (rc != SQLITE_OK)
+   {
+      wxLogMessage("Failed to prepare sample block scan for %s\n"
+                   "\tError: %s",
+                   sqlite3_db_filename(mDB, nullptr),
+                   sqlite3_errmsg(mDB));
+      return false;
+   }
+   auto cleanup = finally([&]{ sqlite3_finalize(stmt); });
+
+   while ((rc = sqlite3_step(stmt)) == SQLITE_ROW)
+      mSampleBlockMetadata.push_back({
+         sqlite3_column_int64(stmt, 0),
+         sqlite3_column_int(stmt, 1),
+         sqlite3_column_double(stmt, 2),
+         sqlite3_column_double(stmt, 3),
+         sqlite3_column_double(stmt, 4),
+         static_cast<size_t>(sqlite3_column_int64(stmt, 5))
+      });
+
+   if (rc != SQLITE_DONE)
+   {
+      wxLogMessage("Failed to scan sample blocks of %s\n"
+                   "\tError: %s",
+                   sqlite3_db_filename(mDB, nullptr),
+                   sqlite3_errmsg(mDB));
+      ClearSampleBlockMetadata();
+      return false;
+   }
+   return true;
+}
+
+auto DBConnection::FindSampleBlockMetadata(long long blockID) const
+   -> const SampleBlockMetadata *
+{
+   const auto end = mSampleBlockMetadata.end();
+   const auto iter = std::lower_bound(mSampleBlockMetadata.begin(), end,
+      blockID, [](const SampleBlockMetadata &metadata, long long id){
+         return metadata.blockID < id;
+      });
+   if (iter == end || iter->blockID != blockID)
+      return nullptr;
+   return &*iter;
+}
+
+void DBConnection::ClearSampleBlockMetadata()
+{
+   // Release the memory too
+   std::vector<SampleBlockMetadata>{}.swap(mSampleBlockMetadata);
+}
+
 void DBConnection::CheckpointThread(sqlite3 *db, const FilePath &fileName)
 {
    int rc = SQLITE_OK;
@@ -607,6 +677,7 @@ struct DBConnectionTransactionScopeImpl final : TransactionScopeImpl {
    bool TransactionStart(const wxString &name) override;
    bool TransactionCommit(const wxString &name) override;
    bool TransactionRollback(const wxString &name) override;
+   bool InTransaction() const override;
 
    DBConnection &mConnection;
 };
@@ -701,6 +772,12 @@ bool DBConnectionTransactionScopeImpl::TransactionRollback(const wxString &name)
    return TransactionCommit(name);
 }
 
+bool DBConnectionTransactionScopeImpl::InTransaction() const
+{
+   // Also true during the explicit transaction of ProjectFileIO::CopyTo()
+   return !sqlite3_get_autocommit(mConnection.DB());
+}
+
 ConnectionPtr::~ConnectionPtr()
 {
    wxASSERT_MSG(!mpConnection, wxT("Project file was not closed at shutdown"));
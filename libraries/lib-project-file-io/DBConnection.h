@@ -19,6 +19,7 @@ Paul Licameli -- split from ProjectFileIO.h
 #include <memory>
 #include <mutex>
 #include <thread>
+#include <vector>
 
 #include "ClientData.h"
 #include "Identifier.h"
@@ -84,6 +85,32 @@ public:
    };
    sqlite3_stmt *Prepare(enum StatementID id, const char *sql);
 
+   //! What SqliteSampleBlock loads of a row of the sampleblocks table, which
+   //! is everything except the summaries and samples
+   struct SampleBlockMetadata
+   {
+      long long blockID;
+      int sampleFormat;
+      double sumMin;
+      double sumMax;
+      double sumRms;
+      size_t sampleBytes;
+   };
+
+   //! Read the metadata of all sample blocks in one table scan, so that
+   //! loading a project need not query for each block separately
+   /*!
+    @return false if the scan failed; FindSampleBlockMetadata() then finds
+    nothing, and blocks are queried one by one as before
+    */
+   bool PreloadSampleBlockMetadata();
+
+   //! @return the preloaded metadata for the block, or null
+   const SampleBlockMetadata *FindSampleBlockMetadata(long long blockID) const;
+
+   //! Free the preloaded metadata; it is not updated as blocks change
+   void ClearSampleBlockMetadata();
+
    void SetBypass( bool bypass );
    bool ShouldBypass();
 
@@ -122,6 +149,9 @@ private:
    using StatementIndex = std::pair<enum StatementID, std::thread::id>;
    std::map<StatementIndex, sqlite3_stmt *> mStatements;
 
+   //! Sorted by block id
+   std::vector<SampleBlockMetadata> mSampleBlockMetadata;
+
    std::shared_ptr<DBConnectionErrors> mpErrors;
    CheckpointFailureCallback mCallback;
 
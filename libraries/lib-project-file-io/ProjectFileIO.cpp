@@ -167,6 +167,39 @@ static const char *ProjectFileSchema =
    "  samples              BLOB"
    ");";
 
+// CREATE SQL undostates
+// undostates holds binary XML documents like those of the project table,
+// for the clips of undo states that SpilledUndoStates removed from memory.
+// Unlike the other tables, it is not persistent: it is meaningful only while
+// the project is open, and is dropped when the project is opened.  It is
+// made only when first needed.
+// undoblocks records the sample blocks that each of those documents refers
+// to.  No objects in memory need remain for those blocks, so the trigger
+// keeps their rows from deletion while any such document refers to them.
+static const char *UndoStatesSchema =
+   "CREATE TABLE IF NOT EXISTS <schema>.undostates"
+   "("
+   "  id                   INTEGER PRIMARY KEY,"
+   "  dict                 BLOB,"
+   "  doc                  BLOB"
+   ");"
+   ""
+   "CREATE TABLE IF NOT EXISTS <schema>.undoblocks"
+   "("
+   "  stateid              INTEGER,"
+   "  blockid              INTEGER,"
+   "  PRIMARY KEY (stateid, blockid)"
+   ") WITHOUT ROWID;"
+   ""
+   "CREATE INDEX IF NOT EXISTS <schema>.undoblocks_blockid"
+   "  ON undoblocks (blockid);"
+   ""
+   "CREATE TRIGGER IF NOT EXISTS <schema>.undoblocks_keep"
+   "  BEFORE DELETE ON sampleblocks"
+   "  WHEN EXISTS"
+   "    (SELECT 1 FROM undoblocks WHERE blockid = OLD.blockid)"
+   "  BEGIN SELECT RAISE(IGNORE); END;";
+
 
 class SQLiteBlobStream final
 {
@@ -475,6 +508,129 @@ wxString ProjectFileIO::GenerateDoc()
    return doc;
 }
 
+int64_t ProjectFileIO::WriteUndoState(
+   const ProjectSerializer &doc, const BlockIDs &blockids)
+{
+   wxString sql{ UndoStatesSchema };
+   sql.Replace("<schema>", "main");
+   if (Exec(sql, {}) != SQLITE_OK)
+      return 0;
+
+   int64_t id = 0;
+   if (!GetValue("SELECT IFNULL(MAX(id), 0) + 1 FROM main.undostates;", id))
+      return 0;
+
+   if (!WriteDoc("undostates", doc, "main", id))
+      return 0;
+
+   // Record the blocks before their objects may be destroyed
+   auto db = DB();
+   sqlite3_stmt *stmt = nullptr;
+   auto cleanup = finally([&]{ sqlite3_finalize(stmt); });
+   int rc = sqlite3_prepare_v2(db,
+      "INSERT INTO main.undoblocks (stateid, blockid) VALUES (?1, ?2);",
+      -1, &stmt, nullptr);
+   for (auto blockid : blockids) {
+      if (rc != SQLITE_OK)
+         break;
+      // Silent blocks have no rows
+      if (blockid <= 0)
+         continue;
+      sqlite3_bind_int64(stmt, 1, id);
+      sqlite3_bind_int64(stmt, 2, blockid);
+      rc = sqlite3_step(stmt);
+      if (rc == SQLITE_DONE)
+         rc = sqlite3_reset(stmt);
+   }
+   if (rc != SQLITE_OK)
+   {
+      ADD_EXCEPTION_CONTEXT("sqlite3.rc", std::to_string(rc));
+      ADD_EXCEPTION_CONTEXT(
+         "sqlite3.context", "ProjectFileIO::WriteUndoState");
+
+      SetDBError(XO("Failed to write an Undo History state"));
+      // The clips of the state remain in memory, keeping their blocks
+      DeleteUndoState(id);
+      return 0;
+   }
+
+   return id;
+}
+
+bool ProjectFileIO::ReadUndoState(int64_t id, XMLTagHandler &handler)
+{
+   // id is an alias of ROWID
+   BufferedProjectBlobStream stream(DB(), "main", "undostates", id);
+   return ProjectSerializer::Decode(stream, &handler);
+}
+
+bool ProjectFileIO::ReadUndoStateBlockIDs(int64_t id, BlockIDs &blockids)
+{
+   auto cb = [&blockids](int cols, char **vals, char **){
+      SampleBlockID blockid;
+      if (cols > 0 && wxString{ vals[0] }.ToLongLong(&blockid))
+         blockids.insert(blockid);
+      return 0;
+   };
+
+   char sql[256];
+   sqlite3_snprintf(sizeof(sql), sql,
+      "SELECT blockid FROM main.undoblocks WHERE stateid = %lld;",
+      static_cast<long long>(id));
+   return Query(sql, cb);
+}
+
+void ProjectFileIO::DeleteUndoState(int64_t id)
+{
+   // See SqliteSampleBlock::~SqliteSampleBlock()
+   if (!HasConnection() || CurrConn()->ShouldBypass())
+      return;
+
+   BlockIDs released;
+   if (!ReadUndoStateBlockIDs(id, released))
+      return;
+
+   char sql[256];
+   sqlite3_snprintf(sizeof(sql), sql,
+      "DELETE FROM main.undostates WHERE id = %lld;"
+      "DELETE FROM main.undoblocks WHERE stateid = %lld;",
+      static_cast<long long>(id), static_cast<long long>(id));
+   if (Exec(sql, {}) != SQLITE_OK)
+      return;
+
+   // Delete the rows of the released blocks, unless objects in memory still
+   // refer to them, which will delete them when destroyed; the trigger keeps
+   // the rows that other states still record
+   auto active = WaveTrackFactory::Get( mProject )
+      .GetSampleBlockFactory()
+         ->GetActiveBlockIDs();
+   WaveTrackUtilities::InspectLazyBlockIDs(TrackList::Get( mProject ), active);
+   sqlite3_stmt *stmt = nullptr;
+   auto cleanup = finally([&]{ sqlite3_finalize(stmt); });
+   int rc = sqlite3_prepare_v2(DB(),
+      "DELETE FROM main.sampleblocks WHERE blockid = ?1;", -1, &stmt, nullptr);
+   for (auto blockid : released)
+   {
+      if (rc != SQLITE_OK)
+         break;
+      if (active.count(blockid))
+         continue;
+      sqlite3_bind_int64(stmt, 1, blockid);
+      rc = sqlite3_step(stmt);
+      if (rc == SQLITE_DONE)
+         rc = sqlite3_reset(stmt);
+   }
+   if (rc != SQLITE_OK)
+   {
+      ADD_EXCEPTION_CONTEXT("sqlite3.rc", std::to_string(rc));
+      ADD_EXCEPTION_CONTEXT(
+         "sqlite3.context", "ProjectFileIO::DeleteUndoState");
+
+      // Only a waste of space, until the project is opened again
+      SetDBError(XO("Failed to delete an Undo History state"));
+   }
+}
+
 sqlite3 *ProjectFileIO::DB()
 {
    return GetConnection().DB();
@@ -1141,6 +1297,29 @@ bool ProjectFileIO::CopyTo(const FilePath &destpath,
          }
       }
 
+      // Undo states removed from memory remain with the rest of the Undo
+      // history when it is retained, with the records of their blocks
+      if (!prune)
+      {
+         int64_t count = 0;
+         if (!GetValue("SELECT COUNT(1) FROM main.sqlite_master"
+               " WHERE type = 'table' AND name = 'undostates';", count))
+            return false;
+         if (count > 0)
+         {
+            wxString sql{ UndoStatesSchema };
+            sql.Replace("<schema>", "outbound");
+            sql += "INSERT INTO outbound.undostates"
+                   "  SELECT * FROM main.undostates;"
+                   "INSERT INTO outbound.undoblocks"
+                   "  SELECT * FROM main.undoblocks;";
+            rc = Exec(sql, {});
+            if (rc != SQLITE_OK)
+               // Error message already captured.
+               return false;
+         }
+      }
+
       // Write the doc.
       //
       // If we're compacting a temporary project (user initiated from the File
@@ -1788,6 +1967,9 @@ void ProjectFileIO::WriteXML(XMLWriter &xmlFile,
 bool ProjectFileIO::AutoSave(bool recording)
 {
    ProjectSerializer autosave;
+   // Don't wait for files imported on demand; their blocks are written again
+   // when all are made
+   SampleBlock::StandInScope standIns;
    WriteXMLHeader(autosave);
    WriteXML(autosave, recording);
 
@@ -1828,7 +2010,8 @@ bool ProjectFileIO::AutoSaveDelete(sqlite3 *db /* = nullptr */)
 
 bool ProjectFileIO::WriteDoc(const char *table,
                              const ProjectSerializer &autosave,
-                             const char *schema /* = "main" */)
+                             const char *schema /* = "main" */,
+                             int64_t id /* = 1 */)
 {
    auto db = DB();
 
@@ -1836,14 +2019,14 @@ bool ProjectFileIO::WriteDoc(const char *table,
 
    int rc;
 
-   // For now, we always use an ID of 1. This will replace the previously
-   // written row every time.
+   // The project and autosave tables always use an ID of 1. This will
+   // replace the previously written row every time.
    char sql[256];
    sqlite3_snprintf(
       sizeof(sql), sql,
-      "INSERT INTO %s.%s(id, dict, doc) VALUES(1, ?1, ?2)"
+      "INSERT INTO %s.%s(id, dict, doc) VALUES(%lld, ?1, ?2)"
       "       ON CONFLICT(id) DO UPDATE SET dict = ?1, doc = ?2;",
-      schema, table);
+      schema, table, static_cast<long long>(id));
 
    sqlite3_stmt *stmt = nullptr;
    auto cleanup = finally([&]
@@ -1912,7 +2095,8 @@ bool ProjectFileIO::WriteDoc(const char *table,
    int64_t rowID = 0;
 
    const wxString rowIDSql =
-      wxString::Format("SELECT ROWID FROM %s.%s WHERE id = 1;", schema, table);
+      wxString::Format("SELECT ROWID FROM %s.%s WHERE id = %lld;",
+         schema, table, static_cast<long long>(id));
 
    if (!GetValue(rowIDSql, rowID, true))
    {
@@ -2040,6 +2224,12 @@ auto ProjectFileIO::LoadProject(const FilePath &fileName, bool ignoreAutosave)
    if (!OpenConnection(fileName))
       return {};
 
+   // Discard undo states that a previous session removed from memory; the
+   // check for orphan blocks below then deletes the rows only they used
+   Exec("DROP TRIGGER IF EXISTS main.undoblocks_keep;"
+        "DROP TABLE IF EXISTS main.undoblocks;"
+        "DROP TABLE IF EXISTS main.undostates;", {}, true);
+
    int64_t rowId = -1;
 
    bool useAutosave =
@@ -2069,7 +2259,24 @@ auto ProjectFileIO::LoadProject(const FilePath &fileName, bool ignoreAutosave)
       BufferedProjectBlobStream stream(
          DB(), "main", useAutosave ? "autosave" : "project", rowId);
 
-      success = ProjectSerializer::Decode(stream, this);
+      // Read the metadata of all blocks at once, rather than one query for
+      // each block the document refers to
+      auto &conn = GetConnection();
+      conn.PreloadSampleBlockMetadata();
+      const auto lazy = LazyProjectLoading.Read();
+      {
+         // Sequences read with this project's factory keep only the ids of
+         // their blocks, and make the blocks when they are first needed
+         SampleBlockFactory::LazyLoadingScope scope{
+            *WaveTrackFactory::Get(mProject).GetSampleBlockFactory(), lazy };
+         auto cleanup = finally([&]{
+            // Keep the metadata for the blocks that are made later; rows
+            // of the table are never updated, so it does not go stale
+            if (!lazy)
+               conn.ClearSampleBlockMetadata();
+         });
+         success = ProjectSerializer::Decode(stream, this);
+      }
 
       if (!success)
       {
@@ -2084,6 +2291,9 @@ auto ProjectFileIO::LoadProject(const FilePath &fileName, bool ignoreAutosave)
       auto blockids = WaveTrackFactory::Get( mProject )
          .GetSampleBlockFactory()
             ->GetActiveBlockIDs();
+      // Blocks of clips loaded lazily are not made yet, but are not orphans
+      WaveTrackUtilities::InspectLazyBlockIDs(
+         TrackList::Get( mProject ), blockids );
       if (blockids.size() > 0)
       {
          success = DeleteBlocks(blockids, true);
@@ -2682,3 +2892,5 @@ static ProjectHistory::AutoSave::Scope scope {
          "Error:_Disk_full_or_not_writable"
       };
 } };
+
+BoolSetting LazyProjectLoading{ L"/FileFormats/LazyProjectLoading", false };
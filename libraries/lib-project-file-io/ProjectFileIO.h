@@ -228,6 +228,27 @@ public:
    //! Return a strings representation of the active project XML doc
    wxString GenerateDoc();
 
+   //! Write a document to the table of undo states removed from memory,
+   //! which does not persist after the project closes
+   /*!
+    The rows of the given sample blocks are not deleted while the document
+    remains, even if no objects in memory refer to them
+    @return a positive id for the document, or 0 for failure
+    */
+   int64_t WriteUndoState(const ProjectSerializer &doc,
+      const BlockIDs &blockids);
+
+   //! Decode a document written by WriteUndoState(); return success
+   bool ReadUndoState(int64_t id, XMLTagHandler &handler);
+
+   //! Add the ids of sample blocks given to WriteUndoState(); return success
+   bool ReadUndoStateBlockIDs(int64_t id, BlockIDs &blockids);
+
+   //! Delete a document written by WriteUndoState(), and the rows of its
+   //! sample blocks that nothing else uses, unless there is no connection or
+   //! it bypasses deletions
+   void DeleteUndoState(int64_t id);
+
 private:
    void OnCheckpointFailure();
 
@@ -273,7 +294,8 @@ private:
    bool InstallSchema(sqlite3 *db, const char *schema = "main");
 
    // Write project or autosave XML (binary) documents
-   bool WriteDoc(const char *table, const ProjectSerializer &autosave, const char *schema = "main");
+   bool WriteDoc(const char *table, const ProjectSerializer &autosave,
+      const char *schema = "main", int64_t id = 1);
 
    // Application defined function to verify blockid exists is in set of blockids
    static void InSet(sqlite3_context *context, int argc, sqlite3_value **argv);
@@ -348,4 +370,8 @@ private:
    std::shared_ptr<AudacityProject> mpProject;
 };
 
+//! Whether opening a project defers making the sample blocks of each clip
+//! until the clip is first used
+extern PROJECT_FILE_IO_API BoolSetting LazyProjectLoading;
+
 #endif
@@ -21,7 +21,13 @@
 #include <wx/ustring.h>
 #include <codecvt>
 #include <locale>
+#include <cstring>
 #include <deque>
+#include <future>
+#include <memory>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
 
 #include <wx/log.h>
 
@@ -141,24 +147,6 @@ template <typename Number> void WriteBigEndian(MemoryStream& out, Number value)
    out.AppendData(&value, sizeof(value));
 }
 
-// Read little-endian file format to native little-endian
-template <typename Number> Number ReadLittleEndian(BufferedStreamReader& in)
-{
-   Number result;
-   in.ReadValue(result);
-   return result;
-}
-
-// Read little-endian file format to native big-endian
-template <typename Number> Number ReadBigEndian(BufferedStreamReader& in)
-{
-   Number result;
-   in.ReadValue(result);
-   auto begin = static_cast<unsigned char*>(static_cast<void*>(&result));
-   std::reverse(begin, begin + sizeof(result));
-   return result;
-}
-
 // Choose between implementations!
 static const auto WriteUShort =
    IsLittleEndian() ? &WriteLittleEndian<UShort> : &WriteBigEndian<UShort>;
@@ -171,27 +159,14 @@ static const auto WriteULong =
 static const auto WriteLongLong =
    IsLittleEndian() ? &WriteLittleEndian<LongLong> : &WriteBigEndian<LongLong>;
 
-static const auto ReadUShort =
-   IsLittleEndian() ? &ReadLittleEndian<UShort> : &ReadBigEndian<UShort>;
-static const auto ReadInt =
-   IsLittleEndian() ? &ReadLittleEndian<Int> : &ReadBigEndian<Int>;
-static const auto ReadLong =
-   IsLittleEndian() ? &ReadLittleEndian<Long> : &ReadBigEndian<Long>;
-static const auto ReadULong =
-   IsLittleEndian() ? &ReadLittleEndian<ULong> : &ReadBigEndian<ULong>;
-static const auto ReadLongLong =
-   IsLittleEndian() ? &ReadLittleEndian<LongLong> : &ReadBigEndian<LongLong>;
-
 // Functions to read and write certain lengths -- maybe we will change
 // our choices for widths or signedness?
 
 using Length = Int; // Instead, as wide as size_t?
 static const auto WriteLength = WriteInt;
-static const auto ReadLength = ReadInt;
 
 using Digits = Int; // Instead, just an unsigned char?
 static const auto WriteDigits = WriteInt;
-static const auto ReadDigits = ReadInt;
 
 class XMLTagHandlerAdapter final
 {
@@ -221,41 +196,25 @@ public:
       mHandlers.pop_back();
    }
 
-   void WriteAttr(const std::string_view& name, std::string value)
-   {
-      assert(mInTag);
-
-      if (!mInTag)
-         return;
-
-      mAttributes.emplace_back(name, CacheString(std::move(value)));
-   }
-
-   template <typename T> void WriteAttr(const std::string_view& name, T value)
+   //! The value, if a string, must stay valid until the next tag
+   void WriteAttr(
+      const std::string_view& name, const XMLAttributeValueView& value)
    {
       assert(mInTag);
 
       if (!mInTag)
          return;
 
-      mAttributes.emplace_back(name, XMLAttributeValueView(value));
+      mAttributes.emplace_back(name, value);
    }
 
-   void WriteData(std::string value)
+   void WriteData(const std::string_view& value)
    {
       if (mInTag)
          EmitStartTag();
 
       if (XMLTagHandler* const handler = mHandlers.back())
-         handler->HandleXMLContent(CacheString(std::move(value)));
-   }
-
-   void WriteRaw(std::string)
-   {
-      // This method is intentionally left empty.
-      // The only data that is serialized by FT_Raw
-      // is the boilerplate code like <?xml > and <!DOCTYPE>
-      // which are ignored
+         handler->HandleXMLContent(value);
    }
 
    bool Finalize()
@@ -295,24 +254,16 @@ private:
          }
       }
 
-      mStringsCache.clear();
       mAttributes.clear();
       mInTag = false;
    }
 
-   std::string_view CacheString(std::string string)
-   {
-      mStringsCache.emplace_back(std::move(string));
-      return mStringsCache.back();
-   }
-
    XMLTagHandler* mBaseHandler;
 
    std::vector<XMLTagHandler*> mHandlers;
 
    std::string_view mCurrentTagName;
 
-   std::deque<std::string> mStringsCache;
    AttributesList mAttributes;
 
    bool mInTag { false };
@@ -324,14 +275,25 @@ private:
 // 
 // }
 
+//! Append UTF-8 to `out`, which grows by at most 3 bytes for each 2 bytes
+//! of input
 template<typename BaseCharType>
-std::string FastStringConvert(const void* bytes, int bytesCount)
+void FastStringConvert(const void* bytes, int bytesCount, std::string& out)
 {
    constexpr int charSize = sizeof(BaseCharType);
 
    assert(bytesCount % charSize == 0);
 
-   const auto begin = static_cast<const BaseCharType*>(bytes);
+   // Strings are not aligned in the document; copy them when necessary into
+   // a buffer that each thread reuses
+   auto begin = static_cast<const BaseCharType*>(bytes);
+   if (reinterpret_cast<std::uintptr_t>(bytes) % alignof(BaseCharType) != 0)
+   {
+      thread_local std::vector<BaseCharType> aligned;
+      aligned.resize(bytesCount / charSize);
+      std::memcpy(aligned.data(), bytes, bytesCount);
+      begin = aligned.data();
+   }
    const auto end = begin + bytesCount / charSize;
 
    const bool isAscii = std::all_of(
@@ -340,10 +302,10 @@ std::string FastStringConvert(const void* bytes, int bytesCount)
       { return static_cast<std::make_unsigned_t<BaseCharType>>(c) < 0x7f; });
 
    if (isAscii)
-      return std::string(begin, end);
-   
-   return std::wstring_convert<std::codecvt_utf8<BaseCharType>, BaseCharType>()
-      .to_bytes(begin, end);
+      out.append(begin, end);
+   else
+      out += std::wstring_convert<
+         std::codecvt_utf8<BaseCharType>, BaseCharType>().to_bytes(begin, end);
 }
 } // namespace
 
@@ -388,10 +350,7 @@ void ProjectSerializer::WriteAttr(const wxString & name, const wxString & value)
 {
    mBuffer.AppendByte(FT_String);
    WriteName(name);
-
-   const Length len = value.length() * sizeof(wxStringCharType);
-   WriteLength( mBuffer, len );
-   mBuffer.AppendData(value.wx_str(), len);
+   WriteString(value);
 }
 
 void ProjectSerializer::WriteAttr(const wxString & name, int value)
@@ -452,24 +411,108 @@ void ProjectSerializer::WriteAttr(const wxString & name, double value, int digit
    WriteDigits( mBuffer, digits );
 }
 
+void ProjectSerializer::StartTag(const XMLName & name)
+{
+   mBuffer.AppendByte(FT_StartTag);
+   WriteName(name);
+}
+
+void ProjectSerializer::EndTag(const XMLName & name)
+{
+   mBuffer.AppendByte(FT_EndTag);
+   WriteName(name);
+}
+
+void ProjectSerializer::WriteAttr(const XMLName & name, const wxChar *value)
+{
+   WriteAttr(name, wxString(value));
+}
+
+void ProjectSerializer::WriteAttr(const XMLName & name, const wxString & value)
+{
+   mBuffer.AppendByte(FT_String);
+   WriteName(name);
+   WriteString(value);
+}
+
+void ProjectSerializer::WriteAttr(const XMLName & name, int value)
+{
+   mBuffer.AppendByte(FT_Int);
+   WriteName(name);
+
+   WriteInt( mBuffer, value );
+}
+
+void ProjectSerializer::WriteAttr(const XMLName & name, bool value)
+{
+   mBuffer.AppendByte(FT_Bool);
+   WriteName(name);
+
+   mBuffer.AppendByte(value);
+}
+
+void ProjectSerializer::WriteAttr(const XMLName & name, long value)
+{
+   mBuffer.AppendByte(FT_Long);
+   WriteName(name);
+
+   WriteLong( mBuffer, value );
+}
+
+void ProjectSerializer::WriteAttr(const XMLName & name, long long value)
+{
+   mBuffer.AppendByte(FT_LongLong);
+   WriteName(name);
+
+   WriteLongLong( mBuffer, value );
+}
+
+void ProjectSerializer::WriteAttr(const XMLName & name, size_t value)
+{
+   mBuffer.AppendByte(FT_SizeT);
+   WriteName(name);
+
+   WriteULong( mBuffer, value );
+}
+
+void ProjectSerializer::WriteAttr(const XMLName & name, float value, int digits)
+{
+   mBuffer.AppendByte(FT_Float);
+   WriteName(name);
+
+   mBuffer.AppendData(&value, sizeof(value));
+   WriteDigits( mBuffer, digits );
+}
+
+void ProjectSerializer::WriteAttr(const XMLName & name, double value, int digits)
+{
+   mBuffer.AppendByte(FT_Double);
+   WriteName(name);
+
+   mBuffer.AppendData(&value, sizeof(value));
+   WriteDigits( mBuffer, digits );
+}
+
 void ProjectSerializer::WriteData(const wxString & value)
 {
    mBuffer.AppendByte(FT_Data);
-
-   Length len = value.length() * sizeof(wxStringCharType);
-   WriteLength( mBuffer, len );
-   mBuffer.AppendData(value.wx_str(), len);
+   WriteString(value);
 }
 
 void ProjectSerializer::Write(const wxString & value)
 {
    mBuffer.AppendByte(FT_Raw);
-   Length len = value.length() * sizeof(wxStringCharType);
+   WriteString(value);
+}
+
+void ProjectSerializer::WriteString(const wxString & value)
+{
+   const Length len = value.length() * sizeof(wxStringCharType);
    WriteLength( mBuffer, len );
    mBuffer.AppendData(value.wx_str(), len);
 }
 
-void ProjectSerializer::WriteName(const wxString & name)
+unsigned short ProjectSerializer::GetNameId(const wxString & name)
 {
    wxASSERT(name.length() * sizeof(wxStringCharType) <= SHRT_MAX);
    UShort id;
@@ -496,7 +539,27 @@ void ProjectSerializer::WriteName(const wxString & name)
       mDictChanged = true;
    }
 
-   WriteUShort( mBuffer, id );
+   return id;
+}
+
+void ProjectSerializer::WriteName(const wxString & name)
+{
+   WriteUShort( mBuffer, GetNameId(name) );
+}
+
+void ProjectSerializer::WriteName(const XMLName & name)
+{
+   auto id = name.GetCachedId();
+   if (id < 0)
+   {
+      // Like mNames, the cached id is good for the rest of the run; if the
+      // name was already used as a wxString, this finds the same id
+      const auto view = name.Name();
+      id = GetNameId(wxString::FromUTF8(view.data(), view.size()));
+      name.SetCachedId(id);
+   }
+
+   WriteUShort( mBuffer, static_cast<UShort>(id) );
 }
 
 const MemoryStream &ProjectSerializer::GetDict() const
@@ -519,220 +582,463 @@ bool ProjectSerializer::DictChanged() const
    return mDictChanged;
 }
 
-// See ProjectFileIO::LoadProject() for explanation of the blockids arg
-bool ProjectSerializer::Decode(BufferedStreamReader& in, XMLTagHandler* handler)
+namespace {
+// Decoding happens in two phases.  A quick scan of the whole document finds
+// the token boundaries and the dictionary in effect at each; it cuts the
+// document into segments.  Then the segments are decoded on worker threads
+// into lists of events, which the calling thread replays in order into the
+// XMLTagHandlers.  The handlers build the project, which is not thread-safe,
+// but reading numbers and converting strings happen in parallel.
+//
+// Strings are converted into one buffer for each segment, reserved in
+// advance so that views of it remain valid; no string is allocated for each
+// attribute.
+
+using NameViews = std::unordered_map<UShort, std::string_view>;
+
+//! Dictionary and character size in effect at some point in the document
+struct DecoderState
 {
-   if (handler == nullptr)
-      return false;
+   NameViews ids;
+   std::vector<NameViews> idStack;
+   char charSize = 0;
+};
 
-   XMLTagHandlerAdapter adapter(handler);
+struct Segment
+{
+   size_t begin;
+   size_t end;
+   //! Total length of strings in the segment, to reserve the text buffer
+   size_t stringBytes;
+   DecoderState state;
+};
 
-   std::vector<char> bytes;
-   IdMap mIds;
-   std::vector<IdMap> mIdStack;
-   char mCharSize = 0;
+//! Tag, attribute, or content
+struct Event
+{
+   unsigned char type;
+   std::string_view name;
+   XMLAttributeValueView value;
+};
+
+struct DecodedSegment
+{
+   std::vector<Event> events;
+   std::string text;
+   //! Names defined within the segment
+   std::deque<std::string> names;
+   bool ok = true;
+   int64_t stringsCount = 0;
+   int64_t stringsLength = 0;
+};
 
-   mIds.clear();
+//! Read a floating point number, which the file format keeps native
+template<typename Number> Number ReadNative(const char* data)
+{
+   Number result;
+   std::memcpy(&result, data, sizeof(result));
+   return result;
+}
 
-   struct Error{}; // exception type for short-range try/catch
-   auto Lookup = [&mIds]( UShort id ) -> std::string_view
+//! Read a fixed-width integer from the little-endian file format
+template<typename Number> Number ReadNumber(const char* data)
+{
+   Number result;
+   std::memcpy(&result, data, sizeof(result));
+   if (!IsLittleEndian())
    {
-      auto iter = mIds.find( id );
-      if (iter == mIds.end())
-      {
-         throw Error{};
-      }
+      auto begin = static_cast<unsigned char*>(static_cast<void*>(&result));
+      std::reverse(begin, begin + sizeof(result));
+   }
+   return result;
+}
 
-      return iter->second;
-   };
+//! Convert a string of the document, appending it to `out`
+void ConvertString(char charSize, const char* data, int len, std::string& out)
+{
+   switch (charSize)
+   {
+      case 1:
+         out.append(data, len);
+         break;
 
-   int64_t stringsCount = 0;
-   int64_t stringsLength = 0;
+      case 2:
+         FastStringConvert<char16_t>(data, len, out);
+         break;
+
+      case 4:
+         FastStringConvert<char32_t>(data, len, out);
+         break;
+
+      default:
+         wxASSERT_MSG(false, wxT("Characters size not 1, 2, or 4"));
+      break;
+   }
+}
 
-   auto ReadString = [&mCharSize, &in, &bytes, &stringsCount, &stringsLength](int len) -> std::string
+//! @return size of the token beginning at `data`, including its type, or 0
+//! if it is truncated; sets `stringBytes` to the length of its string, if any
+size_t TokenSize(const char* data, size_t available, size_t& stringBytes)
+{
+   stringBytes = 0;
+   // Sizes after the type and the UShort name id
+   constexpr size_t idSize = 1 + sizeof(UShort);
+   size_t size = 1;
+   switch (static_cast<unsigned char>(data[0]))
    {
-      bytes.reserve( len );
-      auto data = bytes.data();
-      in.Read( data, len );
-
-      stringsCount++;
-      stringsLength += len;
-      
-      switch (mCharSize)
+      case FT_CharSize: size = 2; break;
+      case FT_StartTag:
+      case FT_EndTag: size = idSize; break;
+      case FT_Int: size = idSize + sizeof(Int); break;
+      case FT_Bool: size = idSize + 1; break;
+      case FT_Long: size = idSize + sizeof(Long); break;
+      case FT_LongLong: size = idSize + sizeof(LongLong); break;
+      case FT_SizeT: size = idSize + sizeof(ULong); break;
+      case FT_Float: size = idSize + sizeof(float) + sizeof(Digits); break;
+      case FT_Double: size = idSize + sizeof(double) + sizeof(Digits); break;
+      case FT_String:
+      case FT_Data:
+      case FT_Raw:
       {
-         case 1:
-            return std::string(bytes.data(), len);
+         const size_t header =
+            (data[0] == FT_String ? idSize : 1) + sizeof(Length);
+         if (available < header)
+            return 0;
+         const auto len = ReadNumber<Length>(data + header - sizeof(Length));
+         if (len < 0)
+            return 0;
+         stringBytes = len;
+         size = header + len;
+         break;
+      }
+      case FT_Name:
+      {
+         const size_t header = idSize + sizeof(UShort);
+         if (available < header)
+            return 0;
+         size = header + ReadNumber<UShort>(data + idSize);
+         break;
+      }
+      default:
+         // FT_Push, FT_Pop, or an unknown type, which is skipped
+         break;
+   }
+   return size <= available ? size : 0;
+}
 
-         case 2:
-            return FastStringConvert<char16_t>(bytes.data(), len);
+//! Apply a token that changes the DecoderState
+/*! @param names owns the strings of new names */
+void UpdateState(DecoderState& state, const char* data,
+   std::deque<std::string>& names)
+{
+   switch (data[0])
+   {
+      case FT_Push:
+         state.idStack.push_back(state.ids);
+         state.ids.clear();
+         break;
 
-         case 4:
-            return FastStringConvert<char32_t>(bytes.data(), len);
+      case FT_Pop:
+         if (!state.idStack.empty())
+         {
+            state.ids = std::move(state.idStack.back());
+            state.idStack.pop_back();
+         }
+         break;
 
-         default:
-            wxASSERT_MSG(false, wxT("Characters size not 1, 2, or 4"));
+      case FT_Name:
+      {
+         const auto id = ReadNumber<UShort>(data + 1);
+         const auto len = ReadNumber<UShort>(data + 1 + sizeof(UShort));
+         auto& name = names.emplace_back();
+         ConvertString(state.charSize, data + 1 + 2 * sizeof(UShort), len, name);
+         state.ids[id] = name;
          break;
       }
 
-      return {};
-   };
+      case FT_CharSize:
+         state.charSize = data[1];
+         break;
 
-   try
+      default:
+         break;
+   }
+}
+
+//! First phase:  find the segments
+/*! @param names owns the strings of names */
+std::vector<Segment> ScanSegments(const std::vector<char>& document,
+   size_t segmentSize, std::deque<std::string>& names)
+{
+   std::vector<Segment> result;
+   DecoderState state;
+   const auto data = document.data();
+   const auto size = document.size();
+   size_t pos = 0;
+   while (pos < size)
    {
-      while (!in.Eof())
+      Segment segment{ pos, pos, 0, state };
+      while (pos < size && pos - segment.begin < segmentSize)
       {
-         UShort id;
-
-         switch (in.GetC())
+         size_t stringBytes;
+         const auto tokenSize = TokenSize(data + pos, size - pos, stringBytes);
+         if (tokenSize == 0)
          {
-            case FT_Push:
-            {
-               mIdStack.push_back(mIds);
-               mIds.clear();
-            }
+            // Ignore a truncated last token
+            pos = size;
             break;
+         }
+         UpdateState(state, data + pos, names);
+         segment.stringBytes += stringBytes;
+         pos += tokenSize;
+         segment.end = pos;
+      }
+      if (segment.end > segment.begin)
+         result.push_back(std::move(segment));
+   }
+   return result;
+}
 
-            case FT_Pop:
-            {
-               mIds = mIdStack.back();
-               mIdStack.pop_back();
-            }
-            break;
+//! Second phase, done in parallel
+/*! The result is allocated here and never moved, so that views of its text,
+ which may be short enough to be stored within the string, remain valid */
+std::unique_ptr<DecodedSegment> DecodeSegment(
+   const std::vector<char>& document, const Segment& segment)
+{
+   auto pResult = std::make_unique<DecodedSegment>();
+   auto& result = *pResult;
+   auto state = segment.state;
+   // Conversion to UTF-8 makes at most 3 bytes of each 2
+   result.text.reserve(segment.stringBytes * 3 / 2);
 
-            case FT_Name:
-            {
-               id = ReadUShort( in );
-               auto len = ReadUShort( in );
-               mIds[id] = ReadString(len);
-            }
-            break;
+   struct Error{}; // exception type for short-range try/catch
+   auto Lookup = [&state](const char* data) -> std::string_view
+   {
+      auto iter = state.ids.find(ReadNumber<UShort>(data));
+      if (iter == state.ids.end())
+      {
+         throw Error{};
+      }
 
-            case FT_StartTag:
-            {
-               id = ReadUShort( in );
+      return iter->second;
+   };
 
-               adapter.EmitStartTag(Lookup(id));
-            }
-            break;
+   auto ReadString = [&](const char* data, int len) -> std::string_view
+   {
+      result.stringsCount++;
+      result.stringsLength += len;
 
-            case FT_EndTag:
-            {
-               id = ReadUShort( in );
+      if (state.charSize == 1)
+         // Refer to the document itself
+         return { data, static_cast<size_t>(len) };
 
-               adapter.EndTag(Lookup(id));
-            }
+      const auto offset = result.text.size();
+      ConvertString(state.charSize, data, len, result.text);
+      return std::string_view{ result.text }.substr(offset);
+   };
+
+   // Number of events is roughly proportional to the size
+   result.events.reserve((segment.end - segment.begin) / 8);
+
+   auto& events = result.events;
+   const auto begin = document.data() + segment.begin;
+   const auto end = document.data() + segment.end;
+   try
+   {
+      for (auto data = begin; data < end;)
+      {
+         size_t stringBytes;
+         const auto tokenSize = TokenSize(data, end - data, stringBytes);
+         // The scan checked the sizes
+         assert(tokenSize > 0);
+
+         const auto type = static_cast<unsigned char>(data[0]);
+         const auto id = data + 1;
+         const auto value = id + sizeof(UShort);
+         switch (type)
+         {
+            case FT_StartTag:
+            case FT_EndTag:
+               events.push_back({ type, Lookup(id), {} });
             break;
 
             case FT_String:
-            {
-               id = ReadUShort( in );
-               int len = ReadLength( in );
-               
-               adapter.WriteAttr(Lookup(id), ReadString(len));
-            }
+               events.push_back({ type, Lookup(id), XMLAttributeValueView{
+                  ReadString(value + sizeof(Length), stringBytes) } });
             break;
 
             case FT_Float:
-            {
-               float val;
-
-               id = ReadUShort( in );
-               in.Read(&val, sizeof(val));
-               /* int dig = */ReadDigits(in);
-
-               adapter.WriteAttr(Lookup(id), val);
-            }
+               events.push_back({ type, Lookup(id),
+                  XMLAttributeValueView{ ReadNative<float>(value) } });
             break;
 
             case FT_Double:
-            {
-               double val;
-
-               id = ReadUShort( in );
-               in.Read(&val, sizeof(val));
-               /*int dig = */ReadDigits(in);
-
-               adapter.WriteAttr(Lookup(id), val);
-            }
+               events.push_back({ type, Lookup(id),
+                  XMLAttributeValueView{ ReadNative<double>(value) } });
             break;
 
             case FT_Int:
-            {
-               id = ReadUShort( in );
-               int val = ReadInt( in );
-
-               adapter.WriteAttr(Lookup(id), val);
-            }
+               events.push_back({ type, Lookup(id),
+                  XMLAttributeValueView{ int(ReadNumber<Int>(value)) } });
             break;
 
             case FT_Bool:
             {
-               unsigned char val;
-
-               id = ReadUShort( in );
-               in.Read(&val, 1);
-
-               adapter.WriteAttr(Lookup(id), val);
+               unsigned char val = value[0];
+               events.push_back(
+                  { type, Lookup(id), XMLAttributeValueView{ val } });
             }
             break;
 
             case FT_Long:
-            {
-               id = ReadUShort( in );
-               long val = ReadLong( in );
-
-               adapter.WriteAttr(Lookup(id), val);
-            }
+               events.push_back({ type, Lookup(id),
+                  XMLAttributeValueView{ long(ReadNumber<Long>(value)) } });
             break;
 
             case FT_LongLong:
-            {
-               id = ReadUShort( in );
-               long long val = ReadLongLong( in );
-               adapter.WriteAttr(Lookup(id), val);
-            }
+               events.push_back({ type, Lookup(id), XMLAttributeValueView{
+                  static_cast<long long>(ReadNumber<LongLong>(value)) } });
             break;
 
             case FT_SizeT:
-            {
-               id = ReadUShort( in );
-               size_t val = ReadULong( in );
-
-               adapter.WriteAttr(Lookup(id), val);
-            }
+               events.push_back({ type, Lookup(id), XMLAttributeValueView{
+                  size_t(ReadNumber<ULong>(value)) } });
             break;
 
             case FT_Data:
-            {
-               int len = ReadLength( in );
-               adapter.WriteData(ReadString(len));
-            }
+               events.push_back({ type, {}, XMLAttributeValueView{
+                  ReadString(data + 1 + sizeof(Length), stringBytes) } });
             break;
 
             case FT_Raw:
-            {
-               int len = ReadLength( in );
-               adapter.WriteRaw(ReadString(len));
-            }
-            break;
-
-            case FT_CharSize:
-            {
-               in.Read(&mCharSize, 1);
-            }
+               // The only data that is serialized by FT_Raw
+               // is the boilerplate code like <?xml > and <!DOCTYPE>
+               // which are ignored
             break;
 
             default:
-               wxASSERT(true);
+               UpdateState(state, data, result.names);
             break;
          }
+         data += tokenSize;
       }
    }
    catch( const Error& )
    {
       // Document was corrupt, or platform differences in size or endianness
       // were not well canonicalized
+      result.ok = false;
+   }
+
+   return pResult;
+}
+
+//! @return whether any tag or data was replayed, after which no attribute of
+//! an earlier segment remains pending in the adapter
+bool Replay(const DecodedSegment& segment, XMLTagHandlerAdapter& adapter)
+{
+   bool flushed = false;
+   for (const auto& event : segment.events)
+   {
+      switch (event.type)
+      {
+         case FT_StartTag:
+            adapter.EmitStartTag(event.name);
+            flushed = true;
+         break;
+
+         case FT_EndTag:
+            adapter.EndTag(event.name);
+            flushed = true;
+         break;
+
+         case FT_Data:
+         {
+            std::string_view value;
+            event.value.TryGet(value);
+            adapter.WriteData(value);
+            flushed = true;
+         }
+         break;
+
+         default:
+            adapter.WriteAttr(event.name, event.value);
+         break;
+      }
+   }
+   return flushed;
+}
+} // namespace
+
+bool ProjectSerializer::Decode(
+   BufferedStreamReader& in, XMLTagHandler* handler, size_t segmentSize)
+{
+   if (handler == nullptr)
       return false;
+
+   // Bring the whole document into memory
+   std::vector<char> document;
+   {
+      constexpr size_t chunkSize = 1024 * 1024;
+      size_t size = 0;
+      while (!in.Eof())
+      {
+         document.resize(size + chunkSize);
+         const auto bytesRead = in.Read(document.data() + size, chunkSize);
+         size += bytesRead;
+         document.resize(size);
+         if (bytesRead == 0)
+            break;
+      }
+   }
+
+   std::deque<std::string> names;
+   const auto segments =
+      ScanSegments(document, std::max<size_t>(1, segmentSize), names);
+
+   XMLTagHandlerAdapter adapter(handler);
+
+   int64_t stringsCount = 0;
+   int64_t stringsLength = 0;
+
+   // Decode up to one segment per thread ahead of the replay.  Attributes of
+   // a tag are replayed only with the next tag, which may be several
+   // segments later if the attributes are long, so keep all the segments
+   // since the last tag.
+   const size_t nThreads =
+      std::max(1u, std::thread::hardware_concurrency());
+   std::deque<std::future<std::unique_ptr<DecodedSegment>>> pending;
+   size_t nextSegment = 0;
+   auto launch = [&]{
+      const auto& segment = segments[nextSegment++];
+      pending.push_back(std::async(
+         segments.size() > 1 ? std::launch::async : std::launch::deferred,
+         [&document, &segment]{ return DecodeSegment(document, segment); }));
+   };
+
+   std::vector<std::unique_ptr<DecodedSegment>> retained;
+   while (nextSegment < segments.size() || !pending.empty())
+   {
+      while (nextSegment < segments.size() && pending.size() < nThreads)
+         launch();
+
+      auto pDecoded = pending.front().get();
+      pending.pop_front();
+      const auto& decoded = *pDecoded;
+
+      if (!decoded.ok)
+      {
+         // Let the other workers finish before the document goes away
+         for (auto& future : pending)
+            future.wait();
+         return false;
+      }
+
+      if (Replay(decoded, adapter))
+         retained.clear();
+      stringsCount += decoded.stringsCount;
+      stringsLength += decoded.stringsLength;
+      retained.push_back(std::move(pDecoded));
    }
 
    wxLogInfo(
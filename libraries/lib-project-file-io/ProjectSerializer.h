@@ -56,6 +56,20 @@ public:
    void WriteAttr(const wxString & name, float value, int digits = -1) override;
    void WriteAttr(const wxString & name, double value, int digits = -1) override;
 
+   void StartTag(const XMLName & name) override;
+   void EndTag(const XMLName & name) override;
+
+   void WriteAttr(const XMLName & name, const wxString &value) override;
+   void WriteAttr(const XMLName & name, const wxChar *value) override;
+
+   void WriteAttr(const XMLName & name, int value) override;
+   void WriteAttr(const XMLName & name, bool value) override;
+   void WriteAttr(const XMLName & name, long value) override;
+   void WriteAttr(const XMLName & name, long long value) override;
+   void WriteAttr(const XMLName & name, size_t value) override;
+   void WriteAttr(const XMLName & name, float value, int digits = -1) override;
+   void WriteAttr(const XMLName & name, double value, int digits = -1) override;
+
    void WriteData(const wxString & value) override;
    void Write(const wxString & data) override;
 
@@ -65,11 +79,24 @@ public:
    bool IsEmpty() const;
    bool DictChanged() const;
 
+   //! Target size, in bytes of the document, of the parts that Decode
+   //! converts in parallel
+   static constexpr size_t DefaultSegmentSize = 256 * 1024;
+
    // Returns empty string if decoding fails
-   static bool Decode(BufferedStreamReader& in, XMLTagHandler* handler);
+   /*! @param segmentSize smaller than the default only to test the joining of
+    the parts */
+   static bool Decode(BufferedStreamReader& in, XMLTagHandler* handler,
+      size_t segmentSize = DefaultSegmentSize);
 
 private:
+   //! @return the identifier of the name in the dictionary, adding it if new
+   unsigned short GetNameId(const wxString& name);
    void WriteName(const wxString& name);
+   //! Interns the name at its first use in the run, then writes it without
+   //! any conversion or lookup
+   void WriteName(const XMLName& name);
+   void WriteString(const wxString& value);
 
 private:
    MemoryStream mBuffer;
@@ -0,0 +1,282 @@
+/*!********************************************************************
+
+Audacity: A Digital Audio Editor
+
+@file SpilledUndoStates.cpp
+
+**********************************************************************/
+
+#include "SpilledUndoStates.h"
+
+#include "AudacityException.h"
+#include "Prefs.h"
+#include "Project.h"
+#include "ProjectFileIO.h"
+#include "ProjectSerializer.h"
+#include "SampleBlock.h"
+#include "UndoManager.h"
+#include "UndoTracks.h"
+#include "WaveClip.h"
+#include "WaveTrack.h"
+
+IntSetting UndoMemoryBudget{ L"/History/UndoMemoryBudget", 0 };
+
+namespace {
+
+static const XMLName UndoClips_tag{ "undoclips" };
+static const XMLName Track_tag{ "track" };
+
+//! Clips of the wave tracks of one undo state, written to the project file
+class SpilledTracks final : public UndoTracks::Spilled
+{
+public:
+   SpilledTracks(ProjectFileIO &projectFileIO, int64_t id,
+      const SampleBlockFactoryPtr &pFactory)
+      : mwProjectFileIO{ projectFileIO.weak_from_this() }
+      , mId{ id }
+      , mwFactory{ pFactory }
+   {}
+
+   ~SpilledTracks() override
+   {
+      GuardedCall([this]{
+         if (auto pProjectFileIO = mwProjectFileIO.lock())
+            pProjectFileIO->DeleteUndoState(mId);
+      });
+   }
+
+   void Reload(TrackList &tracks) override;
+
+   //! Add the ids of the blocks that the clips refer to; return success
+   bool ReadBlockIDs(BlockIDs &blockids) const
+   {
+      const auto pProjectFileIO = mwProjectFileIO.lock();
+      return pProjectFileIO &&
+         pProjectFileIO->ReadUndoStateBlockIDs(mId, blockids);
+   }
+
+   SampleBlockFactoryPtr GetFactory() const { return mwFactory.lock(); }
+
+private:
+   const std::weak_ptr<ProjectFileIO> mwProjectFileIO;
+   const int64_t mId;
+   const std::weak_ptr<SampleBlockFactory> mwFactory;
+};
+
+//! Makes clips for each wave track, from the document that Spill() writes
+class ClipsReader final : public XMLTagHandler
+{
+public:
+   explicit ClipsReader(TrackList &tracks)
+   {
+      for (auto pTrack : tracks.Any<WaveTrack>())
+         mTracks.push_back({ pTrack, {} });
+   }
+
+   //! Insert the clips into the tracks
+   /*! @return false, changing nothing, if the document did not describe
+    every wave track */
+   bool Finish()
+   {
+      if (mNextTrack != mTracks.size())
+         return false;
+      for (auto &[pTrack, clips] : mTracks)
+         for (auto &pClip : clips)
+            pTrack->InsertInterval(pClip, false, true);
+      return true;
+   }
+
+   bool HandleXMLTag(
+      const std::string_view& tag, const AttributesList &) override
+   {
+      return tag == UndoClips_tag || tag == Track_tag;
+   }
+
+   XMLTagHandler *HandleXMLChild(const std::string_view& tag) override
+   {
+      if (tag == Track_tag) {
+         if (mNextTrack == mTracks.size())
+            return nullptr;
+         mpTrack = &mTracks[mNextTrack++];
+         return this;
+      }
+      else if (tag == WaveClip::WaveClip_tag && mpTrack) {
+         auto &[pTrack, clips] = *mpTrack;
+         // As in WaveTrack::HandleXMLChild, make one channel now, and let
+         // deserialization of the sequences make the others
+         clips.push_back(std::make_shared<WaveClip>(1,
+            pTrack->GetSampleBlockFactory(), pTrack->GetSampleFormat(),
+            pTrack->GetRate()));
+         return clips.back().get();
+      }
+      return nullptr;
+   }
+
+   void HandleXMLEndTag(const std::string_view& tag) override
+   {
+      if (tag == Track_tag)
+         mpTrack = nullptr;
+   }
+
+private:
+   using TrackClips = std::pair<WaveTrack *, WaveTrack::IntervalHolders>;
+   std::vector<TrackClips> mTracks;
+   size_t mNextTrack{ 0 };
+   TrackClips *mpTrack{};
+};
+
+void SpilledTracks::Reload(TrackList &tracks)
+{
+   ClipsReader reader{ tracks };
+   const auto pProjectFileIO = mwProjectFileIO.lock();
+   if (!(pProjectFileIO && pProjectFileIO->ReadUndoState(mId, reader) &&
+      reader.Finish()))
+      throw SimpleMessageBoxException{
+         ExceptionType::Internal,
+         XO("Failed to reload an Undo History state from the project file"),
+         XO("Warning")
+      };
+}
+
+//! Watches the Undo history of one project, and removes the clips of older
+//! states from memory when the newer ones use up the budget
+class Spiller final : public ClientData::Base
+{
+public:
+   explicit Spiller(AudacityProject &project)
+      : mProject{ project }
+   {
+      mSubscription = UndoManager::Get(project)
+         .Subscribe([this](UndoRedoMessage message){
+            switch (message.type) {
+            case UndoRedoMessage::Pushed:
+            case UndoRedoMessage::Modified:
+               return OnPush();
+            default:
+               return;
+            }
+         });
+   }
+
+private:
+   void OnPush();
+   //! @return false if writing to the project file failed
+   bool Spill(const UndoStackElem &state, TrackList &tracks);
+
+   AudacityProject &mProject;
+   Observer::Subscription mSubscription;
+};
+
+void Spiller::OnPush()
+{
+   const auto budget = UndoMemoryBudget.Read();
+   if (budget <= 0)
+      return;
+   const size_t budgetBytes = size_t(budget) << 20;
+
+   GuardedCall([&]{
+      auto &manager = UndoManager::Get(mProject);
+      const auto current = manager.GetCurrentState();
+      auto index = manager.GetNumStates();
+      // Count arrays of blocks that consecutive states share only once, as
+      // in the History window
+      WaveTrackUtilities::BlockArrayIdSet seenArrays;
+      size_t used = 0;
+      bool ok = true;
+      manager.VisitStates([&](const UndoStackElem &state){
+         --index;
+         const auto [pTracks, pSpilled] = UndoTracks::FindSpilled(state);
+         if (!ok || !pTracks || pSpilled)
+            return;
+         used += WaveTrackUtilities::InspectClipMemory(*pTracks, seenArrays);
+         // The current state is likely to be needed again soon
+         if (used > budgetBytes && index != current)
+            ok = Spill(state, *pTracks);
+      }, true /* newest state first */);
+   });
+}
+
+bool Spiller::Spill(const UndoStackElem &state, TrackList &tracks)
+{
+   const auto waveTracks = tracks.Any<WaveTrack>();
+   if (waveTracks.empty())
+      return true;
+   for (auto pTrack : waveTracks)
+      for (const auto &pClip : pTrack->Intervals())
+         if (pClip->GetIsPlaceholder())
+            // Not serialized; leave this state in memory
+            return true;
+
+   BlockIDs ids;
+   bool pending = false;
+   WaveTrackUtilities::InspectBlocks(tracks,
+      [&](SampleBlockConstPtr pBlock){ pending |= pBlock->IsPending(); },
+      &ids);
+   if (pending)
+      // Samples of a file imported on demand are not yet written; leave this
+      // state in memory
+      return true;
+
+   ProjectSerializer doc;
+   doc.StartTag(UndoClips_tag);
+   for (auto pTrack : waveTracks) {
+      doc.StartTag(Track_tag);
+      for (const auto &pClip : pTrack->Intervals())
+         pClip->WriteWideXML(doc);
+      doc.EndTag(Track_tag);
+   }
+   doc.EndTag(UndoClips_tag);
+
+   auto &projectFileIO = ProjectFileIO::Get(mProject);
+   // The project file keeps the rows of the blocks, after the clips are
+   // removed
+   const auto id = projectFileIO.WriteUndoState(doc, ids);
+   if (id == 0)
+      // Error message already captured
+      return false;
+
+   // Track objects remain, with their identities and attachments, which the
+   // document does not describe
+   for (auto pTrack : waveTracks) {
+      WaveTrack::IntervalHolders clips;
+      for (const auto &pClip : pTrack->Intervals())
+         clips.push_back(pClip);
+      for (const auto &pClip : clips)
+         pTrack->RemoveInterval(pClip);
+   }
+   UndoTracks::SetSpilled(state, std::make_shared<SpilledTracks>(
+      projectFileIO, id, (*waveTracks.begin())->GetSampleBlockFactory()));
+   return true;
+}
+
+static const AudacityProject::AttachedObjects::RegisteredFactory sSpillerKey{
+   [](AudacityProject &project){
+      return std::make_shared<Spiller>(project);
+   }
+};
+
+}
+
+void SpilledUndoStates::InspectBlocks(const UndoStackElem &state,
+   WaveTrackUtilities::BlockInspector inspector,
+   WaveTrackUtilities::SampleBlockIDSet *pIDs)
+{
+   const auto pSpilled = dynamic_cast<const SpilledTracks *>(
+      UndoTracks::FindSpilled(state).second);
+   if (!pSpilled) {
+      if (auto pTracks = UndoTracks::Find(state))
+         WaveTrackUtilities::InspectBlocks(*pTracks, move(inspector), pIDs);
+      return;
+   }
+   BlockIDs ids;
+   if (!pSpilled->ReadBlockIDs(ids))
+      return;
+   const auto pFactory = inspector ? pSpilled->GetFactory() : nullptr;
+   for (const auto id : ids) {
+      if (pIDs && !pIDs->insert(id).second)
+         continue;
+      if (pFactory)
+         // The block object lasts only for the visit, and its row remains
+         inspector(pFactory->CreateFromId(floatSample, id));
+   }
+}
@@ -0,0 +1,34 @@
+/*!********************************************************************
+
+Audacity: A Digital Audio Editor
+
+@file SpilledUndoStates.h
+@brief Keep the memory that undo history uses within a budget, by moving the
+clips of older states into the project file
+
+**********************************************************************/
+
+#ifndef __AUDACITY_SPILLED_UNDO_STATES__
+#define __AUDACITY_SPILLED_UNDO_STATES__
+
+#include "WaveTrackUtilities.h"
+
+class IntSetting;
+struct UndoStackElem;
+
+namespace SpilledUndoStates {
+
+//! Like WaveTrackUtilities::InspectBlocks() for the tracks of an undo state,
+//! but without reloading the state if its clips were removed from memory
+PROJECT_FILE_IO_API void InspectBlocks(const UndoStackElem &state,
+   WaveTrackUtilities::BlockInspector inspector,
+   WaveTrackUtilities::SampleBlockIDSet *pIDs = nullptr);
+
+}
+
+//! Megabytes of memory that the clips of undo states may use, newest first,
+//! before older states are written to the project file and removed from
+//! memory until needed again; 0 for no limit
+extern PROJECT_FILE_IO_API IntSetting UndoMemoryBudget;
+
+#endif
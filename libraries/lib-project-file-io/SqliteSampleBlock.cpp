@@ -19,14 +19,15 @@ Paul Licameli -- split from SampleBlock.cpp and SampleBlock.h
 #include "XMLTagHandler.h"
 
 #include "SampleBlock.h" // to inherit
+#include "SpilledUndoStates.h"
 #include "UndoManager.h"
-#include "UndoTracks.h"
 #include "WaveTrack.h"
 #include "WaveTrackUtilities.h"
 
 #include "SentryHelper.h"
 #include <wx/log.h>
 
+#include <algorithm>
 #include <mutex>
 
 class SqliteSampleBlockFactory;
@@ -141,6 +142,7 @@ private:
 // used length values
 static std::map< SampleBlockID, std::shared_ptr<SqliteSampleBlock> >
    sSilentBlocks;
+static std::mutex sSilentBlocksMutex;
 
 ///\brief Implementation of @ref SampleBlockFactory using Sqlite database
 class SqliteSampleBlockFactory final
@@ -192,6 +194,8 @@ private:
    using AllBlocksMap =
       std::map< SampleBlockID, std::weak_ptr< SqliteSampleBlock > >;
    AllBlocksMap mAllBlocks;
+   // Blocks of lazily loaded sequences may be made in a worker thread
+   std::mutex mAllBlocksMutex;
 };
 
 SqliteSampleBlockFactory::SqliteSampleBlockFactory( AudacityProject &project )
@@ -219,6 +223,7 @@ SampleBlockPtr SqliteSampleBlockFactory::DoCreate(
    auto sb = std::make_shared<SqliteSampleBlock>(shared_from_this());
    sb->SetSamples(src, numsamples, srcformat);
    // block id has now been assigned
+   std::lock_guard<std::mutex> lock{ mAllBlocksMutex };
    mAllBlocks[ sb->GetBlockID() ] = sb;
    return sb;
 }
@@ -226,6 +231,7 @@ SampleBlockPtr SqliteSampleBlockFactory::DoCreate(
 auto SqliteSampleBlockFactory::GetActiveBlockIDs() -> SampleBlockIDs
 {
    SampleBlockIDs result;
+   std::lock_guard<std::mutex> lock{ mAllBlocksMutex };
    for (auto end = mAllBlocks.end(), it = mAllBlocks.begin(); it != end;) {
       if (it->second.expired())
          // Tighten up the map
@@ -242,6 +248,7 @@ SampleBlockPtr SqliteSampleBlockFactory::DoCreateSilent(
    size_t numsamples, sampleFormat )
 {
    auto id = -static_cast< SampleBlockID >(numsamples);
+   std::lock_guard<std::mutex> lock{ sSilentBlocksMutex };
    auto &result = sSilentBlocks[ id ];
    if ( !result ) {
       result = std::make_shared<SqliteSampleBlock>(nullptr);
@@ -281,19 +288,32 @@ SampleBlockPtr SqliteSampleBlockFactory::DoCreateFromId(
       return DoCreateSilent(-id, floatSample);
 
    // First see if this block id was previously loaded
-   auto& wb = mAllBlocks[id];
-
-   if (auto block = wb.lock())
-      return block;
+   {
+      std::lock_guard<std::mutex> lock{ mAllBlocksMutex };
+      auto iter = mAllBlocks.find(id);
+      if (iter != mAllBlocks.end())
+         if (auto block = iter->second.lock())
+            return block;
+   }
 
    // First sight of this id
+   // Read the database without the lock, which other threads may want
+   // meanwhile
    auto ssb           = std::make_shared<SqliteSampleBlock>(shared_from_this());
-   wb                 = ssb;
    ssb->mSampleFormat = srcformat;
    // This may throw database errors
    // It initializes the rest of the fields
    ssb->Load(static_cast<SampleBlockID>(id));
 
+   std::lock_guard<std::mutex> lock{ mAllBlocksMutex };
+   auto& wb = mAllBlocks[id];
+   if (auto block = wb.lock()) {
+      // Another thread loaded it first; the duplicate must not delete the
+      // row when destroyed
+      ssb->CloseLock();
+      return block;
+   }
+   wb = ssb;
    return ssb;
 }
 
@@ -715,6 +735,20 @@ void SqliteSampleBlock::Load(SampleBlockID sbid)
    mSumMax = -FLT_MAX;
    mSumMin = 0.0;
 
+   // While a project is opened, the rows were read in advance in one scan
+   if (auto pMetadata = Conn()->FindSampleBlockMetadata(sbid))
+   {
+      mBlockID = sbid;
+      mSampleFormat = (sampleFormat) pMetadata->sampleFormat;
+      mSumMin = pMetadata->sumMin;
+      mSumMax = pMetadata->sumMax;
+      mSumRms = pMetadata->sumRms;
+      mSampleBytes = pMetadata->sampleBytes;
+      mSampleCount = mSampleBytes / SAMPLE_SIZE(mSampleFormat);
+      mValid = true;
+      return;
+   }
+
    // Prepare and cache statement...automatically finalized at DB close
    sqlite3_stmt *stmt = Conn()->Prepare(DBConnection::LoadSampleBlock,
       "SELECT sampleformat, summin, summax, sumrms,"
@@ -886,9 +920,11 @@ void SqliteSampleBlock::Delete()
    sqlite3_reset(stmt);
 }
 
+static const XMLName BlockID_attr{ "blockid" };
+
 void SqliteSampleBlock::SaveXML(XMLWriter &xmlFile)
 {
-   xmlFile.WriteAttr(wxT("blockid"), mBlockID);
+   xmlFile.WriteAttr(BlockID_attr, mBlockID);
 }
 
 auto SqliteSampleBlock::SetSizes(
@@ -1072,9 +1108,9 @@ static size_t EstimateRemovedBlocks(
    // Collect ids that survive
    using namespace WaveTrackUtilities;
    SampleBlockIDSet wontDelete;
+   // Do not reload states whose clips were removed from memory
    auto f = [&](const UndoStackElem &elem) {
-      if (auto pTracks = UndoTracks::Find(elem))
-         InspectBlocks(*pTracks, {}, &wontDelete);
+      SpilledUndoStates::InspectBlocks(elem, {}, &wontDelete);
    };
    manager.VisitStates(f, 0, begin);
    manager.VisitStates(f, end, manager.GetNumStates());
@@ -1083,20 +1119,13 @@ static size_t EstimateRemovedBlocks(
    InspectBlocks(TrackList::Get(project), {}, &wontDelete);
 
    // Collect ids that won't survive (and are not negative pseudo ids)
-   SampleBlockIDSet seen, mayDelete;
+   SampleBlockIDSet seen;
    manager.VisitStates([&](const UndoStackElem &elem) {
-      if (auto pTracks = UndoTracks::Find(elem)) {
-         InspectBlocks(*pTracks,
-            [&](SampleBlockConstPtr pBlock){
-               auto id = pBlock->GetBlockID();
-               if (id > 0 && !wontDelete.count(id))
-                  mayDelete.insert(id);
-            },
-            &seen
-         );
-      }
+      SpilledUndoStates::InspectBlocks(elem, {}, &seen);
    }, begin, end);
-   return mayDelete.size();
+   return std::count_if(seen.begin(), seen.end(), [&](SampleBlockID id){
+      return id > 0 && !wontDelete.count(id);
+   });
 }
 
 void SqliteSampleBlockFactory::OnBeginPurge(size_t begin, size_t end)
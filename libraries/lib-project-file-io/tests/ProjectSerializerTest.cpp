@@ -0,0 +1,136 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ * SPDX-FileName: ProjectSerializerTest.cpp
+ */
+
+#include <catch2/catch.hpp>
+
+#include "BufferedStreamReader.h"
+#include "ProjectSerializer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace
+{
+class MemoryStreamReader final : public BufferedStreamReader
+{
+public:
+   explicit MemoryStreamReader(std::vector<char> data)
+       : mData { std::move(data) }
+   {
+   }
+
+private:
+   bool HasMoreData() const override
+   {
+      return mPosition < mData.size();
+   }
+
+   size_t ReadData(void* buffer, size_t maxBytes) override
+   {
+      const auto count = std::min(maxBytes, mData.size() - mPosition);
+      std::memcpy(buffer, mData.data() + mPosition, count);
+      mPosition += count;
+      return count;
+   }
+
+   const std::vector<char> mData;
+   size_t mPosition { 0 };
+};
+
+//! Writes what it is told as text, copying the attributes when it gets them
+class RecordingHandler final : public XMLTagHandler
+{
+public:
+   bool HandleXMLTag(
+      const std::string_view& tag, const AttributesList& attrs) override
+   {
+      record += "<" + std::string(tag);
+      for (const auto& [name, value] : attrs)
+         record += " " + std::string(name) + "=" + value.ToString();
+      record += ">";
+      return true;
+   }
+
+   void HandleXMLEndTag(const std::string_view& tag) override
+   {
+      record += "</" + std::string(tag) + ">";
+   }
+
+   void HandleXMLContent(const std::string_view& content) override
+   {
+      record += content;
+   }
+
+   XMLTagHandler* HandleXMLChild(const std::string_view&) override
+   {
+      return this;
+   }
+
+   std::string record;
+};
+
+std::vector<char> Document(const ProjectSerializer& serializer)
+{
+   std::vector<char> result;
+   for (const auto pStream : { &serializer.GetDict(), &serializer.GetData() })
+      for (const auto [data, size] : *pStream)
+      {
+         const auto begin = static_cast<const char*>(data);
+         result.insert(result.end(), begin, begin + size);
+      }
+   return result;
+}
+} // namespace
+
+TEST_CASE("ProjectSerializer::Decode", "")
+{
+   const auto longValue = std::string(100, 'q');
+
+   ProjectSerializer serializer;
+   serializer.StartTag(wxT("project"));
+   serializer.WriteAttr(wxT("a"), wxT("x"));
+   serializer.WriteAttr(wxT("b"), wxT("yz"));
+   serializer.WriteAttr(wxT("long"), wxString(longValue));
+   serializer.WriteAttr(wxT("number"), 42);
+   serializer.WriteAttr(wxT("c"), wxT("short"));
+   serializer.StartTag(wxT("child"));
+   serializer.WriteAttr(wxT("d"), wxT("w"));
+   serializer.WriteData(wxT("content"));
+   serializer.EndTag(wxT("child"));
+   serializer.StartTag(wxT("leaf"));
+   serializer.WriteAttr(wxT("e"), wxT("v1"));
+   serializer.WriteAttr(wxT("f"), wxT("v2"));
+   serializer.EndTag(wxT("leaf"));
+   serializer.EndTag(wxT("project"));
+   const auto document = Document(serializer);
+
+   const auto expected = "<project a=x b=yz long=" + longValue +
+      " number=42 c=short><child d=w>content</child>" +
+      "<leaf e=v1 f=v2></leaf></project>";
+
+   SECTION("in one segment")
+   {
+      MemoryStreamReader reader { document };
+      RecordingHandler handler;
+      REQUIRE(ProjectSerializer::Decode(reader, &handler));
+      REQUIRE(handler.record == expected);
+   }
+
+   SECTION("with attributes of a tag spanning segments")
+   {
+      // Segments of one token each, or of a few; short string values, whose
+      // text may be kept within the string object, and a value longer than
+      // a segment, must both stay valid until their tag is handled
+      for (const size_t segmentSize : { 1, 5, 13, 40 })
+      {
+         MemoryStreamReader reader { document };
+         RecordingHandler handler;
+         REQUIRE(ProjectSerializer::Decode(reader, &handler, segmentSize));
+         REQUIRE(handler.record == expected);
+      }
+   }
+}
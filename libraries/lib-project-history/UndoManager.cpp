@@ -264,12 +264,7 @@ void UndoManager::SetStateTo(unsigned int n, const Consumer &consumer)
 {
    wxASSERT(n < stack.size());
 
-   current = n;
-
-   lastAction = {};
-   mayConsolidate = false;
-
-   consumer( *stack[current] );
+   ConsumeState(n, consumer);
 
    EnqueueMessage({ UndoRedoMessage::Reset });
 }
@@ -278,12 +273,7 @@ void UndoManager::Undo(const Consumer &consumer)
 {
    wxASSERT(UndoAvailable());
 
-   current--;
-
-   lastAction = {};
-   mayConsolidate = false;
-
-   consumer( *stack[current] );
+   ConsumeState(current - 1, consumer);
 
    EnqueueMessage({ UndoRedoMessage::UndoOrRedo });
 }
@@ -292,8 +282,6 @@ void UndoManager::Redo(const Consumer &consumer)
 {
    wxASSERT(RedoAvailable());
 
-   current++;
-
    /*
    if (!RedoAvailable()) {
       *sel0 = stack[current]->sel0;
@@ -307,12 +295,26 @@ void UndoManager::Redo(const Consumer &consumer)
    }
    */
 
+   ConsumeState(current + 1, consumer);
+
+   EnqueueMessage({ UndoRedoMessage::UndoOrRedo });
+}
+
+void UndoManager::ConsumeState(int n, const Consumer &consumer)
+{
+   const auto previous = current;
+   current = n;
+
    lastAction = {};
    mayConsolidate = false;
 
-   consumer( *stack[current] );
-
-   EnqueueMessage({ UndoRedoMessage::UndoOrRedo });
+   try {
+      consumer( *stack[current] );
+   }
+   catch (...) {
+      current = previous;
+      throw;
+   }
 }
 
 void UndoManager::VisitStates( const Consumer &consumer, bool newestFirst )
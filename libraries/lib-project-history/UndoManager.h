@@ -188,6 +188,8 @@ class PROJECT_HISTORY_API UndoManager final
    // These functions accept a callback that uses the state,
    // and then they send to the project Reset or UndoOrRedo when
    // that has finished.
+   // If the callback throws, as when the state cannot be reloaded, the
+   // current state does not change.
    using Consumer = std::function< void( const UndoStackElem & ) >;
    void SetStateTo(unsigned int n, const Consumer &consumer);
    void Undo(const Consumer &consumer);
@@ -215,6 +217,9 @@ class PROJECT_HISTORY_API UndoManager final
 
    void EnqueueMessage(UndoRedoMessage message);
    void RemoveStateAt(int n);
+   //! Make state n current and pass it to the consumer; on exception, restore
+   //! the previous current state
+   void ConsumeState(int n, const Consumer &consumer);
 
    AudacityProject &mProject;
  
@@ -13,12 +13,14 @@
 
 #include <algorithm>
 #include <cstdlib>
+#include <iterator>
 
 #include "Project.h"
 #include "ProjectNumericFormats.h"
 #include "ProjectRate.h"
 #include "ProjectSnap.h"
 #include "Track.h"
+#include "TrackSnapIndex.h"
 #include "ZoomInfo.h"
 
 inline bool operator < (SnapPoint s1, SnapPoint s2)
@@ -41,20 +43,6 @@ SnapManager::SnapManager(const AudacityProject &project,
    Reinit();
 }
 
-namespace {
-SnapPointArray FindCandidates(
-   SnapPointArray candidates, const TrackList &tracks )
-{
-   for (const auto track : tracks)
-      for (const auto &interval : track->Intervals()) {
-         candidates.emplace_back(interval->Start(), track);
-         if (interval->Start() != interval->End())
-            candidates.emplace_back(interval->End(), track);
-      }
-   return move(candidates);
-}
-}
-
 SnapManager::SnapManager(const AudacityProject &project,
             const TrackList &tracks,
             const ZoomInfo &zoomInfo,
@@ -62,11 +50,12 @@ SnapManager::SnapManager(const AudacityProject &project,
             bool noTimeSnap,
             int pixelTolerance)
    : SnapManager{ project,
-      // Add candidates to given ones by default rules,
-      // then delegate to other ctor
-      FindCandidates( move(candidates), tracks ),
-      zoomInfo, noTimeSnap, pixelTolerance }
+      move(candidates), zoomInfo, noTimeSnap, pixelTolerance }
 {
+   // Take the points of tracks by default rules, as cached for the project
+   auto &index = TrackSnapIndex::Get(project);
+   for (const auto track : tracks)
+      mTrackTimes.emplace_back(track, index.GetTimes(*track));
 }
 
 SnapManager::~SnapManager()
@@ -107,6 +96,36 @@ void SnapManager::Reinit()
    for (const auto &candidate : mCandidates)
       CondListAdd( candidate.t, candidate.track );
 
+   // Sort all by time
+   std::sort(mSnapPoints.begin(), mSnapPoints.end());
+   mCandidatePoints.swap(mSnapPoints);
+}
+
+void SnapManager::GatherPoints(double t)
+{
+   mSnapPoints.clear();
+
+   // Points outside this range are not within the tolerance; a pixel more on
+   // each side allows for the rounding in PixelDiff
+   const auto position = mZoomInfo->TimeToPosition(t, 0);
+   const auto t0 = mZoomInfo->PositionToTime(position - mPixelTolerance - 1, 0);
+   const auto t1 = mZoomInfo->PositionToTime(position + mPixelTolerance + 1, 0);
+
+   // The candidates were filtered already
+   std::copy(
+      std::lower_bound(mCandidatePoints.begin(), mCandidatePoints.end(),
+         SnapPoint{ t0 }),
+      std::upper_bound(mCandidatePoints.begin(), mCandidatePoints.end(),
+         SnapPoint{ t1 }),
+      back_inserter(mSnapPoints));
+
+   for (const auto &[track, pTimes] : mTrackTimes) {
+      const auto end = std::upper_bound(pTimes->begin(), pTimes->end(), t1);
+      for (auto iter = std::lower_bound(pTimes->begin(), end, t0);
+         iter != end; ++iter)
+         CondListAdd( *iter, track );
+   }
+
    // Sort all by time
    std::sort(mSnapPoints.begin(), mSnapPoints.end());
 }
@@ -265,6 +284,7 @@ SnapResults SnapManager::Snap
    SnapResults results;
    // Check to see if we need to reinitialize
    Reinit();
+   GatherPoints(t);
 
    results.timeSnappedTime = results.outTime = t;
    results.outCoord = mZoomInfo->TimeToPosition(t);
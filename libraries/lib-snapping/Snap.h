@@ -15,6 +15,7 @@
 #ifndef __AUDACITY_SNAP__
 #define __AUDACITY_SNAP__
 
+#include <memory>
 #include <vector>
 #include <wx/defs.h>
 #include "ComponentInterfaceSymbol.h"
@@ -64,6 +65,10 @@ public:
 
    //! Construct for (optionally) specified points, plus significant points
    //! on the tracks in the given list
+   /*!
+    The points of tracks are taken from TrackSnapIndex, as they are at
+    construction, and only those near the time are examined at each Snap()
+    */
    SnapManager(const AudacityProject &project,
                const TrackList &tracks,
                const ZoomInfo &zoomInfo,
@@ -84,6 +89,9 @@ public:
 private:
 
    void Reinit();
+   //! Fill mSnapPoints with the points that might be within the pixel
+   //! tolerance of t
+   void GatherPoints(double t);
    void CondListAdd(double t, const Track *track);
    double Get(size_t index);
    wxInt64 PixelDiff(double t, size_t index);
@@ -101,6 +109,12 @@ private:
    //! Two time points closer than this are considered the same
    double mEpsilon{ 1 / 44100.0 };
    SnapPointArray mCandidates;
+   //! Sorted, filtered mCandidates, and a point at zero
+   SnapPointArray mCandidatePoints;
+   //! Sorted times of intervals of each track
+   std::vector<std::pair<const Track *, std::shared_ptr<const std::vector<double>>>>
+      mTrackTimes;
+   //! Points near the time last passed to Snap()
    SnapPointArray mSnapPoints;
 
    // Info for snap-to-time
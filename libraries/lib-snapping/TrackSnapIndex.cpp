@@ -0,0 +1,143 @@
+/*  SPDX-License-Identifier: GPL-2.0-or-later */
+/*!********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  TrackSnapIndex.cpp
+
+**********************************************************************/
+#include "TrackSnapIndex.h"
+#include "Project.h"
+#include "Track.h"
+#include "UndoManager.h"
+
+#include <algorithm>
+
+static const AudacityProject::AttachedObjects::RegisteredFactory sKey {
+   [](AudacityProject& project)
+   {
+      auto result = std::make_shared<TrackSnapIndex>(project);
+      return result;
+   }
+};
+
+TrackSnapIndex& TrackSnapIndex::Get(AudacityProject& project)
+{
+   return project.AttachedObjects::Get<TrackSnapIndex>(sKey);
+}
+
+const TrackSnapIndex& TrackSnapIndex::Get(const AudacityProject& project)
+{
+   return Get(const_cast<AudacityProject&>(project));
+}
+
+TrackSnapIndex::TrackSnapIndex(AudacityProject& project)
+    : mProject { project }
+    , mTrackListSubscription { TrackList::Get(project).Subscribe(
+         [this](const TrackListEvent& event)
+         {
+            switch (event.mType)
+            {
+            case TrackListEvent::TRACK_DATA_CHANGE:
+            case TrackListEvent::ADDITION:
+            case TrackListEvent::DELETION:
+               if (const auto pTrack = event.mpTrack.lock())
+                  mEntries.erase(pTrack.get());
+               break;
+            default:
+               break;
+            }
+         }) }
+    , mUndoSubscription { UndoManager::Get(project).Subscribe(
+         [this](const UndoRedoMessage& message)
+         {
+            switch (message.type)
+            {
+            case UndoRedoMessage::Pushed:
+            case UndoRedoMessage::Modified:
+            case UndoRedoMessage::UndoOrRedo:
+            case UndoRedoMessage::Reset:
+               OnUndoRedo();
+               break;
+            default:
+               break;
+            }
+         }) }
+{
+}
+
+TrackSnapIndex::~TrackSnapIndex() = default;
+
+void TrackSnapIndex::OnUndoRedo()
+{
+   // Changes of intervals are not reported by the track list, but the
+   // history changes after any of them; discard only the entries of tracks
+   // whose intervals are not as they were
+   for (auto iter = mEntries.begin(); iter != mEntries.end();)
+   {
+      const auto pTrack = iter->second.wTrack.lock();
+      if (pTrack && pTrack.get() == iter->first &&
+          SameBounds(*pTrack, iter->second.bounds))
+         ++iter;
+      else
+         iter = mEntries.erase(iter);
+   }
+}
+
+auto TrackSnapIndex::GetTimes(const Track& track) const
+   -> std::shared_ptr<const Times>
+{
+   if (track.GetOwner().get() != &TrackList::Get(mProject))
+      return std::make_shared<Times>(MakeTimes(track));
+
+   auto& entry = mEntries[&track];
+   if (entry.pTimes && entry.wTrack.lock().get() == &track)
+      return entry.pTimes;
+   entry.wTrack = track.shared_from_this();
+   entry.bounds = CollectBounds(track);
+   entry.pTimes = std::make_shared<Times>(SortTimes(entry.bounds));
+   return entry.pTimes;
+}
+
+auto TrackSnapIndex::MakeTimes(const Track& track) -> Times
+{
+   return SortTimes(CollectBounds(track));
+}
+
+auto TrackSnapIndex::CollectBounds(const Track& track) -> Times
+{
+   Times bounds;
+   for (const auto& interval : track.Intervals())
+   {
+      bounds.push_back(interval->Start());
+      bounds.push_back(interval->End());
+   }
+   return bounds;
+}
+
+bool TrackSnapIndex::SameBounds(const Track& track, const Times& bounds)
+{
+   auto iter = bounds.begin();
+   const auto end = bounds.end();
+   for (const auto& interval : track.Intervals())
+   {
+      if (end - iter < 2 || *iter++ != interval->Start() ||
+          *iter++ != interval->End())
+         return false;
+   }
+   return iter == end;
+}
+
+auto TrackSnapIndex::SortTimes(const Times& bounds) -> Times
+{
+   Times times;
+   times.reserve(bounds.size());
+   for (size_t ii = 0; ii + 1 < bounds.size(); ii += 2)
+   {
+      times.push_back(bounds[ii]);
+      if (bounds[ii] != bounds[ii + 1])
+         times.push_back(bounds[ii + 1]);
+   }
+   std::sort(times.begin(), times.end());
+   return times;
+}
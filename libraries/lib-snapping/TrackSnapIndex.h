@@ -0,0 +1,74 @@
+/*  SPDX-License-Identifier: GPL-2.0-or-later */
+/*!********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  TrackSnapIndex.h
+
+**********************************************************************/
+#pragma once
+
+#include "ClientData.h"
+#include "Observer.h"
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+class AudacityProject;
+class Track;
+
+//! Caches, for each track of a project, the sorted times of the starts and
+//! ends of its intervals, so that SnapManager need not collect and sort them
+//! at each drag
+/*!
+ Entries are discarded when the track list reports a change of the track.
+ Changes of intervals are not otherwise reported, so at changes of the undo
+ history, the entries of tracks whose interval bounds differ from those
+ recorded are discarded.  Each is remade when next requested.
+ */
+class SNAPPING_API TrackSnapIndex final : public ClientData::Base
+{
+public:
+   //! Sorted, and the end of an interval is omitted when it equals the start
+   using Times = std::vector<double>;
+
+   static TrackSnapIndex& Get(AudacityProject& project);
+   static const TrackSnapIndex& Get(const AudacityProject& project);
+
+   explicit TrackSnapIndex(AudacityProject& project);
+   TrackSnapIndex(const TrackSnapIndex&) = delete;
+   TrackSnapIndex& operator=(const TrackSnapIndex&) = delete;
+   ~TrackSnapIndex() override;
+
+   //! @return times for the track as it is now; not cached if the track is
+   //! not in the project's track list
+   std::shared_ptr<const Times> GetTimes(const Track& track) const;
+
+   //! Collect and sort the times, without caching
+   static Times MakeTimes(const Track& track);
+
+private:
+   void OnUndoRedo();
+
+   //! Start and end of each interval, in the order of the track
+   static Times CollectBounds(const Track& track);
+   static bool SameBounds(const Track& track, const Times& bounds);
+   static Times SortTimes(const Times& bounds);
+
+   struct Entry
+   {
+      //! Detects reuse of the address by another track, before the
+      //! deletion event arrives
+      std::weak_ptr<const Track> wTrack;
+      //! From CollectBounds(), to detect changes of the intervals
+      Times bounds;
+      std::shared_ptr<const Times> pTimes;
+   };
+
+   AudacityProject& mProject;
+   mutable std::unordered_map<const Track*, Entry> mEntries;
+
+   Observer::Subscription mTrackListSubscription;
+   Observer::Subscription mUndoSubscription;
+};
@@ -14,7 +14,11 @@
 #include "SnapUtils.h"
 
 #include "Project.h"
+#include "ProjectSnap.h"
 #include "ProjectTimeSignature.h"
+#include "Snap.h"
+#include "Track.h"
+#include "ZoomInfo.h"
 
 #include "MockedAudio.h"
 #include "MockedPrefs.h"
@@ -223,3 +227,46 @@ TEST_CASE("Snapping", "")
    BarStepCase(*project, "bar_1_4", 0.0, 1.0, true);
    BarStepCase(*project, "bar_1_4", 4.0, 3.0, false);
 }
+
+TEST_CASE("SnapManager", "")
+{
+   MockedPrefs mockedPrefs;
+   MockedAudio mockedAudio;
+
+   auto project = AudacityProject::Create();
+   ProjectSnap::Get(*project).SetSnapMode(SnapMode::SNAP_OFF);
+
+   // 100 pixels per second, so the default tolerance is 0.04 seconds
+   const ZoomInfo zoomInfo { 0.0, 100.0 };
+   SnapManager snapManager { *project, TrackList::Get(*project), zoomInfo,
+                             SnapPointArray { SnapPoint { 1.0 },
+                                              SnapPoint { 2.0 },
+                                              SnapPoint { 2.01 } } };
+
+   SECTION("snaps to the only point within the tolerance")
+   {
+      const auto results = snapManager.Snap(nullptr, 1.02, false);
+      REQUIRE(results.snappedPoint);
+      REQUIRE(results.outTime == 1.0);
+   }
+
+   SECTION("snaps to zero")
+   {
+      const auto results = snapManager.Snap(nullptr, 0.01, false);
+      REQUIRE(results.snappedPoint);
+      REQUIRE(results.outTime == 0.0);
+   }
+
+   SECTION("does not snap to points beyond the tolerance")
+   {
+      const auto results = snapManager.Snap(nullptr, 1.1, false);
+      REQUIRE(!results.Snapped());
+      REQUIRE(results.outTime == 1.1);
+   }
+
+   SECTION("does not choose between distinct points within the tolerance")
+   {
+      const auto results = snapManager.Snap(nullptr, 2.005, false);
+      REQUIRE(!results.Snapped());
+   }
+}
@@ -13,6 +13,7 @@
 #include "ClipInterface.h"
 #include "ClipSegment.h"
 #include "SilenceSegment.h"
+#include "StretchedClipCache.h"
 #include "TimeAndPitchInterface.h"
 
 #include <algorithm>
@@ -20,11 +21,39 @@
 using ClipConstHolder = std::shared_ptr<const ClipInterface>;
 
 AudioSegmentFactory::AudioSegmentFactory(
-   int sampleRate, int numChannels, ClipConstHolders clips)
+   int sampleRate, int numChannels, ClipConstHolders clips, bool renderAhead)
     : mClips { std::move(clips) }
     , mSampleRate { sampleRate }
     , mNumChannels { numChannels }
 {
+   if (!renderAhead)
+      return;
+   for (const auto& clip : mClips)
+      if (const auto pCache = clip->GetStretchedClipCache())
+      {
+         pCache->Request(*clip);
+         mCaches.emplace(clip.get(), pCache);
+      }
+}
+
+std::shared_ptr<const StretchedClipCache>
+AudioSegmentFactory::FindCache(const ClipInterface& clip) const
+{
+   const auto it = mCaches.find(&clip);
+   return it == mCaches.end() ? nullptr : it->second;
+}
+
+std::shared_ptr<AudioSegment> AudioSegmentFactory::GetClipSegment(
+   const ClipInterface& clip, double durationToDiscard,
+   PlaybackDirection direction)
+{
+   auto& pSegment = mClipSegments[&clip];
+   if (pSegment)
+      pSegment->Reset(durationToDiscard, direction);
+   else
+      pSegment = std::make_shared<ClipSegment>(
+         clip, durationToDiscard, direction, FindCache(clip));
+   return pSegment;
 }
 
 std::vector<std::shared_ptr<AudioSegment>>
@@ -59,7 +88,7 @@ AudioSegmentFactory::CreateAudioSegmentSequenceForward(double t0)
       }
       else if (clip->GetPlayEndTime() <= t0)
          continue;
-      segments.push_back(std::make_shared<ClipSegment>(
+      segments.push_back(GetClipSegment(
          *clip, t0 - clip->GetPlayStartTime(), PlaybackDirection::forward));
       t0 = clip->GetPlayEndTime();
    }
@@ -90,7 +119,7 @@ AudioSegmentFactory::CreateAudioSegmentSequenceBackward(double t0)
       }
       else if (clip->GetPlayStartTime() >= t0)
          continue;
-      segments.push_back(std::make_shared<ClipSegment>(
+      segments.push_back(GetClipSegment(
          *clip, clip->GetPlayEndTime() - t0, PlaybackDirection::backward));
       t0 = clip->GetPlayStartTime();
    }
@@ -16,15 +16,30 @@
 #include "TimeAndPitchInterface.h"
 
 #include <memory>
+#include <unordered_map>
 
 class ClipInterface;
+class ClipSegment;
+class StretchedClipCache;
 using ClipConstHolders = std::vector<std::shared_ptr<const ClipInterface>>;
 
+/*!
+ * Clip segments are made once for each clip, then reset for each new
+ * sequence; so a sequence must not be used any more once the next one is
+ * made.
+ */
 class STRETCHING_SEQUENCE_API AudioSegmentFactory final :
     public AudioSegmentFactoryInterface
 {
 public:
-   AudioSegmentFactory(int sampleRate, int numChannels, ClipConstHolders clips);
+   /*!
+    * @param renderAhead whether to request background rendering of stretched
+    * clips that support it, and read from the renderings when complete; to be
+    * constructed on the main thread then
+    */
+   AudioSegmentFactory(
+      int sampleRate, int numChannels, ClipConstHolders clips,
+      bool renderAhead = false);
 
    std::vector<std::shared_ptr<AudioSegment>> CreateAudioSegmentSequence(
       double playbackStartTime, PlaybackDirection) override;
@@ -37,7 +52,19 @@ private:
    CreateAudioSegmentSequenceBackward(double playbackStartTime);
 
 private:
+   std::shared_ptr<const StretchedClipCache>
+   FindCache(const ClipInterface& clip) const;
+
+   std::shared_ptr<AudioSegment> GetClipSegment(
+      const ClipInterface& clip, double durationToDiscard, PlaybackDirection);
+
    const ClipConstHolders mClips;
+   //! Fetched on construction, so that the audio thread need not
+   std::unordered_map<
+      const ClipInterface*, std::shared_ptr<const StretchedClipCache>>
+      mCaches;
+   std::unordered_map<const ClipInterface*, std::shared_ptr<ClipSegment>>
+      mClipSegments;
    const int mSampleRate;
    const int mNumChannels;
 };
@@ -3,3 +3,8 @@
 ClipTimes::~ClipTimes() = default;
 
 ClipInterface::~ClipInterface() = default;
+
+std::shared_ptr<StretchedClipCache> ClipInterface::GetStretchedClipCache() const
+{
+   return {};
+}
@@ -15,6 +15,8 @@
 #include "SampleCount.h"
 #include "SampleFormat.h"
 
+class StretchedClipCache;
+
 class STRETCHING_SEQUENCE_API ClipTimes
 {
 public:
@@ -63,6 +65,12 @@ public:
    [[nodiscard]] virtual Observer::Subscription
    SubscribeToPitchAndSpeedPresetChange(
       std::function<void(PitchAndSpeedPreset)> cb) const = 0;
+
+   /*!
+    * Optional cache of the stretched audio of this clip, to be called on the
+    * main thread. Default implementation returns null.
+    */
+   virtual std::shared_ptr<StretchedClipCache> GetStretchedClipCache() const;
 };
 
 using ClipConstHolders = std::vector<std::shared_ptr<const ClipInterface>>;
@@ -40,16 +40,17 @@ GetTotalNumSamplesToProduce(const ClipInterface& clip, double durationToDiscard)
 
 ClipSegment::ClipSegment(
    const ClipInterface& clip, double durationToDiscard,
-   PlaybackDirection direction)
-    : mTotalNumSamplesToProduce { GetTotalNumSamplesToProduce(
+   PlaybackDirection direction,
+   const std::shared_ptr<const StretchedClipCache>& cache)
+    : mClip { clip }
+    , mDurationToDiscard { durationToDiscard }
+    , mPlaybackDirection { direction }
+    , mTotalNumSamplesToProduce { GetTotalNumSamplesToProduce(
          clip, durationToDiscard) }
-    , mSource { clip, durationToDiscard, direction }
+    , mCache { cache }
     , mPreserveFormants { clip.GetPitchAndSpeedPreset() ==
                           PitchAndSpeedPreset::OptimizeForVoice }
     , mCentShift { clip.GetCentShift() }
-    , mStretcher { std::make_unique<StaffPadTimeAndPitch>(
-         clip.GetRate(), clip.NChannels(), mSource,
-         GetStretchingParameters(clip)) }
     , mOnSemitoneShiftChangeSubscription { clip.SubscribeToCentShiftChange(
          [this](int cents) {
             mCentShift = cents;
@@ -64,6 +65,51 @@ ClipSegment::ClipSegment(
           })
     }
 {
+   StartReading();
+}
+
+void ClipSegment::Reset(double durationToDiscard, PlaybackDirection direction)
+{
+   mDurationToDiscard = durationToDiscard;
+   mPlaybackDirection = direction;
+   mTotalNumSamplesToProduce =
+      GetTotalNumSamplesToProduce(mClip, durationToDiscard);
+   mTotalNumSamplesProduced = 0;
+   StartReading();
+}
+
+void ClipSegment::StartReading()
+{
+   mRendering =
+      mCache ? mCache->Find(StretchedClipCache::Key::Get(mClip)) : nullptr;
+   if (mRendering)
+   {
+      const sampleCount offset { mDurationToDiscard * mClip.GetRate() + .5 };
+      mRenderingStart =
+         mPlaybackDirection == PlaybackDirection::forward ?
+            offset :
+            sampleCount { mRendering->front().size() } - offset;
+   }
+   else if (mStretcher && mStretchRatio == mClip.GetStretchRatio())
+   {
+      // Spare the construction of the stretcher.  Changes of pitch and
+      // formant preservation still apply at the next GetFloats.
+      mSource->Reset(mDurationToDiscard, mPlaybackDirection);
+      mStretcher->Reset();
+   }
+   else
+      StartStretching(mDurationToDiscard);
+}
+
+void ClipSegment::StartStretching(double durationToDiscard)
+{
+   // Destroy the stretcher before the source it refers to
+   mStretcher.reset();
+   mSource.emplace(mClip, durationToDiscard, mPlaybackDirection);
+   mStretchRatio = mClip.GetStretchRatio();
+   mStretcher = std::make_unique<StaffPadTimeAndPitch>(
+      mClip.GetRate(), mClip.NChannels(), *mSource,
+      GetStretchingParameters(mClip));
 }
 
 ClipSegment::~ClipSegment()
@@ -81,13 +127,33 @@ size_t ClipSegment::GetFloats(float* const* buffers, size_t numSamples)
    // cannot trust that the observer subscriptions do not get called after
    // destruction of this object, so better not do anything too sophisticated
    // there.
-   if (mUpdateFormantPreservation.exchange(false))
-      mStretcher->OnFormantPreservationChange(mPreserveFormants);
-   if (mUpdateCentShift.exchange(false))
-      mStretcher->OnCentShiftChange(mCentShift);
+   if (mRendering)
+   {
+      const auto formantsChanged = mUpdateFormantPreservation.exchange(false);
+      const auto centsChanged = mUpdateCentShift.exchange(false);
+      if (formantsChanged || centsChanged)
+      {
+         // The rendering is stale; continue from here with a stretcher,
+         // which takes the new parameters from the clip
+         mRendering.reset();
+         StartStretching(
+            mDurationToDiscard +
+            mTotalNumSamplesProduced.as_double() / mClip.GetRate());
+      }
+   }
+   else
+   {
+      if (mUpdateFormantPreservation.exchange(false))
+         mStretcher->OnFormantPreservationChange(mPreserveFormants);
+      if (mUpdateCentShift.exchange(false))
+         mStretcher->OnCentShiftChange(mCentShift);
+   }
    const auto numSamplesToProduce = limitSampleBufferSize(
       numSamples, mTotalNumSamplesToProduce - mTotalNumSamplesProduced);
-   mStretcher->GetSamples(buffers, numSamplesToProduce);
+   if (mRendering)
+      CopyFromRendering(buffers, numSamplesToProduce);
+   else
+      mStretcher->GetSamples(buffers, numSamplesToProduce);
    mTotalNumSamplesProduced += numSamplesToProduce;
    return numSamplesToProduce;
 }
@@ -99,5 +165,24 @@ bool ClipSegment::Empty() const
 
 size_t ClipSegment::NChannels() const
 {
-   return mSource.NChannels();
+   return mClip.NChannels();
+}
+
+void ClipSegment::CopyFromRendering(
+   float* const* buffers, size_t numSamples) const
+{
+   const auto forward = mPlaybackDirection == PlaybackDirection::forward;
+   for (size_t i = 0; i < mRendering->size(); ++i)
+   {
+      const auto& channel = (*mRendering)[i];
+      const sampleCount size { channel.size() };
+      const auto step = forward ? 1 : -1;
+      auto position = forward ?
+                         mRenderingStart + mTotalNumSamplesProduced :
+                         mRenderingStart - mTotalNumSamplesProduced - 1;
+      for (size_t j = 0; j < numSamples; ++j, position += step)
+         buffers[i][j] = position >= 0 && position < size ?
+                            channel[position.as_size_t()] :
+                            0.f;
+   }
 }
@@ -14,8 +14,10 @@
 #include "ClipTimeAndPitchSource.h"
 #include "Observer.h"
 #include "PlaybackDirection.h"
+#include "StretchedClipCache.h"
 #include <atomic>
 #include <memory>
+#include <optional>
 
 class ClipInterface;
 class TimeAndPitchInterface;
@@ -26,12 +28,21 @@ using PitchRatioChangeCbSubscriber =
 /*!
  * It is important that objects of this class are instantiated and destroyed on
  * the same thread, due to the owned Observer::Subscription.
+ *
+ * If given a cache holding a complete rendering of the clip with its current
+ * parameters, samples are copied from it, and no stretcher is made unless
+ * pitch or formant preservation change during playback.
+ *
+ * Reset() repositions the segment, in either direction, reusing the stretcher
+ * and the subscriptions, so that seeking and scrubbing need not construct
+ * segments anew.
  */
 class STRETCHING_SEQUENCE_API ClipSegment final : public AudioSegment
 {
 public:
    ClipSegment(const ClipInterface&,
-      double durationToDiscard, PlaybackDirection);
+      double durationToDiscard, PlaybackDirection,
+      const std::shared_ptr<const StretchedClipCache>& cache = nullptr);
    ~ClipSegment() override;
 
    // AudioSegment
@@ -39,10 +50,26 @@ public:
    bool Empty() const override;
    size_t NChannels() const override;
 
+   //! Continue as if newly constructed with these arguments
+   void Reset(double durationToDiscard, PlaybackDirection);
+
 private:
-   const sampleCount mTotalNumSamplesToProduce;
+   void StartReading();
+   void StartStretching(double durationToDiscard);
+   void CopyFromRendering(float* const* buffers, size_t numSamples) const;
+
+   const ClipInterface& mClip;
+   double mDurationToDiscard;
+   PlaybackDirection mPlaybackDirection;
+   sampleCount mTotalNumSamplesToProduce;
    sampleCount mTotalNumSamplesProduced = 0;
-   ClipTimeAndPitchSource mSource;
+   const std::shared_ptr<const StretchedClipCache> mCache;
+   //! Null when stretching live
+   std::shared_ptr<const StretchedClipCache::Rendering> mRendering;
+   //! Forward: index in mRendering of the first sample to produce.
+   //! Backward: one past it.
+   sampleCount mRenderingStart = 0;
+   std::optional<ClipTimeAndPitchSource> mSource;
    bool mPreserveFormants;
    int mCentShift;
    std::atomic<bool> mUpdateFormantPreservation = false;
@@ -51,6 +78,8 @@ private:
    // in its ctor.
    // todo(mhodgkinson) make this safe.
    std::unique_ptr<TimeAndPitchInterface> mStretcher;
+   //! The stretch ratio mStretcher was made with
+   double mStretchRatio = 1.0;
    Observer::Subscription mOnSemitoneShiftChangeSubscription;
    Observer::Subscription mOnFormantPreservationChangeSubscription;
 };
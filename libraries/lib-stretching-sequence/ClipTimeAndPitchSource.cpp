@@ -87,6 +87,13 @@ void ClipTimeAndPitchSource::Pull(
    }
 }
 
+void ClipTimeAndPitchSource::Reset(
+   double durationToDiscard, PlaybackDirection direction)
+{
+   mLastReadSample = GetLastReadSample(mClip, durationToDiscard, direction);
+   mPlaybackDirection = direction;
+}
+
 size_t ClipTimeAndPitchSource::NChannels() const
 {
    return mClip.NChannels();
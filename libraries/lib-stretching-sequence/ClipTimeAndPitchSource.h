@@ -32,9 +32,12 @@ public:
 
    size_t NChannels() const;
 
+   //! Continue reading as if newly constructed with these arguments
+   void Reset(double durationToDiscard, PlaybackDirection);
+
 private:
    const ClipInterface& mClip;
    sampleCount mLastReadSample = 0;
-   const PlaybackDirection mPlaybackDirection;
+   PlaybackDirection mPlaybackDirection;
    ChannelSampleViews mChannelSampleViews;
 };
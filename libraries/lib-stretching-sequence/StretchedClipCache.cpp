@@ -0,0 +1,347 @@
+/*  SPDX-License-Identifier: GPL-2.0-or-later */
+/*!********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  StretchedClipCache.cpp
+
+**********************************************************************/
+#include "StretchedClipCache.h"
+#include "MemoryX.h"
+#include "StaffPadTimeAndPitch.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+struct StretchedClipCache::State
+{
+   std::mutex mutex;
+   std::condition_variable finished;
+   //! Guarded by mutex
+   std::shared_ptr<const Rendering> rendering;
+   //! What rendering is for, or what is being rendered
+   Key key;
+   //! Whether the request of the current generation is not yet done
+   bool pending = false;
+   //! If not 0, the budget refused the rendering for key, which needed this
+   //! many samples
+   size_t refusedSamples = 0;
+   //! Incremented by each request and invalidation; a rendering of an older
+   //! generation stops and is discarded
+   std::atomic<unsigned> generation { 0 };
+};
+
+namespace
+{
+std::atomic<size_t> totalRenderedSamples { 0 };
+std::atomic<size_t> totalRenderedSamplesLimit {
+   StretchedClipCache::maxTotalRenderedSamples
+};
+
+//! The one thread rendering for all caches
+class RenderThread final
+{
+public:
+   static RenderThread& Get()
+   {
+      static RenderThread instance;
+      return instance;
+   }
+
+   ~RenderThread()
+   {
+      {
+         std::lock_guard lock { mMutex };
+         mStopping = true;
+      }
+      mCondition.notify_one();
+      if (mThread.joinable())
+         mThread.join();
+   }
+
+   void Submit(std::function<void()> job)
+   {
+      {
+         std::lock_guard lock { mMutex };
+         if (!mThread.joinable())
+            mThread = std::thread { [this] { Run(); } };
+         mJobs.push_back(std::move(job));
+      }
+      mCondition.notify_one();
+   }
+
+private:
+   void Run()
+   {
+      while (true)
+      {
+         std::function<void()> job;
+         {
+            std::unique_lock lock { mMutex };
+            mCondition.wait(
+               lock, [this] { return mStopping || !mJobs.empty(); });
+            // Cancelled jobs still run, to release their views here
+            if (mJobs.empty())
+               return;
+            job = std::move(mJobs.front());
+            mJobs.pop_front();
+         }
+         job();
+      }
+   }
+
+   std::mutex mMutex;
+   std::condition_variable mCondition;
+   std::deque<std::function<void()>> mJobs;
+   bool mStopping = false;
+   std::thread mThread;
+};
+
+//! Whether the budget of all renderings has room for more samples now
+bool Fits(size_t numSamples)
+{
+   return totalRenderedSamples + numSamples <= totalRenderedSamplesLimit;
+}
+
+//! Reserve from the budget of all renderings
+bool Reserve(size_t numSamples)
+{
+   auto total = totalRenderedSamples.load();
+   do
+      if (total + numSamples > totalRenderedSamplesLimit)
+         return false;
+   while (!totalRenderedSamples.compare_exchange_weak(
+      total, total + numSamples));
+   return true;
+}
+
+//! Samples per channel produced by each call to the stretcher
+constexpr size_t renderBlockSize = 1024;
+
+class RenderingSource final : public TimeAndPitchSource
+{
+public:
+   explicit RenderingSource(const StretchedClipCache::Rendering& audio)
+       : mAudio { audio }
+   {
+   }
+
+   void Pull(float* const* buffers, size_t samplesPerChannel) override
+   {
+      for (size_t i = 0; i < mAudio.size(); ++i)
+      {
+         const auto& channel = mAudio[i];
+         const auto available = mPosition < channel.size() ?
+                                   channel.size() - mPosition :
+                                   size_t { 0 };
+         const auto numToCopy = std::min(available, samplesPerChannel);
+         std::copy(
+            channel.begin() + mPosition,
+            channel.begin() + mPosition + numToCopy, buffers[i]);
+         std::fill(
+            buffers[i] + numToCopy, buffers[i] + samplesPerChannel, 0.f);
+      }
+      mPosition += samplesPerChannel;
+   }
+
+private:
+   const StretchedClipCache::Rendering& mAudio;
+   size_t mPosition = 0;
+};
+
+sampleCount GetRenderedLength(const StretchedClipCache::Key& key)
+{
+   return sampleCount { key.numSourceSamples.as_double() * key.stretchRatio +
+                        .5 };
+}
+} // namespace
+
+auto StretchedClipCache::Key::Get(const ClipInterface& clip) -> Key
+{
+   return { clip.GetStretchRatio(),      clip.GetCentShift(),
+            clip.GetPitchAndSpeedPreset(), clip.GetVisibleSampleCount(),
+            clip.GetRate(),              clip.NChannels() };
+}
+
+bool operator==(
+   const StretchedClipCache::Key& a, const StretchedClipCache::Key& b)
+{
+   return a.stretchRatio == b.stretchRatio && a.centShift == b.centShift &&
+          a.preset == b.preset && a.numSourceSamples == b.numSourceSamples &&
+          a.rate == b.rate && a.nChannels == b.nChannels;
+}
+
+StretchedClipCache::StretchedClipCache()
+    : mState { std::make_shared<State>() }
+{
+}
+
+StretchedClipCache::~StretchedClipCache()
+{
+   Invalidate();
+}
+
+size_t StretchedClipCache::TotalRenderedSamples()
+{
+   return totalRenderedSamples;
+}
+
+size_t StretchedClipCache::SetMaxTotalRenderedSamples(size_t numSamples)
+{
+   return totalRenderedSamplesLimit.exchange(numSamples);
+}
+
+bool StretchedClipCache::IsCacheable(const ClipInterface& clip)
+{
+   const auto key = Key::Get(clip);
+   if (
+      TimeAndPitchInterface::IsPassThroughMode(key.stretchRatio) &&
+      key.centShift == 0)
+      // Playback does not run the stretcher anyway
+      return false;
+   const auto length = GetRenderedLength(key);
+   return length > 0 &&
+          length.as_double() * key.nChannels <= maxRenderedSamples;
+}
+
+auto StretchedClipCache::Find(const Key& key) const
+   -> std::shared_ptr<const Rendering>
+{
+   std::lock_guard lock { mState->mutex };
+   return key == mState->key ? mState->rendering : nullptr;
+}
+
+void StretchedClipCache::Request(const ClipInterface& clip)
+{
+   if (!IsCacheable(clip))
+      return;
+   const auto key = Key::Get(clip);
+   unsigned generation;
+   {
+      std::lock_guard lock { mState->mutex };
+      if (key == mState->key)
+      {
+         if (mState->rendering || mState->pending)
+            return;
+         // Refused before; submit again only when the budget has room
+         if (mState->refusedSamples > 0 && !Fits(mState->refusedSamples))
+            return;
+      }
+      // Cancels the rendering of any other key
+      generation = ++mState->generation;
+      mState->rendering.reset();
+      mState->key = key;
+      mState->pending = true;
+      mState->refusedSamples = 0;
+   }
+
+   // Capture the samples now; the views share the immutable block data, so
+   // the render thread does not touch the clip
+   constexpr auto mayThrow = false;
+   std::vector<AudioSegmentSampleView> views;
+   for (size_t i = 0; i < key.nChannels; ++i)
+      views.push_back(clip.GetSampleView(
+         i, 0, key.numSourceSamples.as_size_t(), mayThrow));
+
+   RenderThread::Get().Submit(
+      [pState = mState, generation, key, views = std::move(views)]() mutable {
+         Render(*pState, generation, key, std::move(views));
+      });
+}
+
+void StretchedClipCache::Invalidate()
+{
+   std::lock_guard lock { mState->mutex };
+   ++mState->generation;
+   mState->rendering.reset();
+   mState->key = {};
+   mState->pending = false;
+   mState->refusedSamples = 0;
+   mState->finished.notify_all();
+}
+
+void StretchedClipCache::Wait()
+{
+   std::unique_lock lock { mState->mutex };
+   mState->finished.wait(lock, [this] { return !mState->pending; });
+}
+
+void StretchedClipCache::Render(
+   State& state, unsigned generation, Key key,
+   std::vector<AudioSegmentSampleView> views)
+{
+   std::shared_ptr<Rendering> result;
+   size_t refusedSamples = 0;
+   auto finish = finally([&] {
+      std::lock_guard lock { state.mutex };
+      if (state.generation == generation)
+      {
+         state.rendering = std::move(result);
+         state.pending = false;
+         state.refusedSamples = refusedSamples;
+      }
+      state.finished.notify_all();
+   });
+   const auto cancelled = [&] { return state.generation != generation; };
+
+   const auto length = GetRenderedLength(key).as_size_t();
+   const auto numSamples = length * key.nChannels;
+   const auto numSourceSamples = key.numSourceSamples.as_size_t();
+   // The copy of the source is counted too, while the rendering is made
+   const auto numCopiedSamples = numSourceSamples * key.nChannels;
+   if (cancelled())
+      return;
+   if (!Reserve(numSamples + numCopiedSamples))
+   {
+      // Playback will stretch live instead
+      refusedSamples = numSamples + numCopiedSamples;
+      return;
+   }
+   // The budget is released when the last ClipSegment reading the rendering
+   // lets it go
+   const auto deleter = [numSamples](Rendering* p) {
+      delete p;
+      totalRenderedSamples -= numSamples;
+   };
+   std::shared_ptr<Rendering> rendering {
+      new Rendering(key.nChannels, std::vector<float>(length)), deleter
+   };
+
+   // Release the reservation for the source after it is destroyed
+   auto releaseSource =
+      finally([&] { totalRenderedSamples -= numCopiedSamples; });
+   Rendering source(key.nChannels);
+   for (size_t i = 0; i < key.nChannels; ++i)
+   {
+      source[i].resize(numSourceSamples);
+      views[i].Copy(source[i].data(), numSourceSamples);
+   }
+   views.clear();
+
+   TimeAndPitchInterface::Parameters params;
+   params.timeRatio = key.stretchRatio;
+   params.pitchRatio = std::pow(2., key.centShift / 1200.);
+   params.preserveFormants =
+      key.preset == PitchAndSpeedPreset::OptimizeForVoice;
+   RenderingSource audioSource { source };
+   StaffPadTimeAndPitch stretcher { key.rate, key.nChannels, audioSource,
+                                    params };
+
+   std::vector<float*> pointers(key.nChannels);
+   for (size_t done = 0; done < length; done += renderBlockSize)
+   {
+      if (cancelled())
+         return;
+      const auto numToRender = std::min(renderBlockSize, length - done);
+      for (size_t i = 0; i < key.nChannels; ++i)
+         pointers[i] = (*rendering)[i].data() + done;
+      stretcher.GetSamples(pointers.data(), numToRender);
+   }
+   result = std::move(rendering);
+}
@@ -0,0 +1,107 @@
+/*  SPDX-License-Identifier: GPL-2.0-or-later */
+/*!********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  StretchedClipCache.h
+
+**********************************************************************/
+#pragma once
+
+#include "ClipInterface.h"
+#include "SampleCount.h"
+
+#include <memory>
+#include <vector>
+
+/*!
+ * @brief Holds the audio of one clip as stretched and pitch-shifted with its
+ * current parameters, rendered ahead on a background thread, so that playback
+ * from any position may start without running the stretcher.
+ *
+ * One thread renders for all caches, in the order of the requests, and the
+ * renderings of all caches together, with the copies of the source samples
+ * of the one being rendered, are limited to maxTotalRenderedSamples.  A
+ * request refused for that limit is not made again for the same parameters
+ * until there is room for it.
+ *
+ * @details The rendering is valid only for the parameters it was made with;
+ * Find() compares them.  Changes of the samples of the clip are not
+ * observable through ClipInterface, so the owner of the cache must call
+ * Invalidate() when they happen.
+ *
+ * Request() and Invalidate() are meant for the main thread; Find() may be
+ * called from any thread.
+ */
+class STRETCHING_SEQUENCE_API StretchedClipCache final
+{
+public:
+   //! Clip properties that determine the stretched audio
+   struct Key
+   {
+      static Key Get(const ClipInterface& clip);
+
+      double stretchRatio = 1.0;
+      int centShift = 0;
+      PitchAndSpeedPreset preset = PitchAndSpeedPreset::Default;
+      sampleCount numSourceSamples = 0;
+      int rate = 0;
+      size_t nChannels = 0;
+
+      friend bool operator==(const Key& a, const Key& b);
+      friend bool operator!=(const Key& a, const Key& b) { return !(a == b); }
+   };
+
+   //! Stretched audio of the whole clip, one vector per channel
+   using Rendering = std::vector<std::vector<float>>;
+
+   //! Clips whose rendering would take more samples, over all channels, are
+   //! not cached
+   static constexpr size_t maxRenderedSamples = 1 << 25;
+   //! A request is not rendered if the renderings of all caches, still
+   //! referenced, with its own rendering and source samples, would then take
+   //! more samples
+   static constexpr size_t maxTotalRenderedSamples = 1 << 26;
+
+   //! Samples in the renderings of all caches that are still referenced, and
+   //! in the source of any rendering in progress
+   static size_t TotalRenderedSamples();
+
+   //! Replace maxTotalRenderedSamples as the limit, as for tests
+   //! @return the previous limit
+   static size_t SetMaxTotalRenderedSamples(size_t numSamples);
+
+   StretchedClipCache();
+   StretchedClipCache(const StretchedClipCache&) = delete;
+   StretchedClipCache& operator=(const StretchedClipCache&) = delete;
+   //! Cancels any rendering in progress, without waiting
+   ~StretchedClipCache();
+
+   //! Whether the clip needs stretching at all, and its rendering fits
+   static bool IsCacheable(const ClipInterface& clip);
+
+   //! @return the complete rendering for `key`, or null
+   std::shared_ptr<const Rendering> Find(const Key& key) const;
+
+   //! Start rendering the clip in the background, unless the rendering for
+   //! its current parameters is complete or in progress
+   /*!
+    The samples of the clip are captured before return; the clip need not
+    outlive the rendering.
+    */
+   void Request(const ClipInterface& clip);
+
+   //! Cancel any rendering and discard the result, without waiting
+   void Invalidate();
+
+   //! Block until the rendering requested last, if any, finishes
+   void Wait();
+
+private:
+   struct State;
+   static void Render(State& state, unsigned generation, Key key,
+      std::vector<AudioSegmentSampleView> views);
+
+   //! Shared with the render thread, which may outlive the cache
+   const std::shared_ptr<State> mState;
+};
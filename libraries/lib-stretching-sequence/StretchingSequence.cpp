@@ -187,11 +187,12 @@ bool StretchingSequence::MutableGet(
 }
 
 std::shared_ptr<StretchingSequence> StretchingSequence::Create(
-   const PlayableSequence& sequence, const ClipConstHolders& clips)
+   const PlayableSequence& sequence, const ClipConstHolders& clips,
+   bool renderAhead)
 {
    const int sampleRate = sequence.GetRate();
    return std::make_shared<StretchingSequence>(
       sequence, sampleRate, sequence.NChannels(),
       std::make_unique<AudioSegmentFactory>(
-         sampleRate, sequence.NChannels(), clips));
+         sampleRate, sequence.NChannels(), clips, renderAhead));
 }
@@ -22,13 +22,16 @@ class AudioSegmentFactoryInterface;
 class ClipInterface;
 using ClipConstHolders = std::vector<std::shared_ptr<const ClipInterface>>;
 
-// For now this class assumes forward reading, which will be sufficient for the
-// first goal of allowing export and rendering.
+// Reads forward or backward from any position.  A read that does not follow
+// on from the previous one repositions the segments, which reuse their
+// stretchers.
 class STRETCHING_SEQUENCE_API StretchingSequence final : public PlayableSequence
 {
 public:
-   static std::shared_ptr<StretchingSequence>
-   Create(const PlayableSequence&, const ClipConstHolders& clips);
+   //! @param renderAhead see AudioSegmentFactory
+   static std::shared_ptr<StretchingSequence> Create(
+      const PlayableSequence&, const ClipConstHolders& clips,
+      bool renderAhead = false);
 
    StretchingSequence(
       const PlayableSequence&, int sampleRate, size_t numChannels,
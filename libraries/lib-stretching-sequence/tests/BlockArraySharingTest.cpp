@@ -0,0 +1,61 @@
+/*  SPDX-License-Identifier: GPL-2.0-or-later */
+/*!********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  BlockArraySharingTest.cpp
+
+**********************************************************************/
+#include "MockSampleBlockFactory.h"
+#include "Sequence.h"
+#include "TestWaveClipMaker.h"
+#include "WaveTrackUtilities.h"
+
+#include <catch2/catch.hpp>
+
+namespace
+{
+constexpr auto sampleRate = 10;
+
+const void* BlockArrayId(const WaveTrack& track)
+{
+   return (*track.Intervals().begin())->GetSequence(0)->GetBlockArrayId();
+}
+} // namespace
+
+TEST_CASE("Undo states share arrays of blocks")
+{
+   const auto factory = std::make_shared<MockSampleBlockFactory>();
+   TestWaveClipMaker clipMaker { sampleRate, factory };
+   const auto tracks = TrackList::Create(nullptr);
+   const auto track = WaveTrack::Create(factory, floatSample, sampleRate);
+   tracks->Add(track);
+   track->InsertInterval(clipMaker.ClipFilledWith(.5f, 30, 1), true);
+
+   // As UndoTracks copies the tracks of an undo state
+   const auto state = TrackList::Create(nullptr);
+   state->Add(track->Duplicate());
+   const auto& stateTrack = **state->Any<const WaveTrack>().begin();
+   REQUIRE(BlockArrayId(*track) == BlockArrayId(stateTrack));
+
+   SECTION("after InspectBlocks")
+   {
+      size_t numBlocks = 0;
+      const auto count = [&](const SampleBlockConstPtr&) { ++numBlocks; };
+      WaveTrackUtilities::InspectBlocks(*tracks, count);
+      WaveTrackUtilities::InspectBlocks(*state, count);
+      REQUIRE(numBlocks > 0);
+      REQUIRE(BlockArrayId(*track) == BlockArrayId(stateTrack));
+
+      WaveTrackUtilities::BlockArrayIdSet ids;
+      const auto memory = WaveTrackUtilities::InspectClipMemory(*tracks, ids);
+      // The array was counted already
+      REQUIRE(WaveTrackUtilities::InspectClipMemory(*state, ids) < memory);
+   }
+
+   SECTION("until one of them changes")
+   {
+      track->Clear(1.0, 1.5);
+      REQUIRE(BlockArrayId(*track) != BlockArrayId(stateTrack));
+   }
+}
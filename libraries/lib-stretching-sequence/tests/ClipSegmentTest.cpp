@@ -15,6 +15,8 @@
 
 #include <catch2/catch.hpp>
 
+#include <cmath>
+
 namespace
 {
 constexpr auto sampleRate = 3;
@@ -76,3 +78,52 @@ TEST_CASE("ClipSegment")
       REQUIRE(output.channelVectors[0] == expected);
    }
 }
+
+TEST_CASE("ClipSegment::Reset")
+{
+   const auto direction =
+      GENERATE(PlaybackDirection::forward, PlaybackDirection::backward);
+
+   SECTION("repositions in either direction")
+   {
+      const auto clip = std::make_shared<FloatVectorClip>(
+         sampleRate, FloatVectorVector { { 1.f, 2.f, 3.f, 4.f, 5.f } });
+      const auto numSamples = clip->GetVisibleSampleCount().as_size_t(); // 5
+      ClipSegment sut { *clip, 0., PlaybackDirection::forward };
+      AudioContainer output(numSamples, 1u);
+      REQUIRE(sut.GetFloats(output.channelPointers.data(), 2) == 2);
+      constexpr auto playbackOffset = 2 / static_cast<double>(sampleRate);
+      sut.Reset(playbackOffset, direction);
+      REQUIRE(!sut.Empty());
+      REQUIRE(sut.GetFloats(output.channelPointers.data(), numSamples) == 3);
+      const auto expected = direction == PlaybackDirection::forward ?
+                               std::vector<float> { 3.f, 4.f, 5.f, 0.f, 0.f } :
+                               std::vector<float> { 3.f, 2.f, 1.f, 0.f, 0.f };
+      REQUIRE(output.channelVectors[0] == expected);
+   }
+
+   SECTION("reuses the stretcher as if new")
+   {
+      constexpr auto rate = 44100;
+      std::vector<float> sine(rate / 2);
+      for (size_t i = 0; i < sine.size(); ++i)
+         sine[i] = std::sin(2 * 3.14159265358979 * 440 * i / rate);
+      FloatVectorClip clip { rate, sine, 1u };
+      clip.stretchRatio = 1.5;
+
+      constexpr auto numSamples = 10000u;
+      constexpr auto playbackOffset = 0.1;
+      ClipSegment sut { clip, 0., PlaybackDirection::forward };
+      AudioContainer output(numSamples, 1u);
+      sut.GetFloats(output.channelPointers.data(), numSamples);
+      sut.Reset(playbackOffset, direction);
+      REQUIRE(
+         sut.GetFloats(output.channelPointers.data(), numSamples) ==
+         numSamples);
+
+      ClipSegment fresh { clip, playbackOffset, direction };
+      AudioContainer expected(numSamples, 1u);
+      fresh.GetFloats(expected.channelPointers.data(), numSamples);
+      REQUIRE(output.channelVectors == expected.channelVectors);
+   }
+}
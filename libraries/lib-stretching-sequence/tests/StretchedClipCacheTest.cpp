@@ -0,0 +1,160 @@
+/*  SPDX-License-Identifier: GPL-2.0-or-later */
+/*!********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  StretchedClipCacheTest.cpp
+
+**********************************************************************/
+#include "StretchedClipCache.h"
+#include "AudioContainer.h"
+#include "ClipSegment.h"
+#include "FloatVectorClip.h"
+#include "MemoryX.h"
+
+#include <catch2/catch.hpp>
+
+#include <cmath>
+
+namespace
+{
+constexpr auto sampleRate = 44100;
+
+std::vector<float> Sine(size_t numSamples)
+{
+   std::vector<float> result(numSamples);
+   for (size_t i = 0; i < numSamples; ++i)
+      result[i] = std::sin(2 * 3.14159265358979 * 440 * i / sampleRate);
+   return result;
+}
+} // namespace
+
+TEST_CASE("StretchedClipCache")
+{
+   const auto numChannels = GENERATE(1u, 2u);
+   FloatVectorClip clip { sampleRate, Sine(sampleRate / 2), numChannels };
+   const auto cache = std::make_shared<StretchedClipCache>();
+
+   SECTION("does not cache clips that need no stretching")
+   {
+      REQUIRE(!StretchedClipCache::IsCacheable(clip));
+      cache->Request(clip);
+      cache->Wait();
+      REQUIRE(!cache->Find(StretchedClipCache::Key::Get(clip)));
+   }
+
+   clip.stretchRatio = 1.5;
+   REQUIRE(StretchedClipCache::IsCacheable(clip));
+   cache->Request(clip);
+   cache->Wait();
+   const auto rendering = cache->Find(StretchedClipCache::Key::Get(clip));
+   REQUIRE(rendering);
+   REQUIRE(rendering->size() == numChannels);
+   const auto expectedLength =
+      static_cast<size_t>(clip.GetVisibleSampleCount().as_double() * 1.5 + .5);
+   REQUIRE(rendering->front().size() == expectedLength);
+
+   SECTION("rendering is invalid for other parameters")
+   {
+      auto key = StretchedClipCache::Key::Get(clip);
+      key.stretchRatio = 2;
+      REQUIRE(!cache->Find(key));
+   }
+
+   SECTION("renderings of all caches share a budget until released")
+   {
+      const auto before = StretchedClipCache::TotalRenderedSamples();
+      REQUIRE(before >= expectedLength * numChannels);
+      auto other = std::make_shared<StretchedClipCache>();
+      other->Request(clip);
+      other->Wait();
+      auto otherRendering = other->Find(StretchedClipCache::Key::Get(clip));
+      REQUIRE(otherRendering);
+      const auto after = before + expectedLength * numChannels;
+      REQUIRE(StretchedClipCache::TotalRenderedSamples() == after);
+      // Still counted while read
+      other.reset();
+      REQUIRE(StretchedClipCache::TotalRenderedSamples() == after);
+      otherRendering.reset();
+      REQUIRE(StretchedClipCache::TotalRenderedSamples() == before);
+   }
+
+   SECTION("the budget counts the source, and refusals last until it has room")
+   {
+      const auto before = StretchedClipCache::TotalRenderedSamples();
+      clip.stretchRatio = 2;
+      const auto key = StretchedClipCache::Key::Get(clip);
+      const auto numSourceSamples =
+         clip.GetVisibleSampleCount().as_size_t() * numChannels;
+      const auto numSamples = 2 * numSourceSamples;
+      // Room for the rendering, but not for the copy of its source as well
+      const auto previous = StretchedClipCache::SetMaxTotalRenderedSamples(
+         before + numSamples + numSourceSamples - 1);
+      auto restore = finally([&] {
+         StretchedClipCache::SetMaxTotalRenderedSamples(previous);
+      });
+      cache->Request(clip);
+      cache->Wait();
+      REQUIRE(!cache->Find(key));
+      REQUIRE(StretchedClipCache::TotalRenderedSamples() == before);
+      // Still no room
+      cache->Request(clip);
+      cache->Wait();
+      REQUIRE(!cache->Find(key));
+
+      StretchedClipCache::SetMaxTotalRenderedSamples(
+         before + numSamples + numSourceSamples);
+      cache->Request(clip);
+      cache->Wait();
+      REQUIRE(cache->Find(key));
+      // The source is released when the rendering is done
+      REQUIRE(StretchedClipCache::TotalRenderedSamples() == before + numSamples);
+   }
+
+   SECTION("a new request replaces one not yet done")
+   {
+      clip.stretchRatio = 2;
+      cache->Request(clip);
+      clip.stretchRatio = 0.75;
+      cache->Request(clip);
+      cache->Wait();
+      auto key = StretchedClipCache::Key::Get(clip);
+      REQUIRE(cache->Find(key));
+      key.stretchRatio = 2;
+      REQUIRE(!cache->Find(key));
+   }
+
+   SECTION("Invalidate discards the rendering")
+   {
+      cache->Invalidate();
+      REQUIRE(!cache->Find(StretchedClipCache::Key::Get(clip)));
+   }
+
+   SECTION("ClipSegment reads from the rendering")
+   {
+      const auto direction =
+         GENERATE(PlaybackDirection::forward, PlaybackDirection::backward);
+      constexpr auto offset = 1000;
+      ClipSegment sut { clip, static_cast<double>(offset) / sampleRate,
+                        direction, cache };
+      const auto numSamples = expectedLength - offset;
+      AudioContainer output(numSamples, numChannels);
+      REQUIRE(
+         sut.GetFloats(output.channelPointers.data(), numSamples) ==
+         numSamples);
+      REQUIRE(sut.Empty());
+      for (size_t c = 0; c < numChannels; ++c)
+      {
+         const auto& channel = (*rendering)[c];
+         const auto asExpected =
+            direction == PlaybackDirection::forward ?
+               std::equal(
+                  channel.begin() + offset, channel.end(),
+                  output.channelVectors[c].begin()) :
+               std::equal(
+                  channel.rbegin() + offset, channel.rend(),
+                  output.channelVectors[c].begin());
+         REQUIRE(asExpected);
+      }
+   }
+}
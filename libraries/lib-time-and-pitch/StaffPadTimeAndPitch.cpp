@@ -175,14 +175,28 @@ void StaffPadTimeAndPitch::OnFormantPreservationChange(bool preserve)
       InitializeStretcher();
 }
 
+void StaffPadTimeAndPitch::Reset()
+{
+   if (!mTimeAndPitch)
+      // Pass-through has no state
+      return;
+   // Keeps the FFT setup and the buffers
+   mTimeAndPitch->reset();
+   Prime();
+}
+
 void StaffPadTimeAndPitch::InitializeStretcher()
 {
    mTimeAndPitch = CreateTimeAndPitch(
       mSampleRate, mNumChannels, mParameters, mFormantShifter);
+   Prime();
+}
+
+void StaffPadTimeAndPitch::Prime()
+{
    auto numOutputSamplesToDiscard =
       mTimeAndPitch->getLatencySamplesForStretchRatio(
          mParameters.timeRatio * mParameters.pitchRatio);
-   AudioContainer container(maxBlockSize, mNumChannels);
    while (numOutputSamplesToDiscard > 0)
    {
       if (IllState())
@@ -191,8 +205,8 @@ void StaffPadTimeAndPitch::InitializeStretcher()
       while (numRequired > 0)
       {
          const auto numSamplesToFeed = std::min(maxBlockSize, numRequired);
-         mAudioSource.Pull(container.Get(), numSamplesToFeed);
-         mTimeAndPitch->feedAudio(container.Get(), numSamplesToFeed);
+         mAudioSource.Pull(mReadBuffer.Get(), numSamplesToFeed);
+         mTimeAndPitch->feedAudio(mReadBuffer.Get(), numSamplesToFeed);
          numRequired -= numSamplesToFeed;
       }
       const auto totalNumSamplesToRetrieve = std::min(
@@ -203,7 +217,7 @@ void StaffPadTimeAndPitch::InitializeStretcher()
       {
          const auto numSamplesToRetrieve = std::min(
             maxBlockSize, totalNumSamplesToRetrieve - totalNumRetrievedSamples);
-         mTimeAndPitch->retrieveAudio(container.Get(), numSamplesToRetrieve);
+         mTimeAndPitch->retrieveAudio(mReadBuffer.Get(), numSamplesToRetrieve);
          totalNumRetrievedSamples += numSamplesToRetrieve;
       }
       numOutputSamplesToDiscard -= totalNumSamplesToRetrieve;
@@ -14,10 +14,13 @@ public:
    void GetSamples(float* const*, size_t) override;
    void OnCentShiftChange(int cents) override;
    void OnFormantPreservationChange(bool preserve) override;
+   void Reset() override;
 
 private:
    bool IllState() const;
    void InitializeStretcher();
+   //! Pull from the source and discard output until past the latency
+   void Prime();
 
    const int mSampleRate;
    const std::unique_ptr<FormantShifterLoggerInterface> mFormantShifterLogger;
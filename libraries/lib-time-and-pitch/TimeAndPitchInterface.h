@@ -43,6 +43,9 @@ public:
    virtual void GetSamples(float* const*, size_t) = 0;
    virtual void OnCentShiftChange(int cents) = 0;
    virtual void OnFormantPreservationChange(bool preserve) = 0;
+   //! Discard all buffered audio and start again from the current position
+   //! of the source, reusing allocations, as if newly constructed
+   virtual void Reset() = 0;
 
    virtual ~TimeAndPitchInterface();
 };
@@ -12,6 +12,8 @@
 #include "Track.h"
 #include "UndoManager.h"
 
+#include <cassert>
+
 // Undo/redo handling of selection changes
 namespace {
 struct TrackListRestorer final : UndoStateExtension {
@@ -26,6 +28,7 @@ struct TrackListRestorer final : UndoStateExtension {
       }
    }
    void RestoreUndoRedoState(AudacityProject &project) override {
+      Reload();
       auto &dstTracks = TrackList::Get(project);
       dstTracks.Clear();
       for (auto pTrack : *mpTracks)
@@ -34,9 +37,29 @@ struct TrackListRestorer final : UndoStateExtension {
    bool CanUndoOrRedo(const AudacityProject &project) override {
       return !PendingTracks::Get(project).HasPendingTracks();
    }
+   //! May throw; then the state remains spilled
+   void Reload() {
+      if (mpSpilled) {
+         mpSpilled->Reload(*mpTracks);
+         mpSpilled.reset();
+      }
+   }
    const std::shared_ptr<TrackList> mpTracks;
+   std::shared_ptr<UndoTracks::Spilled> mpSpilled;
 };
 
+TrackListRestorer *FindRestorer(const UndoStackElem &state)
+{
+   auto &exts = state.state.extensions;
+   auto end = exts.end(),
+      iter = std::find_if(exts.begin(), end, [](auto &pExt){
+         return dynamic_cast<TrackListRestorer*>(pExt.get());
+      });
+   if (iter != end)
+      return static_cast<TrackListRestorer*>(iter->get());
+   return nullptr;
+}
+
 UndoRedoExtensionRegistry::Entry sEntry {
    [](AudacityProject &project) -> std::shared_ptr<UndoStateExtension> {
       return std::make_shared<TrackListRestorer>(project);
@@ -44,14 +67,30 @@ UndoRedoExtensionRegistry::Entry sEntry {
 };
 }
 
+UndoTracks::Spilled::~Spilled() = default;
+
 TrackList *UndoTracks::Find(const UndoStackElem &state)
 {
-   auto &exts = state.state.extensions;
-   auto end = exts.end(),
-      iter = std::find_if(exts.begin(), end, [](auto &pExt){
-         return dynamic_cast<TrackListRestorer*>(pExt.get());
-      });
-   if (iter != end)
-      return static_cast<TrackListRestorer*>(iter->get())->mpTracks.get();
+   if (auto pRestorer = FindRestorer(state)) {
+      pRestorer->Reload();
+      return pRestorer->mpTracks.get();
+   }
    return nullptr;
 }
+
+auto UndoTracks::FindSpilled(const UndoStackElem &state)
+   -> std::pair<TrackList *, Spilled *>
+{
+   if (auto pRestorer = FindRestorer(state))
+      return { pRestorer->mpTracks.get(), pRestorer->mpSpilled.get() };
+   return {};
+}
+
+void UndoTracks::SetSpilled(
+   const UndoStackElem &state, std::shared_ptr<Spilled> pSpilled)
+{
+   if (auto pRestorer = FindRestorer(state)) {
+      assert(!pRestorer->mpSpilled);
+      pRestorer->mpSpilled = move(pSpilled);
+   }
+}
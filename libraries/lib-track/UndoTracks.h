@@ -10,11 +10,38 @@
 #ifndef __AUDACITY_UNDO_TRACKS__
 #define __AUDACITY_UNDO_TRACKS__
 
+#include <memory>
+#include <utility>
+
 class TrackList;
 struct UndoStackElem;
 
 namespace UndoTracks {
+
+//! Part of the contents of the tracks of an undo state, which was saved
+//! elsewhere and removed from memory
+class TRACK_API Spilled {
+public:
+   virtual ~Spilled();
+   //! Put the saved contents back into the tracks they were removed from
+   /*! May throw */
+   virtual void Reload(TrackList &tracks) = 0;
+};
+
+//! Find the tracks of the state, reloading them first if they were spilled
+/*! May throw */
 TRACK_API TrackList *Find(const UndoStackElem &state);
+
+//! Find the tracks of the state, as they are, and what was spilled from them
+//! if anything
+TRACK_API std::pair<TrackList *, Spilled *>
+FindSpilled(const UndoStackElem &state);
+
+//! Record that contents were removed from the tracks of the state, so that
+//! the next Find() or restoration of the state reloads them
+/*! @pre `FindSpilled(state).first && !FindSpilled(state).second` */
+TRACK_API void SetSpilled(
+   const UndoStackElem &state, std::shared_ptr<Spilled> pSpilled);
 }
 
 #endif
@@ -59,3 +59,9 @@ bool TransactionScope::Commit()
 
    return !mInTrans;
 }
+
+bool TransactionScope::InProgress(AudacityProject &project)
+{
+   const auto pImpl = Factory::Call(project);
+   return pImpl && pImpl->InTransaction();
+}
@@ -44,6 +44,10 @@ public:
    //! Commit the transaction
    bool Commit();
 
+   //! Whether a transaction of the project is open, so that what is written
+   //! now may yet be rolled back
+   static bool InProgress(AudacityProject &project);
+
 private:
    std::unique_ptr<TransactionScopeImpl> mpImpl;
    bool mInTrans;
@@ -60,6 +64,8 @@ public:
    virtual bool TransactionCommit(const wxString &name) = 0;
    //! @return success
    virtual bool TransactionRollback(const wxString &name) = 0;
+   //! @return whether a transaction is open
+   virtual bool InTransaction() const = 0;
 };
 
 #endif
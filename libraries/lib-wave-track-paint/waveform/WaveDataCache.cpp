@@ -205,6 +205,11 @@ MakeDefaultDataProvider(const WaveClip& clip, int channelIndex)
       const auto blockIndex  = sequence->FindBlock(requiredSample);
       const auto& inputBlock = sequence->GetBlockArray()[blockIndex];
 
+      // Don't wait for a file imported on demand, but ask for this block
+      // first; the element remains incomplete, and is updated when drawn again
+      if (inputBlock.sb->IsPending(true))
+         return false;
+
       outBlock.FirstSample = inputBlock.start.as_long_long();
       outBlock.NumSamples  = inputBlock.sb->GetSampleCount();
 
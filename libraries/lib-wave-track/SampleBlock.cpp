@@ -10,9 +10,12 @@ SampleBlock.cpp
 #include "InconsistencyException.h"
 #include "SampleBlock.h"
 #include "SampleFormat.h"
+#include "BasicUI.h"
 
 #include <wx/defs.h>
 
+#include <atomic>
+
 SampleBlockFactoryPtr SampleBlockFactory::New( AudacityProject &project )
 {
    auto &factory = Factory::Get();
@@ -21,6 +24,15 @@ SampleBlockFactoryPtr SampleBlockFactory::New( AudacityProject &project )
    return factory( project );
 }
 
+namespace {
+std::atomic<unsigned long long> sFactoryCount{ 0 };
+}
+
+SampleBlockFactory::SampleBlockFactory()
+   : mSerialNumber{ ++sFactoryCount }
+{
+}
+
 SampleBlockFactory::~SampleBlockFactory() = default;
 
 SampleBlockPtr SampleBlockFactory::Create(constSamplePtr src,
@@ -30,7 +42,10 @@ SampleBlockPtr SampleBlockFactory::Create(constSamplePtr src,
    auto result = DoCreate(src, numsamples, srcformat);
    if (!result)
       THROW_INCONSISTENCY_EXCEPTION;
-   Publisher<SampleBlockCreateMessage>::Publish({});
+   // Blocks may be made on worker threads, as for imports, but observers
+   // expect the main thread
+   if (BasicUI::IsUiThread())
+      Publisher<SampleBlockCreateMessage>::Publish({});
    return result;
 }
 
@@ -41,7 +56,8 @@ SampleBlockPtr SampleBlockFactory::CreateSilent(
    auto result = DoCreateSilent(numsamples, srcformat);
    if (!result)
       THROW_INCONSISTENCY_EXCEPTION;
-   Publisher<SampleBlockCreateMessage>::Publish({});
+   if (BasicUI::IsUiThread())
+      Publisher<SampleBlockCreateMessage>::Publish({});
    return result;
 }
 
@@ -52,7 +68,8 @@ SampleBlockPtr SampleBlockFactory::CreateFromXML(
    auto result = DoCreateFromXML(srcformat, attrs);
    if (!result)
       THROW_INCONSISTENCY_EXCEPTION;
-   Publisher<SampleBlockCreateMessage>::Publish({});
+   if (BasicUI::IsUiThread())
+      Publisher<SampleBlockCreateMessage>::Publish({});
    return result;
 }
 
@@ -62,12 +79,37 @@ SampleBlockPtr SampleBlockFactory::CreateFromId(
    auto result = DoCreateFromId(srcformat, id);
    if (!result)
       THROW_INCONSISTENCY_EXCEPTION;
-   Publisher<SampleBlockCreateMessage>::Publish({});
+   if (BasicUI::IsUiThread())
+      Publisher<SampleBlockCreateMessage>::Publish({});
    return result;
 }
 
 SampleBlock::~SampleBlock() = default;
 
+bool SampleBlock::IsPending(bool) const noexcept
+{
+   return false;
+}
+
+namespace {
+thread_local unsigned sStandInScopes = 0;
+}
+
+SampleBlock::StandInScope::StandInScope()
+{
+   ++sStandInScopes;
+}
+
+SampleBlock::StandInScope::~StandInScope()
+{
+   --sStandInScopes;
+}
+
+bool SampleBlock::StandInScope::InEffect()
+{
+   return sStandInScopes > 0;
+}
+
 size_t SampleBlock::GetSamples(samplePtr dest,
                    sampleFormat destformat,
                    size_t sampleoffset,
@@ -16,6 +16,7 @@ SampleBlock.h
 #include <functional>
 #include <memory>
 #include <unordered_set>
+#include <utility>
 
 #include "Observer.h"
 #include "XMLTagHandler.h"
@@ -89,6 +90,24 @@ public:
 
    virtual void SaveXML(XMLWriter &xmlFile) = 0;
 
+   //! Whether the samples are not yet stored, as for a file that is imported
+   //! on demand; reading them waits until they are at least decoded
+   /*!
+    Default returns false
+    @param prefer if pending, make this block before others
+    */
+   virtual bool IsPending(bool prefer = false) const noexcept;
+
+   //! While one exists on this thread, SaveXML() of a pending block describes
+   //! silence, instead of waiting for the samples
+   struct WAVE_TRACK_API StandInScope {
+      StandInScope();
+      ~StandInScope();
+      StandInScope(const StandInScope&) = delete;
+      StandInScope &operator=(const StandInScope&) = delete;
+      static bool InEffect();
+   };
+
 protected:
    virtual size_t DoGetSamples(samplePtr dest,
                      sampleFormat destformat,
@@ -124,8 +143,32 @@ public:
    // Invoke the installed factory (throw an exception if none was installed)
    static SampleBlockFactoryPtr New( AudacityProject &project );
 
+   SampleBlockFactory();
    virtual ~SampleBlockFactory();
 
+   //! Distinguishes this factory from all others made in this session, as
+   //! block ids are unique only within one factory
+   unsigned long long GetSerialNumber() const { return mSerialNumber; }
+
+   //! While it lives, sequences that load from XML with the factory defer
+   //! making their blocks until they are first used
+   class LazyLoadingScope {
+   public:
+      LazyLoadingScope(SampleBlockFactory &factory, bool lazy)
+         : mFactory{ factory }
+         , mWasLazy{ std::exchange(factory.mLazyLoading, lazy) }
+      {}
+      ~LazyLoadingScope() { mFactory.mLazyLoading = mWasLazy; }
+      LazyLoadingScope(const LazyLoadingScope&) = delete;
+      LazyLoadingScope &operator=(const LazyLoadingScope&) = delete;
+   private:
+      SampleBlockFactory &mFactory;
+      const bool mWasLazy;
+   };
+
+   //! Whether a LazyLoadingScope for this factory asks for lazy loading
+   bool IsLazyLoading() const { return mLazyLoading; }
+
    // Returns a non-null pointer or else throws an exception
    SampleBlockPtr Create(constSamplePtr src,
       size_t numsamples,
@@ -169,6 +212,10 @@ protected:
 
    virtual SampleBlockPtr
    DoCreateFromId(sampleFormat srcformat, SampleBlockID id) = 0;
+
+private:
+   const unsigned long long mSerialNumber;
+   bool mLazyLoading{ false };
 };
 
 #endif
@@ -32,7 +32,8 @@
 #include "Sequence.h"
 
 #include <algorithm>
-#include <optional>
+#include <mutex>
+#include <utility>
 #include <float.h>
 #include <math.h>
 
@@ -47,8 +48,91 @@
 
 size_t Sequence::sMaxDiskBlockSize = 1048576;
 
-const char *Sequence::Sequence_tag = "sequence";
-const char *Sequence::WaveBlock_tag = "waveblock";
+namespace {
+// Serializes the making of blocks of lazily loaded sequences, which might be
+// first needed by a worker thread
+std::mutex sLazyMutex;
+}
+
+//! Block ids and starts read from a project document
+/*!
+ Shared among copies of a sequence, such as undo states, until each needs its
+ blocks.  The first to need them makes them, and the blocks are kept here so
+ that the others get the same SampleBlock objects:  a block must not be
+ deleted from the database while any copy might still refer to its id.
+ */
+struct Sequence::LazyBlocks
+{
+   struct Entry
+   {
+      SampleBlockID id;
+      sampleCount start;
+   };
+   //! Not changed after loading
+   std::vector<Entry> entries;
+   sampleFormat format{ floatSample };
+   sampleCount numSamples{ 0 };
+   //! Given to each copy as its array of blocks, copied when one changes
+   std::shared_ptr<BlockArray> blocks;
+
+   const std::shared_ptr<BlockArray> &Make(SampleBlockFactory &factory);
+};
+
+auto Sequence::LazyBlocks::Make(SampleBlockFactory &factory)
+   -> const std::shared_ptr<BlockArray> &
+{
+   if (blocks)
+      return blocks;
+
+   BlockArray result;
+   result.reserve(entries.size());
+   sampleCount pos = 0;
+   for (size_t ii = 0, nn = entries.size(); ii < nn; ++ii) {
+      const auto &entry = entries[ii];
+      SeqBlock::SampleBlockPtr sb;
+      try {
+         sb = factory.CreateFromId(format, entry.id);
+      }
+      catch (...) {
+      }
+      if (!sb) {
+         // Too late to fail the opening of the project; treat it as a
+         // missing block, as when the data of a block cannot be read
+         const auto end = ii + 1 < nn ? entries[ii + 1].start : numSamples;
+         const auto length = std::max<sampleCount>(end - entry.start, 0);
+         wxLogWarning(
+            wxT("Sample block %lld could not be loaded; replaced with silence."),
+            entry.id);
+         if (length == 0)
+            continue;
+         sb = factory.CreateSilent(length.as_size_t(), format);
+      }
+      if (entry.start != pos)
+         // As in HandleXMLEndTag
+         wxLogWarning(
+            wxT("Gap detected in project file.\n")
+            wxT("   Start (%s) for block file %lld is not one sample past end of previous block (%s).\n")
+            wxT("   Moving start so blocks are contiguous."),
+            Internat::ToString(entry.start.as_double(), 0),
+            entry.id,
+            Internat::ToString(pos.as_double(), 0));
+      result.push_back({ sb, pos });
+      pos += sb->GetSampleCount();
+   }
+   if (pos != numSamples) {
+      wxLogWarning(
+         wxT("Gap detected in project file. Correcting sequence sample count from %s to %s."),
+         Internat::ToString(numSamples.as_double(), 0),
+         Internat::ToString(pos.as_double(), 0));
+      numSamples = pos;
+   }
+
+   blocks = std::make_shared<BlockArray>(std::move(result));
+   return blocks;
+}
+
+const XMLName Sequence::Sequence_tag{ "sequence" };
+const XMLName Sequence::WaveBlock_tag{ "waveblock" };
 
 // Sequence methods
 Sequence::Sequence(
@@ -70,6 +154,25 @@ Sequence::Sequence(
    mMinSamples(orig.mMinSamples),
    mMaxSamples(orig.mMaxSamples)
 {
+   {
+      // Share blocks not yet made, rather than make them to copy them
+      std::lock_guard<std::mutex> lock{ sLazyMutex };
+      if (orig.mLazy.load(std::memory_order_relaxed) &&
+          pFactory == orig.mpFactory) {
+         mpLazyBlocks = orig.mpLazyBlocks;
+         mNumSamples = orig.mNumSamples;
+         mLazy.store(true, std::memory_order_relaxed);
+         return;
+      }
+   }
+   if (pFactory == orig.mpFactory) {
+      // Share the array of blocks, which is copied only when one of the
+      // sequences changes it.  The append buffer is not copied, as by Paste.
+      orig.Materialize();
+      mpBlock = orig.mpBlock;
+      mNumSamples = orig.mNumSamples;
+      return;
+   }
    Paste(0, &orig);
 }
 
@@ -89,8 +192,15 @@ size_t Sequence::GetIdealBlockSize() const
 
 bool Sequence::CloseLock() noexcept
 {
-   for (unsigned int i = 0; i < mBlock.size(); i++)
-      mBlock[i].sb->CloseLock();
+   {
+      // Blocks made for other copies may also be those of this sequence
+      std::lock_guard<std::mutex> lock{ sLazyMutex };
+      if (mLazy.load(std::memory_order_relaxed) && mpLazyBlocks->blocks)
+         for (auto &block : *mpLazyBlocks->blocks)
+            block.sb->CloseLock();
+   }
+   for (unsigned int i = 0; i < Blocks().size(); i++)
+      Blocks()[i].sb->CloseLock();
 
    return true;
 }
@@ -103,7 +213,7 @@ SampleFormats Sequence::GetSampleFormats() const
 /*
 bool Sequence::SetSampleFormat(sampleFormat format)
 {
-   if (mBlock.size() > 0 || mNumSamples > 0)
+   if (Blocks().size() > 0 || mNumSamples > 0)
       return false;
 
    mSampleFormat = format;
@@ -140,11 +250,12 @@ namespace {
 bool Sequence::ConvertToSampleFormat(sampleFormat format,
    const std::function<void(size_t)> & progressReport)
 {
+   Materialize();
    if (format == mSampleFormats.Stored())
       // no change
       return false;
 
-   if (mBlock.size() == 0)
+   if (Blocks().size() == 0)
    {
       // Effective format can be made narrowest when there is no content
       mSampleFormats = { narrowestSampleFormat, format };
@@ -177,7 +288,7 @@ bool Sequence::ConvertToSampleFormat(sampleFormat format,
    // Use the ratio of old to NEW mMaxSamples to make a reasonable guess
    // at allocation.
    newBlockArray.reserve
-      (1 + mBlock.size() * ((float)oldMaxSamples / (float)mMaxSamples));
+      (1 + Blocks().size() * ((float)oldMaxSamples / (float)mMaxSamples));
 
    {
       size_t oldSize = oldMaxSamples;
@@ -185,9 +296,9 @@ bool Sequence::ConvertToSampleFormat(sampleFormat format,
       size_t newSize = oldMaxSamples;
       SampleBuffer bufferNew(newSize, format);
 
-      for (size_t i = 0, nn = mBlock.size(); i < nn; i++)
+      for (size_t i = 0, nn = Blocks().size(); i < nn; i++)
       {
-         SeqBlock &oldSeqBlock = mBlock[i];
+         const SeqBlock &oldSeqBlock = Blocks()[i];
          const auto &oldBlockFile = oldSeqBlock.sb;
          const auto len = oldBlockFile->GetSampleCount();
          ensureSampleBufferSize(bufferOld, oldFormats.Stored(), oldSize, len);
@@ -241,7 +352,8 @@ bool Sequence::ConvertToSampleFormat(sampleFormat format,
 std::pair<float, float> Sequence::GetMinMax(
    sampleCount start, sampleCount len, bool mayThrow) const
 {
-   if (len == 0 || mBlock.size() == 0) {
+   Materialize();
+   if (len == 0 || Blocks().size() == 0) {
       return {
          0.f,
          // FLT_MAX?  So it doesn't look like a spurious '0' to a caller?
@@ -262,7 +374,7 @@ std::pair<float, float> Sequence::GetMinMax(
    // already in memory.
 
    for (unsigned b = block0 + 1; b < block1; ++b) {
-      auto results = mBlock[b].sb->GetMinMaxRMS(mayThrow);
+      auto results = Blocks()[b].sb->GetMinMaxRMS(mayThrow);
 
       if (results.min < min)
          min = results.min;
@@ -275,7 +387,7 @@ std::pair<float, float> Sequence::GetMinMax(
    // of either of these blocks is within min...max, then we can ignore them.
    // If not, we need read some samples and summaries from disk.
    {
-      const SeqBlock &theBlock = mBlock[block0];
+      const SeqBlock &theBlock = Blocks()[block0];
       const auto &theFile = theBlock.sb;
       auto results = theFile->GetMinMaxRMS(mayThrow);
 
@@ -299,7 +411,7 @@ std::pair<float, float> Sequence::GetMinMax(
 
    if (block1 > block0)
    {
-      const SeqBlock &theBlock = mBlock[block1];
+      const SeqBlock &theBlock = Blocks()[block1];
       const auto &theFile = theBlock.sb;
       auto results = theFile->GetMinMaxRMS(mayThrow);
 
@@ -322,9 +434,10 @@ std::pair<float, float> Sequence::GetMinMax(
 
 float Sequence::GetRMS(sampleCount start, sampleCount len, bool mayThrow) const
 {
+   Materialize();
    // len is the number of samples that we want the rms of.
    // it may be longer than a block, and the code is carefully set up to handle that.
-   if (len == 0 || mBlock.size() == 0)
+   if (len == 0 || Blocks().size() == 0)
       return 0.f;
 
    double sumsq = 0.0;
@@ -337,7 +450,7 @@ float Sequence::GetRMS(sampleCount start, sampleCount len, bool mayThrow) const
    // this is very fast because we have the rms of every entire block
    // already in memory.
    for (unsigned b = block0 + 1; b < block1; b++) {
-      const SeqBlock &theBlock = mBlock[b];
+      const SeqBlock &theBlock = Blocks()[b];
       const auto &sb = theBlock.sb;
       auto results = sb->GetMinMaxRMS(mayThrow);
 
@@ -351,7 +464,7 @@ float Sequence::GetRMS(sampleCount start, sampleCount len, bool mayThrow) const
    // selection may only partly overlap these blocks.
    // If not, we need read some samples and summaries from disk.
    {
-      const SeqBlock &theBlock = mBlock[block0];
+      const SeqBlock &theBlock = Blocks()[block0];
       const auto &sb = theBlock.sb;
       // start lies within theBlock
       auto s0 = ( start - theBlock.start ).as_size_t();
@@ -368,7 +481,7 @@ float Sequence::GetRMS(sampleCount start, sampleCount len, bool mayThrow) const
    }
 
    if (block1 > block0) {
-      const SeqBlock &theBlock = mBlock[block1];
+      const SeqBlock &theBlock = Blocks()[block1];
       const auto &sb = theBlock.sb;
 
       // start + len - 1 lies within theBlock
@@ -392,6 +505,7 @@ float Sequence::GetRMS(sampleCount start, sampleCount len, bool mayThrow) const
 std::unique_ptr<Sequence> Sequence::Copy( const SampleBlockFactoryPtr &pFactory,
    sampleCount s0, sampleCount s1) const
 {
+   Materialize();
    // Make a new Sequence object for the specified factory:
    auto dest = std::make_unique<Sequence>(pFactory, mSampleFormats);
    if (s0 >= s1 || s0 >= mNumSamples || s1 < 0) {
@@ -402,7 +516,7 @@ std::unique_ptr<Sequence> Sequence::Copy( const SampleBlockFactoryPtr &pFactory,
    // contents are used -- must copy if factories are different:
    auto pUseFactory = (pFactory == mpFactory) ? nullptr : pFactory.get();
 
-   int numBlocks = mBlock.size();
+   int numBlocks = Blocks().size();
 
    int b0 = FindBlock(s0);
    const int b1 = FindBlock(s1 - 1);
@@ -412,7 +526,8 @@ std::unique_ptr<Sequence> Sequence::Copy( const SampleBlockFactoryPtr &pFactory,
    wxUnusedVar(numBlocks);
    wxASSERT(b0 <= b1);
 
-   dest->mBlock.reserve(b1 - b0 + 1);
+   auto &destBlocks = dest->MutableBlocks();
+   destBlocks.reserve(b1 - b0 + 1);
 
    auto bufferSize = mMaxSamples;
    const auto format = mSampleFormats.Stored();
@@ -422,7 +537,7 @@ std::unique_ptr<Sequence> Sequence::Copy( const SampleBlockFactoryPtr &pFactory,
 
    // Do any initial partial block
 
-   const SeqBlock &block0 = mBlock[b0];
+   const SeqBlock &block0 = Blocks()[b0];
    if (s0 != block0.start) {
       const auto &sb = block0.sb;
       // Nonnegative result is length of block0 or less:
@@ -442,13 +557,13 @@ std::unique_ptr<Sequence> Sequence::Copy( const SampleBlockFactoryPtr &pFactory,
    // If there are blocks in the middle, use the blocks whole
    for (int bb = b0 + 1; bb < b1; ++bb)
       AppendBlock(pUseFactory, format,
-         dest->mBlock, dest->mNumSamples, mBlock[bb]);
+         destBlocks, dest->mNumSamples, Blocks()[bb]);
       // Increase ref count or duplicate file
 
    // Do the last block
    if (b1 > b0) {
       // Probable case of a partial block
-      const SeqBlock &block = mBlock[b1];
+      const SeqBlock &block = Blocks()[b1];
       const auto &sb = block.sb;
       // s1 is within block:
       blocklen = (s1 - block.start).as_size_t();
@@ -463,7 +578,7 @@ std::unique_ptr<Sequence> Sequence::Copy( const SampleBlockFactoryPtr &pFactory,
       else
          // Special case of a whole block
          AppendBlock(pUseFactory, format,
-            dest->mBlock, dest->mNumSamples, block);
+            destBlocks, dest->mNumSamples, block);
          // Increase ref count or duplicate file
    }
 
@@ -498,6 +613,8 @@ namespace {
 /*! @excsafety{Strong} */
 void Sequence::Paste(sampleCount s, const Sequence *src)
 {
+   Materialize();
+   src->Materialize();
    if ((s < 0) || (s > mNumSamples))
    {
       wxLogError(
@@ -529,7 +646,7 @@ void Sequence::Paste(sampleCount s, const Sequence *src)
       THROW_INCONSISTENCY_EXCEPTION;
    }
 
-   const BlockArray &srcBlock = src->mBlock;
+   const BlockArray &srcBlock = src->Blocks();
    auto addedLen = src->mNumSamples;
    const unsigned int srcNumBlocks = srcBlock.size();
    auto sampleSize = SAMPLE_SIZE(format);
@@ -537,7 +654,7 @@ void Sequence::Paste(sampleCount s, const Sequence *src)
    if (addedLen == 0 || srcNumBlocks == 0)
       return;
 
-   const size_t numBlocks = mBlock.size();
+   const size_t numBlocks = Blocks().size();
 
    // Decide whether to share sample blocks or make new copies, when whole block
    // contents are used -- must copy if factories are different:
@@ -545,13 +662,13 @@ void Sequence::Paste(sampleCount s, const Sequence *src)
       (src->mpFactory == mpFactory) ? nullptr : mpFactory.get();
 
    if (numBlocks == 0 ||
-       (s == mNumSamples && mBlock.back().sb->GetSampleCount() >= mMinSamples)) {
+       (s == mNumSamples && Blocks().back().sb->GetSampleCount() >= mMinSamples)) {
       // Special case: this track is currently empty, or it's safe to append
       // onto the end because the current last block is longer than the
       // minimum size
 
       // Build and swap a copy so there is a strong exception safety guarantee
-      BlockArray newBlock{ mBlock };
+      BlockArray newBlock{ Blocks() };
       sampleCount samples = mNumSamples;
       for (unsigned int i = 0; i < srcNumBlocks; i++)
          // AppendBlock may throw for limited disk space, if pasting from
@@ -565,9 +682,9 @@ void Sequence::Paste(sampleCount s, const Sequence *src)
       return;
    }
 
-   const int b = (s == mNumSamples) ? mBlock.size() - 1 : FindBlock(s);
+   const int b = (s == mNumSamples) ? Blocks().size() - 1 : FindBlock(s);
    wxASSERT((b >= 0) && (b < (int)numBlocks));
-   SeqBlock *const pBlock = &mBlock[b];
+   const SeqBlock *const pBlock = &Blocks()[b];
    const auto length = pBlock->sb->GetSampleCount();
    const auto largerBlockLen = addedLen + length;
    // PRL: when insertion point is the first sample of a block,
@@ -577,7 +694,7 @@ void Sequence::Paste(sampleCount s, const Sequence *src)
       // Special case: we can fit all of the NEW samples inside of
       // one block!
 
-      SeqBlock &block = *pBlock;
+      const SeqBlock &block = *pBlock;
       // largerBlockLen is not more than mMaxSamples...
       SampleBuffer buffer(largerBlockLen.as_size_t(), format);
 
@@ -593,17 +710,19 @@ void Sequence::Paste(sampleCount s, const Sequence *src)
            splitPoint, length - splitPoint, true);
 
       // largerBlockLen is not more than mMaxSamples...
-      block.sb = mpFactory->Create(
+      auto sb = mpFactory->Create(
          buffer.ptr(),
          largerBlockLen.as_size_t(),
          format);
 
-      // Don't make a duplicate array.  We can still give Strong-guarantee
-      // if we modify only one block in place.
+      // Don't make a duplicate array, unless it is shared.  We can still
+      // give Strong-guarantee if we modify only one block in place.
+      auto &blocks = MutableBlocks();
+      blocks[b].sb = std::move(sb);
 
       // use No-fail-guarantee in remaining steps
       for (unsigned int i = b + 1; i < numBlocks; i++)
-         mBlock[i].start += addedLen;
+         blocks[i].start += addedLen;
 
       mNumSamples += addedLen;
 
@@ -620,9 +739,9 @@ void Sequence::Paste(sampleCount s, const Sequence *src)
    // then resplit it all
    BlockArray newBlock;
    newBlock.reserve(numBlocks + srcNumBlocks + 2);
-   newBlock.insert(newBlock.end(), mBlock.begin(), mBlock.begin() + b);
+   newBlock.insert(newBlock.end(), Blocks().begin(), Blocks().begin() + b);
 
-   SeqBlock &splitBlock = mBlock[b];
+   const SeqBlock &splitBlock = Blocks()[b];
    auto splitLen = splitBlock.sb->GetSampleCount();
    // s lies within splitBlock
    auto splitPoint = ( s - splitBlock.start ).as_size_t();
@@ -693,7 +812,7 @@ void Sequence::Paste(sampleCount s, const Sequence *src)
    // Copy remaining blocks to NEW block array and
    // swap the NEW block array in for the old
    for (i = b + 1; i < numBlocks; i++)
-      newBlock.push_back(mBlock[i].Plus(addedLen));
+      newBlock.push_back(Blocks()[i].Plus(addedLen));
 
    CommitChangesIfConsistent
       (newBlock, mNumSamples + addedLen, wxT("Paste branch three"));
@@ -711,6 +830,7 @@ void Sequence::SetSilence(sampleCount s0, sampleCount len)
 /*! @excsafety{Strong} */
 void Sequence::InsertSilence(sampleCount s0, sampleCount len)
 {
+   Materialize();
    auto &factory = *mpFactory;
 
    // Quick check to make sure that it doesn't overflow
@@ -732,7 +852,8 @@ void Sequence::InsertSilence(sampleCount s0, sampleCount len)
    // Could nBlocks overflow a size_t?  Not very likely.  You need perhaps
    // 2 ^ 52 samples which is over 3000 years at 44.1 kHz.
    auto nBlocks = (len + idealSamples - 1) / idealSamples;
-   sTrack.mBlock.reserve(nBlocks.as_size_t());
+   auto &silentBlocks = sTrack.MutableBlocks();
+   silentBlocks.reserve(nBlocks.as_size_t());
 
    const auto format = mSampleFormats.Stored();
    if (len >= idealSamples) {
@@ -740,7 +861,7 @@ void Sequence::InsertSilence(sampleCount s0, sampleCount len)
          idealSamples,
          format);
       while (len >= idealSamples) {
-         sTrack.mBlock.push_back(SeqBlock(silentFile, pos));
+         silentBlocks.push_back(SeqBlock(silentFile, pos));
 
          pos += idealSamples;
          len -= idealSamples;
@@ -748,7 +869,7 @@ void Sequence::InsertSilence(sampleCount s0, sampleCount len)
    }
    if (len != 0) {
       // len is not more than idealSamples:
-      sTrack.mBlock.push_back(SeqBlock(
+      silentBlocks.push_back(SeqBlock(
          factory.CreateSilent(len.as_size_t(), format), pos));
       pos += len;
    }
@@ -780,12 +901,14 @@ void Sequence::AppendBlock( SampleBlockFactory *pFactory, sampleFormat format,
 
 sampleCount Sequence::GetBlockStart(sampleCount position) const
 {
+   Materialize();
    int b = FindBlock(position);
-   return mBlock[b].start;
+   return Blocks()[b].start;
 }
 
 size_t Sequence::GetBestBlockSize(sampleCount start) const
 {
+   Materialize();
    // This method returns a nice number of samples you should try to grab in
    // one big chunk in order to land on a block boundary, based on the starting
    // sample.  The value returned will always be nonzero and will be no larger
@@ -795,15 +918,15 @@ size_t Sequence::GetBestBlockSize(sampleCount start) const
       return mMaxSamples;
 
    int b = FindBlock(start);
-   int numBlocks = mBlock.size();
+   int numBlocks = Blocks().size();
 
-   const SeqBlock &block = mBlock[b];
+   const SeqBlock &block = Blocks()[b];
    // start is in block:
    auto result = (block.start + block.sb->GetSampleCount() - start).as_size_t();
 
    decltype(result) length;
    while(result < mMinSamples && b+1<numBlocks &&
-         ((length = mBlock[b+1].sb->GetSampleCount()) + result) <= mMaxSamples) {
+         ((length = Blocks()[b+1].sb->GetSampleCount()) + result) <= mMaxSamples) {
       b++;
       result += length;
    }
@@ -813,17 +936,61 @@ size_t Sequence::GetBestBlockSize(sampleCount start) const
    return result;
 }
 
-static constexpr auto Start_attr = "start";
-static constexpr auto MaxSamples_attr = "maxsamples";
-static constexpr auto SampleFormat_attr = "sampleformat";
-static constexpr auto EffectiveSampleFormat_attr = "effectivesampleformat";
-static constexpr auto NumSamples_attr = "numsamples";
+static const XMLName Start_attr{ "start" };
+static const XMLName MaxSamples_attr{ "maxsamples" };
+static const XMLName SampleFormat_attr{ "sampleformat" };
+static const XMLName EffectiveSampleFormat_attr{ "effectivesampleformat" };
+static const XMLName NumSamples_attr{ "numsamples" };
+// Written by SqliteSampleBlock::SaveXML; read and written here only for
+// blocks loaded lazily
+static const XMLName BlockID_attr{ "blockid" };
 
 bool Sequence::HandleXMLTag(const std::string_view& tag, const AttributesList &attrs)
 {
    auto &factory = *mpFactory;
 
    /* handle waveblock tag and its attributes */
+   if (tag == WaveBlock_tag && mpLazyBlocks)
+   {
+      // Remember just the id; see Materialize()
+      std::optional<SampleBlockID> id;
+      sampleCount::type start = 0;
+      for (auto pair : attrs)
+      {
+         auto attr = pair.first;
+         auto value = pair.second;
+
+         if (attr == BlockID_attr)
+         {
+            long long nValue;
+            if (!value.TryGet(nValue))
+            {
+               mErrorOpening = true;
+               return false;
+            }
+            id = nValue;
+         }
+         else if (attr == Start_attr)
+         {
+            if (!value.TryGet(start))
+            {
+               mErrorOpening = true;
+               return false;
+            }
+         }
+      }
+
+      if (!id)
+      {
+         mErrorOpening = true;
+         return false;
+      }
+
+      mpLazyBlocks->entries.push_back({ *id, start });
+
+      return true;
+   }
+
    if (tag == WaveBlock_tag)
    {
       SeqBlock wb;
@@ -857,7 +1024,7 @@ bool Sequence::HandleXMLTag(const std::string_view& tag, const AttributesList &a
          }
       }
 
-      mBlock.push_back(wb);
+      MutableBlocks().push_back(wb);
 
       return true;
    }
@@ -942,6 +1109,9 @@ bool Sequence::HandleXMLTag(const std::string_view& tag, const AttributesList &a
          return false;
       }
 
+      if (mpFactory->IsLazyLoading())
+         mpLazyBlocks = std::make_shared<LazyBlocks>();
+
       return true;
    }
 
@@ -955,13 +1125,29 @@ void Sequence::HandleXMLEndTag(const std::string_view& tag)
       return;
    }
 
+   if (mpLazyBlocks)
+   {
+      if (mpLazyBlocks->entries.empty())
+         mpLazyBlocks.reset();
+      else
+      {
+         mpLazyBlocks->entries.shrink_to_fit();
+         mpLazyBlocks->format = mSampleFormats.Stored();
+         mpLazyBlocks->numSamples = mNumSamples;
+         // Starts and lengths are checked when the blocks are made
+         mLazy.store(true, std::memory_order_release);
+         return;
+      }
+   }
+
    // Make sure that the sequence is valid.
 
    // Make sure that start times and lengths are consistent
    sampleCount numSamples = 0;
-   for (unsigned b = 0, nn = mBlock.size(); b < nn;  b++)
+   auto &blocks = MutableBlocks();
+   for (unsigned b = 0, nn = blocks.size(); b < nn;  b++)
    {
-      SeqBlock &block = mBlock[b];
+      SeqBlock &block = blocks[b];
       if (block.start != numSamples)
       {
          wxLogWarning(
@@ -1016,8 +1202,26 @@ void Sequence::WriteXML(XMLWriter &xmlFile) const
       static_cast<size_t>( mSampleFormats.Effective() ));
    xmlFile.WriteAttr(NumSamples_attr, mNumSamples.as_long_long() );
 
-   for (b = 0; b < mBlock.size(); b++) {
-      const SeqBlock &bb = mBlock[b];
+   std::shared_ptr<LazyBlocks> pLazyBlocks;
+   {
+      std::lock_guard<std::mutex> lock{ sLazyMutex };
+      if (mLazy.load(std::memory_order_relaxed))
+         pLazyBlocks = mpLazyBlocks;
+   }
+   if (pLazyBlocks) {
+      // Write again what was read, without making the blocks
+      for (const auto &entry : pLazyBlocks->entries) {
+         xmlFile.StartTag(WaveBlock_tag);
+         xmlFile.WriteAttr(Start_attr, entry.start.as_long_long());
+         xmlFile.WriteAttr(BlockID_attr, entry.id);
+         xmlFile.EndTag(WaveBlock_tag);
+      }
+      xmlFile.EndTag(Sequence_tag);
+      return;
+   }
+
+   for (b = 0; b < Blocks().size(); b++) {
+      const SeqBlock &bb = Blocks()[b];
 
       // See http://bugzilla.audacityteam.org/show_bug.cgi?id=451.
       if (bb.sb->GetSampleCount() > mMaxSamples)
@@ -1052,14 +1256,57 @@ void Sequence::WriteXML(XMLWriter &xmlFile) const
    xmlFile.EndTag(Sequence_tag);
 }
 
+void Sequence::Materialize() const
+{
+   if (!mLazy.load(std::memory_order_acquire))
+      return;
+   std::lock_guard<std::mutex> lock{ sLazyMutex };
+   if (!mLazy.load(std::memory_order_relaxed))
+      return;
+
+   // The contents of the sequence do not change
+   auto &self = const_cast<Sequence &>(*this);
+   // Share the array with other copies that make it
+   self.mpBlock = self.mpLazyBlocks->Make(*mpFactory);
+   if (mNumSamples != mpLazyBlocks->numSamples)
+      // The document was inconsistent
+      self.mNumSamples = mpLazyBlocks->numSamples;
+   self.mpLazyBlocks.reset();
+   mLazy.store(false, std::memory_order_release);
+}
+
+BlockArray &Sequence::MutableBlocks()
+{
+   if (mpBlock.use_count() > 1)
+      mpBlock = std::make_shared<BlockArray>(*mpBlock);
+   return *mpBlock;
+}
+
+size_t Sequence::GetBlockArrayBytes() const
+{
+   Materialize();
+   return sizeof(BlockArray) + Blocks().capacity() * sizeof(SeqBlock);
+}
+
+void Sequence::VisitLazyBlockIDs(
+   const std::function<void(long long)> &visitor) const
+{
+   std::lock_guard<std::mutex> lock{ sLazyMutex };
+   if (!mLazy.load(std::memory_order_relaxed))
+      return;
+   for (const auto &entry : mpLazyBlocks->entries)
+      visitor(entry.id);
+}
+
 int Sequence::FindBlock(sampleCount pos) const
 {
+   Materialize();
    wxASSERT(pos >= 0 && pos < mNumSamples);
 
    if (pos == 0)
       return 0;
 
-   int numBlocks = mBlock.size();
+   int numBlocks = Blocks().size();
 
    size_t lo = 0, hi = numBlocks, guess;
    sampleCount loSamples = 0, hiSamples = mNumSamples;
@@ -1071,7 +1318,7 @@ int Sequence::FindBlock(sampleCount pos) const
       const double frac = (pos - loSamples).as_double() /
          (hiSamples - loSamples).as_double();
       guess = std::min(hi - 1, lo + size_t(frac * (hi - lo)));
-      const SeqBlock &block = mBlock[guess];
+      const SeqBlock &block = Blocks()[guess];
 
       wxASSERT(block.sb->GetSampleCount() > 0);
       wxASSERT(lo <= guess && guess < hi && lo < hi);
@@ -1095,8 +1342,8 @@ int Sequence::FindBlock(sampleCount pos) const
 
    const int rval = guess;
    wxASSERT(rval >= 0 && rval < numBlocks &&
-            pos >= mBlock[rval].start &&
-            pos < mBlock[rval].start + mBlock[rval].sb->GetSampleCount());
+            pos >= Blocks()[rval].start &&
+            pos < Blocks()[rval].start + Blocks()[rval].sb->GetSampleCount());
 
    return rval;
 }
@@ -1126,6 +1373,7 @@ bool Sequence::Read(samplePtr buffer, sampleFormat format,
 AudioSegmentSampleView Sequence::GetFloatSampleView(
    sampleCount start, size_t length, bool mayThrow) const
 {
+   Materialize();
    assert(start < mNumSamples);
    length = limitSampleBufferSize(length, mNumSamples - start);
    std::vector<BlockSampleView> blockViews;
@@ -1136,7 +1384,7 @@ AudioSegmentSampleView Sequence::GetFloatSampleView(
    while (cursor < start + length)
    {
       const auto b = FindBlock(cursor);
-      const SeqBlock& block = mBlock[b];
+      const SeqBlock& block = Blocks()[b];
       blockViews.push_back(block.sb->GetFloatSampleView(mayThrow));
       cursor = block.start + block.sb->GetSampleCount();
    }
@@ -1185,9 +1433,10 @@ bool Sequence::Get(samplePtr buffer, sampleFormat format,
 bool Sequence::Get(int b, samplePtr buffer, sampleFormat format,
    sampleCount start, size_t len, bool mayThrow) const
 {
+   Materialize();
    bool result = true;
    while (len) {
-      const SeqBlock &block = mBlock[b];
+      const SeqBlock &block = Blocks()[b];
       // start is in block
       const auto bstart = (start - block.start).as_size_t();
       // bstart is not more than block length
@@ -1209,10 +1458,11 @@ bool Sequence::Get(int b, samplePtr buffer, sampleFormat format,
 void Sequence::SetSamples(constSamplePtr buffer, sampleFormat format,
    sampleCount start, sampleCount len, sampleFormat effectiveFormat)
 {
+   Materialize();
    effectiveFormat = std::min(effectiveFormat, format);
    auto &factory = *mpFactory;
 
-   const auto size = mBlock.size();
+   const auto size = Blocks().size();
 
    if (start < 0 || start + len > mNumSamples)
       THROW_INCONSISTENCY_EXCEPTION;
@@ -1229,7 +1479,7 @@ void Sequence::SetSamples(constSamplePtr buffer, sampleFormat format,
 
    int b = FindBlock(start);
    BlockArray newBlock;
-   std::copy( mBlock.begin(), mBlock.begin() + b, std::back_inserter(newBlock) );
+   std::copy( Blocks().begin(), Blocks().begin() + b, std::back_inserter(newBlock) );
 
    while (len > 0
       // Redundant termination condition,
@@ -1238,7 +1488,7 @@ void Sequence::SetSamples(constSamplePtr buffer, sampleFormat format,
       // that cause the loop to make no progress because blen == 0
       && b < (int)size
    ) {
-      newBlock.push_back( mBlock[b] );
+      newBlock.push_back( Blocks()[b] );
       SeqBlock &block = newBlock.back();
       // start is within block
       const auto bstart = ( start - block.start ).as_size_t();
@@ -1315,7 +1565,7 @@ void Sequence::SetSamples(constSamplePtr buffer, sampleFormat format,
       b++;
    }
 
-   std::copy( mBlock.begin() + b, mBlock.end(), std::back_inserter(newBlock) );
+   std::copy( Blocks().begin() + b, Blocks().end(), std::back_inserter(newBlock) );
 
    CommitChangesIfConsistent( newBlock, mNumSamples, wxT("SetSamples") );
 
@@ -1324,13 +1574,14 @@ void Sequence::SetSamples(constSamplePtr buffer, sampleFormat format,
 
 size_t Sequence::GetIdealAppendLen() const
 {
-   int numBlocks = mBlock.size();
+   Materialize();
+   int numBlocks = Blocks().size();
    const auto max = GetMaxBlockSize();
 
    if (numBlocks == 0)
       return max;
 
-   const auto lastBlockLen = mBlock.back().sb->GetSampleCount();
+   const auto lastBlockLen = Blocks().back().sb->GetSampleCount();
    if (lastBlockLen >= max)
       return max;
    else
@@ -1349,8 +1600,10 @@ SeqBlock::SampleBlockPtr Sequence::AppendNewBlock(
 }
 
 /*! @excsafety{Strong} */
-void Sequence::AppendSharedBlock(const SeqBlock::SampleBlockPtr &pBlock)
+void Sequence::AppendSharedBlock(const SeqBlock::SampleBlockPtr &pBlock,
+   sampleFormat effectiveFormat)
 {
+   Materialize();
    auto len = pBlock->GetSampleCount();
 
    // Quick check to make sure that it doesn't overflow
@@ -1363,6 +1616,7 @@ void Sequence::AppendSharedBlock(const SeqBlock::SampleBlockPtr &pBlock)
 
    AppendBlocksIfConsistent(newBlock, false,
                             newNumSamples, wxT("Append"));
+   mSampleFormats.UpdateEffective(effectiveFormat);
 
 // JKC: During generate we use Append again and again.
 // If generating a long sequence this test would give O(n^2)
@@ -1405,6 +1659,24 @@ bool Sequence::Append(
       if (len == 0)
          break;
 
+      if (mAppendBufferLen == 0 && len >= blockSize &&
+          format == seqFormat && stride == 1) {
+         // Whole blocks that need no conversion (and so no dithering) are
+         // made directly from the given buffer, sparing a copy into
+         // mAppendBuffer
+         // use Strong-guarantee
+         DoAppend(buffer, format, blockSize, true);
+         mAppendEffectiveFormat =
+            std::max(mAppendEffectiveFormat, effectiveFormat);
+         mSampleFormats.UpdateEffective(mAppendEffectiveFormat);
+         result = true;
+
+         buffer += blockSize * SAMPLE_SIZE(format);
+         len -= blockSize;
+         blockSize = GetIdealAppendLen();
+         continue;
+      }
+
       // use No-fail-guarantee for rest of this "for"
       wxASSERT(mAppendBufferLen <= mMaxSamples);
       auto toCopy = std::min(len, mMaxSamples - mAppendBufferLen);
@@ -1431,6 +1703,7 @@ bool Sequence::Append(
 SeqBlock::SampleBlockPtr Sequence::DoAppend(
    constSamplePtr buffer, sampleFormat format, size_t len, bool coalesce)
 {
+   Materialize();
    SeqBlock::SampleBlockPtr result;
 
    if (len == 0)
@@ -1446,8 +1719,8 @@ SeqBlock::SampleBlockPtr Sequence::DoAppend(
    sampleCount newNumSamples = mNumSamples;
 
    // If the last block is not full, we need to add samples to it
-   int numBlocks = mBlock.size();
-   SeqBlock *pLastBlock;
+   int numBlocks = Blocks().size();
+   const SeqBlock *pLastBlock;
    decltype(pLastBlock->sb->GetSampleCount()) length;
    size_t bufferSize = mMaxSamples;
    const auto dstFormat = mSampleFormats.Stored();
@@ -1456,7 +1729,7 @@ SeqBlock::SampleBlockPtr Sequence::DoAppend(
    if (coalesce &&
        numBlocks > 0 &&
        (length =
-        (pLastBlock = &mBlock.back())->sb->GetSampleCount()) < mMinSamples) {
+        (pLastBlock = &Blocks().back())->sb->GetSampleCount()) < mMinSamples) {
       // Enlarge a sub-minimum block at the end
       const SeqBlock &lastBlock = *pLastBlock;
       const auto addLen = std::min(mMaxSamples - length, len);
@@ -1578,6 +1851,7 @@ void Sequence::Blockify(SampleBlockFactory &factory,
 /*! @excsafety{Strong} */
 void Sequence::Delete(sampleCount start, sampleCount len)
 {
+   Materialize();
    if (len == 0)
       return;
 
@@ -1586,7 +1860,7 @@ void Sequence::Delete(sampleCount start, sampleCount len)
 
    auto &factory = *mpFactory;
 
-   const unsigned int numBlocks = mBlock.size();
+   const unsigned int numBlocks = Blocks().size();
 
    const unsigned int b0 = FindBlock(start);
    unsigned int b1 = FindBlock(start + len - 1);
@@ -1594,7 +1868,7 @@ void Sequence::Delete(sampleCount start, sampleCount len)
    const auto format = mSampleFormats.Stored();
    auto sampleSize = SAMPLE_SIZE(format);
 
-   SeqBlock *pBlock;
+   const SeqBlock *pBlock;
    decltype(pBlock->sb->GetSampleCount()) length;
 
    // One buffer for reuse in various branches here
@@ -1606,8 +1880,8 @@ void Sequence::Delete(sampleCount start, sampleCount len)
    // block and the resulting length is not too small, perform the
    // deletion within this block:
    if (b0 == b1 &&
-       (length = (pBlock = &mBlock[b0])->sb->GetSampleCount()) - len >= mMinSamples) {
-      SeqBlock &b = *pBlock;
+       (length = (pBlock = &Blocks()[b0])->sb->GetSampleCount()) - len >= mMinSamples) {
+      const SeqBlock &b = *pBlock;
       // start is within block
       auto pos = ( start - b.start ).as_size_t();
 
@@ -1628,15 +1902,17 @@ void Sequence::Delete(sampleCount start, sampleCount len)
            // is not more than the length of the block
            ( pos + len ).as_size_t(), newLen - pos, true);
 
-      b.sb = factory.Create(scratch.ptr(), newLen, format);
+      auto sb = factory.Create(scratch.ptr(), newLen, format);
 
-      // Don't make a duplicate array.  We can still give Strong-guarantee
-      // if we modify only one block in place.
+      // Don't make a duplicate array, unless it is shared.  We can still
+      // give Strong-guarantee if we modify only one block in place.
+      auto &blocks = MutableBlocks();
+      blocks[b0].sb = std::move(sb);
 
       // use No-fail-guarantee in remaining steps
 
       for (unsigned int j = b0 + 1; j < numBlocks; j++)
-         mBlock[j].start -= len;
+         blocks[j].start -= len;
 
       mNumSamples -= len;
 
@@ -1652,7 +1928,7 @@ void Sequence::Delete(sampleCount start, sampleCount len)
 
    // Copy the blocks before the deletion point over to
    // the NEW array
-   newBlock.insert(newBlock.end(), mBlock.begin(), mBlock.begin() + b0);
+   newBlock.insert(newBlock.end(), Blocks().begin(), Blocks().begin() + b0);
    unsigned int i;
 
    // First grab the samples in block b0 before the deletion point
@@ -1660,7 +1936,7 @@ void Sequence::Delete(sampleCount start, sampleCount len)
    // or if this would be the first block in the array, write it out.
    // Otherwise combine it with the previous block (splitting them
    // 50/50 if necessary).
-   const SeqBlock &preBlock = mBlock[b0];
+   const SeqBlock &preBlock = Blocks()[b0];
    // start is within preBlock
    auto preBufferLen = ( start - preBlock.start ).as_size_t();
    if (preBufferLen) {
@@ -1674,7 +1950,7 @@ void Sequence::Delete(sampleCount start, sampleCount len)
 
          newBlock.push_back(SeqBlock(pFile, preBlock.start));
       } else {
-         const SeqBlock &prepreBlock = mBlock[b0 - 1];
+         const SeqBlock &prepreBlock = Blocks()[b0 - 1];
          const auto prepreLen = prepreBlock.sb->GetSampleCount();
          const auto sum = prepreLen + preBufferLen;
 
@@ -1702,7 +1978,7 @@ void Sequence::Delete(sampleCount start, sampleCount len)
    // for its own block, or if this would be the last block in
    // the array, write it out.  Otherwise combine it with the
    // subsequent block (splitting them 50/50 if necessary).
-   const SeqBlock &postBlock = mBlock[b1];
+   const SeqBlock &postBlock = Blocks()[b1];
    // start + len - 1 lies within postBlock
    const auto postBufferLen = (
        (postBlock.start + postBlock.sb->GetSampleCount()) - (start + len)
@@ -1720,7 +1996,7 @@ void Sequence::Delete(sampleCount start, sampleCount len)
 
          newBlock.push_back(SeqBlock(file, start));
       } else {
-         SeqBlock &postpostBlock = mBlock[b1 + 1];
+         const SeqBlock &postpostBlock = Blocks()[b1 + 1];
          const auto postpostLen = postpostBlock.sb->GetSampleCount();
          const auto sum = postpostLen + postBufferLen;
 
@@ -1745,7 +2021,7 @@ void Sequence::Delete(sampleCount start, sampleCount len)
 
    // Copy the remaining blocks over from the old array
    for (i = b1 + 1; i < numBlocks; i++)
-      newBlock.push_back(mBlock[i].Plus(-len));
+      newBlock.push_back(Blocks()[i].Plus(-len));
 
    CommitChangesIfConsistent
       (newBlock, mNumSamples - len, wxT("Delete - branch two"));
@@ -1753,7 +2029,8 @@ void Sequence::Delete(sampleCount start, sampleCount len)
 
 void Sequence::ConsistencyCheck(const wxChar *whereStr, bool mayThrow) const
 {
-   ConsistencyCheck(mBlock, mMaxSamples, 0, mNumSamples, whereStr, mayThrow);
+   Materialize();
+   ConsistencyCheck(Blocks(), mMaxSamples, 0, mNumSamples, whereStr, mayThrow);
 }
 
 void Sequence::ConsistencyCheck
@@ -1812,10 +2089,16 @@ void Sequence::CommitChangesIfConsistent
 {
    ConsistencyCheck( newBlock, mMaxSamples, 0, numSamples, whereStr ); // may throw
 
+   // Don't change an array shared with copies; allocate its replacement
+   // before the steps that must not fail
+   auto pBlock = mpBlock.use_count() > 1
+      ? std::make_shared<BlockArray>() : mpBlock;
+
    // now commit
    // use No-fail-guarantee
 
-   mBlock.swap(newBlock);
+   pBlock->swap(newBlock);
+   mpBlock = std::move(pBlock);
    mNumSamples = numSamples;
 }
 
@@ -1832,28 +2115,29 @@ void Sequence::AppendBlocksIfConsistent
    bool tmpValid = false;
    SeqBlock tmp;
 
-   if ( replaceLast && ! mBlock.empty() ) {
-      tmp = mBlock.back(), tmpValid = true;
-      mBlock.pop_back();
+   auto &blocks = MutableBlocks();
+   if ( replaceLast && ! blocks.empty() ) {
+      tmp = blocks.back(), tmpValid = true;
+      blocks.pop_back();
    }
 
-   auto prevSize = mBlock.size();
+   auto prevSize = blocks.size();
 
    bool consistent = false;
    auto cleanup = finally( [&] {
       if ( !consistent ) {
-         mBlock.resize( prevSize );
+         blocks.resize( prevSize );
          if ( tmpValid )
-            mBlock.push_back( tmp );
+            blocks.push_back( tmp );
       }
    } );
 
    std::copy( additionalBlocks.begin(), additionalBlocks.end(),
-              std::back_inserter( mBlock ) );
+              std::back_inserter( blocks ) );
 
    // Check consistency only of the blocks that were added,
    // avoiding quadratic time for repeated checking of repeating appends
-   ConsistencyCheck( mBlock, mMaxSamples, prevSize, numSamples, whereStr ); // may throw
+   ConsistencyCheck( blocks, mMaxSamples, prevSize, numSamples, whereStr ); // may throw
 
    // now commit
    // use No-fail-guarantee
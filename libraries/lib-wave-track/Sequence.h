@@ -12,8 +12,10 @@
 #define __AUDACITY_SEQUENCE__
 
 
+#include <atomic>
 #include <vector>
 #include <functional>
+#include <memory>
 
 #include "SampleFormat.h"
 #include "XMLTagHandler.h"
@@ -53,8 +55,8 @@ using BlockPtrArray = std::vector<SeqBlock*>; // non-owning pointers
 class WAVE_TRACK_API Sequence final : public XMLTagHandler{
  public:
 
-   static const char *Sequence_tag;
-   static const char *WaveBlock_tag;
+   static const XMLName Sequence_tag;
+   static const XMLName WaveBlock_tag;
 
    //
    // Static methods
@@ -162,8 +164,12 @@ class WAVE_TRACK_API Sequence final : public XMLTagHandler{
    SeqBlock::SampleBlockPtr AppendNewBlock(
       constSamplePtr buffer, sampleFormat format, size_t len);
    //! Append a complete block, not coalescing
-   /*! @excsafety{Strong} */
-   void AppendSharedBlock(const SeqBlock::SampleBlockPtr &pBlock);
+   /*!
+    @param effectiveFormat of the samples in the block
+    @excsafety{Strong}
+    */
+   void AppendSharedBlock(const SeqBlock::SampleBlockPtr &pBlock,
+      sampleFormat effectiveFormat = narrowestSampleFormat);
    /*! @excsafety{Strong} */
    void Delete(sampleCount start, sampleCount len);
 
@@ -229,8 +235,26 @@ class WAVE_TRACK_API Sequence final : public XMLTagHandler{
    // you're doing!
    //
 
-   BlockArray &GetBlockArray() { return mBlock; }
-   const BlockArray &GetBlockArray() const { return mBlock; }
+   //! The array is first copied, if it is shared with copies of this sequence
+   BlockArray &GetBlockArray() { Materialize(); return MutableBlocks(); }
+   const BlockArray &GetBlockArray() const { Materialize(); return Blocks(); }
+
+   //! Identifies the storage of the array of blocks, which copies of this
+   //! sequence, such as undo states, share until one of them changes
+   const void *GetBlockArrayId() const { Materialize(); return mpBlock.get(); }
+   //! Bytes of memory used by the array of blocks, not the samples
+   size_t GetBlockArrayBytes() const;
+
+   //! Visit the ids of blocks read lazily and not yet made, if any
+   void VisitLazyBlockIDs(const std::function<void(long long)> &visitor) const;
+
+   //! Make the blocks read lazily, if that is not yet done
+   /*!
+    Logically const; may be called from any thread, but it reads the
+    database, so callers should make the blocks before playback rather than
+    leave that to the audio thread
+    */
+   void Materialize() const;
 
    size_t GetAppendBufferLen() const { return mAppendBufferLen; }
    constSamplePtr GetAppendBuffer() const { return mAppendBuffer.ptr(); }
@@ -249,7 +273,9 @@ class WAVE_TRACK_API Sequence final : public XMLTagHandler{
 
    SampleBlockFactoryPtr mpFactory;
 
-   BlockArray    mBlock;
+   //! Shared with copies of this sequence until one of them changes it;
+   //! never null
+   std::shared_ptr<BlockArray> mpBlock{ std::make_shared<BlockArray>() };
    SampleFormats  mSampleFormats;
 
    // Not size_t!  May need to be large:
@@ -264,6 +290,13 @@ class WAVE_TRACK_API Sequence final : public XMLTagHandler{
 
    bool          mErrorOpening{ false };
 
+   struct LazyBlocks;
+   //! Non-null while blocks read lazily are not yet made; shared with copies
+   //! of this sequence
+   std::shared_ptr<LazyBlocks> mpLazyBlocks;
+   //! Whether mpLazyBlocks needs to be made into mpBlock
+   mutable std::atomic<bool> mLazy{ false };
+
    //
    // Private methods
    //
@@ -271,6 +304,11 @@ class WAVE_TRACK_API Sequence final : public XMLTagHandler{
    //! @return possibly a large or negative value
    sampleCount GetBlockStart(sampleCount position) const;
 
+   const BlockArray &Blocks() const { return *mpBlock; }
+   //! Copies the array first if it is shared, so that copies of this
+   //! sequence do not see the changes
+   BlockArray &MutableBlocks();
+
    //! Does not do any dithering
    /*! @excsafety{Strong} */
    SeqBlock::SampleBlockPtr DoAppend(
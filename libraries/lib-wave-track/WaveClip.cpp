@@ -18,6 +18,7 @@
 #include <math.h>
 #include <numeric>
 #include <optional>
+#include <utility>
 #include <vector>
 #include <wx/log.h>
 
@@ -26,6 +27,7 @@
 #include "InconsistencyException.h"
 #include "Resample.h"
 #include "Sequence.h"
+#include "StretchedClipCache.h"
 #include "TimeAndPitchInterface.h"
 #include "UserException.h"
 
@@ -417,7 +419,8 @@ void WaveClip::SetEnvelope(std::unique_ptr<Envelope> p)
 const BlockArray* WaveClip::GetSequenceBlockArray(size_t ii) const
 {
    assert(ii < NChannels());
-   return &mSequences[ii]->GetBlockArray();
+   // Not the non-const overload, which would unshare the array
+   return &std::as_const(*mSequences[ii]).GetBlockArray();
 }
 
 size_t WaveClip::GetAppendBufferLen(size_t iChannel) const
@@ -658,6 +661,61 @@ Observer::Subscription WaveClip::SubscribeToPitchAndSpeedPresetChange(
       });
 }
 
+namespace {
+//! Owns the cache of stretched audio, discarding it when samples change
+struct StretchedClipCacheAttachment final : WaveClipListener
+{
+   ~StretchedClipCacheAttachment() override = default;
+
+   std::unique_ptr<WaveClipListener> Clone() const override
+   {
+      // Don't need to copy contents
+      return std::make_unique<StretchedClipCacheAttachment>();
+   }
+
+   void MarkChanged() noexcept override { mCache->Invalidate(); }
+   void Invalidate() override { mCache->Invalidate(); }
+   void MakeStereo(WaveClipListener &&, bool) override { Invalidate(); }
+   void SwapChannels() override { Invalidate(); }
+   void Erase(size_t) override { Invalidate(); }
+
+   //! Trimming does not call MarkChanged(), so compare it at each use
+   void CheckTrims(double trimLeft, double trimRight)
+   {
+      if (trimLeft != mTrimLeft || trimRight != mTrimRight) {
+         mCache->Invalidate();
+         mTrimLeft = trimLeft;
+         mTrimRight = trimRight;
+      }
+   }
+
+   const std::shared_ptr<StretchedClipCache> mCache =
+      std::make_shared<StretchedClipCache>();
+   double mTrimLeft{ 0 };
+   double mTrimRight{ 0 };
+};
+
+WaveClip::Attachments::RegisteredFactory sKeyStretchedClipCache{
+   [](WaveClip &) {
+      return std::make_unique<StretchedClipCacheAttachment>();
+   }
+};
+}
+
+std::shared_ptr<StretchedClipCache> WaveClip::GetStretchedClipCache() const
+{
+   if (!RenderAheadStretchedClips.Read())
+      return {};
+   auto &attachment = const_cast<WaveClip&>(*this) // Consider it mutable data
+      .Attachments::Get<StretchedClipCacheAttachment>(
+         sKeyStretchedClipCache);
+   attachment.CheckTrims(mTrimLeft, mTrimRight);
+   return attachment.mCache;
+}
+
+BoolSetting RenderAheadStretchedClips{
+   L"/AudioIO/RenderAheadStretchedClips", false };
+
 bool WaveClip::HasEqualPitchAndSpeed(const WaveClip& other) const
 {
    return StretchRatioEquals(other.GetStretchRatio()) &&
@@ -694,7 +752,7 @@ size_t WaveClip::CountBlocks() const
 {
    return std::accumulate(mSequences.begin(), mSequences.end(), size_t{},
    [](size_t acc, auto &pSequence){
-      return acc + pSequence->GetBlockArray().size(); });
+      return acc + std::as_const(*pSequence).GetBlockArray().size(); });
 }
 
 //! A hint for sizing of well aligned fetches
@@ -841,6 +899,25 @@ void WaveClip::AppendLegacySharedBlock(
    mSequences[0]->AppendSharedBlock( pBlock );
 }
 
+void WaveClip::AppendSharedBlocks(
+   const std::vector<std::shared_ptr<SampleBlock>> &blocks,
+   sampleFormat effectiveFormat)
+{
+   assert(blocks.size() == NChannels());
+   StrongInvariantScope scope{ *this };
+
+   Transaction transaction{ *this };
+
+   size_t ii = 0;
+   for (auto &pSequence : mSequences)
+      pSequence->AppendSharedBlock(blocks[ii++], effectiveFormat);
+
+   transaction.Commit();
+   // use No-fail-guarantee
+   UpdateEnvelopeTrackLen();
+   MarkChanged();
+}
+
 bool WaveClip::Append(size_t iChannel, const size_t nChannels,
    constSamplePtr buffers[], sampleFormat format,
    size_t len, unsigned int stride, sampleFormat effectiveFormat)
@@ -1067,8 +1144,20 @@ void WaveClip::WriteXML(size_t ii, XMLWriter &xmlFile) const
 // may throw
 {
    assert(ii < NChannels());
+   DoWriteXML(ii, ii + 1, false, xmlFile);
+}
+
+void WaveClip::WriteWideXML(XMLWriter &xmlFile) const
+// may throw
+{
+   DoWriteXML(0, NChannels(), true, xmlFile);
+}
 
-   if (GetSequenceSamplesCount() <= 0)
+void WaveClip::DoWriteXML(size_t begin, size_t end, bool keepEmpty,
+   XMLWriter &xmlFile) const
+// may throw
+{
+   if (!keepEmpty && GetSequenceSamplesCount() <= 0)
       // Oops, I'm empty? How did that happen? Anyway, I do nothing but causing
       // problems, don't save me.
       return;
@@ -1087,11 +1176,13 @@ void WaveClip::WriteXML(size_t ii, XMLWriter &xmlFile) const
       listener.WriteXMLAttributes(xmlFile);
    });
 
-   mSequences[ii]->WriteXML(xmlFile);
+   // HandleXMLChild() makes one channel for each sequence tag
+   for (auto ii = begin; ii < end; ++ii)
+      mSequences[ii]->WriteXML(xmlFile);
    mEnvelope->WriteXML(xmlFile);
 
    for (const auto &clip: mCutLines)
-      clip->WriteXML(ii, xmlFile);
+      clip->DoWriteXML(begin, end, keepEmpty, xmlFile);
 
    xmlFile.EndTag(WaveClip_tag);
 }
@@ -2058,5 +2149,6 @@ WaveClip::Transaction::~Transaction()
       clip.mSequences.swap(sequences);
       clip.mTrimLeft = mTrimLeft;
       clip.mTrimRight = mTrimRight;
+      clip.MarkChanged();
    }
 }
@@ -19,6 +19,7 @@
 #include "XMLTagHandler.h"
 #include "SampleCount.h"
 #include "AudioSegmentSampleView.h"
+#include "Prefs.h"
 
 #include <wx/longlong.h>
 
@@ -373,6 +374,9 @@ public:
    SubscribeToPitchAndSpeedPresetChange(
       std::function<void(PitchAndSpeedPreset)> cb) const override;
 
+   //! Null unless RenderAheadStretchedClips is enabled
+   std::shared_ptr<StretchedClipCache> GetStretchedClipCache() const override;
+
    // Resample clip. This also will set the rate, but without changing
    // the length of the clip
    void Resample(int rate, BasicUI::ProgressDialog *progress = nullptr);
@@ -615,6 +619,17 @@ public:
     */
    void AppendLegacySharedBlock(const std::shared_ptr<SampleBlock> &pBlock);
 
+   //! Append a complete block to each channel, not coalescing
+   /*!
+    @pre `blocks.size() == NChannels()`
+    @pre the blocks have equal sample counts and the stored sample format
+    @param effectiveFormat of the samples in the blocks
+    @excsafety{Strong}
+    */
+   void AppendSharedBlocks(
+      const std::vector<std::shared_ptr<SampleBlock>> &blocks,
+      sampleFormat effectiveFormat);
+
    //! Append (non-interleaved) samples to some or all channels
    //! You must call Flush after the last Append
    /*!
@@ -768,6 +783,11 @@ public:
     */
    void WriteXML(size_t ii, XMLWriter &xmlFile) const;
 
+   //! Write all channels in one tag, which HandleXMLTag() and the other
+   //! deserialization functions also accept, and do not skip empty clips.
+   /*! The project file does not use this format, but undo states may */
+   void WriteWideXML(XMLWriter &xmlFile) const;
+
    // AWD, Oct 2009: for pasting whitespace at the end of selection
    bool GetIsPlaceholder() const { return mIsPlaceholder; }
    void SetIsPlaceholder(bool val) { mIsPlaceholder = val; }
@@ -881,6 +901,13 @@ private:
    const SampleBlockFactoryPtr &GetFactory() const;
    std::vector<std::unique_ptr<Sequence>> GetEmptySequenceCopies() const;
    void StretchCutLines(double ratioChange);
+   //! Write channels in [begin, end) and likewise for cut lines
+   /*!
+    @param keepEmpty whether to write this clip and cut lines that have no
+    samples
+    */
+   void DoWriteXML(size_t begin, size_t end, bool keepEmpty,
+      XMLWriter &xmlFile) const;
    double SnapToTrackSample(double time) const noexcept;
 
    //! Fix consistency of cutlines and envelope after deleting from Sequences
@@ -978,4 +1005,8 @@ private:
    wxString mName;
 };
 
+//! Whether playback renders stretched clips ahead in the background, so that
+//! seeking in them does not restart the stretcher
+extern WAVE_TRACK_API BoolSetting RenderAheadStretchedClips;
+
 #endif
@@ -1013,6 +1013,14 @@ auto WaveTrack::EmptyCopy(
    return EmptyCopy(NChannels(), pFactory);
 }
 
+auto WaveTrack::DuplicateWithFactory(
+   const SampleBlockFactoryPtr &pFactory) const -> Holder
+{
+   auto result = EmptyCopy(pFactory);
+   result->CopyClips(result->mClips, result->mpFactory, mClips, false);
+   return result;
+}
+
 void WaveTrack::MakeMono()
 {
    mRightChannel.reset();
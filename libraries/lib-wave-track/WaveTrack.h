@@ -356,6 +356,14 @@ public:
    Holder EmptyCopy(const SampleBlockFactoryPtr &pFactory = {})
    const;
 
+   //! Copy the track, with its clips, making the blocks of the copy with the
+   //! given factory
+   /*!
+    As for a track that was decoded into blocks in memory, and is to be
+    stored in the project that owns the factory
+    */
+   Holder DuplicateWithFactory(const SampleBlockFactoryPtr &pFactory) const;
+
    //! Simply discard any right channel
    void MakeMono();
 
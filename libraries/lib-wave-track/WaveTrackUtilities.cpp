@@ -9,6 +9,7 @@
 
 **********************************************************************/
 #include "WaveTrackUtilities.h"
+#include "Envelope.h"
 #include "SampleBlock.h"
 #include "Sequence.h"
 #include "WaveClip.h"
@@ -400,6 +401,42 @@ void WaveTrackUtilities::InspectBlocks(const TrackList &tracks,
    VisitBlocks(const_cast<TrackList &>(tracks), move(inspector), pIDs);
 }
 
+void WaveTrackUtilities::InspectLazyBlockIDs(const TrackList &tracks,
+   SampleBlockIDSet &ids)
+{
+   for (auto wt : tracks.Any<const WaveTrack>())
+      for (const auto &pClip : GetAllClips(*wt))
+         for (const auto &pChannel : pClip->Channels())
+            pChannel->GetSequence().VisitLazyBlockIDs(
+               [&](SampleBlockID id){ ids.insert(id); });
+}
+
+void WaveTrackUtilities::MaterializeBlocks(
+   const WaveTrack &track, double t0, double t1)
+{
+   for (const auto &pClip : track.Intervals())
+      if (pClip->IntersectsPlayRegion(t0, t1))
+         for (const auto &pChannel : pClip->Channels())
+            pChannel->GetSequence().Materialize();
+}
+
+size_t WaveTrackUtilities::InspectClipMemory(const TrackList &tracks,
+   BlockArrayIdSet &ids)
+{
+   size_t result = 0;
+   for (auto wt : tracks.Any<const WaveTrack>())
+      for (const auto &pClip : GetAllClips(*wt)) {
+         result += sizeof(WaveClip) +
+            pClip->GetEnvelope().GetNumberOfPoints() * sizeof(EnvPoint);
+         for (const auto &pChannel : pClip->Channels()) {
+            auto &sequence = pChannel->GetSequence();
+            if (ids.insert(sequence.GetBlockArrayId()).second)
+               result += sequence.GetBlockArrayBytes();
+         }
+      }
+   return result;
+}
+
 WaveTrack::IntervalConstHolders
 WaveTrackUtilities::GetClipsIntersecting(const WaveTrack &track,
    double t0, double t1)
@@ -181,6 +181,34 @@ WAVE_TRACK_API void VisitBlocks(TrackList &tracks, BlockVisitor visitor,
 WAVE_TRACK_API void InspectBlocks(const TrackList &tracks,
    BlockInspector inspector, SampleBlockIDSet *pIDs = nullptr);
 
+//! Accumulate ids of blocks that sequences loaded lazily refer to, but which
+//! were not yet made; unlike InspectBlocks, does not make them
+WAVE_TRACK_API void InspectLazyBlockIDs(const TrackList &tracks,
+   SampleBlockIDSet &ids);
+
+//! Make the blocks of sequences loaded lazily, in the clips of the track
+//! that intersect [t0, t1), so that later reads of them, as by the audio
+//! thread, do not query the database
+/*!
+ Other clips make their blocks when first read
+ @pre `t0 <= t1`
+ */
+WAVE_TRACK_API void MaterializeBlocks(
+   const WaveTrack &track, double t0, double t1);
+
+//! Identities of arrays of blocks, which copies of sequences may share
+using BlockArrayIdSet = std::unordered_set<const void *>;
+
+//! Estimate bytes of memory used by the clips of the tracks, not counting
+//! samples
+/*!
+ Arrays of blocks are shared among copies of a sequence, such as the undo
+ states, until one of them changes; count only the arrays not yet in `ids`,
+ and accumulate them there.  Envelopes are not shared and are always counted.
+ */
+WAVE_TRACK_API size_t InspectClipMemory(const TrackList &tracks,
+   BlockArrayIdSet &ids);
+
 /*!
  @pre t0 <= t1
  */
@@ -0,0 +1,64 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  XMLName.h
+
+**********************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <string_view>
+
+/*! \brief A tag or attribute name, known at compile time, that writers may
+ * intern once per run instead of converting and looking it up at each use.
+ *
+ * Define each as an object of static storage duration, initialized with a
+ * string literal.  The constructor is constexpr, so such objects are
+ * initialized before any dynamic initialization and may be used from the
+ * constructors of other static objects.
+ *
+ * The name converts to std::string_view, so it compares directly with the tag
+ * and attribute names passed to XMLTagHandler.
+ *
+ * One cached identifier is reserved for the writer that keeps a dictionary of
+ * names for the whole run, which is ProjectSerializer.
+ */
+class XMLName final
+{
+public:
+   //! @pre `name` is a string literal, in ASCII
+   explicit constexpr XMLName(const char* name) noexcept
+       : mName { name }
+   {
+   }
+
+   XMLName(const XMLName&) = delete;
+   XMLName& operator=(const XMLName&) = delete;
+
+   constexpr std::string_view Name() const noexcept
+   {
+      return mName;
+   }
+
+   constexpr operator std::string_view() const noexcept
+   {
+      return mName;
+   }
+
+   //! @return identifier cached by the interning writer, or -1
+   int GetCachedId() const noexcept
+   {
+      return mCachedId.load(std::memory_order_relaxed);
+   }
+
+   void SetCachedId(int id) const noexcept
+   {
+      mCachedId.store(id, std::memory_order_relaxed);
+   }
+
+private:
+   const std::string_view mName;
+   mutable std::atomic<int> mCachedId { -1 };
+};
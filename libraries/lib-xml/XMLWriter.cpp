@@ -199,6 +199,78 @@ void XMLWriter::WriteAttr(const wxString &name, double value, int digits)
       Internat::ToString(value, digits)));
 }
 
+wxString XMLWriter::ToString(const XMLName &name)
+{
+   const auto view = name.Name();
+   return wxString::FromUTF8(view.data(), view.size());
+}
+
+void XMLWriter::StartTag(const XMLName &name)
+// may throw
+{
+   StartTag(ToString(name));
+}
+
+void XMLWriter::EndTag(const XMLName &name)
+// may throw
+{
+   EndTag(ToString(name));
+}
+
+void XMLWriter::WriteAttr(const XMLName &name, const wxString &value)
+// may throw from Write()
+{
+   WriteAttr(ToString(name), value);
+}
+
+void XMLWriter::WriteAttr(const XMLName &name, const wxChar *value)
+// may throw from Write()
+{
+   WriteAttr(ToString(name), value);
+}
+
+void XMLWriter::WriteAttr(const XMLName &name, int value)
+// may throw from Write()
+{
+   WriteAttr(ToString(name), value);
+}
+
+void XMLWriter::WriteAttr(const XMLName &name, bool value)
+// may throw from Write()
+{
+   WriteAttr(ToString(name), value);
+}
+
+void XMLWriter::WriteAttr(const XMLName &name, long value)
+// may throw from Write()
+{
+   WriteAttr(ToString(name), value);
+}
+
+void XMLWriter::WriteAttr(const XMLName &name, long long value)
+// may throw from Write()
+{
+   WriteAttr(ToString(name), value);
+}
+
+void XMLWriter::WriteAttr(const XMLName &name, size_t value)
+// may throw from Write()
+{
+   WriteAttr(ToString(name), value);
+}
+
+void XMLWriter::WriteAttr(const XMLName &name, float value, int digits)
+// may throw from Write()
+{
+   WriteAttr(ToString(name), value, digits);
+}
+
+void XMLWriter::WriteAttr(const XMLName &name, double value, int digits)
+// may throw from Write()
+{
+   WriteAttr(ToString(name), value, digits);
+}
+
 void XMLWriter::WriteData(const wxString &value)
 // may throw from Write()
 {
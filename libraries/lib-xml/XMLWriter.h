@@ -18,6 +18,7 @@
 
 #include "FileException.h"
 #include "Identifier.h"
+#include "XMLName.h"
 
 ///
 /// XMLWriter
@@ -49,6 +50,26 @@ class XML_API XMLWriter /* not final */ {
    virtual void WriteAttr(const wxString &name, float value, int digits = -1);
    virtual void WriteAttr(const wxString &name, double value, int digits = -1);
 
+   // Overloads for names known at compile time.  The defaults convert the
+   // name and call the overloads above; writers override them to avoid that.
+   virtual void StartTag(const XMLName &name);
+   virtual void EndTag(const XMLName &name);
+
+   // nonvirtual pass-through
+   void WriteAttr(const XMLName &name, const Identifier &value)
+      { WriteAttr( name, value.GET() ); }
+
+   virtual void WriteAttr(const XMLName &name, const wxString &value);
+   virtual void WriteAttr(const XMLName &name, const wxChar *value);
+
+   virtual void WriteAttr(const XMLName &name, int value);
+   virtual void WriteAttr(const XMLName &name, bool value);
+   virtual void WriteAttr(const XMLName &name, long value);
+   virtual void WriteAttr(const XMLName &name, long long value);
+   virtual void WriteAttr(const XMLName &name, size_t value);
+   virtual void WriteAttr(const XMLName &name, float value, int digits = -1);
+   virtual void WriteAttr(const XMLName &name, double value, int digits = -1);
+
    virtual void WriteData(const wxString &value);
 
    virtual void WriteSubTree(const wxString &value);
@@ -60,6 +81,8 @@ class XML_API XMLWriter /* not final */ {
    // XML encoding, i.e. '<' becomes '&lt;'
    static wxString XMLEsc(const wxString & s);
 
+   static wxString ToString(const XMLName &name);
+
  protected:
 
    bool mInTag;
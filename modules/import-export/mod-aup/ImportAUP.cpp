@@ -631,11 +631,11 @@ bool AUPImportFileHandle::HandleXMLTag(const std::string_view& tag, const Attrib
    {
       success = HandleWaveClip(handler);
    }
-   else if (mCurrentTag == Sequence::Sequence_tag)
+   else if (mCurrentTag == Sequence::Sequence_tag.Name())
    {
       success = HandleSequence(handler);
    }
-   else if (mCurrentTag == Sequence::WaveBlock_tag)
+   else if (mCurrentTag == Sequence::WaveBlock_tag.Name())
    {
       success = HandleWaveBlock(handler);
    }
@@ -31,6 +31,7 @@
 #include "Export.h"
 
 #include "Mix.h"
+#include "PipelinedMixer.h"
 #include "Prefs.h"
 #include "SelectFile.h"
 #include "ShuttleGui.h"
@@ -425,7 +426,7 @@ class CLExportProcessor : public ExportProcessor
       unsigned channels;
       wxString cmd;
       bool showOutput;
-      std::unique_ptr<Mixer> mixer;
+      std::unique_ptr<PipelinedMixer> mixer;
       wxString output;
       std::unique_ptr<ExportCLProcess> process;
    } context;
@@ -629,7 +630,8 @@ bool CLExportProcessor::Initialize(AudacityProject& project,
 
    // Mix 'em up
    const auto &tracks = TrackList::Get( project );
-   context.mixer = ExportPluginHelpers::CreateMixer(
+   context.mixer = std::make_unique<PipelinedMixer>(
+      ExportPluginHelpers::CreateMixer(
                             tracks,
                             selectionOnly,
                             t0,
@@ -639,7 +641,8 @@ bool CLExportProcessor::Initialize(AudacityProject& project,
                             true,
                             rate,
                             floatSample,
-                            mixerSpec);
+                            !IsDraftQuality(),
+                            mixerSpec));
 
    context.status = selectionOnly
          ? XO("Exporting the selected audio using command-line encoder")
@@ -32,6 +32,7 @@ function.
 
 #include "BasicSettings.h"
 #include "Mix.h"
+#include "PipelinedMixer.h"
 #include "Tags.h"
 #include "Track.h"
 #include "wxFileNameWrapper.h"
@@ -611,7 +612,7 @@ public:
    std::unique_ptr<Mixer> CreateMixer(const TrackList &tracks,
          bool selectionOnly,
          double startTime, double stopTime,
-         MixerOptions::Downmix *mixerSpec);
+         bool highQuality, MixerOptions::Downmix *mixerSpec);
 
 private:
 
@@ -669,7 +670,7 @@ class FFmpegExportProcessor final : public ExportProcessor
       TranslatableString status;
       double t0;
       double t1;
-      std::unique_ptr<Mixer> mixer;
+      std::unique_ptr<PipelinedMixer> mixer;
       std::unique_ptr<FFmpegExporter> exporter;
    } context;
 
@@ -726,12 +727,12 @@ FFmpegExporter::FFmpegExporter(std::shared_ptr<FFmpegFunctions> ffmpeg,
    }
 }
 
-std::unique_ptr<Mixer> FFmpegExporter::CreateMixer(const TrackList& tracks, bool selectionOnly, double startTime, double stopTime, MixerOptions::Downmix* mixerSpec)
+std::unique_ptr<Mixer> FFmpegExporter::CreateMixer(const TrackList& tracks, bool selectionOnly, double startTime, double stopTime, bool highQuality, MixerOptions::Downmix* mixerSpec)
 {
    return ExportPluginHelpers::CreateMixer(tracks, selectionOnly,
       startTime, stopTime,
       mChannels, mDefaultFrameSize, true,
-      mSampleRate, int16Sample, mixerSpec);
+      mSampleRate, int16Sample, highQuality, mixerSpec);
 }
 
 
@@ -1639,9 +1640,10 @@ bool FFmpegExportProcessor::Initialize(AudacityProject& project,
       throw ExportErrorException("FFmpeg:1008");
    }
 
-   context.mixer = context.exporter->CreateMixer(tracks, selectionOnly,
-      t0, t1,
-      mixerSpec);
+   context.mixer = std::make_unique<PipelinedMixer>(
+      context.exporter->CreateMixer(tracks, selectionOnly,
+         t0, t1,
+         !IsDraftQuality(), mixerSpec));
 
    context.status = selectionOnly
          ? XO("Exporting selected audio as %s")
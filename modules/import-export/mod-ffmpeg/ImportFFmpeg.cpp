@@ -270,8 +270,8 @@ private:
    wxInt64               mProgressPos = 0;   //!< Current timestamp, file position or whatever is used as first argument for Update()
    wxInt64               mProgressLen = 1;   //!< Duration, total length or whatever is used as second argument for Update()
 
-   bool                  mCancelled = false;     //!< True if importing was canceled by user
-   bool                  mStopped = false;       //!< True if importing was stopped by user
+   std::atomic<bool>     mCancelled { false };   //!< True if importing was canceled by user
+   std::atomic<bool>     mStopped { false };     //!< True if importing was stopped by user
    const FilePath        mName;
    std::vector<WaveTrack::Holder> mStreams;
 };
@@ -16,6 +16,9 @@ Joshua Haberman
 
 #include <rapidjson/document.h>
 
+#include <algorithm>
+#include <thread>
+
 #include "Export.h"
 
 #include <wx/ffile.h>
@@ -25,6 +28,7 @@ Joshua Haberman
 
 #include "float_cast.h"
 #include "Mix.h"
+#include "PipelinedMixer.h"
 #include "Prefs.h"
 
 #include "Tags.h"
@@ -184,7 +188,7 @@ class FLACExportProcessor final : public ExportProcessor
       sampleFormat format;
       FLAC::Encoder::File encoder;
       wxFFile f;
-      std::unique_ptr<Mixer> mixer;
+      std::unique_ptr<PipelinedMixer> mixer;
    } context;
 
 public:
@@ -374,6 +378,14 @@ bool FLACExportProcessor::Initialize(AudacityProject& project,
    encoder.set_rice_parameter_search_dist(flacLevels[levelPref].rice_parameter_search_dist) &&
    encoder.set_max_lpc_order(flacLevels[levelPref].max_lpc_order);
 
+#if FLAC_API_VERSION_CURRENT >= 14
+   // libFLAC 1.5 can encode frames on several threads, and writes the same
+   // stream as with one.  Failure only means that it uses one.
+   if (success)
+      encoder.set_num_threads(
+         std::clamp(std::thread::hardware_concurrency(), 1u, 64u));
+#endif
+
    if (!success) {
       // TODO: more precise message
       throw ExportErrorException("FLAC:336");
@@ -402,10 +414,13 @@ bool FLACExportProcessor::Initialize(AudacityProject& project,
 
    metadata.reset();
 
-   context.mixer = ExportPluginHelpers::CreateMixer(tracks, selectionOnly,
+   // Mix the next blocks while the encoder compresses this one
+   context.mixer = std::make_unique<PipelinedMixer>(
+      ExportPluginHelpers::CreateMixer(tracks, selectionOnly,
                             t0, t1,
                             numChannels, SAMPLES_PER_RUN, false,
-                            sampleRate, context.format, mixerSpec);
+                            sampleRate, context.format, !IsDraftQuality(),
+                            mixerSpec));
 
    context.status = selectionOnly
       ? XO("Exporting the selected audio as FLAC")
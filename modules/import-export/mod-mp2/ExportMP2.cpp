@@ -41,6 +41,7 @@
 #include "Export.h"
 #include "FileIO.h"
 #include "Mix.h"
+#include "PipelinedMixer.h"
 #include "Tags.h"
 #include "Track.h"
 
@@ -252,7 +253,7 @@ class MP2ExportProcessor final : public ExportProcessor
       double t0;
       double t1;
       wxFileNameWrapper fName;
-      std::unique_ptr<Mixer> mixer;
+      std::unique_ptr<PipelinedMixer> mixer;
       ArrayOf<char> id3buffer;
       int id3len;
       twolame_options* encodeOptions{};
@@ -398,10 +399,11 @@ bool MP2ExportProcessor::Initialize(AudacityProject& project,
       : XO("Exporting the audio at %ld kbps")
            .Format( bitrate );
 
-   context.mixer = ExportPluginHelpers::CreateMixer(tracks, selectionOnly,
+   context.mixer = std::make_unique<PipelinedMixer>(
+      ExportPluginHelpers::CreateMixer(tracks, selectionOnly,
          t0, t1,
          stereo ? 2 : 1, pcmBufferSize, true,
-         sampleRate, int16Sample, mixerSpec);
+         sampleRate, int16Sample, !IsDraftQuality(), mixerSpec));
 
    return true;
 }
@@ -79,6 +79,7 @@
 #include "float_cast.h"
 #include "HelpSystem.h"
 #include "Mix.h"
+#include "PipelinedMixer.h"
 #include "Prefs.h"
 #include "Tags.h"
 #include "Track.h"
@@ -1603,7 +1604,7 @@ class MP3ExportProcessor final : public ExportProcessor
       wxFileOffset infoTagPos;
       size_t bufferSize;
       int inSamples;
-      std::unique_ptr<Mixer> mixer;
+      std::unique_ptr<PipelinedMixer> mixer;
    } context;
 
 public:
@@ -1945,10 +1946,13 @@ bool MP3ExportProcessor::Initialize(AudacityProject& project,
             .Format( bitrate );
    }
 
-   context.mixer = ExportPluginHelpers::CreateMixer(tracks, selectionOnly,
+   // LAME encodes one frame after another, so mix the next blocks while it
+   // encodes this one
+   context.mixer = std::make_unique<PipelinedMixer>(
+      ExportPluginHelpers::CreateMixer(tracks, selectionOnly,
          t0, t1,
          channels, context.inSamples, true,
-         rate, floatSample, mixerSpec);
+         rate, floatSample, !IsDraftQuality(), mixerSpec));
 
    return true;
 }
@@ -18,6 +18,7 @@
 #include "ImportPlugin.h"
 #include "ImportUtils.h"
 #include "ImportProgressListener.h"
+#include "OnDemandImport.h"
 #include "Project.h"
 
 #define DESC XO("MP3 files")
@@ -28,6 +29,8 @@
 
 #include <mpg123.h>
 
+#include <vector>
+
 #include "Tags.h"
 #include "WaveTrack.h"
 
@@ -120,6 +123,8 @@ public:
    std::unique_ptr<ImportFileHandle> Open(const FilePath &Filename, AudacityProject*) override;
 }; // class MP3ImportPlugin
 
+class MP3OnDemandDecoder;
+
 class MP3ImportFileHandle final : public ImportFileHandleEx
 {
 public:
@@ -133,6 +138,9 @@ public:
       TrackHolders& outTracks, Tags* tags,
       std::optional<LibFileFormats::AcidizerTags>& outAcidTags) override;
 
+   std::unique_ptr<OnDemandDecoder> MakeOnDemandDecoder(Tags* tags) override;
+
+   bool ReadOutputFormat();
    bool SetupOutputFormat();
 
    void ReadTags(Tags* tags);
@@ -154,14 +162,63 @@ private:
    WaveTrackFactory* mTrackFactory { nullptr };
    WaveTrack::Holder mTrack;
    unsigned mNumChannels { 0 };
+   long mRate { 0 };
 
    mpg123_handle* mHandle { nullptr };
 
    bool mFloat64Output {};
 
    friend MP3ImportPlugin;
+   friend MP3OnDemandDecoder;
 }; // class MP3ImportFileHandle
 
+//! Decodes with a handle of its own, because the one that was opened for the
+//! import is destroyed after it
+class MP3OnDemandDecoder final : public OnDemandDecoder
+{
+public:
+   MP3OnDemandDecoder(
+      std::unique_ptr<MP3ImportFileHandle> pHandle, off_t numFrames)
+       : mpHandle { std::move(pHandle) }
+       , mNumFrames { numFrames }
+   {
+   }
+
+   unsigned NumChannels() const override
+   {
+      return mpHandle->mNumChannels;
+   }
+
+   sampleFormat Format() const override
+   {
+      return floatSample;
+   }
+
+   double Rate() const override
+   {
+      return mpHandle->mRate;
+   }
+
+   sampleCount NumFrames() const override
+   {
+      return mNumFrames;
+   }
+
+   bool Seek(sampleCount frame) override
+   {
+      return mpg123_seek(mpHandle->mHandle, frame.as_long_long(), SEEK_SET) >= 0;
+   }
+
+   size_t Decode(const samplePtr buffers[], size_t len) override;
+
+private:
+   const std::unique_ptr<MP3ImportFileHandle> mpHandle;
+   const sampleCount mNumFrames;
+
+   std::vector<unsigned char> mBuffer;
+   std::vector<float> mConversionBuffer;
+}; // class MP3OnDemandDecoder
+
 std::unique_ptr<ImportFileHandle> MP3ImportPlugin::Open(
    const FilePath &Filename, AudacityProject *)
 {
@@ -348,12 +405,31 @@ void MP3ImportFileHandle::Import(
    progressListener.OnImportResult(ImportProgressListener::ImportResult::Success);
 }
 
-bool MP3ImportFileHandle::SetupOutputFormat()
+std::unique_ptr<OnDemandDecoder>
+MP3ImportFileHandle::MakeOnDemandDecoder(Tags* tags)
+{
+   auto pHandle = std::make_unique<MP3ImportFileHandle>(GetFilename());
+
+   if (!pHandle->Open() || !pHandle->ReadOutputFormat())
+      return nullptr;
+
+   // After mpg123_scan, the length and seeking are exact, with the
+   // gapless option
+   const auto numFrames = mpg123_length(pHandle->mHandle);
+
+   if (numFrames <= 0 || mpg123_seek(pHandle->mHandle, 0, SEEK_SET) < 0)
+      return nullptr;
+
+   ReadTags(tags);
+
+   return std::make_unique<MP3OnDemandDecoder>(std::move(pHandle), numFrames);
+}
+
+bool MP3ImportFileHandle::ReadOutputFormat()
 {
-   long rate;
    int channels;
    int encoding = MPG123_ENC_FLOAT_32;
-   mpg123_getformat(mHandle, &rate, &channels, &encoding);
+   mpg123_getformat(mHandle, &mRate, &channels, &encoding);
 
    mNumChannels = channels == MPG123_MONO ? 1 : 2;
 
@@ -366,15 +442,78 @@ bool MP3ImportFileHandle::SetupOutputFormat()
 
    mFloat64Output = encoding == MPG123_ENC_FLOAT_64;
 
+   return true;
+}
+
+bool MP3ImportFileHandle::SetupOutputFormat()
+{
+   if (!ReadOutputFormat())
+      return false;
+
    mTrack = ImportUtils::NewWaveTrack(
       *mTrackFactory,
       mNumChannels,
       floatSample,
-      rate);
+      mRate);
 
    return true;
 }
 
+size_t MP3OnDemandDecoder::Decode(const samplePtr buffers[], size_t len)
+{
+   const auto handle = mpHandle->mHandle;
+   const auto numChannels = mpHandle->mNumChannels;
+   const auto float64 = mpHandle->mFloat64Output;
+   const size_t sampleSize = float64 ? sizeof(double) : sizeof(float);
+   const size_t bytes = len * numChannels * sampleSize;
+
+   mBuffer.resize(bytes);
+
+   size_t bytesRead = 0;
+
+   while (bytesRead < bytes)
+   {
+      size_t done = 0;
+      const auto ret =
+         mpg123_read(handle, mBuffer.data() + bytesRead, bytes - bytesRead, &done);
+
+      bytesRead += done;
+
+      if (ret != MPG123_OK)
+      {
+         if (ret != MPG123_DONE)
+            wxLogError(
+               "Failed to decode MP3 file: %s", mpg123_plain_strerror(ret));
+         break;
+      }
+
+      if (done == 0)
+         break;
+   }
+
+   const size_t frames = bytesRead / sampleSize / numChannels;
+   auto samples = reinterpret_cast<constSamplePtr>(mBuffer.data());
+
+   // See MP3ImportFileHandle::Import
+   if (float64)
+   {
+      mConversionBuffer.resize(frames * numChannels);
+
+      for (size_t sampleIndex = 0; sampleIndex < mConversionBuffer.size();
+           ++sampleIndex)
+      {
+         mConversionBuffer[sampleIndex] = static_cast<float>(
+            reinterpret_cast<const double*>(mBuffer.data())[sampleIndex]);
+      }
+
+      samples = reinterpret_cast<constSamplePtr>(mConversionBuffer.data());
+   }
+
+   DeinterleaveSamples(samples, floatSample, buffers, numChannels, frames);
+
+   return frames;
+}
+
 void MP3ImportFileHandle::ReadTags(Tags* tags)
 {
    mpg123_id3v1* v1;
@@ -23,6 +23,7 @@
 #include "ExportPluginRegistry.h"
 #include "FileIO.h"
 #include "Mix.h"
+#include "PipelinedMixer.h"
 
 #include "Tags.h"
 #include "Track.h"
@@ -107,7 +108,7 @@ class OGGExportProcessor final : public ExportProcessor
       double t0;
       double t1;
       unsigned numChannels;
-      std::unique_ptr<Mixer> mixer;
+      std::unique_ptr<PipelinedMixer> mixer;
       std::unique_ptr<FileIO> outFile;
       wxFileNameWrapper fName;
 
@@ -269,10 +270,11 @@ bool OGGExportProcessor::Initialize(AudacityProject& project,
       }
    }
 
-   context.mixer = ExportPluginHelpers::CreateMixer(tracks, selectionOnly,
+   context.mixer = std::make_unique<PipelinedMixer>(
+      ExportPluginHelpers::CreateMixer(tracks, selectionOnly,
          t0, t1,
          numChannels, SAMPLES_PER_RUN, false,
-         sampleRate, floatSample, mixerSpec);
+         sampleRate, floatSample, !IsDraftQuality(), mixerSpec));
 
    context.status = selectionOnly
       ? XO("Exporting the selected audio as Ogg Vorbis")
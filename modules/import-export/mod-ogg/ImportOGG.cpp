@@ -52,6 +52,7 @@ static const auto exts = {
 #include "ImportPlugin.h"
 #include "ImportProgressListener.h"
 #include "ImportUtils.h"
+#include "OnDemandImport.h"
 
 class OggImportPlugin final : public ImportPlugin
 {
@@ -103,6 +104,8 @@ public:
       TrackHolders& outTracks, Tags* tags,
       std::optional<LibFileFormats::AcidizerTags>& outAcidTags) override;
 
+   std::unique_ptr<OnDemandDecoder> MakeOnDemandDecoder(Tags* tags) override;
+
    wxInt32 GetStreamCount() override
    {
       if (mVorbisFile)
@@ -126,6 +129,8 @@ public:
    }
 
 private:
+   void ReadTags(Tags* tags);
+
    std::unique_ptr<wxFFile> mFile;
    std::unique_ptr<OggVorbis_File> mVorbisFile;
 
@@ -134,6 +139,48 @@ private:
    std::vector<WaveTrack::Holder> mStreams;
 };
 
+//! Takes over the file from OggImportFileHandle
+class OggOnDemandDecoder final : public OnDemandDecoder
+{
+public:
+   OggOnDemandDecoder(std::unique_ptr<wxFFile> &&file,
+                      std::unique_ptr<OggVorbis_File> &&vorbisFile)
+   :  mFile(std::move(file)),
+      mVorbisFile(std::move(vorbisFile)),
+      mNumFrames(ov_pcm_total(mVorbisFile.get(), 0))
+   {
+   }
+   ~OggOnDemandDecoder();
+
+   unsigned NumChannels() const override
+   {
+      return mVorbisFile->vi[0].channels;
+   }
+
+   // The format agrees with what OggImportFileHandle::Import() appends
+   sampleFormat Format() const override { return int16Sample; }
+
+   double Rate() const override
+   {
+      return mVorbisFile->vi[0].rate;
+   }
+
+   sampleCount NumFrames() const override { return mNumFrames; }
+
+   bool Seek(sampleCount frame) override
+   {
+      return ov_pcm_seek(mVorbisFile.get(), frame.as_long_long()) == 0;
+   }
+
+   size_t Decode(const samplePtr buffers[], size_t len) override;
+
+private:
+   std::unique_ptr<wxFFile> mFile;
+   std::unique_ptr<OggVorbis_File> mVorbisFile;
+   const sampleCount mNumFrames;
+   std::vector<short> mBuffer;
+};
+
 
 TranslatableString OggImportPlugin::GetPluginFormatDescription()
 {
@@ -339,6 +386,33 @@ void OggImportFileHandle::Import(
 
    ImportUtils::FinalizeImport(outTracks, mStreams);
 
+   ReadTags(tags);
+
+   progressListener.OnImportResult(IsStopped()
+                                   ? ImportProgressListener::ImportResult::Stopped
+                                   : ImportProgressListener::ImportResult::Success);
+}
+
+std::unique_ptr<OnDemandDecoder>
+OggImportFileHandle::MakeOnDemandDecoder(Tags* tags)
+{
+   // Links of a chained file may differ in format, and only the whole file
+   // can be imported on demand
+   if (!mVorbisFile || mVorbisFile->links != 1 || mStreamUsage[0] == 0 ||
+       ov_pcm_total(mVorbisFile.get(), 0) <= 0)
+      return nullptr;
+
+   ReadTags(tags);
+
+   // See Import()
+   ov_pcm_seek(mVorbisFile.get(), 0);
+
+   return std::make_unique<OggOnDemandDecoder>(
+      std::move(mFile), std::move(mVorbisFile));
+}
+
+void OggImportFileHandle::ReadTags(Tags* tags)
+{
    //\todo { Extract comments from each stream? }
    if (mVorbisFile->vc[0].comments > 0) {
       tags->Clear();
@@ -355,15 +429,64 @@ void OggImportFileHandle::Import(
          tags->SetTag(name, value);
       }
    }
-
-   progressListener.OnImportResult(IsStopped()
-                                   ? ImportProgressListener::ImportResult::Stopped
-                                   : ImportProgressListener::ImportResult::Success);
 }
 
 OggImportFileHandle::~OggImportFileHandle()
 {
-   ov_clear(mVorbisFile.get());
-   mFile->Detach();    // so that it doesn't try to close the file (ov_clear()
+   // Both may have been given to OggOnDemandDecoder
+   if (mVorbisFile)
+      ov_clear(mVorbisFile.get());
+   if (mFile)
+      mFile->Detach(); // so that it doesn't try to close the file (ov_clear()
                        // did that already)
 }
+
+OggOnDemandDecoder::~OggOnDemandDecoder()
+{
+   ov_clear(mVorbisFile.get());
+   mFile->Detach();
+}
+
+size_t OggOnDemandDecoder::Decode(const samplePtr buffers[], size_t len)
+{
+   const auto channels = NumChannels();
+   mBuffer.resize(len * channels);
+
+   // See OggImportFileHandle::Import()
+   int testvar = 1, endian;
+   if (*(char *)&testvar)
+      endian = 0;  // little endian
+   else
+      endian = 1;  // big endian
+
+   size_t bytesWanted = mBuffer.size() * sizeof(short);
+   size_t bytesRead = 0;
+   int bitstream = 0;
+   while (bytesRead < bytesWanted) {
+      const auto result = ov_read(mVorbisFile.get(),
+         reinterpret_cast<char *>(mBuffer.data()) + bytesRead,
+         std::min<size_t>(bytesWanted - bytesRead, 4096u),
+         endian,
+         2,    // word length (2 for 16 bit samples)
+         1,    // signed
+         &bitstream);
+
+      if (result == OV_HOLE)
+         // Best effort for a malformed file, as in Import()
+         continue;
+      else if (result < 0) {
+         wxLogError(wxT("Ogg Vorbis importer: ov_read() returned error %i"),
+            result);
+         break;
+      }
+      else if (result == 0)
+         break;
+
+      bytesRead += result;
+   }
+
+   const size_t frames = bytesRead / sizeof(short) / channels;
+   DeinterleaveSamples(reinterpret_cast<constSamplePtr>(mBuffer.data()),
+      int16Sample, buffers, channels, frames);
+   return frames;
+}
@@ -27,6 +27,9 @@
 #include "ImportUtils.h"
 #include "ImportProgressListener.h"
 #include "CodeConversions.h"
+#include "OnDemandImport.h"
+
+#include <vector>
 
 #include <opus/opusfile.h>
 
@@ -46,6 +49,8 @@ public:
      const FilePath &Filename, AudacityProject*) override;
 };
 
+class OpusOnDemandDecoder;
+
 class OpusImportFileHandle final : public ImportFileHandleEx
 {
 public:
@@ -61,6 +66,8 @@ public:
       TrackHolders& outTracks, Tags* tags,
       std::optional<LibFileFormats::AcidizerTags>& outAcidTags) override;
 
+   std::unique_ptr<OnDemandDecoder> MakeOnDemandDecoder(Tags* tags) override;
+
    wxInt32 GetStreamCount() override;
    const TranslatableStrings &GetStreamInfo() override;
    void SetStreamUsage(wxInt32 StreamID, bool Use) override;
@@ -76,6 +83,8 @@ private:
    void NotifyImportFailed(ImportProgressListener& progressListener, int error);
    void NotifyImportFailed(ImportProgressListener& progressListener, const TranslatableString& error);
 
+   void ReadTags(Tags* tags);
+
    wxFile mFile;
 
    OpusFileCallbacks mCallbacks;
@@ -91,6 +100,50 @@ private:
    // Opus decodes to float samples internally, optionally converting them to int16.
    // We let Audacity to convert the stream to the project sample format.
    const sampleFormat mFormat { floatSample };
+
+   friend OpusOnDemandDecoder;
+};
+
+//! Decodes with a handle of its own, because the one that was opened for the
+//! import is destroyed after it
+class OpusOnDemandDecoder final : public OnDemandDecoder
+{
+public:
+   explicit OpusOnDemandDecoder(std::unique_ptr<OpusImportFileHandle> handle)
+       : mHandle { std::move(handle) }
+   {
+   }
+
+   unsigned NumChannels() const override
+   {
+      return mHandle->mNumChannels;
+   }
+
+   sampleFormat Format() const override
+   {
+      return mHandle->mFormat;
+   }
+
+   double Rate() const override
+   {
+      return mHandle->mSampleRate;
+   }
+
+   sampleCount NumFrames() const override
+   {
+      return mHandle->mNumSamples;
+   }
+
+   bool Seek(sampleCount frame) override
+   {
+      return op_pcm_seek(mHandle->mOpusFile, frame.as_long_long()) == 0;
+   }
+
+   size_t Decode(const samplePtr buffers[], size_t len) override;
+
+private:
+   const std::unique_ptr<OpusImportFileHandle> mHandle;
+   std::vector<float> mBuffer;
 };
 
 // ============================================================================
@@ -246,6 +299,73 @@ void OpusImportFileHandle::Import(
 
    ImportUtils::FinalizeImport(outTracks, *track);
 
+   ReadTags(tags);
+
+   progressListener.OnImportResult(IsStopped()
+                                   ? ImportProgressListener::ImportResult::Stopped
+                                   : ImportProgressListener::ImportResult::Success);
+}
+
+std::unique_ptr<OnDemandDecoder>
+OpusImportFileHandle::MakeOnDemandDecoder(Tags* tags)
+{
+   auto handle = std::make_unique<OpusImportFileHandle>(GetFilename());
+
+   if (!handle->IsOpen() || handle->mNumSamples <= 0 ||
+       !op_seekable(handle->mOpusFile))
+      return nullptr;
+
+   ReadTags(tags);
+
+   return std::make_unique<OpusOnDemandDecoder>(std::move(handle));
+}
+
+size_t OpusOnDemandDecoder::Decode(const samplePtr buffers[], size_t len)
+{
+   const auto opusFile = mHandle->mOpusFile;
+   const auto numChannels = mHandle->mNumChannels;
+
+   mBuffer.resize(len * numChannels);
+
+   size_t samplesRead = 0;
+
+   // op_read_float() returns at most one packet at a time
+   while (samplesRead < len)
+   {
+      int linkIndex { -1 };
+      const auto result = op_read_float(opusFile,
+         mBuffer.data() + samplesRead * numChannels,
+         (len - samplesRead) * numChannels, &linkIndex);
+
+      if (result == OP_HOLE)
+         continue;
+
+      if (result < 0)
+      {
+         mHandle->LogOpusError("Error while decoding Opus file", result);
+         break;
+      }
+
+      if (result == 0)
+         break;
+
+      if (op_head(opusFile, linkIndex)->channel_count != numChannels)
+      {
+         wxLogError("Opus file has changed the number of channels in the middle");
+         break;
+      }
+
+      samplesRead += result;
+   }
+
+   DeinterleaveSamples(reinterpret_cast<constSamplePtr>(mBuffer.data()),
+      floatSample, buffers, numChannels, samplesRead);
+
+   return samplesRead;
+}
+
+void OpusImportFileHandle::ReadTags(Tags* tags)
+{
    auto opusTags = op_tags(mOpusFile, -1);
 
    if (opusTags != nullptr)
@@ -278,10 +398,6 @@ void OpusImportFileHandle::Import(
             }
          }
    }
-
-   progressListener.OnImportResult(IsStopped()
-                                   ? ImportProgressListener::ImportResult::Stopped
-                                   : ImportProgressListener::ImportResult::Success);
 }
 
 wxInt32 OpusImportFileHandle::GetStreamCount()
@@ -19,6 +19,7 @@
 #include "Dither.h"
 #include "FileFormats.h"
 #include "Mix.h"
+#include "PipelinedMixer.h"
 #include "Prefs.h"
 #include "Tags.h"
 #include "Track.h"
@@ -384,7 +385,7 @@ class PCMExportProcessor final : public ExportProcessor
       int subformat;
       double t0;
       double t1;
-      std::unique_ptr<Mixer> mixer;
+      std::unique_ptr<PipelinedMixer> mixer;
       TranslatableString status;
       SF_INFO info;
       sampleFormat format;
@@ -680,10 +681,12 @@ bool PCMExportProcessor::Initialize(AudacityProject& project,
 
       
       wxASSERT(info.channels >= 0);
-      context.mixer = ExportPluginHelpers::CreateMixer(tracks, selectionOnly,
+      context.mixer = std::make_unique<PipelinedMixer>(
+         ExportPluginHelpers::CreateMixer(tracks, selectionOnly,
                                t0, t1,
                                info.channels, maxBlockLen, true,
-                               sampleRate, context.format, mixerSpec);
+                               sampleRate, context.format, !IsDraftQuality(),
+                               mixerSpec));
    }
 
    return true;
@@ -323,8 +323,11 @@ void PCMImportFileHandle::Import(
 
       SampleBuffer srcbuffer, buffer;
       wxASSERT(mInfo.channels >= 0);
+      // Mono needs no deinterleaving
+      const bool deinterleave = mInfo.channels > 1;
       while (NULL == srcbuffer.Allocate(maxBlock * mInfo.channels, mFormat).ptr() ||
-             NULL == buffer.Allocate(maxBlock, mFormat).ptr())
+             (deinterleave &&
+              NULL == buffer.Allocate(maxBlock * mInfo.channels, mFormat).ptr()))
       {
          maxBlock /= 2;
          if (maxBlock < 1)
@@ -334,8 +337,17 @@ void PCMImportFileHandle::Import(
          }
       }
 
+      // Each channel's samples are contiguous in buffer
+      std::vector<samplePtr> channelBuffers(mInfo.channels);
+      for (int c = 0; c < mInfo.channels; ++c)
+         channelBuffers[c] = deinterleave
+            ? buffer.ptr() + c * maxBlock * SAMPLE_SIZE(mFormat)
+            : srcbuffer.ptr();
+
       decltype(fileTotalFrames) framescompleted = 0;
 
+      // Reading whole blocks of the track, with no conversion of format, lets
+      // each channel make its sample blocks directly from channelBuffers
       long block;
       do {
          block = maxBlock;
@@ -352,25 +364,16 @@ void PCMImportFileHandle::Import(
          }
 
          if (block) {
+            const auto format =
+               (mFormat == int16Sample) ? int16Sample : floatSample;
+            if (deinterleave)
+               DeinterleaveSamples(srcbuffer.ptr(), format,
+                  channelBuffers.data(), mInfo.channels, block);
             unsigned c = 0;
             ImportUtils::ForEachChannel(*track, [&](auto& channel)
             {
-               if (mFormat==int16Sample) {
-                  for(int j=0; j<block; j++)
-                     ((short *)buffer.ptr())[j] =
-                        ((short *)srcbuffer.ptr())[mInfo.channels*j+c];
-               }
-               else {
-                  for(int j=0; j<block; j++)
-                     ((float *)buffer.ptr())[j] =
-                        ((float *)srcbuffer.ptr())[mInfo.channels*j+c];
-               }
-
                channel.AppendBuffer(
-                  buffer.ptr(),
-                  (mFormat == int16Sample) ? int16Sample : floatSample,
-                  block, 1, mEffectiveFormat
-               );
+                  channelBuffers[c], format, block, 1, mEffectiveFormat);
                ++c;
             });
             framescompleted += block;
@@ -17,6 +17,7 @@
 #include "Export.h"
 #include "wxFileNameWrapper.h"
 #include "Mix.h"
+#include "PipelinedMixer.h"
 
 #include <wavpack/wavpack.h>
 
@@ -256,7 +257,7 @@ class WavPackExportProcessor final : public ExportProcessor
       sampleFormat format;
       WriteId outWvFile, outWvcFile;
       WavpackContext *wpc{};
-      std::unique_ptr<Mixer> mixer;
+      std::unique_ptr<PipelinedMixer> mixer;
       std::unique_ptr<Tags> metadata;
    } context;
 public:
@@ -485,10 +486,11 @@ bool WavPackExportProcessor::Initialize(AudacityProject& project,
          : *metadata
       );
 
-   context.mixer = ExportPluginHelpers::CreateMixer(tracks, selectionOnly,
+   context.mixer = std::make_unique<PipelinedMixer>(
+      ExportPluginHelpers::CreateMixer(tracks, selectionOnly,
          t0, t1,
          numChannels, SAMPLES_PER_RUN, true,
-         sampleRate, context.format, mixerSpec);
+         sampleRate, context.format, !IsDraftQuality(), mixerSpec));
 
    return true;
 }
@@ -53,6 +53,7 @@ public:
 
       CloudProjectsSavePath.Invalidate();
       DaysToKeepFiles.Invalidate();
+      FastMixdownPreviews.Invalidate();
 
       // Enum settings are not cacheable, so we need to invalidate them
       // sync::SaveLocationMode.Invalidate();
@@ -145,6 +146,15 @@ public:
          }
          S.EndStatic();
 
+         S.StartStatic(XO("Audio preview"));
+         {
+            S.SetBorder(8);
+            S.TieCheckBox(
+               XXO("&Generate previews quickly, at lower quality"),
+               FastMixdownPreviews);
+         }
+         S.EndStatic();
+
          S.StartStatic(XO("Temporary Cloud files directory"));
          {
             S.SetBorder(8);
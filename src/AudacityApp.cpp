@@ -68,6 +68,7 @@ It handles initialization and termination by subclassing wxApp.
 #include "AColor.h"
 #include "AudacityFileConfig.h"
 #include "AudioIO.h"
+#include "BatchTempoDetection.h"
 #include "Benchmark.h"
 #include "Clipboard.h"
 #include "CommandLineArgs.h"
@@ -1653,6 +1654,18 @@ bool AudacityApp::InitPart2()
             QuitAudacity(true);
          }
 
+         wxString meterOutput;
+         if (parser->Found(wxT("m"), &meterOutput))
+         {
+            std::vector<FilePath> files;
+            for (size_t i = 0, cnt = parser->GetParamCount(); i < cnt; i++)
+               files.push_back(parser->GetParam(i));
+            if (!RunBatchTempoDetection(*project, files, meterOutput))
+               wxPrintf(_("Could not write to %s\n"), meterOutput);
+            QuitAudacity(true);
+            return;
+         }
+
          for (size_t i = 0, cnt = parser->GetParamCount(); i < cnt; i++)
          {
             // PRL: Catch any exceptions, don't try this file again, continue to
@@ -2377,6 +2390,11 @@ std::unique_ptr<wxCmdLineParser> AudacityApp::ParseCommandLine()
    /*i18n-hint: This runs a set of automatic tests on Audacity itself */
    parser->AddSwitch(wxT("t"), wxT("test"), _("run self diagnostics"));
 
+   /*i18n-hint: This detects the tempo and meter of the given audio files,
+    *           without opening them, writing one line of results per file */
+   parser->AddOption(wxT("m"), wxT("detect-meter"),
+                     _("detect tempo and meter of the files, writing JSON lines to the given file"));
+
    /*i18n-hint: This displays the Audacity version */
    parser->AddSwitch(wxT("v"), wxT("version"), _("display Audacity version"));
 
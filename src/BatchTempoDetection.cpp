@@ -0,0 +1,80 @@
+/*  SPDX-License-Identifier: GPL-2.0-or-later */
+/*!********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  BatchTempoDetection.cpp
+
+**********************************************************************/
+#include "BatchTempoDetection.h"
+#include "BatchMeterDetection.h"
+#include "ClipMirAudioReader.h"
+#include "CodeConversions.h"
+#include "Import.h"
+#include "ImportPlugin.h"
+#include "ImportProgressListener.h"
+#include "Tags.h"
+#include "WaveTrack.h"
+
+#include <fstream>
+
+namespace
+{
+//! Imports the first stream of each file, without user interaction
+class SilentImportProgress final : public ImportProgressListener
+{
+public:
+   bool OnImportFileOpened(ImportFileHandle& importFileHandle) override
+   {
+      importFileHandle.SetStreamUsage(0, true);
+      return true;
+   }
+   void OnImportProgress(double) override
+   {
+   }
+   void OnImportResult(ImportResult) override
+   {
+   }
+};
+} // namespace
+
+bool RunBatchTempoDetection(
+   AudacityProject& project, const std::vector<FilePath>& files,
+   const FilePath& output)
+{
+   std::ofstream out(output.fn_str());
+   if (!out)
+      return false;
+
+   std::vector<std::string> filenames;
+   filenames.reserve(files.size());
+   for (const auto& file : files)
+      filenames.push_back(audacity::ToUTF8(file));
+
+   const auto open = [&](const std::string& filename)
+      -> std::unique_ptr<MIR::MirAudioReader> {
+      SilentImportProgress progress;
+      TrackHolders tracks;
+      Tags tags;
+      std::optional<LibFileFormats::AcidizerTags> acidTags;
+      TranslatableString errorMessage;
+      if (!Importer::Get().Import(
+             project, audacity::ToWXString(filename), &progress,
+             &WaveTrackFactory::Get(project), tracks, &tags, acidTags,
+             errorMessage))
+         return nullptr;
+      // Like ProjectFileManager, analyze only files giving a single clip
+      if (tracks.size() != 1)
+         return nullptr;
+      const auto waveTrack = dynamic_cast<WaveTrack*>(tracks[0].get());
+      if (!waveTrack || waveTrack->NIntervals() != 1)
+         return nullptr;
+      // The reader shares the clip, so the track may go
+      return std::make_unique<ClipMirAudioReader>(
+         std::move(acidTags), filename, *waveTrack);
+   };
+
+   MIR::DetectMetersInFiles(
+      filenames, open, MIR::FalsePositiveTolerance::Lenient, out);
+   return static_cast<bool>(out);
+}
@@ -0,0 +1,29 @@
+/*  SPDX-License-Identifier: GPL-2.0-or-later */
+/*!********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  BatchTempoDetection.h
+
+**********************************************************************/
+#pragma once
+
+#include "Identifier.h"
+
+#include <vector>
+
+class AudacityProject;
+
+/*!
+ * @brief Imports each of the files and writes its tempo and meter, as
+ * detected from the signal, as a JSON line to `output`.
+ *
+ * @details The files are decoded with the import plugins, one at a time,
+ * into the sample storage of `project`, but no tracks are added to it; the
+ * decoded audio is discarded after analysis. No dialogs are shown.
+ *
+ * @return whether `output` could be written
+ */
+AUDACITY_DLL_API bool RunBatchTempoDetection(
+   AudacityProject& project, const std::vector<FilePath>& files,
+   const FilePath& output);
@@ -28,7 +28,12 @@ of sample block storage.
 #include <wx/valgen.h>
 #include <wx/valtext.h>
 
+#include <algorithm>
+#include <cstring>
+
+#include "BufferedStreamReader.h"
 #include "Project.h"
+#include "ProjectSerializer.h"
 #include "ProjectTimeSignature.h"
 #include "SampleBlock.h"
 #include "ShuttleGui.h"
@@ -64,6 +69,8 @@ private:
    void OnClear( wxCommandEvent &event );
    void OnClose( wxCommandEvent &event );
 
+   void RunProjectDocumentBenchmark();
+
    void Printf(const TranslatableString &str);
    void HoldPrint(bool hold);
    void FlushPrint();
@@ -316,6 +323,141 @@ void BenchmarkDialog::FlushPrint()
    mToPrint = wxT("");
 }
 
+namespace {
+//! Reads the dictionary, then the document, as stored in a project file
+class SerializerStream final : public BufferedStreamReader
+{
+public:
+   explicit SerializerStream(const ProjectSerializer &serializer)
+   {
+      for (auto pStream : { &serializer.GetDict(), &serializer.GetData() })
+         for (auto chunk : *pStream)
+            mChunks.push_back(chunk);
+   }
+
+protected:
+   bool HasMoreData() const override
+   {
+      return mChunk < mChunks.size();
+   }
+
+   size_t ReadData(void *buffer, size_t maxBytes) override
+   {
+      size_t bytesRead = 0;
+      while (bytesRead < maxBytes && mChunk < mChunks.size()) {
+         const auto &[data, size] = mChunks[mChunk];
+         const auto count = std::min(maxBytes - bytesRead, size - mOffset);
+         memcpy(static_cast<char*>(buffer) + bytesRead,
+            static_cast<const char*>(data) + mOffset, count);
+         bytesRead += count;
+         if ((mOffset += count) == size) {
+            ++mChunk;
+            mOffset = 0;
+         }
+      }
+      return bytesRead;
+   }
+
+private:
+   std::vector<MemoryStream::StreamChunk> mChunks;
+   size_t mChunk{ 0 };
+   size_t mOffset{ 0 };
+};
+
+//! Accepts any document, counting the block ids
+struct BlockCounter final : XMLTagHandler
+{
+   bool HandleXMLTag(
+      const std::string_view &tag, const AttributesList &attrs) override
+   {
+      if (tag == Sequence::WaveBlock_tag)
+         for (auto &[attr, value] : attrs) {
+            long long id;
+            if (attr == "blockid" && value.TryGet(id)) {
+               ++count;
+               sum += id;
+            }
+         }
+      return true;
+   }
+
+   XMLTagHandler *HandleXMLChild(const std::string_view &) override
+   {
+      return this;
+   }
+
+   long long count{ 0 };
+   long long sum{ 0 };
+};
+}
+
+// Saves and loads a synthetic project document of many blocks, to measure
+// serialization apart from the sample data
+void BenchmarkDialog::RunProjectDocumentBenchmark()
+{
+   constexpr long long numBlocks = 1000000;
+   static const XMLName Start_attr{ "start" };
+   static const XMLName BlockID_attr{ "blockid" };
+
+   Printf( XO("Saving and loading a project document of %lld blocks...\n")
+      .Format( numBlocks ) );
+   wxTheApp->Yield();
+   FlushPrint();
+
+   const auto write = [](XMLWriter &writer, auto &sequenceTag,
+      auto &blockTag, auto &startAttr, auto &blockIDAttr
+   ){
+      writer.StartTag(wxT("project"));
+      writer.StartTag(wxT("wavetrack"));
+      writer.StartTag(wxT("waveclip"));
+      writer.StartTag(sequenceTag);
+      for (long long i = 0; i < numBlocks; ++i) {
+         writer.StartTag(blockTag);
+         writer.WriteAttr(startAttr, i * 262144);
+         writer.WriteAttr(blockIDAttr, i + 1);
+         writer.EndTag(blockTag);
+      }
+      writer.EndTag(sequenceTag);
+      writer.EndTag(wxT("waveclip"));
+      writer.EndTag(wxT("wavetrack"));
+      writer.EndTag(wxT("project"));
+   };
+
+   wxStopWatch timer;
+   {
+      ProjectSerializer serializer;
+      const wxString sequenceTag{ Sequence::Sequence_tag.Name().data() },
+         blockTag{ Sequence::WaveBlock_tag.Name().data() },
+         startAttr{ Start_attr.Name().data() },
+         blockIDAttr{ BlockID_attr.Name().data() };
+      timer.Start();
+      write(serializer, sequenceTag, blockTag, startAttr, blockIDAttr);
+      Printf( XO("Time to save with string names: %ld ms\n")
+         .Format( timer.Time() ) );
+   }
+
+   ProjectSerializer serializer;
+   timer.Start();
+   write(serializer, Sequence::Sequence_tag, Sequence::WaveBlock_tag,
+      Start_attr, BlockID_attr);
+   Printf( XO("Time to save with interned names: %ld ms\n")
+      .Format( timer.Time() ) );
+
+   SerializerStream stream{ serializer };
+   BlockCounter counter;
+   timer.Start();
+   const auto success = ProjectSerializer::Decode(stream, &counter);
+   const auto elapsed = timer.Time();
+   if (!success || counter.count != numBlocks ||
+       counter.sum != numBlocks * (numBlocks + 1) / 2)
+      Printf( XO("Project document did not load correctly.\n") );
+   else
+      Printf( XO("Time to load: %ld ms\n").Format( elapsed ) );
+
+   wxTheApp->Yield();
+   FlushPrint();
+}
+
 void BenchmarkDialog::OnRun( wxCommandEvent & WXUNUSED(event))
 {
    TransferDataFromWindow();
@@ -573,6 +715,8 @@ void BenchmarkDialog::OnRun( wxCommandEvent & WXUNUSED(event))
    Printf( XO("At 44100 Hz, %d bytes per sample, the estimated number of\n simultaneous tracks that could be played at once: %.1f\n" )
       .Format( SAMPLE_SIZE(SampleFormat), (nChunks*chunkSize/44100.0)/(elapsed/1000.0) ) );
 
+   RunProjectDocumentBenchmark();
+
    goto success;
 
  fail:
@@ -10,10 +10,48 @@
 **********************************************************************/
 #include "ClipMirAudioReader.h"
 #include "ClipInterface.h"
+#include "SampleBlock.h"
+#include "Sequence.h"
 #include "WaveClip.h"
 
 #include <cassert>
 
+namespace
+{
+MIR::AudioContentKey GetBlockKey(const WaveClip& clip)
+{
+   const auto start = clip.TimeToSamples(clip.GetTrimLeft());
+   const auto numSamples = clip.GetVisibleSampleCount();
+   // Block ids are unique only within the database of one project
+   const auto& factory = clip.GetSequence(0)->GetFactory();
+   if (!factory)
+      return {};
+   MIR::AudioContentKey key {
+      static_cast<long long>(factory->GetSerialNumber()), clip.GetRate(),
+      numSamples.as_long_long()
+   };
+   for (size_t iChannel = 0; iChannel < clip.NChannels(); ++iChannel)
+   {
+      const auto& sequence = *clip.GetSequence(iChannel);
+      const auto& blocks = sequence.GetBlockArray();
+      if (blocks.empty() || numSamples == 0)
+         continue;
+      const auto b0 = sequence.FindBlock(start);
+      const auto b1 = sequence.FindBlock(start + numSamples - 1);
+      // Where the visible samples begin in the first block, then the blocks
+      key.push_back((start - blocks[b0].start).as_long_long());
+      for (auto b = b0; b <= b1; ++b)
+      {
+         // Blocks of a file imported on demand do not yet have their ids
+         if (blocks[b].sb->IsPending())
+            return {};
+         key.push_back(blocks[b].sb->GetBlockID());
+      }
+   }
+   return key;
+}
+} // namespace
+
 ClipMirAudioReader::ClipMirAudioReader(
    std::optional<LibFileFormats::AcidizerTags> tags, std::string filename,
    WaveTrack& singleClipWaveTrack)
@@ -21,6 +59,7 @@ ClipMirAudioReader::ClipMirAudioReader(
     , filename { std::move(filename) }
     , clip(*singleClipWaveTrack.Intervals().begin())
     , mClip(singleClipWaveTrack.GetClipInterfaces()[0])
+    , mContentKey { GetBlockKey(*clip) }
 {
 }
 
@@ -46,6 +85,11 @@ void ClipMirAudioReader::ReadFloats(
       buffer, buffer + numFrames, buffer, [](float f) { return f / 2; });
 }
 
+MIR::AudioContentKey ClipMirAudioReader::GetContentKey() const
+{
+   return mContentKey;
+}
+
 void ClipMirAudioReader::AddChannel(
    size_t iChannel, float* buffer, sampleCount start, size_t len) const
 {
@@ -41,11 +41,18 @@ public:
    void
    ReadFloats(float* buffer, long long where, size_t numFrames) const override;
 
+   /*!
+    * The rate, the visible extent, and the IDs of the sample blocks it spans,
+    * as they were at construction; empty if some of the blocks were pending.
+    */
+   MIR::AudioContentKey GetContentKey() const override;
+
 private:
    void AddChannel(
       size_t iChannel, float* buffer, sampleCount start, size_t len) const;
 
    const std::shared_ptr<const ClipInterface> mClip;
+   const MIR::AudioContentKey mContentKey;
 
    // An array with two entries because maybe two channels, and each channel has
    // two caches to cope with back-and-forth access between beginning and end
@@ -42,6 +42,7 @@ undo memory so as to free up space.
 #include "ProjectHistory.h"
 #include "ProjectWindows.h"
 #include "ShuttleGui.h"
+#include "SpilledUndoStates.h"
 #include "AudacityMessageBox.h"
 #include "HelpSystem.h"
 
@@ -69,11 +70,14 @@ struct SpaceUsageCalculator {
    }
 
    SpaceArray space;
+   //! Memory, apart from samples, that each state adds to the newer states
+   SpaceArray memory;
    Type clipboardSpaceUsage;
 
    void Calculate( UndoManager &manager )
    {
       SampleBlockIDSet seen;
+      BlockArrayIdSet seenArrays;
 
       // After copies and pastes, a block file may be used in more than
       // one place in one undo history state, and it may be used in more than
@@ -90,11 +94,20 @@ struct SpaceUsageCalculator {
       // contribution to space usage should be counted only in that latest
       // state.
 
+      // Arrays of blocks that consecutive states share are likewise counted
+      // only in the latest state.
+
       manager.VisitStates(
-         [this, &seen](const UndoStackElem &elem) {
-            // Scan all tracks at current level
-            if (auto pTracks = UndoTracks::Find(elem))
-               space.push_back(CalculateUsage(*pTracks, seen));
+         [this, &seen, &seenArrays](const UndoStackElem &elem) {
+            // Scan all tracks at current level, but do not reload states
+            // whose clips were removed from memory
+            if (auto pTracks = UndoTracks::FindSpilled(elem).first) {
+               Type usage = 0;
+               SpilledUndoStates::InspectBlocks(
+                  elem, BlockSpaceUsageAccumulator(usage), &seen);
+               space.push_back(usage);
+               memory.push_back(InspectClipMemory(*pTracks, seenArrays));
+            }
          },
          true // newest state first
       );
@@ -176,7 +189,8 @@ void HistoryDialog::Populate(ShuttleGui & S)
             .ConnectRoot(wxEVT_KEY_DOWN, &HistoryDialog::OnListKeyDown)
             .AddListControlReportMode(
                { { XO("Action"), wxLIST_FORMAT_LEFT, 260 },
-                 { XO("Used Space"), wxLIST_FORMAT_LEFT, 125 } },
+                 { XO("Used Space"), wxLIST_FORMAT_LEFT, 125 },
+                 { XO("Memory"), wxLIST_FORMAT_LEFT, 100 } },
                wxLC_SINGLE_SEL
             );
 
@@ -290,6 +304,7 @@ void HistoryDialog::DoUpdate()
 
    // point to size for oldest state
    auto iter = calculator.space.rbegin();
+   auto memoryIter = calculator.memory.rbegin();
 
    mList->DeleteAllItems();
 
@@ -303,6 +318,8 @@ void HistoryDialog::DoUpdate()
          const auto &desc = elem.description;
          mList->InsertItem(i, desc.Translation(), i == mSelected ? 1 : 0);
          mList->SetItem(i, 1, size.Translation());
+         mList->SetItem(i, 2,
+            Internat::FormatSize(*memoryIter++).Translation());
          ++i;
       },
       false // oldest state first
@@ -425,7 +425,8 @@ int ProjectAudioManager::PlayPlayRegion(const SelectedRegion &selectedRegion,
                return std::make_unique<CutPreviewPlaybackPolicy>(tless, diff);
             };
          token = gAudioIO->StartStream(
-            MakeTransportTracks(TrackList::Get(*p), false, nonWaveToo),
+            MakeTransportTracks(
+               TrackList::Get(*p), tcp0, tcp1, false, nonWaveToo),
             tcp0, tcp1, tcp1, myOptions);
       }
       else {
@@ -436,7 +437,7 @@ int ProjectAudioManager::PlayPlayRegion(const SelectedRegion &selectedRegion,
                t1 = latestEnd;
          }
          token = gAudioIO->StartStream(
-            MakeTransportTracks(tracks, false, nonWaveToo),
+            MakeTransportTracks(tracks, t0, t1, false, nonWaveToo),
             t0, t1, mixerLimit, options);
       }
       if (token != 0) {
@@ -726,7 +727,7 @@ void ProjectAudioManager::OnRecord(bool altAppearance)
          /* TODO: set up stereo tracks if that is how the user has set up
           * their preferences, and choose sample format based on prefs */
          transportTracks =
-            MakeTransportTracks(TrackList::Get( *p ), false, true);
+            MakeTransportTracks(TrackList::Get( *p ), t0, t1, false, true);
          for (const auto &wt : existingTracks) {
             auto end = transportTracks.playbackSequences.end();
             auto it = std::find_if(
@@ -29,6 +29,7 @@ Paul Licameli split from AudacityProject.cpp
 #include "ImportProgressListener.h"
 #include "Legacy.h"
 #include "MusicInformationRetrieval.h"
+#include "OnDemandImport.h"
 #include "PlatformCompatibility.h"
 #include "Project.h"
 #include "ProjectFileIO.h"
@@ -67,7 +68,17 @@ Paul Licameli split from AudacityProject.cpp
 
 #include "ProjectFileIOExtension.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <numeric>
 #include <optional>
+#include <thread>
 #include <wx/frame.h>
 #include <wx/log.h>
 
@@ -108,6 +119,14 @@ void ProjectFileManager::DiscardAutosave(const FilePath &filename)
 
 ProjectFileManager::ProjectFileManager( AudacityProject &project )
 : mProject{ project }
+, mOnDemandImportsSubscription{ OnDemandImports::Get(project).Subscribe(
+   [this](const OnDemandImportMessage &message){
+      // Show the newly decoded blocks
+      TrackPanel::Get(mProject).Refresh(false);
+      // Autosave wrote silence for them; write them now
+      if (message.finished)
+         ProjectFileIO::Get(mProject).AutoSave();
+   }) }
 {
 }
 
@@ -387,6 +406,10 @@ bool ProjectFileManager::DoSave(const FilePath & fileName, const bool fromSaveAs
    }
    // End of confirmations
 
+   // The document refers to the blocks of files imported on demand
+   if (!OnDemandImports::Get(proj).Finish())
+      return false;
+
    // Always save a backup of the original project file
    std::optional<ProjectFileIO::BackupProject> pBackupProject;
    if (fromSaveAs && wxFileExists(fileName))
@@ -756,6 +779,10 @@ bool ProjectFileManager::SaveCopy(const FilePath &fileName /* = wxT("") */)
       break;
    } while (bPrompt);
 
+   // The document refers to the blocks of files imported on demand
+   if (!OnDemandImports::Get(project).Finish())
+      return false;
+
    if (!projectFileIO.SaveCopy(fName))
    {
       auto msg = FileException::WriteFailureMessage(fName);
@@ -808,6 +835,9 @@ void ProjectFileManager::CompactProjectOnClose()
    auto &project = mProject;
    auto &projectFileIO = ProjectFileIO::Get(project);
 
+   // Stop making blocks before the database is compacted and closed
+   OnDemandImports::Get(project).Abandon();
+
    // Lock all blocks in all tracks of the last saved version, so that
    // the sample blocks aren't deleted from the database when we destroy the
    // sample block objects in memory.
@@ -861,6 +891,7 @@ void ProjectFileManager::CloseProject()
    auto &project = mProject;
    auto &projectFileIO = ProjectFileIO::Get(project);
 
+   OnDemandImports::Get(project).Abandon();
    projectFileIO.CloseProject();
 
    // Blocks were locked in CompactProjectOnClose, so DELETE the data structure so that
@@ -1367,6 +1398,79 @@ bool ProjectFileManager::Import(const FilePath& fileName, bool addToHistory)
 
 namespace
 {
+//! Threads that analyze imported audio, kept for the rest of the session
+/*!
+ Not new threads for each import:  the analyses read sample blocks, and the
+ database connection caches prepared statements for each thread that reads
+ from it, until the connection closes
+ */
+class AnalysisThreads final
+{
+public:
+   static AnalysisThreads& Get()
+   {
+      static AnalysisThreads instance;
+      return instance;
+   }
+
+   ~AnalysisThreads()
+   {
+      {
+         std::lock_guard<std::mutex> lock { mMutex };
+         mStopping = true;
+      }
+      mCondition.notify_all();
+      for (auto& thread : mThreads)
+         thread.join();
+   }
+
+   static size_t Size()
+   {
+      return std::max(std::thread::hardware_concurrency(), 1u);
+   }
+
+   std::future<void> Submit(std::function<void()> function)
+   {
+      std::packaged_task<void()> task { move(function) };
+      auto result = task.get_future();
+      {
+         std::lock_guard<std::mutex> lock { mMutex };
+         if (mThreads.empty())
+            for (size_t i = 0; i < Size(); ++i)
+               mThreads.emplace_back([this] { Run(); });
+         mTasks.push_back(move(task));
+      }
+      mCondition.notify_one();
+      return result;
+   }
+
+private:
+   void Run()
+   {
+      while (true)
+      {
+         std::packaged_task<void()> task;
+         {
+            std::unique_lock<std::mutex> lock { mMutex };
+            mCondition.wait(
+               lock, [this] { return mStopping || !mTasks.empty(); });
+            if (mTasks.empty())
+               return;
+            task = move(mTasks.front());
+            mTasks.pop_front();
+         }
+         // Exceptions go to the future
+         task();
+      }
+   }
+
+   std::mutex mMutex;
+   std::condition_variable mCondition;
+   std::deque<std::packaged_task<void()>> mTasks;
+   bool mStopping { false };
+   std::vector<std::thread> mThreads;
+};
+
 std::vector<std::shared_ptr<MIR::AnalyzedAudioClip>> RunTempoDetection(
    const std::vector<std::shared_ptr<ClipMirAudioReader>>& readers,
    const MIR::ProjectInterface& project, bool projectWasEmpty)
@@ -1374,33 +1478,85 @@ std::vector<std::shared_ptr<MIR::AnalyzedAudioClip>> RunTempoDetection(
    const auto isBeatsAndMeasures = project.ViewIsBeatsAndMeasures();
    const auto projectTempo = project.GetTempo();
 
+   // Each reader is analyzed on one of the AnalysisThreads, so that importing
+   // many loops at once does not take the sum of their analysis times.  The
+   // workers only read the samples of their clips, which nothing else
+   // modifies meanwhile; this thread owns the readers, reports the progress
+   // and carries the cancellation.
+   std::vector<std::atomic<double>> progresses(readers.size());
+   std::atomic<bool> cancelled { false };
+   std::atomic<size_t> next { 0 };
+   std::vector<std::optional<MIR::ProjectSyncInfo>> syncInfos(readers.size());
+   const auto analyze = [&] {
+      for (auto i = next++; i < readers.size(); i = next++)
+      {
+         const auto& reader = *readers[i];
+         const MIR::ProjectSyncInfoInput input {
+            reader,
+            reader.filename,
+            reader.tags,
+            [&, i](double progressFraction) {
+               if (cancelled)
+                  throw UserException {};
+               progresses[i] = progressFraction;
+            },
+            projectTempo,
+            projectWasEmpty,
+            isBeatsAndMeasures,
+         };
+         syncInfos[i] = MIR::GetProjectSyncInfo(input);
+         progresses[i] = 1.;
+      }
+   };
+
+   const auto numWorkers =
+      std::min<size_t>(AnalysisThreads::Size(), readers.size());
+   std::vector<std::future<void>> workers;
+   for (size_t i = 0; i < numWorkers; ++i)
+      workers.push_back(AnalysisThreads::Get().Submit(analyze));
+   // Stops the workers if the user cancels
+   auto cleanup = finally([&] {
+      cancelled = true;
+      for (auto& worker : workers)
+         if (worker.valid())
+            worker.wait();
+   });
+
    using namespace BasicUI;
    auto progress = MakeProgress(
       XO("Music Information Retrieval"), XO("Analyzing imported audio"),
       ProgressShowCancel);
-   auto count = 0;
-   const auto reportProgress = [&](double progressFraction) {
-      const auto result = progress->Poll(
-         (count + progressFraction) / readers.size() * 1000, 1000);
-      if (result != ProgressResult::Success)
-         throw UserException {};
-   };
+   for (auto& worker : workers)
+      while (worker.wait_for(std::chrono::milliseconds { 50 }) !=
+             std::future_status::ready)
+      {
+         const auto done = std::accumulate(
+            progresses.begin(), progresses.end(), 0.,
+            [](double sum, const std::atomic<double>& p) { return sum + p; });
+         if (progress->Poll(done / readers.size() * 1000, 1000) !=
+             ProgressResult::Success)
+            throw UserException {};
+      }
+   // Rethrows any exception of the analysis
+   for (auto& worker : workers)
+      worker.get();
 
    std::vector<std::shared_ptr<MIR::AnalyzedAudioClip>> analyzedClips;
    analyzedClips.reserve(readers.size());
-   std::transform(
-      readers.begin(), readers.end(), std::back_inserter(analyzedClips),
-      [&](const std::shared_ptr<ClipMirAudioReader>& reader) {
-         const MIR::ProjectSyncInfoInput input {
-            *reader,      reader->filename, reader->tags,       reportProgress,
-            projectTempo, projectWasEmpty,  isBeatsAndMeasures,
-         };
-         auto syncInfo = MIR::GetProjectSyncInfo(input);
-         ++count;
-         return std::make_shared<AnalyzedWaveClip>(reader, syncInfo);
-      });
+   for (size_t i = 0; i < readers.size(); ++i)
+      analyzedClips.push_back(
+         std::make_shared<AnalyzedWaveClip>(readers[i], syncInfos[i]));
    return analyzedClips;
 }
+
+//! Whether importing the file changes the project other than by adding tracks
+bool ImportsIntoProject(const FilePath& fileName)
+{
+   const auto extension = fileName.AfterLast('.');
+   return extension.IsSameAs(wxT("aup3"), false) ||
+      extension.IsSameAs(wxT("aup"), false) ||
+      extension.IsSameAs(wxT("lof"), false);
+}
 } // namespace
 
 bool ProjectFileManager::Import(
@@ -1409,7 +1565,8 @@ bool ProjectFileManager::Import(
    const auto projectWasEmpty =
       TrackList::Get(mProject).Any<WaveTrack>().empty();
    std::vector<std::shared_ptr<ClipMirAudioReader>> resultingReaders;
-   const auto success = std::all_of(
+   const auto importOneAtATime = [&] {
+      return std::all_of(
       fileNames.begin(), fileNames.end(), [&](const FilePath& fileName) {
          std::shared_ptr<ClipMirAudioReader> resultingReader;
          const auto success = Import(fileName, addToHistory, resultingReader);
@@ -1417,6 +1574,12 @@ bool ProjectFileManager::Import(
             resultingReaders.push_back(std::move(resultingReader));
          return success;
       });
+   };
+   const auto success =
+      (fileNames.size() > 1 &&
+       std::none_of(fileNames.begin(), fileNames.end(), ImportsIntoProject))
+         ? ImportInParallel(fileNames, addToHistory, resultingReaders)
+         : importOneAtATime();
    if (success && !resultingReaders.empty())
    {
       const auto pProj = mProject.shared_from_this();
@@ -1569,6 +1732,70 @@ bool ProjectFileManager::Import(
    return true;
 }
 
+bool ProjectFileManager::ImportInParallel(
+   const std::vector<FilePath>& fileNames, bool addToHistory,
+   std::vector<std::shared_ptr<ClipMirAudioReader>>& resultingReaders)
+{
+   auto &project = mProject;
+   const auto oldTags = Tags::Get( project ).shared_from_this();
+
+   // Chooses streams, and reports on files that must be retried here with
+   // other plugins
+   ImportProgress importProgress(project);
+   std::unique_ptr<BasicUI::ProgressDialog> progress;
+   const auto poll = [&](double fraction) {
+      constexpr double ProgressSteps { 1000.0 };
+      if (!progress)
+         progress = BasicUI::MakeProgress(XO("Import"),
+            XO("Importing %lld files")
+               .Format(static_cast<long long>(fileNames.size())));
+      return progress->Poll(fraction * ProgressSteps, ProgressSteps);
+   };
+   auto results = Importer::Get().ImportFiles(
+      project, fileNames, &importProgress, &WaveTrackFactory::Get(project),
+      *oldTags, poll);
+   progress.reset();
+
+   const auto projectTempo = ProjectTimeSignature::Get(project).GetTempo();
+   for (size_t i = 0; i < results.size(); ++i)
+   {
+      const auto& fileName = fileNames[i];
+      auto& result = results[i];
+      if (!result.errorMessage.empty())
+         // Additional help via a Help button links to the manual.
+         BasicUI::ShowErrorDialog( *ProjectFramePlacement(&project),
+            XO("Error Importing"), result.errorMessage, wxT("Importing_Audio"));
+      // Files after the first failure were not imported, or were cancelled
+      if (!result.success)
+         return false;
+
+      // The tags of a later file replace those of an earlier one, as when
+      // importing one at a time
+      if (!(*result.tags == *oldTags))
+         Tags::Set( project, result.tags );
+
+      for (auto track : result.tracks)
+         DoProjectTempoChange(*track, projectTempo);
+
+      if (result.tracks.size() == 1)
+      {
+         if (const auto waveTrack =
+            dynamic_cast<WaveTrack*>(result.tracks[0].get()))
+            resultingReaders.emplace_back(new ClipMirAudioReader {
+               std::move(result.acidTags), fileName.ToStdString(),
+               *waveTrack });
+      }
+
+      if (addToHistory) {
+         FileHistory::Global().Append(fileName);
+      }
+
+      // PRL: Undo history is incremented inside this:
+      AddImportedTracks(fileName, std::move(result.tracks));
+   }
+   return true;
+}
+
 #include "Clipboard.h"
 #include "ShuttleGui.h"
 #include "HelpSystem.h"
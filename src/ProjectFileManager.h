@@ -17,6 +17,7 @@ Paul Licameli split from AudacityProject.h
 
 #include "ClientData.h" // to inherit
 #include "FileNames.h" // for FileType
+#include "Observer.h"
 
 class wxString;
 class wxFileName;
@@ -122,6 +123,12 @@ private:
       const FilePath& fileName, bool addToHistory,
       std::shared_ptr<ClipMirAudioReader>& resultingReader);
 
+   //! Import audio files at once, on worker threads, then add their tracks
+   //! in order of the files, as if imported one at a time
+   bool ImportInParallel(
+      const std::vector<FilePath>& fileNames, bool addToHistory,
+      std::vector<std::shared_ptr<ClipMirAudioReader>>& resultingReaders);
+
    /*!
     @param fileName a path assumed to exist and contain an .aup3 project
     @param addtohistory whether to add the file to the MRU list
@@ -144,6 +151,8 @@ private:
 
    AudacityProject &mProject;
 
+   Observer::Subscription mOnDemandImportsSubscription;
+
    std::shared_ptr<TrackList> mLastSavedTracks;
 
    // Are we currently closing as the result of a menu command?
@@ -11,6 +11,7 @@
 
 #include "TransportUtilities.h"
 
+#include <algorithm>
 #include <thread>
 #include "AudioIO.h"
 #include "AudioIOSequences.h"
@@ -24,6 +25,7 @@
 #include "toolbars/ControlToolBar.h"
 #include "ProgressDialog.h"
 #include "WaveTrack.h"
+#include "WaveTrackUtilities.h"
 
 void TransportUtilities::PlayCurrentRegionAndWait(
    const CommandContext &context,
@@ -205,16 +207,23 @@ void TransportUtilities::DoStartPlaying(
    }
 }
 
-TransportSequences MakeTransportTracks(
-   TrackList &trackList, bool selectedOnly, bool nonWaveToo)
+TransportSequences MakeTransportTracks(TrackList &trackList,
+   double t0, double t1, bool selectedOnly, bool nonWaveToo)
 {
    TransportSequences result;
    {
+      // Blocks of a project opened lazily, in the span to be played, are
+      // made here, so that the audio thread does not read the database to
+      // start; clips reached later by seeking make theirs when first read
+      const auto [first, last] = std::minmax(t0, t1);
       const auto range = trackList.Any<WaveTrack>()
          + (selectedOnly ? &Track::IsSelected : &Track::Any);
-      for (auto pTrack : range)
+      for (auto pTrack : range) {
+         WaveTrackUtilities::MaterializeBlocks(*pTrack, first, last);
          result.playbackSequences.push_back(
-            StretchingSequence::Create(*pTrack, pTrack->GetClipInterfaces()));
+            StretchingSequence::Create(*pTrack, pTrack->GetClipInterfaces(),
+               true));
+      }
    }
    if (nonWaveToo) {
       const auto range = trackList.Any<const PlayableTrack>() +
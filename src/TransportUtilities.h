@@ -40,9 +40,10 @@ struct AUDACITY_DLL_API TransportUtilities
 };
 
 /*!
+ @param t0, t1 the span to be played first, in either order
  @param nonWaveToo if true, collect all PlayableTracks
  */
-TransportSequences MakeTransportTracks(
-   TrackList &trackList, bool selectedOnly, bool nonWaveToo = false);
+TransportSequences MakeTransportTracks(TrackList &trackList,
+   double t0, double t1, bool selectedOnly, bool nonWaveToo = false);
 
 #endif
@@ -20,6 +20,7 @@
 #include "EffectEditor.h"
 #include "EffectOutputTracks.h"
 #include "LoadEffects.h"
+#include "PrefetchingChannelReader.h"
 #include "UserException.h"
 
 #include <math.h>
@@ -235,20 +236,19 @@ bool EffectAutoDuck::Process(EffectInstance &, EffectSettings &)
    {
       Floats rmsWindow{ kRMSWindowSize, true };
 
-      Floats buf{ kBufSize };
-
       // initialize the following two variables to prevent compiler warning
       double duckRegionStart = 0;
       sampleCount curSamplesPause = 0;
 
-      auto pos = start;
-
       const auto pControlChannel = *pControlTrack->Channels().begin();
-      while (pos < end)
+      // Read the next block in the background while this one is analyzed
+      PrefetchingChannelReader reader{ { pControlChannel.get() }, start, end,
+         kBufSize };
+      while (reader.Next())
       {
-         const auto len = limitSampleBufferSize( kBufSize, end - pos );
-
-         pControlChannel->GetFloats(buf.get(), pos, len);
+         const auto pos = reader.Position();
+         const auto len = reader.Length();
+         const auto buf = reader.GetBuffer(0);
 
          for (auto i = pos; i < pos + len; i++)
          {
@@ -298,10 +298,8 @@ bool EffectAutoDuck::Process(EffectInstance &, EffectSettings &)
             }
          }
 
-         pos += len;
-
          if (TotalProgress(
-            (pos - start).as_double() /
+            (pos + len - start).as_double() /
             (end - start).as_double() /
             (GetNumWaveTracks() + 1)
          ))
@@ -464,9 +462,6 @@ bool EffectAutoDuck::ApplyDuckFade(int trackNum, WaveChannel &track,
    auto start = track.TimeToLongSamples(t0);
    auto end = track.TimeToLongSamples(t1);
 
-   Floats buf{ kBufSize };
-   auto pos = start;
-
    auto fadeDownSamples = track.TimeToLongSamples(
       mOuterFadeDownLen + mInnerFadeDownLen);
    if (fadeDownSamples < 1)
@@ -480,9 +475,12 @@ bool EffectAutoDuck::ApplyDuckFade(int trackNum, WaveChannel &track,
    float fadeDownStep = mDuckAmountDb / fadeDownSamples.as_double();
    float fadeUpStep = mDuckAmountDb / fadeUpSamples.as_double();
 
-   while (pos < end) {
-      const auto len = limitSampleBufferSize(kBufSize, end - pos);
-      track.GetFloats(buf.get(), pos, len);
+   // Read the next block in the background while this one is faded
+   PrefetchingChannelReader reader{ { &track }, start, end, kBufSize };
+   while (reader.Next()) {
+      const auto pos = reader.Position();
+      const auto len = reader.Length();
+      const auto buf = reader.GetBuffer(0);
       for (auto i = pos; i < pos + len; ++i) {
          float gainDown = fadeDownStep * (i - start).as_float();
          float gainUp = fadeUpStep * (end - i).as_float();
@@ -499,14 +497,13 @@ bool EffectAutoDuck::ApplyDuckFade(int trackNum, WaveChannel &track,
          buf[ ( i - pos ).as_size_t() ] *= DB_TO_LINEAR(gain);
       }
 
-      if (!track.SetFloats(buf.get(), pos, len)) {
+      reader.Wait();
+      if (!track.SetFloats(buf, pos, len)) {
          cancel = true;
          break;
       }
 
-      pos += len;
-
-      float curTime = track.LongSamplesToTime(pos);
+      float curTime = track.LongSamplesToTime(pos + len);
       float fractionFinished = (curTime - mT0) / (mT1 - mT0);
       if (TotalProgress((trackNum + 1 + fractionFinished) /
          (GetNumWaveTracks() + 1))
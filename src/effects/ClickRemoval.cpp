@@ -27,6 +27,7 @@
 #include "EffectEditor.h"
 #include "EffectOutputTracks.h"
 #include "LoadEffects.h"
+#include "PrefetchingChannelReader.h"
 
 #include <math.h>
 
@@ -163,12 +164,16 @@ bool EffectClickRemoval::ProcessOne(
       idealBlockLen += (windowSize - (idealBlockLen % windowSize));
 
    bool bResult = true;
-   decltype(len) s = 0;
-   Floats buffer{ idealBlockLen };
    Floats datawindow{ windowSize };
-   while ((len - s) > windowSize / 2) {
-      auto block = limitSampleBufferSize(idealBlockLen, len - s);
-      track.GetFloats(buffer.get(), start + s, block);
+   // Read the next block in the background while clicks are removed
+   PrefetchingChannelReader reader{ { &track }, start, start + len,
+      idealBlockLen };
+   while (reader.Next()) {
+      const auto block = reader.Length();
+      // A short tail at the end is left alone
+      if (block <= windowSize / 2)
+         break;
+      const auto buffer = reader.GetBuffer(0);
       for (decltype(block) i = 0;
            i + windowSize / 2 < block; i += windowSize / 2
       ) {
@@ -184,12 +189,13 @@ bool EffectClickRemoval::ProcessOne(
 
       if (mbDidSomething) {
          // RemoveClicks() actually did something.
-         if(!track.SetFloats(buffer.get(), start + s, block)) {
+         reader.Wait();
+         if(!track.SetFloats(buffer, reader.Position(), block)) {
             bResult = false;
             break;
          }
       }
-      s += block;
+      const auto s = reader.Position() + block - start;
       if (TrackProgress(count, s.as_double() / len.as_double())) {
          bResult = false;
          break;
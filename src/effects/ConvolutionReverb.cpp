@@ -0,0 +1,468 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  ConvolutionReverb.cpp
+
+*******************************************************************//**
+
+\class EffectConvolutionReverb
+\brief Reverberation by convolution with a recorded impulse response
+
+*//*******************************************************************/
+#include "ConvolutionReverb.h"
+#include "EffectEditor.h"
+#include "EffectUIServices.h"
+#include "LoadEffects.h"
+
+#include <wx/button.h>
+#include <wx/file.h>
+#include <wx/textctrl.h>
+
+#include "FileFormats.h"
+#include "FileNames.h"
+#include "PartitionedConvolver.h"
+#include "Resample.h"
+#include "ShuttleGui.h"
+#include "wxPanelWrapper.h"
+#include "../widgets/valnum.h"
+
+#include <cmath>
+
+namespace {
+//! Partition size of the head of the impulse response, and the latency
+constexpr size_t convolutionBlockSize = 256;
+//! Longest partitions of the tail of the impulse response
+constexpr size_t maxPartitionSize = 16384;
+//! Impulse responses are truncated to this many seconds
+constexpr double maxImpulseDuration = 30.0;
+
+using Impulse = std::vector<std::vector<float>>;
+
+//! Read all channels of an impulse response, converted to the given rate and
+//! scaled to unit energy per channel
+/*!
+ @return empty if the file cannot be read
+ */
+Impulse LoadImpulse(const wxString &path, double rate)
+{
+   wxFile f;
+   SFFile sndFile;
+   SF_INFO info{};
+   if (!path.empty() && f.Open(path))
+      // As in ImportRaw, use the file descriptor, for Unicode file names
+      sndFile.reset(
+         SFCall<SNDFILE*>(sf_open_fd, f.fd(), SFM_READ, &info, FALSE));
+   if (!sndFile || info.channels <= 0 || info.frames <= 0)
+      return {};
+
+   const auto nChannels = static_cast<size_t>(info.channels);
+   const auto maxFrames = static_cast<sf_count_t>(
+      maxImpulseDuration * info.samplerate);
+   const auto nFrames = static_cast<size_t>(
+      std::min<sf_count_t>(info.frames, maxFrames));
+   std::vector<float> interleaved(nFrames * nChannels);
+   const auto nRead = static_cast<size_t>(SFCall<sf_count_t>(sf_readf_float,
+      sndFile.get(), interleaved.data(), static_cast<sf_count_t>(nFrames)));
+   if (nRead == 0)
+      return {};
+
+   Impulse result(nChannels);
+   const auto factor = rate / info.samplerate;
+   for (size_t iChannel = 0; iChannel < nChannels; ++iChannel) {
+      std::vector<float> channel(nRead);
+      for (size_t ii = 0; ii < nRead; ++ii)
+         channel[ii] = interleaved[ii * nChannels + iChannel];
+
+      auto &output = result[iChannel];
+      if (factor == 1.0)
+         output = move(channel);
+      else {
+         Resample resample{ true, factor, factor };
+         output.resize(static_cast<size_t>(std::ceil(nRead * factor)) + 1);
+         const auto [consumed, produced] = resample.Process(factor,
+            channel.data(), channel.size(), true,
+            output.data(), output.size());
+         output.resize(produced);
+      }
+
+      double energy = 0;
+      for (auto sample : output)
+         energy += sample * sample;
+      if (energy > 0) {
+         const auto scale = static_cast<float>(1.0 / std::sqrt(energy));
+         for (auto &sample : output)
+            sample *= scale;
+      }
+   }
+   return result;
+}
+
+struct ConvolutionReverbState
+{
+   //! One per channel of the processed audio
+   std::vector<std::unique_ptr<PartitionedConvolver>> mConvolvers;
+   //! Delays the dry signal by the latency of the convolvers
+   std::vector<std::vector<float>> mDryDelay;
+   size_t mDryPosition{ 0 };
+   //! Delayed dry signal of one channel for the block being processed
+   std::vector<float> mDry;
+};
+}
+
+const EffectParameterMethods& EffectConvolutionReverb::Parameters() const
+{
+   static CapturedParameters<EffectConvolutionReverb,
+      ImpulseFile, WetGain, DryGain
+   > parameters;
+   return parameters;
+}
+
+const ComponentInterfaceSymbol EffectConvolutionReverb::Symbol
+{ XO("Convolution Reverb") };
+
+namespace{ BuiltinEffectsModule::Registration< EffectConvolutionReverb > reg; }
+
+struct EffectConvolutionReverb::Instance
+   : public PerTrackEffect::Instance
+   , public EffectInstanceWithBlockSize
+{
+   explicit Instance(const PerTrackEffect& effect)
+      : PerTrackEffect::Instance{ effect }
+   {}
+
+   bool ProcessInitialize(EffectSettings &settings, double sampleRate,
+      ChannelNames chanMap) override;
+
+   size_t ProcessBlock(EffectSettings& settings,
+      const float* const* inBlock, float* const* outBlock, size_t blockLen)
+      override;
+
+   SampleCount GetLatency(const EffectSettings &, double) const override
+   {
+      return convolutionBlockSize;
+   }
+
+   // Realtime section
+
+   bool RealtimeInitialize(EffectSettings& settings, double sampleRate)
+      override;
+
+   bool RealtimeAddProcessor(EffectSettings& settings, EffectOutputs *,
+      unsigned numChannels, float sampleRate) override;
+
+   bool RealtimeFinalize(EffectSettings& settings) noexcept override;
+
+   size_t RealtimeProcess(size_t group, EffectSettings& settings,
+      const float* const* inbuf, float* const* outbuf, size_t numSamples)
+      override;
+
+   bool RealtimeSuspend() override;
+
+   unsigned GetAudioOutCount() const override
+   {
+      return mChannels;
+   }
+
+   unsigned GetAudioInCount() const override
+   {
+      return mChannels;
+   }
+
+   bool LoadImpulse(const EffectSettings &settings, double sampleRate);
+
+   void InstanceInit(ConvolutionReverbState &state, unsigned numChannels);
+
+   size_t InstanceProcess(EffectSettings& settings,
+      ConvolutionReverbState& state,
+      const float* const* inBlock, float* const* outBlock, size_t blockLen);
+
+   Impulse mImpulse;
+   ConvolutionReverbState mState;
+   std::vector<ConvolutionReverbState> mSlaves;
+   unsigned mChannels{ 2 };
+};
+
+std::shared_ptr<EffectInstance>
+EffectConvolutionReverb::MakeInstance() const
+{
+   return std::make_shared<Instance>(*this);
+}
+
+EffectConvolutionReverb::EffectConvolutionReverb()
+{
+   SetLinearEffectFlag(true);
+}
+
+EffectConvolutionReverb::~EffectConvolutionReverb()
+{
+}
+
+// ComponentInterface implementation
+
+ComponentInterfaceSymbol EffectConvolutionReverb::GetSymbol() const
+{
+   return Symbol;
+}
+
+TranslatableString EffectConvolutionReverb::GetDescription() const
+{
+   return XO("Applies the acoustics of a space recorded as an impulse response");
+}
+
+ManualPageID EffectConvolutionReverb::ManualPage() const
+{
+   return L"Convolution_Reverb";
+}
+
+// EffectDefinitionInterface implementation
+
+EffectType EffectConvolutionReverb::GetType() const
+{
+   return EffectTypeProcess;
+}
+
+auto EffectConvolutionReverb::RealtimeSupport() const -> RealtimeSince
+{
+   return RealtimeSince::After_3_1;
+}
+
+bool EffectConvolutionReverb::Instance::LoadImpulse(
+   const EffectSettings &settings, double sampleRate)
+{
+   auto &path = GetSettings(settings).mImpulseFile;
+   mImpulse = ::LoadImpulse(path, sampleRate);
+   if (mImpulse.empty()) {
+      EffectUIServices::DoMessageBox(mProcessor,
+         XO("Could not read an impulse response from \"%s\".").Format(path));
+      return false;
+   }
+   return true;
+}
+
+void EffectConvolutionReverb::Instance::InstanceInit(
+   ConvolutionReverbState &state, unsigned numChannels)
+{
+   state.mConvolvers.clear();
+   state.mDryDelay.clear();
+   state.mDryPosition = 0;
+   for (unsigned iChannel = 0; iChannel < numChannels; ++iChannel) {
+      // Stereo impulse responses apply left to left and right to right;
+      // a mono one applies to all channels
+      const auto &impulse = mImpulse[std::min<size_t>(iChannel,
+         mImpulse.size() - 1)];
+      state.mConvolvers.push_back(std::make_unique<PartitionedConvolver>(
+         impulse.data(), impulse.size(),
+         convolutionBlockSize, maxPartitionSize));
+      state.mDryDelay.emplace_back(convolutionBlockSize);
+   }
+   state.mDry.resize(GetBlockSize());
+}
+
+bool EffectConvolutionReverb::Instance::ProcessInitialize(
+   EffectSettings &settings, double sampleRate, ChannelNames chanMap)
+{
+   // For destructive processing, fix the number of channels, maybe as 1 not 2
+   mChannels = (chanMap && chanMap[0] != ChannelNameEOL &&
+      chanMap[1] == ChannelNameFrontRight) ? 2 : 1;
+   if (!LoadImpulse(settings, sampleRate))
+      return false;
+   InstanceInit(mState, mChannels);
+   return true;
+}
+
+size_t EffectConvolutionReverb::Instance::ProcessBlock(
+   EffectSettings& settings,
+   const float* const* inBlock, float* const* outBlock, size_t blockLen)
+{
+   return InstanceProcess(settings, mState, inBlock, outBlock, blockLen);
+}
+
+bool EffectConvolutionReverb::Instance::RealtimeInitialize(
+   EffectSettings& settings, double sampleRate)
+{
+   SetBlockSize(512);
+   mSlaves.clear();
+   // The impulse response is read once for all processors.  A change of
+   // file while playing takes effect when realtime processing restarts,
+   // because reading it is not safe on the audio thread.
+   return LoadImpulse(settings, sampleRate);
+}
+
+bool EffectConvolutionReverb::Instance::RealtimeAddProcessor(
+   EffectSettings&, EffectOutputs *, unsigned numChannels, float)
+{
+   ConvolutionReverbState state;
+   InstanceInit(state, numChannels);
+   mSlaves.push_back(move(state));
+   return true;
+}
+
+bool EffectConvolutionReverb::Instance::RealtimeFinalize(
+   EffectSettings&) noexcept
+{
+   mSlaves.clear();
+   mImpulse.clear();
+   return true;
+}
+
+size_t EffectConvolutionReverb::Instance::RealtimeProcess(size_t group,
+   EffectSettings& settings,
+   const float* const* inbuf, float* const* outbuf, size_t numSamples)
+{
+   if (group >= mSlaves.size())
+      return 0;
+   return InstanceProcess(settings, mSlaves[group], inbuf, outbuf, numSamples);
+}
+
+bool EffectConvolutionReverb::Instance::RealtimeSuspend()
+{
+   for (auto &state : mSlaves) {
+      for (auto &pConvolver : state.mConvolvers)
+         pConvolver->Reset();
+      for (auto &delay : state.mDryDelay)
+         std::fill(delay.begin(), delay.end(), 0.0f);
+   }
+   return true;
+}
+
+size_t EffectConvolutionReverb::Instance::InstanceProcess(
+   EffectSettings& settings, ConvolutionReverbState& state,
+   const float* const* inBlock, float* const* outBlock, size_t blockLen)
+{
+   auto &rs = GetSettings(settings);
+   const auto wetMult = static_cast<float>(DB_TO_LINEAR(rs.mWetGain));
+   const auto dryMult = static_cast<float>(DB_TO_LINEAR(rs.mDryGain));
+
+   const auto nChannels = state.mConvolvers.size();
+   if (state.mDry.size() < blockLen)
+      state.mDry.resize(blockLen);
+   const auto startPosition = state.mDryPosition;
+   for (size_t c = 0; c < nChannels; ++c) {
+      const auto ibuf = inBlock[c];
+      const auto obuf = outBlock[c];
+      auto &delay = state.mDryDelay[c];
+
+      // Take the delayed dry signal before output may overwrite input
+      auto position = startPosition;
+      for (size_t i = 0; i < blockLen; ++i) {
+         state.mDry[i] = delay[position];
+         delay[position] = ibuf[i];
+         if (++position == convolutionBlockSize)
+            position = 0;
+      }
+
+      state.mConvolvers[c]->Process(ibuf, obuf, blockLen);
+      for (size_t i = 0; i < blockLen; ++i)
+         obuf[i] = dryMult * state.mDry[i] + wetMult * obuf[i];
+   }
+   state.mDryPosition = (startPosition + blockLen) % convolutionBlockSize;
+   return blockLen;
+}
+
+struct EffectConvolutionReverb::Editor
+   : EffectEditor
+{
+   Editor(const EffectUIServices& services,
+      EffectSettingsAccess& access,
+      const EffectConvolutionReverbSettings& settings
+   )  : EffectEditor{ services, access }
+      , mSettings{ settings }
+   {}
+   virtual ~Editor() = default;
+
+   bool ValidateUI() override;
+   bool UpdateUI() override;
+
+   void PopulateOrExchange(ShuttleGui& S);
+
+   void OnBrowse(wxCommandEvent &evt);
+
+   EffectConvolutionReverbSettings mSettings;
+   wxTextCtrl *mFileText{};
+   wxWindow *mParent{};
+};
+
+std::unique_ptr<EffectEditor> EffectConvolutionReverb::MakeEditor(
+   ShuttleGui& S, EffectInstance&, EffectSettingsAccess& access,
+   const EffectOutputs *) const
+{
+   auto& settings = access.Get();
+   auto& myEffSettings = GetSettings(settings);
+
+   auto result = std::make_unique<Editor>(*this, access, myEffSettings);
+   result->PopulateOrExchange(S);
+   return result;
+}
+
+void EffectConvolutionReverb::Editor::PopulateOrExchange(ShuttleGui & S)
+{
+   mParent = S.GetParent();
+
+   S.AddSpace(0, 5);
+
+   S.StartMultiColumn(3, wxEXPAND);
+   {
+      S.SetStretchyCol(1);
+      mFileText = S.AddTextBox(XXO("&Impulse response:"),
+         mSettings.mImpulseFile, 40);
+      auto pButton = S.AddButton(XXO("&Browse..."));
+      BindTo(*pButton, wxEVT_BUTTON, &Editor::OnBrowse);
+   }
+   S.EndMultiColumn();
+
+   S.StartMultiColumn(2, wxALIGN_CENTER);
+   {
+      S.Validator<FloatingPointValidator<double>>(
+            1, &mSettings.mWetGain, NumValidatorStyle::ONE_TRAILING_ZERO,
+            WetGain.min, WetGain.max)
+         .AddTextBox(XXO("&Wet gain (dB):"), L"", 10);
+
+      S.Validator<FloatingPointValidator<double>>(
+            1, &mSettings.mDryGain, NumValidatorStyle::ONE_TRAILING_ZERO,
+            DryGain.min, DryGain.max)
+         .AddTextBox(XXO("&Dry gain (dB):"), L"", 10);
+   }
+   S.EndMultiColumn();
+}
+
+void EffectConvolutionReverb::Editor::OnBrowse(wxCommandEvent &)
+{
+   static const FileNames::FileTypes types{
+      { XO("Audio files"), sf_get_all_extensions(), true },
+      FileNames::AllFiles
+   };
+   FileDialogWrapper filePicker(mParent,
+      XO("Choose an impulse response file"), FileNames::DataDir(), L"",
+      types);
+   if (filePicker.ShowModal() == wxID_CANCEL)
+      return;
+   mFileText->SetValue(filePicker.GetPath());
+   ValidateUI();
+   Publish(EffectSettingChanged{});
+}
+
+bool EffectConvolutionReverb::Editor::ValidateUI()
+{
+   mSettings.mImpulseFile = mFileText->GetValue();
+   mAccess.ModifySettings
+   (
+      [this](EffectSettings& settings)
+      {
+         // pass back the modified settings to the MessageBuffer
+
+         EffectConvolutionReverb::GetSettings(settings) = mSettings;
+         return nullptr;
+      }
+   );
+
+   return true;
+}
+
+bool EffectConvolutionReverb::Editor::UpdateUI()
+{
+   // get the settings from the MessageBuffer and write them to our local copy
+   mSettings = GetSettings(mAccess.Get());
+   mFileText->ChangeValue(mSettings.mImpulseFile);
+   return true;
+}
@@ -0,0 +1,75 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  ConvolutionReverb.h
+
+**********************************************************************/
+
+#ifndef __AUDACITY_EFFECT_CONVOLUTION_REVERB__
+#define __AUDACITY_EFFECT_CONVOLUTION_REVERB__
+
+#include "StatelessPerTrackEffect.h"
+#include "ShuttleAutomation.h"
+
+struct EffectConvolutionReverbSettings
+{
+   static constexpr wchar_t impulseFileDefault[] = L"";
+   static constexpr double wetGainDefault = -6.0;
+   static constexpr double dryGainDefault = 0.0;
+
+   //! Path of an audio file holding the impulse response
+   wxString mImpulseFile{ impulseFileDefault };
+   double mWetGain{ wetGainDefault };
+   double mDryGain{ dryGainDefault };
+};
+
+class EffectConvolutionReverb final : public EffectWithSettings<
+   EffectConvolutionReverbSettings, StatelessPerTrackEffect
+>
+{
+public:
+   static const ComponentInterfaceSymbol Symbol;
+
+   EffectConvolutionReverb();
+   virtual ~EffectConvolutionReverb();
+
+   // ComponentInterface implementation
+
+   ComponentInterfaceSymbol GetSymbol() const override;
+   TranslatableString GetDescription() const override;
+   ManualPageID ManualPage() const override;
+
+   // EffectDefinitionInterface implementation
+
+   EffectType GetType() const override;
+   RealtimeSince RealtimeSupport() const override;
+
+   // Effect implementation
+
+   std::unique_ptr<EffectEditor> MakeEditor(
+      ShuttleGui & S, EffectInstance &instance,
+      EffectSettingsAccess &access, const EffectOutputs *pOutputs)
+   const override;
+
+   struct Editor;
+
+   struct Instance;
+
+   std::shared_ptr<EffectInstance> MakeInstance() const override;
+
+private:
+   const EffectParameterMethods& Parameters() const override;
+
+static constexpr EffectParameter ImpulseFile{
+   &EffectConvolutionReverbSettings::mImpulseFile, L"ImpulseFile",
+   EffectConvolutionReverbSettings::impulseFileDefault, L"", L"", L"" };
+static constexpr EffectParameter WetGain{
+   &EffectConvolutionReverbSettings::mWetGain, L"WetGain",
+   EffectConvolutionReverbSettings::wetGainDefault, -60.0, 20.0, 1 };
+static constexpr EffectParameter DryGain{
+   &EffectConvolutionReverbSettings::mDryGain, L"DryGain",
+   EffectConvolutionReverbSettings::dryGainDefault, -60.0, 20.0, 1 };
+};
+
+#endif
@@ -0,0 +1,313 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  DynamicCompressor.cpp
+
+*******************************************************************//**
+
+\class EffectDynamicCompressor
+\brief Feed-forward compressor with lookahead, usable in realtime
+
+Unlike EffectCompressor, which makes two passes and follows the envelope
+sample by sample, all processing is done by CompressorProcessor in blocks.
+
+*//*******************************************************************/
+#include "DynamicCompressor.h"
+#include "EffectEditor.h"
+#include "LoadEffects.h"
+
+#include "ShuttleGui.h"
+#include "../widgets/valnum.h"
+
+#include <algorithm>
+#include <cmath>
+
+const EffectParameterMethods& EffectDynamicCompressor::Parameters() const
+{
+   static CapturedParameters<EffectDynamicCompressor,
+      Threshold, MakeupGain, KneeWidth, Ratio, Lookahead, Attack, Release
+   > parameters;
+   return parameters;
+}
+
+const ComponentInterfaceSymbol EffectDynamicCompressor::Symbol
+{ XO("Dynamic Compressor") };
+
+namespace{ BuiltinEffectsModule::Registration< EffectDynamicCompressor > reg; }
+
+struct EffectDynamicCompressor::Instance
+   : public PerTrackEffect::Instance
+   , public EffectInstanceWithBlockSize
+{
+   explicit Instance(const PerTrackEffect& effect)
+      : PerTrackEffect::Instance{ effect }
+   {}
+
+   bool ProcessInitialize(EffectSettings &settings, double sampleRate,
+      ChannelNames chanMap) override;
+
+   size_t ProcessBlock(EffectSettings& settings,
+      const float* const* inBlock, float* const* outBlock, size_t blockLen)
+      override;
+
+   SampleCount GetLatency(const EffectSettings &settings, double sampleRate)
+      const override;
+
+   // Realtime section
+
+   bool RealtimeInitialize(EffectSettings& settings, double sampleRate)
+      override;
+
+   bool RealtimeAddProcessor(EffectSettings& settings, EffectOutputs *,
+      unsigned numChannels, float sampleRate) override;
+
+   bool RealtimeFinalize(EffectSettings& settings) noexcept override;
+
+   size_t RealtimeProcess(size_t group, EffectSettings& settings,
+      const float* const* inbuf, float* const* outbuf, size_t numSamples)
+      override;
+
+   bool RealtimeSuspend() override;
+
+   unsigned GetAudioOutCount() const override
+   {
+      return mChannels;
+   }
+
+   unsigned GetAudioInCount() const override
+   {
+      return mChannels;
+   }
+
+   static size_t InstanceProcess(EffectSettings& settings,
+      CompressorProcessor& processor,
+      const float* const* inBlock, float* const* outBlock, size_t blockLen);
+
+   CompressorProcessor mProcessor;
+   std::vector<std::unique_ptr<CompressorProcessor>> mSlaves;
+   unsigned mChannels{ 2 };
+};
+
+std::shared_ptr<EffectInstance>
+EffectDynamicCompressor::MakeInstance() const
+{
+   return std::make_shared<Instance>(*this);
+}
+
+EffectDynamicCompressor::EffectDynamicCompressor()
+{
+}
+
+EffectDynamicCompressor::~EffectDynamicCompressor()
+{
+}
+
+// ComponentInterface implementation
+
+ComponentInterfaceSymbol EffectDynamicCompressor::GetSymbol() const
+{
+   return Symbol;
+}
+
+TranslatableString EffectDynamicCompressor::GetDescription() const
+{
+   return XO("Reduces the dynamic range of audio, looking ahead for peaks");
+}
+
+ManualPageID EffectDynamicCompressor::ManualPage() const
+{
+   return L"Dynamic_Compressor";
+}
+
+// EffectDefinitionInterface implementation
+
+EffectType EffectDynamicCompressor::GetType() const
+{
+   return EffectTypeProcess;
+}
+
+auto EffectDynamicCompressor::RealtimeSupport() const -> RealtimeSince
+{
+   return RealtimeSince::After_3_1;
+}
+
+bool EffectDynamicCompressor::Instance::ProcessInitialize(
+   EffectSettings &settings, double sampleRate, ChannelNames chanMap)
+{
+   // For destructive processing, fix the number of channels, maybe as 1 not 2
+   mChannels = (chanMap && chanMap[0] != ChannelNameEOL &&
+      chanMap[1] == ChannelNameFrontRight) ? 2 : 1;
+   mProcessor.SetSettings(GetSettings(settings));
+   mProcessor.Init(sampleRate, mChannels);
+   return true;
+}
+
+size_t EffectDynamicCompressor::Instance::ProcessBlock(
+   EffectSettings& settings,
+   const float* const* inBlock, float* const* outBlock, size_t blockLen)
+{
+   return InstanceProcess(settings, mProcessor, inBlock, outBlock, blockLen);
+}
+
+SampleCount EffectDynamicCompressor::Instance::GetLatency(
+   const EffectSettings &settings, double sampleRate) const
+{
+   // Computed as CompressorProcessor does, so it is right even before
+   // initialization
+   const auto lookaheadMs = std::clamp(GetSettings(settings).lookaheadMs,
+      0.0, CompressorProcessor::maxLookaheadMs);
+   return std::lround(lookaheadMs * sampleRate / 1000);
+}
+
+bool EffectDynamicCompressor::Instance::RealtimeInitialize(
+   EffectSettings&, double)
+{
+   SetBlockSize(CompressorProcessor::maxBlockSize);
+   mSlaves.clear();
+   return true;
+}
+
+bool EffectDynamicCompressor::Instance::RealtimeAddProcessor(
+   EffectSettings& settings, EffectOutputs *, unsigned numChannels,
+   float sampleRate)
+{
+   auto pProcessor =
+      std::make_unique<CompressorProcessor>(GetSettings(settings));
+   pProcessor->Init(sampleRate, numChannels);
+   mSlaves.push_back(move(pProcessor));
+   return true;
+}
+
+bool EffectDynamicCompressor::Instance::RealtimeFinalize(
+   EffectSettings&) noexcept
+{
+   mSlaves.clear();
+   return true;
+}
+
+size_t EffectDynamicCompressor::Instance::RealtimeProcess(size_t group,
+   EffectSettings& settings,
+   const float* const* inbuf, float* const* outbuf, size_t numSamples)
+{
+   if (group >= mSlaves.size())
+      return 0;
+   return InstanceProcess(settings, *mSlaves[group], inbuf, outbuf,
+      numSamples);
+}
+
+bool EffectDynamicCompressor::Instance::RealtimeSuspend()
+{
+   for (auto &pProcessor : mSlaves)
+      pProcessor->Reset();
+   return true;
+}
+
+size_t EffectDynamicCompressor::Instance::InstanceProcess(
+   EffectSettings& settings, CompressorProcessor& processor,
+   const float* const* inBlock, float* const* outBlock, size_t blockLen)
+{
+   // Settings may change between blocks while playing
+   auto &cs = GetSettings(settings);
+   if (cs != processor.GetSettings())
+      processor.SetSettings(cs);
+   processor.Process(inBlock, outBlock, static_cast<int>(blockLen));
+   return blockLen;
+}
+
+struct EffectDynamicCompressor::Editor
+   : EffectEditor
+{
+   Editor(const EffectUIServices& services,
+      EffectSettingsAccess& access, const CompressorSettings& settings
+   )  : EffectEditor{ services, access }
+      , mSettings{ settings }
+   {}
+   virtual ~Editor() = default;
+
+   bool ValidateUI() override;
+   bool UpdateUI() override;
+
+   void PopulateOrExchange(ShuttleGui& S);
+
+   CompressorSettings mSettings;
+};
+
+std::unique_ptr<EffectEditor> EffectDynamicCompressor::MakeEditor(
+   ShuttleGui& S, EffectInstance&, EffectSettingsAccess& access,
+   const EffectOutputs *) const
+{
+   auto& settings = access.Get();
+   auto& myEffSettings = GetSettings(settings);
+
+   auto result = std::make_unique<Editor>(*this, access, myEffSettings);
+   result->PopulateOrExchange(S);
+   return result;
+}
+
+void EffectDynamicCompressor::Editor::PopulateOrExchange(ShuttleGui & S)
+{
+   S.AddSpace(0, 5);
+
+   S.StartMultiColumn(2, wxALIGN_CENTER);
+   {
+      S.Validator<FloatingPointValidator<double>>(
+            1, &mSettings.thresholdDb, NumValidatorStyle::ONE_TRAILING_ZERO,
+            Threshold.min, Threshold.max)
+         .AddTextBox(XXO("&Threshold (dB):"), L"", 10);
+
+      S.Validator<FloatingPointValidator<double>>(
+            1, &mSettings.makeupGainDb, NumValidatorStyle::ONE_TRAILING_ZERO,
+            MakeupGain.min, MakeupGain.max)
+         .AddTextBox(XXO("&Make-up gain (dB):"), L"", 10);
+
+      S.Validator<FloatingPointValidator<double>>(
+            1, &mSettings.kneeWidthDb, NumValidatorStyle::ONE_TRAILING_ZERO,
+            KneeWidth.min, KneeWidth.max)
+         .AddTextBox(XXO("&Knee width (dB):"), L"", 10);
+
+      S.Validator<FloatingPointValidator<double>>(
+            1, &mSettings.ratio, NumValidatorStyle::ONE_TRAILING_ZERO,
+            Ratio.min, Ratio.max)
+         .AddTextBox(XXO("&Ratio:"), L"", 10);
+
+      S.Validator<FloatingPointValidator<double>>(
+            1, &mSettings.lookaheadMs, NumValidatorStyle::ONE_TRAILING_ZERO,
+            Lookahead.min, Lookahead.max)
+         .AddTextBox(XXO("&Lookahead (ms):"), L"", 10);
+
+      S.Validator<FloatingPointValidator<double>>(
+            1, &mSettings.attackMs, NumValidatorStyle::ONE_TRAILING_ZERO,
+            Attack.min, Attack.max)
+         .AddTextBox(XXO("&Attack (ms):"), L"", 10);
+
+      S.Validator<FloatingPointValidator<double>>(
+            1, &mSettings.releaseMs, NumValidatorStyle::ONE_TRAILING_ZERO,
+            Release.min, Release.max)
+         .AddTextBox(XXO("R&elease (ms):"), L"", 10);
+   }
+   S.EndMultiColumn();
+}
+
+bool EffectDynamicCompressor::Editor::ValidateUI()
+{
+   mAccess.ModifySettings
+   (
+      [this](EffectSettings& settings)
+      {
+         // pass back the modified settings to the MessageBuffer
+
+         EffectDynamicCompressor::GetSettings(settings) = mSettings;
+         return nullptr;
+      }
+   );
+
+   return true;
+}
+
+bool EffectDynamicCompressor::Editor::UpdateUI()
+{
+   // get the settings from the MessageBuffer and write them to our local copy
+   mSettings = GetSettings(mAccess.Get());
+   return true;
+}
@@ -0,0 +1,70 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  DynamicCompressor.h
+
+**********************************************************************/
+
+#ifndef __AUDACITY_EFFECT_DYNAMIC_COMPRESSOR__
+#define __AUDACITY_EFFECT_DYNAMIC_COMPRESSOR__
+
+#include "StatelessPerTrackEffect.h"
+#include "ShuttleAutomation.h"
+#include "CompressorProcessor.h"
+
+class EffectDynamicCompressor final : public EffectWithSettings<
+   CompressorSettings, StatelessPerTrackEffect
+>
+{
+public:
+   static const ComponentInterfaceSymbol Symbol;
+
+   EffectDynamicCompressor();
+   virtual ~EffectDynamicCompressor();
+
+   // ComponentInterface implementation
+
+   ComponentInterfaceSymbol GetSymbol() const override;
+   TranslatableString GetDescription() const override;
+   ManualPageID ManualPage() const override;
+
+   // EffectDefinitionInterface implementation
+
+   EffectType GetType() const override;
+   RealtimeSince RealtimeSupport() const override;
+
+   // Effect implementation
+
+   std::unique_ptr<EffectEditor> MakeEditor(
+      ShuttleGui & S, EffectInstance &instance,
+      EffectSettingsAccess &access, const EffectOutputs *pOutputs)
+   const override;
+
+   struct Editor;
+
+   struct Instance;
+
+   std::shared_ptr<EffectInstance> MakeInstance() const override;
+
+private:
+   const EffectParameterMethods& Parameters() const override;
+
+static constexpr EffectParameter Threshold{ &CompressorSettings::thresholdDb,
+   L"Threshold", CompressorSettings::thresholdDbDefault, -60.0, 0.0, 1 };
+static constexpr EffectParameter MakeupGain{ &CompressorSettings::makeupGainDb,
+   L"MakeupGain", CompressorSettings::makeupGainDbDefault, 0.0, 30.0, 1 };
+static constexpr EffectParameter KneeWidth{ &CompressorSettings::kneeWidthDb,
+   L"KneeWidth", CompressorSettings::kneeWidthDbDefault, 0.0, 30.0, 1 };
+static constexpr EffectParameter Ratio{ &CompressorSettings::ratio,
+   L"Ratio", CompressorSettings::ratioDefault, 1.0, 100.0, 1 };
+static constexpr EffectParameter Lookahead{ &CompressorSettings::lookaheadMs,
+   L"Lookahead", CompressorSettings::lookaheadMsDefault,
+   0.0, CompressorProcessor::maxLookaheadMs, 1 };
+static constexpr EffectParameter Attack{ &CompressorSettings::attackMs,
+   L"Attack", CompressorSettings::attackMsDefault, 0.0, 1000.0, 1 };
+static constexpr EffectParameter Release{ &CompressorSettings::releaseMs,
+   L"Release", CompressorSettings::releaseMsDefault, 0.0, 5000.0, 1 };
+};
+
+#endif
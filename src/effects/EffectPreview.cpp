@@ -172,12 +172,12 @@ void EffectPreview(EffectBase &effect,
 
    if (success)
    {
-      auto tracks = MakeTransportTracks(*mTracks, true);
-
       // Some effects (Paulstretch) may need to generate more
       // than previewLen, so take the min.
       t1 = std::min(mT0 + previewLen, mT1);
 
+      auto tracks = MakeTransportTracks(*mTracks, mT0, t1, true);
+
       // Start audio playing
       auto options = ProjectAudioIO::GetDefaultOptions(*pProject);
       int token = gAudioIO->StartStream(tracks, mT0, t1, t1, options);
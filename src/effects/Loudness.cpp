@@ -16,6 +16,7 @@
 #include "EBUR128.h"
 #include "EffectEditor.h"
 #include "EffectOutputTracks.h"
+#include "PrefetchingChannelReader.h"
 
 #include <math.h>
 
@@ -110,7 +111,6 @@ bool EffectLoudness::Process(EffectInstance &, EffectSettings &)
    bool bGoodResult = true;
    auto topMsg = XO("Normalizing Loudness...\n");
 
-   AllocBuffers(outputs.Get());
    mProgressVal = 0;
 
    for (auto pTrack : outputs.Get().Selected<WaveTrack>()) {
@@ -178,10 +178,8 @@ bool EffectLoudness::Process(EffectInstance &, EffectSettings &)
                extent = sqrt((RMS[0] * RMS[0] + RMS[1] * RMS[1]) / 2.0);
          }
 
-         if (extent == 0.0) {
-            FreeBuffers();
+         if (extent == 0.0)
             return false;
-         }
          float mult = ratio / extent;
 
          if (mNormalizeTo == kLoudness) {
@@ -211,8 +209,8 @@ bool EffectLoudness::Process(EffectInstance &, EffectSettings &)
       }
       else {
          // processOne captured nChannels which is 2 and is passed to
-         // LoadBufferBlock, StoreBufferBlock which find the track from the
-         // channel and iterate channels
+         // ProcessOne, which finds the track from the channel and iterates
+         // channels
          if (!(bGoodResult = processOne(**pTrack->Channels().begin())))
             break;
       }
@@ -222,7 +220,6 @@ done:
    if (bGoodResult)
       outputs.Commit();
 
-   FreeBuffers();
    return bGoodResult;
 }
 
@@ -350,38 +347,6 @@ bool EffectLoudness::TransferDataFromWindow(EffectSettings &)
 
 // EffectLoudness implementation
 
-/// Get required buffer size for the largest whole track and allocate buffers.
-/// This reduces the amount of allocations required.
-void EffectLoudness::AllocBuffers(TrackList &outputs)
-{
-   mTrackBufferCapacity = 0;
-   bool stereoTrackFound = false;
-   double maxSampleRate = 0;
-   mProcStereo = false;
-
-   for (auto track : outputs.Selected<WaveTrack>() + &Track::Any) {
-      mTrackBufferCapacity = std::max(mTrackBufferCapacity, track->GetMaxBlockSize());
-      maxSampleRate = std::max(maxSampleRate, track->GetRate());
-
-      // There is a stereo track
-      if(track->NChannels() == 2)
-         stereoTrackFound = true;
-   }
-
-   // Initiate a processing buffer. This buffer will (most likely)
-   // be shorter than the length of the track being processed.
-   mTrackBuffer[0].reinit(mTrackBufferCapacity);
-
-   if(!mStereoInd && stereoTrackFound)
-      mTrackBuffer[1].reinit(mTrackBufferCapacity);
-}
-
-void EffectLoudness::FreeBuffers()
-{
-   mTrackBuffer[0].reset();
-   mTrackBuffer[1].reset();
-}
-
 bool EffectLoudness::GetTrackRMS(WaveChannel &track,
    const double curT0, const double curT1, float &rms)
 {
@@ -414,100 +379,87 @@ bool EffectLoudness::ProcessOne(WaveChannel &track, size_t nChannels,
    if (curT1 <= curT0)
       return false;
 
-   // Go through the track one buffer at a time. s counts which
-   // sample the current buffer starts at.
-   auto s = start;
-   while (s < end) {
-      // Get a block of samples (smaller than the size of the buffer)
-      // Adjust the block size if it is the final block in the track
-      auto blockLen = limitSampleBufferSize(
-         track.GetBestBlockSize(s),
-         mTrackBufferCapacity);
-
-      const size_t remainingLen = (end - s).as_size_t();
-      blockLen = blockLen > remainingLen ? remainingLen : blockLen;
-      LoadBufferBlock(track, nChannels, s, blockLen);
+   std::vector<const WaveChannel *> channels;
+   if (nChannels == 1)
+      channels.push_back(&track);
+   else
+      for (const auto pChannel : track.GetTrack().Channels())
+         channels.push_back(pChannel.get());
 
+   // Go through the track one block at a time, while the next block is read
+   // in the background.
+   PrefetchingChannelReader reader{ move(channels), start, end };
+   while (reader.Next()) {
       // Process the buffer.
       if (pLoudnessProcessor) {
-         if (!AnalyseBufferBlock(*pLoudnessProcessor))
+         if (!AnalyseBufferBlock(reader, *pLoudnessProcessor))
             return false;
       }
       else {
-         if (!ProcessBufferBlock(mult))
+         if (!ProcessBufferBlock(reader, mult))
             return false;
-         if (!StoreBufferBlock(track, nChannels, s, blockLen))
+         // Write only after the read of the next block completes
+         reader.Wait();
+         if (!StoreBufferBlock(track, reader))
             return false;
       }
-
-      // Increment s one blockfull of samples
-      s += blockLen;
    }
 
    // Return true because the effect processing succeeded ... unless cancelled
    return true;
 }
 
-void EffectLoudness::LoadBufferBlock(WaveChannel &track, size_t nChannels,
-   sampleCount pos, size_t len)
-{
-   size_t idx = 0;
-   const auto getOne = [&](WaveChannel &channel) {
-      // Get the samples from the track and put them in the buffer
-      channel.GetFloats(mTrackBuffer[idx].get(), pos, len);
-   };
-
-   if (nChannels == 1)
-      getOne(track);
-   else
-      for (const auto channel : track.GetTrack().Channels()) {
-         getOne(*channel);
-         ++idx;
-      }
-   mTrackBufferLen = len;
-}
-
 /// Calculates sample sum (for DC) and EBU R128 weighted square sum
 /// (for loudness).
-bool EffectLoudness::AnalyseBufferBlock(EBUR128 &loudnessProcessor)
+bool EffectLoudness::AnalyseBufferBlock(
+   const PrefetchingChannelReader &reader, EBUR128 &loudnessProcessor)
 {
-   for(size_t i = 0; i < mTrackBufferLen; i++)
+   const auto len = reader.Length();
+   const auto buffer0 = reader.GetBuffer(0);
+   const auto buffer1 = mProcStereo ? reader.GetBuffer(1) : nullptr;
+   for(size_t i = 0; i < len; i++)
    {
-      loudnessProcessor.ProcessSampleFromChannel(mTrackBuffer[0][i], 0);
+      loudnessProcessor.ProcessSampleFromChannel(buffer0[i], 0);
       if (mProcStereo)
-         loudnessProcessor.ProcessSampleFromChannel(mTrackBuffer[1][i], 1);
+         loudnessProcessor.ProcessSampleFromChannel(buffer1[i], 1);
       loudnessProcessor.NextSample();
    }
 
-   if (!UpdateProgress())
+   if (!UpdateProgress(len))
       return false;
    return true;
 }
 
-bool EffectLoudness::ProcessBufferBlock(const float mult)
+bool EffectLoudness::ProcessBufferBlock(
+   PrefetchingChannelReader &reader, const float mult)
 {
-   for(size_t i = 0; i < mTrackBufferLen; i++)
+   const auto len = reader.Length();
+   const auto buffer0 = reader.GetBuffer(0);
+   const auto buffer1 = mProcStereo ? reader.GetBuffer(1) : nullptr;
+   for(size_t i = 0; i < len; i++)
    {
-      mTrackBuffer[0][i] = mTrackBuffer[0][i] * mult;
+      buffer0[i] = buffer0[i] * mult;
       if (mProcStereo)
-         mTrackBuffer[1][i] = mTrackBuffer[1][i] * mult;
+         buffer1[i] = buffer1[i] * mult;
    }
 
-   if(!UpdateProgress())
+   if(!UpdateProgress(len))
       return false;
    return true;
 }
 
-bool EffectLoudness::StoreBufferBlock(WaveChannel &track, size_t nChannels,
-   sampleCount pos, size_t len)
+bool EffectLoudness::StoreBufferBlock(
+   WaveChannel &track, PrefetchingChannelReader &reader)
 {
+   const auto pos = reader.Position();
+   const auto len = reader.Length();
    size_t idx = 0;
    const auto setOne = [&](WaveChannel &channel){
       // Copy the newly-changed samples back onto the track.
-      return channel.SetFloats(mTrackBuffer[idx].get(), pos, len);
+      return channel.SetFloats(reader.GetBuffer(idx), pos, len);
    };
 
-   if (nChannels == 1)
+   if (reader.NChannels() == 1)
       return setOne(track);
    else {
       for (auto channel : track.GetTrack().Channels()) {
@@ -519,9 +471,9 @@ bool EffectLoudness::StoreBufferBlock(WaveChannel &track, size_t nChannels,
    }
 }
 
-bool EffectLoudness::UpdateProgress()
+bool EffectLoudness::UpdateProgress(size_t len)
 {
-   mProgressVal += (double(1 + mProcStereo) * double(mTrackBufferLen)
+   mProgressVal += (double(1 + mProcStereo) * double(len)
                  / (double(GetNumWaveTracks()) * double(mSteps) * mTrackLen));
    return !TotalProgress(mProgressVal, mProgressMsg);
 }
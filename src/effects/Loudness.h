@@ -25,6 +25,7 @@
 class wxChoice;
 class wxSimplebook;
 class EBUR128;
+class PrefetchingChannelReader;
 class ShuttleGui;
 class WaveChannel;
 using Floats = ArrayOf<float>;
@@ -68,20 +69,17 @@ public:
 private:
    // EffectLoudness implementation
 
-   void AllocBuffers(TrackList &outputs);
-   void FreeBuffers();
    static bool GetTrackRMS(WaveChannel &track,
       double curT0, double curT1, float &rms);
    [[nodiscard]] bool ProcessOne(WaveChannel &track, size_t nChannels,
       double curT0, double curT1, float mult, EBUR128 *pLoudnessProcessor);
-   void LoadBufferBlock(WaveChannel &track, size_t nChannels,
-      sampleCount pos, size_t len);
-   bool AnalyseBufferBlock(EBUR128 &loudnessProcessor);
-   bool ProcessBufferBlock(float mult);
-   [[nodiscard]] bool StoreBufferBlock(WaveChannel &track, size_t nChannels,
-      sampleCount pos, size_t len);
-
-   bool UpdateProgress();
+   bool AnalyseBufferBlock(const PrefetchingChannelReader &reader,
+      EBUR128 &loudnessProcessor);
+   bool ProcessBufferBlock(PrefetchingChannelReader &reader, float mult);
+   [[nodiscard]] bool StoreBufferBlock(WaveChannel &track,
+      PrefetchingChannelReader &reader);
+
+   bool UpdateProgress(size_t len);
    void OnChoice(wxCommandEvent & evt);
    void OnUpdateUI(wxCommandEvent & evt);
    void UpdateUI();
@@ -107,9 +105,6 @@ private:
    wxCheckBox *mStereoIndCheckBox;
    wxCheckBox *mDualMonoCheckBox;
 
-   Floats mTrackBuffer[2];    // MM: must be increased once surround channels are supported
-   size_t mTrackBufferLen;
-   size_t mTrackBufferCapacity;
    bool   mProcStereo;
 
    const EffectParameterMethods& Parameters() const override;
@@ -17,6 +17,7 @@
 #include "EffectEditor.h"
 #include "EffectOutputTracks.h"
 #include "LoadEffects.h"
+#include "PrefetchingChannelReader.h"
 
 #include <math.h>
 
@@ -348,40 +349,24 @@ bool EffectNormalize::AnalyseTrackData(const WaveChannel &track,
    //to make it a double now than it is to do it later
    auto len = (end - start).as_double();
 
-   //Initiate a processing buffer.  This buffer will (most likely)
-   //be shorter than the length of the track being processed.
-   Floats buffer{ track.GetMaxBlockSize() };
-
    double sum = 0.0; // dc offset inits
 
-   sampleCount blockSamples;
    sampleCount totalSamples = 0;
 
-   //Go through the track one buffer at a time. s counts which
-   //sample the current buffer starts at.
-   auto s = start;
-   while (s < end) {
-      //Get a block of samples (smaller than the size of the buffer)
-      //Adjust the block size if it is the final block in the track
-      const auto block = limitSampleBufferSize(
-         track.GetBestBlockSize(s),
-         end - s
-      );
-
-      //Get the samples from the track and put them in the buffer
-      track.GetFloats(
-         buffer.get(), s, block, FillFormat::fillZero, true, &blockSamples);
-      totalSamples += blockSamples;
+   //Go through the track one block at a time, while the next block is read
+   //in the background.
+   PrefetchingChannelReader reader{ { &track }, start, end };
+   while (reader.Next()) {
+      const auto s = reader.Position();
+      const auto block = reader.Length();
+      totalSamples += reader.NumWithinClips();
 
       //Process the buffer.
-      sum = AnalyseDataDC(buffer.get(), block, sum);
-
-      //Increment s one blockfull of samples
-      s += block;
+      sum = AnalyseDataDC(reader.GetBuffer(0), block, sum);
 
       //Update the Progress meter
-      if (!report((s - start).as_double() / len)) {
-         rc = false; //lda .. break, not return, so that buffer is deleted
+      if (!report((s + block - start).as_double() / len)) {
+         rc = false;
          break;
       }
    }
@@ -413,40 +398,29 @@ bool EffectNormalize::ProcessOne(WaveChannel &track,
    //to make it a double now than it is to do it later
    auto len = (end - start).as_double();
 
-   //Initiate a processing buffer.  This buffer will (most likely)
-   //be shorter than the length of the track being processed.
-   Floats buffer{ track.GetMaxBlockSize() };
-
-   //Go through the track one buffer at a time. s counts which
-   //sample the current buffer starts at.
-   auto s = start;
-   while (s < end) {
-      //Get a block of samples (smaller than the size of the buffer)
-      //Adjust the block size if it is the final block in the track
-      const auto block = limitSampleBufferSize(
-         track.GetBestBlockSize(s),
-         end - s
-      );
-
-      //Get the samples from the track and put them in the buffer
-      track.GetFloats(buffer.get(), s, block);
+   //Go through the track one block at a time, while the next block is read
+   //in the background.
+   PrefetchingChannelReader reader{ { &track }, start, end };
+   while (reader.Next()) {
+      const auto s = reader.Position();
+      const auto block = reader.Length();
+      const auto buffer = reader.GetBuffer(0);
 
       //Process the buffer.
-      ProcessData(buffer.get(), block, offset);
+      ProcessData(buffer, block, offset);
 
-      //Copy the newly-changed samples back onto the track.
-      if (!track.SetFloats(buffer.get(), s, block)) {
+      //Copy the newly-changed samples back onto the track, after the read
+      //of the next block completes
+      reader.Wait();
+      if (!track.SetFloats(buffer, s, block)) {
          rc = false;
          break;
       }
 
-      //Increment s one blockfull of samples
-      s += block;
-
       //Update the Progress meter
       if (TotalProgress(progress +
-                        ((s - start).as_double() / len)/double(2*GetNumWaveTracks()), msg)) {
-         rc = false; //lda .. break, not return, so that buffer is deleted
+                        ((s + block - start).as_double() / len)/double(2*GetNumWaveTracks()), msg)) {
+         rc = false;
          break;
       }
    }
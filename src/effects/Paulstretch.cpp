@@ -19,6 +19,10 @@
 #include "LoadEffects.h"
 
 #include <algorithm>
+#include <cstdint>
+#include <future>
+#include <random>
+#include <thread>
 
 #include <math.h>
 
@@ -26,6 +30,7 @@
 
 #include "ShuttleGui.h"
 #include "FFT.h"
+#include "PowerSpectrumGetter.h"
 #include "../widgets/valnum.h"
 #include "AudacityMessageBox.h"
 #include "Prefs.h"
@@ -34,6 +39,27 @@
 
 #include "WaveTrack.h"
 
+namespace {
+//! Phases are random but reproducible: they depend only on this, the channel,
+//! and the position of the window, not on the order of computation
+constexpr uint64_t phaseSeed = 0x5eed'9a01'5773'7c4bULL;
+
+//! Windows of one batch per thread
+constexpr size_t windowsPerThread = 4;
+//! Bound on samples of windows held at once, when windows are long
+constexpr size_t maxBatchSamples = 1 << 24;
+
+uint32_t WindowSeed(int channel, uint64_t window)
+{
+   // splitmix64 finalizer
+   auto z = phaseSeed + (uint64_t(channel) << 40) +
+      window * 0x9e3779b97f4a7c15ULL;
+   z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+   z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+   return static_cast<uint32_t>(z ^ (z >> 31));
+}
+}
+
 const EffectParameterMethods& EffectPaulstretch::Parameters() const
 {
    static CapturedParameters<EffectPaulstretch,
@@ -44,6 +70,12 @@ const EffectParameterMethods& EffectPaulstretch::Parameters() const
 
 /// \brief Class that helps EffectPaulStretch.  It does the FFTs and inner loop
 /// of the effect.
+/*!
+ Each output buffer depends only on two windows of input, each transformed
+ with its own random phases, so that windows can be computed in any order and
+ on several threads at once; only the schedule of input positions in
+ get_nsamples() is sequential.
+ */
 class PaulStretch
 {
 public:
@@ -51,13 +83,29 @@ public:
    //in_bufsize is also a half of a FFT buffer (in samples)
    virtual ~PaulStretch();
 
-   void process(float *smps, size_t nsmps);
+   //! FFT plan and buffers for one thread
+   struct Workspace {
+      explicit Workspace(size_t poolsize);
+      PffftSetupHolder setup;
+      PffftFloatVector spectrum, work;
+   };
+
+   //! Transform `poolsize` samples of input with phases randomized from
+   //! `seed`, into `poolsize` samples of `result`
+   /*! Safe to call concurrently with distinct workspaces */
+   void process_window(const float *pool, float *result, uint32_t seed,
+      Workspace &workspace) const;
+
+   //! Overlap-add the first half of the previous window with the second half
+   //! of the current window into out_bufsize samples
+   void make_output(const float *previous, const float *current, float *out)
+      const;
 
    size_t get_nsamples();//how many samples are required to be added in the pool next time
    size_t get_nsamples_for_fill();//how many samples are required to be added for a complete buffer refill (at start of the song or after seek)
 
 private:
-   void process_spectrum(float *WXUNUSED(freq)) {};
+   void process_spectrum(float *WXUNUSED(freq)) const {};
 
    const float samplerate;
    const float rap;
@@ -65,20 +113,13 @@ private:
 
 public:
    const size_t out_bufsize;
-   const Floats out_buf;
-
-private:
-   const Floats old_out_smp_buf;
-
-public:
    const size_t poolsize;//how many samples are inside the input_pool size (need to know how many samples to fill when seeking)
 
 private:
-   const Floats in_pool;//de marimea in_bufsize
-
    double remained_samples;//how many fraction of samples has remained (0..1)
 
-   const Floats fft_smps, fft_c, fft_s, fft_freq, fft_tmp;
+   //! Hann window of poolsize samples
+   const Floats window;
 };
 
 //
@@ -349,55 +390,112 @@ bool EffectPaulstretch::ProcessOne(const WaveChannel &track,
 
       PaulStretch stretch(amount, stretch_buf_size, rate);
 
-      auto nget = stretch.get_nsamples_for_fill();
+      const auto poolsize = stretch.poolsize;
+      const auto fade_len = std::min<size_t>(100, poolsize / 2 - 1);
+      Floats fade_track_smps{ fade_len };
+      Floats out_buf{ stretch.out_bufsize };
+      // First half of the most recent window
+      Floats previous{ stretch.out_bufsize };
+
+      // Windows are transformed in batches, on all threads, each with its
+      // own FFT plan; the batch is bounded in memory for long windows
+      const size_t nThreads =
+         std::max(1u, std::thread::hardware_concurrency());
+      const auto batchSize = std::max(nThreads, std::min(
+         nThreads * windowsPerThread, maxBatchSamples / poolsize));
+      std::vector<PaulStretch::Workspace> workspaces;
+      workspaces.reserve(nThreads);
+      for (size_t ii = 0; ii < nThreads; ++ii)
+         workspaces.emplace_back(poolsize);
+      Floats windows{ batchSize * poolsize };
+      std::vector<float> input;
+      // End positions of windows of the batch, relative to start
+      std::vector<sampleCount> ends;
+      ends.reserve(batchSize);
 
-      auto bufsize = stretch.poolsize;
-      Floats buffer0{ bufsize };
-      float *bufferptr0 = buffer0.get();
+      auto nget = stretch.get_nsamples_for_fill();
+      decltype(len) s = 0;
+      // Count of windows so far, including the one that primes `previous`
+      uint64_t nWindows = 0;
       bool first_time = true;
-
-      const auto fade_len = std::min<size_t>(100, bufsize / 2 - 1);
       bool cancelled = false;
 
-      {
-         Floats fade_track_smps{ fade_len };
-         decltype(len) s=0;
+      while (!cancelled && s < len) {
+         // The schedule of input positions does not depend on the data
+         ends.clear();
+         while (s < len && ends.size() < batchSize) {
+            s += nget;
+            ends.push_back(s);
+            nget = stretch.get_nsamples();
+         }
 
-         while (s < len) {
-            track.GetFloats(bufferptr0, start + s, nget);
-            stretch.process(buffer0.get(), nget);
+         // Sample blocks are read on this thread only
+         const auto spanStart = ends.front() - poolsize;
+         const auto spanLen = (ends.back() - spanStart).as_size_t();
+         input.resize(spanLen);
+         track.GetFloats(input.data(), start + spanStart, spanLen);
+
+         if (first_time) {
+            // Fill `previous` from the first window, with other phases
+            stretch.process_window(input.data(), windows.get(),
+               WindowSeed(count, nWindows++), workspaces[0]);
+            std::copy(windows.get(), windows.get() + stretch.out_bufsize,
+               previous.get());
+         }
 
-            if (first_time) {
-               stretch.process(buffer0.get(), 0);
-            };
+         const auto nBatch = ends.size();
+         const auto transform = [&, nWindows](size_t iThread) {
+            for (auto ii = iThread; ii < nBatch; ii += nThreads) {
+               const auto offset =
+                  (ends[ii] - poolsize - spanStart).as_size_t();
+               stretch.process_window(input.data() + offset,
+                  windows.get() + ii * poolsize,
+                  WindowSeed(count, nWindows + ii), workspaces[iThread]);
+            }
+         };
+         {
+            std::vector<std::future<void>> futures;
+            for (size_t iThread = 1; iThread < std::min(nThreads, nBatch);
+               ++iThread)
+               futures.push_back(
+                  std::async(std::launch::async, transform, iThread));
+            transform(0);
+            for (auto &future : futures)
+               future.get();
+         }
+         nWindows += nBatch;
 
-            s += nget;
+         // Overlap-add in order
+         for (size_t ii = 0; ii < nBatch; ++ii) {
+            const auto current = windows.get() + ii * poolsize;
+            stretch.make_output(previous.get(), current, out_buf.get());
+            std::copy(current, current + stretch.out_bufsize, previous.get());
 
             if (first_time){//blend the start of the selection
                track.GetFloats(fade_track_smps.get(), start, fade_len);
                first_time = false;
                for (size_t i = 0; i < fade_len; i++){
                   float fi = (float)i / (float)fade_len;
-                  stretch.out_buf[i] =
-                     stretch.out_buf[i] * fi + (1.0 - fi) * fade_track_smps[i];
+                  out_buf[i] =
+                     out_buf[i] * fi + (1.0 - fi) * fade_track_smps[i];
                }
             }
-            if (s >= len){//blend the end of the selection
+            if (ends[ii] >= len){//blend the end of the selection
                track.GetFloats(fade_track_smps.get(), end - fade_len, fade_len);
                for (size_t i = 0; i < fade_len; i++){
                   float fi = (float)i / (float)fade_len;
-                  auto i2 = bufsize / 2 - 1 - i;
-                  stretch.out_buf[i2] =
-                     stretch.out_buf[i2] * fi + (1.0 - fi) *
+                  auto i2 = poolsize / 2 - 1 - i;
+                  out_buf[i2] =
+                     out_buf[i2] * fi + (1.0 - fi) *
                      fade_track_smps[fade_len - 1 - i];
                }
             }
 
-            outputTrack.Append((samplePtr)stretch.out_buf.get(), floatSample, stretch.out_bufsize);
+            outputTrack.Append((samplePtr)out_buf.get(), floatSample,
+               stretch.out_bufsize);
 
-            nget = stretch.get_nsamples();
             if (TrackProgress(count,
-               s.as_double() / len.as_double()
+               ends[ii].as_double() / len.as_double()
             )) {
                cancelled = true;
                break;
@@ -422,77 +520,62 @@ PaulStretch::PaulStretch(float rap_, size_t in_bufsize_, float samplerate_ )
    , rap { std::max(1.0f, rap_) }
    , in_bufsize { in_bufsize_ }
    , out_bufsize { std::max(size_t{ 8 }, in_bufsize) }
-   , out_buf { out_bufsize }
-   , old_out_smp_buf { out_bufsize * 2, true }
    , poolsize { in_bufsize_ * 2 }
-   , in_pool { poolsize, true }
    , remained_samples { 0.0 }
-   , fft_smps { poolsize, true }
-   , fft_c { poolsize, true }
-   , fft_s { poolsize, true }
-   , fft_freq { poolsize, true }
-   , fft_tmp { poolsize }
+   , window { poolsize }
 {
+   std::fill(window.get(), window.get() + poolsize, 1.0f);
+   WindowFunc(eWinFuncHann, poolsize, window.get());
 }
 
 PaulStretch::~PaulStretch()
 {
 }
 
-void PaulStretch::process(float *smps, size_t nsmps)
+PaulStretch::Workspace::Workspace(size_t poolsize)
+   : setup{ pffft_new_setup(poolsize, PFFFT_REAL) }
+   , spectrum(poolsize)
+   , work(poolsize)
 {
-   //add NEW samples to the pool
-   if ((smps != NULL) && (nsmps != 0)) {
-      if (nsmps > poolsize) {
-         nsmps = poolsize;
-      }
-      int nleft = poolsize - nsmps;
-
-      //move left the samples from the pool to make room for NEW samples
-      for (int i = 0; i < nleft; i++)
-         in_pool[i] = in_pool[i + nsmps];
-
-      //add NEW samples to the pool
-      for (size_t i = 0; i < nsmps; i++)
-         in_pool[i + nleft] = smps[i];
-   }
+}
 
-   //get the samples from the pool
+void PaulStretch::process_window(const float *pool, float *result,
+   uint32_t seed, Workspace &workspace) const
+{
+   const auto fft_smps = workspace.spectrum.data();
    for (size_t i = 0; i < poolsize; i++)
-      fft_smps[i] = in_pool[i];
-   WindowFunc(eWinFuncHann, poolsize, fft_smps.get());
+      fft_smps[i] = pool[i] * window[i];
 
-   RealFFT(poolsize, fft_smps.get(), fft_c.get(), fft_s.get());
-
-   for (size_t i = 0; i < poolsize / 2; i++)
-      fft_freq[i] = sqrt(fft_c[i] * fft_c[i] + fft_s[i] * fft_s[i]);
-   process_spectrum(fft_freq.get());
+   // Ordered real spectrum: DC, Nyquist, then interleaved real and imaginary
+   // parts of the other bins
+   pffft_transform_ordered(workspace.setup.get(), fft_smps, fft_smps,
+      workspace.work.data(), PFFFT_FORWARD);
 
+   process_spectrum(fft_smps);
 
    //put randomize phases to frequencies and do a IFFT
+   std::minstd_rand random{ seed };
    float inv_2p15_2pi = 1.0 / 16384.0 * (float)M_PI;
    for (size_t i = 1; i < poolsize / 2; i++) {
-      unsigned int random = (rand()) & 0x7fff;
-      float phase = random * inv_2p15_2pi;
-      float s = fft_freq[i] * sin(phase);
-      float c = fft_freq[i] * cos(phase);
-
-      fft_c[i] = fft_c[poolsize - i] = c;
-
-      fft_s[i] = s; fft_s[poolsize - i] = -s;
+      const auto re = fft_smps[2 * i], im = fft_smps[2 * i + 1];
+      const auto freq = sqrt(re * re + im * im);
+      float phase = (random() & 0x7fff) * inv_2p15_2pi;
+      fft_smps[2 * i] = freq * cos(phase);
+      fft_smps[2 * i + 1] = freq * sin(phase);
    }
-   fft_c[0] = fft_s[0] = 0.0;
-   fft_c[poolsize / 2] = fft_s[poolsize / 2] = 0.0;
+   fft_smps[0] = fft_smps[1] = 0.0;
 
-   FFT(poolsize, true, fft_c.get(), fft_s.get(), fft_smps.get(), fft_tmp.get());
-
-   float max = 0.0, max2 = 0.0;
-   for (size_t i = 0; i < poolsize; i++) {
-      max = std::max(max, fabsf(fft_tmp[i]));
-      max2 = std::max(max2, fabsf(fft_smps[i]));
-   }
+   pffft_transform_ordered(workspace.setup.get(), fft_smps, fft_smps,
+      workspace.work.data(), PFFFT_BACKWARD);
 
+   const float scale = 1.0f / poolsize;
+   for (size_t i = 0; i < poolsize; i++)
+      result[i] = fft_smps[i] * scale;
+}
 
+void PaulStretch::make_output(
+   const float *previous, const float *current, float *out) const
+{
    //make the output buffer
    float tmp = 1.0 / (float) out_bufsize * M_PI;
    float hinv_sqrt2 = 0.853553390593f;//(1.0+1.0/sqrt(2))*0.5;
@@ -505,15 +588,11 @@ void PaulStretch::process(float *smps, size_t nsmps)
 
    for (size_t i = 0; i < out_bufsize; i++) {
       float a = (0.5 + 0.5 * cos(i * tmp));
-      float out = fft_smps[i + out_bufsize] * (1.0 - a) + old_out_smp_buf[i] * a;
-      out_buf[i] =
-         out * (hinv_sqrt2 - (1.0 - hinv_sqrt2) * cos(i * 2.0 * tmp)) *
+      float out_smp = current[i + out_bufsize] * (1.0 - a) + previous[i] * a;
+      out[i] =
+         out_smp * (hinv_sqrt2 - (1.0 - hinv_sqrt2) * cos(i * 2.0 * tmp)) *
          ampfactor;
    }
-
-   //copy the current output buffer to old buffer
-   for (size_t i = 0; i < out_bufsize * 2; i++)
-      old_out_smp_buf[i] = fft_smps[i];
 }
 
 size_t PaulStretch::get_nsamples()
@@ -12,7 +12,9 @@
 
 #include "ExportAudioDialog.h"
 
+#include <algorithm>
 #include <numeric>
+#include <optional>
 
 #include <wx/frame.h>
 
@@ -869,37 +871,17 @@ ExportResult ExportAudioDialog::DoExportSplitByLabels(const ExportPlugin& plugin
                                                       const ExportProcessor::Parameters& parameters,
                                                       FilePaths& exporterFiles)
 {
-   auto ok = ExportResult::Success;   // did it work?
-   /* Go round again and do the exporting (so this run is slow but
-    * non-interactive) */
+   std::vector<SplitFile> files;
    for(auto& activeSetting : mExportSettings)
    {
       /* get the settings to use for the export from the array */
       // Bug 1440 fix.
       if( activeSetting.filename.GetName().empty() )
          continue;
-
-      // Export it
-      ok = DoExport(plugin, formatIndex, parameters, activeSetting.filename, activeSetting.channels,
-         activeSetting.t0, activeSetting.t1, false, activeSetting.tags, exporterFiles);
-      
-      if (ok == ExportResult::Stopped) {
-         AudacityMessageDialog dlgMessage(
-            nullptr,
-            XO("Continue to export remaining files?"),
-            XO("Export"),
-            wxYES_NO | wxNO_DEFAULT | wxICON_WARNING);
-         if (dlgMessage.ShowModal() != wxID_YES ) {
-            // User decided not to continue - bail out!
-            break;
-         }
-      }
-      else if (ok != ExportResult::Success) {
-         break;
-      }
+      files.push_back({ &activeSetting, nullptr });
    }
 
-   return ok;
+   return DoExportSplit(plugin, formatIndex, parameters, files, false, exporterFiles);
 }
 
 ExportResult ExportAudioDialog::DoExportSplitByTracks(const ExportPlugin& plugin,
@@ -922,131 +904,178 @@ ExportResult ExportAudioDialog::DoExportSplitByTracks(const ExportPlugin& plugin
    for (auto tr : tracks.Selected<WaveTrack>())
       tr->SetSelected(false);
 
-   auto ok = ExportResult::Success;
-
+   std::vector<SplitFile> files;
    int count = 0;
    for (auto tr : waveTracks) {
-
-      wxLogDebug( "Get setting %i", count );
       /* get the settings to use for the export from the array */
-      auto& activeSetting = mExportSettings[count];
-      if( activeSetting.filename.GetName().empty() ){
-         count++;
+      auto& activeSetting = mExportSettings[count++];
+      if( activeSetting.filename.GetName().empty() )
          continue;
-      }
-
-      /* Select the track */
-      SelectionStateChanger changer2{ selectionState, tracks };
-      tr->SetSelected(true);
-
-      // Export the data. "channels" are per track.
-      ok = DoExport(plugin, formatIndex, parameters, activeSetting.filename, activeSetting.channels,
-         activeSetting.t0, activeSetting.t1, true, activeSetting.tags, exporterFiles);
-      
-      if (ok == ExportResult::Stopped) {
-         AudacityMessageDialog dlgMessage(
-            nullptr,
-            XO("Continue to export remaining files?"),
-            XO("Export"),
-            wxYES_NO | wxNO_DEFAULT | wxICON_WARNING);
-         if (dlgMessage.ShowModal() != wxID_YES ) {
-            // User decided not to continue - bail out!
-            break;
-         }
-      }
-      
-      else if (ok != ExportResult::Success) {
-         break;
-      }
-      // increment export counter
-      count++;
+      files.push_back({ &activeSetting, tr });
    }
-   
-   
-   return ok ;
+
+   // Export the data. "channels" are per track.
+   return DoExportSplit(plugin, formatIndex, parameters, files, true, exporterFiles);
 }
 
-ExportResult ExportAudioDialog::DoExport(const ExportPlugin& plugin,
-                                         int formatIndex,
-                                         const ExportProcessor::Parameters& parameters,
-                                         const wxFileName& filename,
-                                         int channels,
-                                         double t0, double t1, bool selectedOnly,
-                                         const Tags& tags,
-                                         FilePaths& exportedFiles)
+namespace
 {
-   wxFileName name;
-
-   wxLogDebug(wxT("Doing multiple Export: File name \"%s\""), (filename.GetFullName()));
-   wxLogDebug(wxT("Channels: %i, Start: %lf, End: %lf "), channels, t0, t1);
-   if (selectedOnly)
-      wxLogDebug(wxT("Selected Region Only"));
-   else
-      wxLogDebug(wxT("Whole Project"));
-
-   wxFileName backup;
-   if (mOverwriteExisting->GetValue()) {
-      name = filename;
-      backup.Assign(name);
-
-      int suffix = 0;
-      do {
-         backup.SetName(name.GetName() +
-                           wxString::Format(wxT("%d"), suffix));
-         ++suffix;
+//! Chooses the path of an exported file, putting aside any file that it
+//! replaces, and afterward discards either that or the new file
+class ExportTarget final
+{
+public:
+   ExportTarget(const wxFileName& filename, bool overwrite)
+   {
+      wxFileName name;
+      if (overwrite) {
+         name = filename;
+         mBackup.Assign(name);
+
+         int suffix = 0;
+         do {
+            mBackup.SetName(name.GetName() +
+                              wxString::Format(wxT("%d"), suffix));
+            ++suffix;
+         }
+         while (mBackup.FileExists());
+         ::wxRenameFile(filename.GetFullPath(), mBackup.GetFullPath());
       }
-      while (backup.FileExists());
-      ::wxRenameFile(filename.GetFullPath(), backup.GetFullPath());
-   }
-   else {
-      name = filename;
-      int i = 2;
-      wxString base(name.GetName());
-      while (name.FileExists()) {
-         name.SetName(wxString::Format(wxT("%s-%d"), base, i++));
+      else {
+         name = filename;
+         int i = 2;
+         wxString base(name.GetName());
+         while (name.FileExists()) {
+            name.SetName(wxString::Format(wxT("%s-%d"), base, i++));
+         }
       }
+      mFullPath = name.GetFullPath();
    }
 
-   bool success{false};
-   const wxString fullPath{name.GetFullPath()};
+   const wxString& GetFullPath() const { return mFullPath; }
 
-   auto cleanup = finally( [&] {
-      if (backup.IsOk()) {
+   void Finish(bool success) const
+   {
+      if (mBackup.IsOk()) {
          if ( success )
             // Remove backup
-            ::wxRemoveFile(backup.GetFullPath());
+            ::wxRemoveFile(mBackup.GetFullPath());
          else {
             // Restore original
-            ::wxRemoveFile(fullPath);
-            ::wxRenameFile(backup.GetFullPath(), fullPath);
+            ::wxRemoveFile(mFullPath);
+            ::wxRenameFile(mBackup.GetFullPath(), mFullPath);
          }
       }
       else {
          if ( ! success )
             // Remove any new, and only partially written, file.
-            ::wxRemoveFile(fullPath);
+            ::wxRemoveFile(mFullPath);
       }
-   } );
-   
-   auto result = ExportResult::Error;
-   ExportProgressUI::ExceptionWrappedCall([&]
-   {
-      result = ExportProgressUI::Show(ExportTaskBuilder{}.SetPlugin(&plugin, formatIndex)
-                                    .SetParameters(parameters)
-                                    .SetRange(t0, t1, selectedOnly)
-                                    .SetTags(&tags)
-                                    .SetNumChannels(channels)
-                                    .SetFileName(fullPath)
-                                    .SetSampleRate(mExportOptionsPanel->GetSampleRate())
-                                    .Build(mProject));
-   });
-
-   success = result == ExportResult::Success || result == ExportResult::Stopped;
-
-   if(success)
-      exportedFiles.push_back(fullPath);
-   
-   return result;
+   }
+
+private:
+   wxFileName mBackup;
+   wxString mFullPath;
+};
 }
 
+ExportResult ExportAudioDialog::DoExportSplit(const ExportPlugin& plugin,
+                                              int formatIndex,
+                                              const ExportProcessor::Parameters& parameters,
+                                              const std::vector<SplitFile>& files,
+                                              bool selectedOnly,
+                                              FilePaths& exportedFiles)
+{
+   auto& tracks = TrackList::Get(mProject);
+   auto& selectionState = SelectionState::Get( mProject );
+   const auto overwrite = mOverwriteExisting->GetValue();
+   const auto sampleRate = mExportOptionsPanel->GetSampleRate();
+
+   // Targets are made only for the files that are exported
+   std::vector<std::optional<ExportTarget>> targets(files.size());
+   std::vector<ExportResult> results(files.size(), ExportResult::Error);
+
+   // Called on this thread, one file at a time, as workers become free
+   const auto makeTask = [&](size_t index) {
+      const auto& file = files[index];
+      const auto& setting = *file.setting;
+
+      wxLogDebug(wxT("Doing multiple Export: File name \"%s\""), (setting.filename.GetFullName()));
+      wxLogDebug(wxT("Channels: %i, Start: %lf, End: %lf "), setting.channels, setting.t0, setting.t1);
+      if (selectedOnly)
+         wxLogDebug(wxT("Selected Region Only"));
+      else
+         wxLogDebug(wxT("Whole Project"));
+
+      const auto& target = targets[index].emplace(setting.filename, overwrite);
+
+      // The processor finds the tracks to mix when it is made, so the track
+      // need be selected only until then
+      std::optional<SelectionStateChanger> changer;
+      if (file.track) {
+         changer.emplace(selectionState, tracks);
+         file.track->SetSelected(true);
+      }
+
+      return ExportTaskBuilder{}.SetPlugin(&plugin, formatIndex)
+         .SetParameters(parameters)
+         .SetRange(setting.t0, setting.t1, selectedOnly)
+         .SetTags(&setting.tags)
+         .SetNumChannels(setting.channels)
+         .SetFileName(target.GetFullPath())
+         .SetSampleRate(sampleRate)
+         .Build(mProject);
+   };
 
+   auto ok = ExportResult::Success;
+   size_t first = 0;
+   while (first < files.size()) {
+      // Files of the same name are not exported at once, so that the later
+      // one replaces the earlier, or is named after it, as when exporting
+      // one after another
+      auto last = first + 1;
+      while (last < files.size() &&
+         std::none_of(files.begin() + first, files.begin() + last,
+            [&](const SplitFile& file) {
+               return file.setting->filename == files[last].setting->filename;
+            }))
+         ++last;
+
+      const auto next = ExportProgressUI::ShowParallel(first, last, makeTask,
+         [&](size_t index, ExportResult result) { results[index] = result; });
+
+      // Report the first file, in the order of export, that did not succeed
+      ok = ExportResult::Success;
+      for (auto index = first; index < last; ++index) {
+         if (!targets[index])
+            continue;
+         const auto result = results[index];
+         const auto success =
+            result == ExportResult::Success || result == ExportResult::Stopped;
+         targets[index]->Finish(success);
+         if (success)
+            exportedFiles.push_back(targets[index]->GetFullPath());
+         if (ok == ExportResult::Success)
+            ok = result;
+      }
+
+      if (ok == ExportResult::Stopped) {
+         AudacityMessageDialog dlgMessage(
+            nullptr,
+            XO("Continue to export remaining files?"),
+            XO("Export"),
+            wxYES_NO | wxNO_DEFAULT | wxICON_WARNING);
+         if (dlgMessage.ShowModal() != wxID_YES ) {
+            // User decided not to continue - bail out!
+            break;
+         }
+      }
+      else if (ok != ExportResult::Success) {
+         break;
+      }
+
+      first = std::max(next, first + 1);
+   }
+
+   return ok;
+}
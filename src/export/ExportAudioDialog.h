@@ -20,6 +20,7 @@
 class ExportFilePanel;
 class AudacityProject;
 class ShuttleGui;
+class WaveTrack;
 
 class Exporter;
 class ExportPlugin;
@@ -51,6 +52,13 @@ class ExportAudioDialog final : public wxDialogWrapper
       Tags tags; /**< The set of metadata to use for the export */
    };
 
+   ///\brief One file of a split export
+   struct SplitFile
+   {
+      const ExportSetting* setting;
+      WaveTrack* track; /**< If not null, the only track to select for the export */
+   };
+
 public:
    enum class ExportMode
    {
@@ -102,14 +110,13 @@ private:
                                       const ExportProcessor::Parameters& parameters,
                                       FilePaths& exporterFiles);
    
-   ExportResult DoExport(const ExportPlugin& plugin,
-                         int formatIndex,
-                         const ExportProcessor::Parameters& parameters,
-                         const wxFileName& filename,
-                         int channels,
-                         double t0, double t1, bool selectedOnly,
-                         const Tags& tags,
-                         FilePaths& exportedFiles);
+   //! Export the files, several at once
+   ExportResult DoExportSplit(const ExportPlugin& plugin,
+                              int formatIndex,
+                              const ExportProcessor::Parameters& parameters,
+                              const std::vector<SplitFile>& files,
+                              bool selectedOnly,
+                              FilePaths& exportedFiles);
    
    AudacityProject& mProject;
 
@@ -29,7 +29,8 @@ for classification of the sample format and the used endianness.
 #include "sndfile.h"
 
 FormatClassifier::FormatClassifier(const char* filename) :
-   mReader(filename),
+   // Only a few pages near the start are read
+   mReader(filename, false),
    mMeter(cSiglen)
 {
    // Define the classification classes
@@ -203,8 +204,8 @@ void FormatClassifier::ReadSignal(FormatClassT format, size_t stride)
 
    mReader.Reset();
 
-   // Do a dummy read of 1024 bytes to skip potential header information
-   mReader.ReadSamples(mRawBuffer.get(), 1024, MultiFormatReader::Uint8, MachineEndianness::Little);
+   // Skip 1024 bytes of potential header information
+   mReader.Skip(1024);
 
    do
    {
@@ -223,8 +224,9 @@ void FormatClassifier::ReadSignal(FormatClassT format, size_t stride)
             // Integrate signals
             Add(mSigBuffer.get(), mAuxBuffer.get(), cSiglen);
 
-            // Do some dummy reads to break signal coherence
-            mReader.ReadSamples(mRawBuffer.get(), n + 1, stride, format.format, format.endian);
+            // Skip some samples to break signal coherence
+            mReader.Skip((n + 1) * stride *
+               MultiFormatReader::SampleSize(format.format));
          }
       }
 
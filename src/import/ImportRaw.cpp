@@ -38,6 +38,7 @@ and sample size to help you importing data of an unknown format.
 #include "ProgressDialog.h"
 
 #include <cmath>
+#include <exception>
 #include <stdint.h>
 #include <vector>
 
@@ -52,6 +53,7 @@ and sample size to help you importing data of an unknown format.
 
 // #include "RawAudioGuess.h"
 #include "FormatClassifier.h"
+#include "MultiFormatReader.h"
 
 #include "sndfile.h"
 
@@ -100,6 +102,51 @@ double ImportRawDialog::mRate = 0;  // -> project rate
 double ImportRawDialog::mPercent = 100.;
 
 
+// Whether samples of the encoding can be converted straight from a mapping
+// of the file, and how
+static bool GetMappedFormat(int encoding,
+   MultiFormatReader::FormatT &format, MachineEndianness::EndiannessT &endian)
+{
+   switch (encoding & SF_FORMAT_SUBMASK)
+   {
+      case SF_FORMAT_PCM_S8:
+         format = MultiFormatReader::Int8;
+         break;
+      case SF_FORMAT_PCM_U8:
+         format = MultiFormatReader::Uint8;
+         break;
+      case SF_FORMAT_PCM_16:
+         format = MultiFormatReader::Int16;
+         break;
+      case SF_FORMAT_PCM_32:
+         format = MultiFormatReader::Int32;
+         break;
+      case SF_FORMAT_FLOAT:
+         format = MultiFormatReader::Float;
+         break;
+      case SF_FORMAT_DOUBLE:
+         format = MultiFormatReader::Double;
+         break;
+      default:
+         return false;
+   }
+
+   switch (encoding & SF_FORMAT_ENDMASK)
+   {
+      case SF_ENDIAN_LITTLE:
+         endian = MachineEndianness::Little;
+         break;
+      case SF_ENDIAN_BIG:
+         endian = MachineEndianness::Big;
+         break;
+      default:
+         // libsndfile reads raw data of no endianness as the CPU's
+         endian = MachineEndianness().Which();
+         break;
+   }
+   return true;
+}
+
 // This function leaves outTracks empty as an indication of error,
 // but may also throw FileException to make use of the application's
 // user visible error reporting.
@@ -135,37 +182,64 @@ void ImportRaw(const AudacityProject &project, wxWindow *parent, const wxString
       wxFile f;   // will be closed when it goes out of scope
       SFFile sndFile;
 
-      if (f.Open(fileName)) {
-         // Even though there is an sf_open() that takes a filename, use the one that
-         // takes a file descriptor since wxWidgets can open a file with a Unicode name and
-         // libsndfile can't (under Windows).
-         sndFile.reset(SFCall<SNDFILE*>(sf_open_fd, f.fd(), SFM_READ, &sndInfo, FALSE));
+      // Simple encodings are converted straight from a mapping of the file
+      MultiFormatReader::FormatT mappedFormat = MultiFormatReader::Int16;
+      MachineEndianness::EndiannessT mappedEndian = MachineEndianness::Little;
+      std::unique_ptr<MultiFormatReader> pReader;
+      if (GetMappedFormat(encoding, mappedFormat, mappedEndian)) {
+         try {
+            pReader = std::make_unique<MultiFormatReader>(fileName.utf8_str());
+         }
+         catch (const std::exception&) {
+            throw FileException{ FileException::Cause::Open, fileName };
+         }
+         // Else read with libsndfile, rather than one sample at a time
+         if (!pReader->IsMapped())
+            pReader.reset();
       }
 
-      if (!sndFile){
-         char str[1000];
-         sf_error_str((SNDFILE *)NULL, str, 1000);
-         wxPrintf("%s\n", str);
-
-         throw FileException{ FileException::Cause::Open, fileName };
+      sf_count_t fileFrames = 0;
+      if (pReader) {
+         const auto frameSize =
+            MultiFormatReader::SampleSize(mappedFormat) * numChannels;
+         const auto fileSize = pReader->GetSize();
+         if (fileSize > (uint64_t)offset)
+            fileFrames = (fileSize - offset) / frameSize;
       }
+      else {
+         if (f.Open(fileName)) {
+            // Even though there is an sf_open() that takes a filename, use the one that
+            // takes a file descriptor since wxWidgets can open a file with a Unicode name and
+            // libsndfile can't (under Windows).
+            sndFile.reset(SFCall<SNDFILE*>(sf_open_fd, f.fd(), SFM_READ, &sndInfo, FALSE));
+         }
 
-
-      {
-         int result = sf_command(sndFile.get(), SFC_SET_RAW_START_OFFSET, &offset, sizeof(offset));
-         if (result != 0) {
+         if (!sndFile){
             char str[1000];
-            sf_error_str(sndFile.get(), str, 1000);
+            sf_error_str((SNDFILE *)NULL, str, 1000);
             wxPrintf("%s\n", str);
 
-            throw FileException{ FileException::Cause::Read, fileName };
+            throw FileException{ FileException::Cause::Open, fileName };
+         }
+
+
+         {
+            int result = sf_command(sndFile.get(), SFC_SET_RAW_START_OFFSET, &offset, sizeof(offset));
+            if (result != 0) {
+               char str[1000];
+               sf_error_str(sndFile.get(), str, 1000);
+               wxPrintf("%s\n", str);
+
+               throw FileException{ FileException::Cause::Read, fileName };
+            }
          }
+         SFCall<sf_count_t>(sf_seek, sndFile.get(), 0, SEEK_SET);
+         fileFrames = sndInfo.frames;
       }
-      SFCall<sf_count_t>(sf_seek, sndFile.get(), 0, SEEK_SET);
 
       auto totalFrames =
          // fraction of a sf_count_t value
-         (sampleCount)(sndInfo.frames * percent / 100.0);
+         (sampleCount)(fileFrames * percent / 100.0);
 
       //
       // Sample format:
@@ -182,7 +256,8 @@ void ImportRaw(const AudacityProject &project, wxWindow *parent, const wxString
 
       const auto maxBlockSize = (*trackList->Any<WaveTrack>().begin())->GetMaxBlockSize();
 
-      SampleBuffer srcbuffer(maxBlockSize * numChannels, format);
+      // Interleaved samples from libsndfile
+      SampleBuffer srcbuffer(pReader ? 0 : maxBlockSize * numChannels, format);
       SampleBuffer buffer(maxBlockSize, format);
 
       decltype(totalFrames) framescompleted = 0;
@@ -201,43 +276,68 @@ void ImportRaw(const AudacityProject &project, wxWindow *parent, const wxString
          block =
             limitSampleBufferSize( maxBlockSize, totalFrames - framescompleted );
 
-         sf_count_t sf_result;
-         if (format == int16Sample)
-            sf_result = SFCall<sf_count_t>(sf_readf_short, sndFile.get(), (short *)srcbuffer.ptr(), block);
-         else
-            sf_result = SFCall<sf_count_t>(sf_readf_float, sndFile.get(), (float *)srcbuffer.ptr(), block);
-
-         if (sf_result >= 0) {
-            block = sf_result;
-         }
-         else {
-            // This is not supposed to happen, sndfile.h says result is always
-            // a count, not an invalid value for error
-            throw FileException{ FileException::Cause::Read, fileName };
-         }
-
-         if (block) {
+         if (pReader) {
+            const auto destFormat =
+               (format == int16Sample) ? int16Sample : floatSample;
+            const auto sampleSize = MultiFormatReader::SampleSize(mappedFormat);
             size_t c = 0;
             ImportUtils::ForEachChannel(*trackList, [&](auto& channel)
             {
-               if (format == int16Sample) {
-                  for (size_t j = 0; j < block; ++j)
-                     ((short *)buffer.ptr())[j] =
-                     ((short *)srcbuffer.ptr())[numChannels * j + c];
-               }
-               else {
-                  for (size_t j = 0; j < block; ++j)
-                     ((float *)buffer.ptr())[j] =
-                     ((float *)srcbuffer.ptr())[numChannels * j + c];
-               }
-
-               channel.AppendBuffer(buffer.ptr(),
-                  ((format == int16Sample) ? int16Sample : floatSample), block,
+               // Convert this channel's samples into the buffer, skipping
+               // over the other channels
+               if (!pReader->Seek(offset +
+                  (framescompleted.as_long_long() * numChannels + c) *
+                     sampleSize))
+                  throw FileException{ FileException::Cause::Read, fileName };
+               const auto nRead = pReader->ReadConverted(buffer.ptr(),
+                  destFormat, block, numChannels, mappedFormat, mappedEndian);
+               // Only whole frames of the file were counted, so none is short
+               wxASSERT(nRead == block);
+               channel.AppendBuffer(buffer.ptr(), destFormat, nRead,
                   1, sf_subtype_to_effective_format(encoding));
                ++c;
             });
             framescompleted += block;
          }
+         else {
+            sf_count_t sf_result;
+            if (format == int16Sample)
+               sf_result = SFCall<sf_count_t>(sf_readf_short, sndFile.get(), (short *)srcbuffer.ptr(), block);
+            else
+               sf_result = SFCall<sf_count_t>(sf_readf_float, sndFile.get(), (float *)srcbuffer.ptr(), block);
+
+            if (sf_result >= 0) {
+               block = sf_result;
+            }
+            else {
+               // This is not supposed to happen, sndfile.h says result is always
+               // a count, not an invalid value for error
+               throw FileException{ FileException::Cause::Read, fileName };
+            }
+
+            if (block) {
+               size_t c = 0;
+               ImportUtils::ForEachChannel(*trackList, [&](auto& channel)
+               {
+                  if (format == int16Sample) {
+                     for (size_t j = 0; j < block; ++j)
+                        ((short *)buffer.ptr())[j] =
+                        ((short *)srcbuffer.ptr())[numChannels * j + c];
+                  }
+                  else {
+                     for (size_t j = 0; j < block; ++j)
+                        ((float *)buffer.ptr())[j] =
+                        ((float *)srcbuffer.ptr())[numChannels * j + c];
+                  }
+
+                  channel.AppendBuffer(buffer.ptr(),
+                     ((format == int16Sample) ? int16Sample : floatSample), block,
+                     1, sf_subtype_to_effective_format(encoding));
+                  ++c;
+               });
+               framescompleted += block;
+            }
+         }
 
          updateResult = progress.Update(
             framescompleted.as_long_long(),
@@ -476,7 +576,7 @@ void ImportRawDialog::OnPlay(wxCommandEvent & WXUNUSED(event))
 void ImportRawDialog::OnDetect(wxCommandEvent & event)
 {
    try {
-      // Yes, FormatClassifier currently handles filenames in UTF8 format only, that's a TODO ...
+      // FormatClassifier takes the file name in UTF-8
       FormatClassifier theClassifier(mFileName.utf8_str());
       mEncoding = theClassifier.GetResultFormatLibSndfile();
       mChannels = theClassifier.GetResultChannels();
@@ -16,12 +16,29 @@ machine endianness representations.
 
 #include "MultiFormatReader.h"
 
+#include <algorithm>
+#include <cmath>
 #include <exception>
+#include <limits>
 #include <stdexcept>
 #include <cstring>
 #include <stdint.h>
 
+#include <wx/crt.h>
 #include <wx/defs.h>
+#include <wx/filefn.h>
+#include <wx/filename.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "MemoryX.h"
 
 MachineEndianness::MachineEndianness()
 {
@@ -36,33 +53,150 @@ MachineEndianness::MachineEndianness()
 }
 
 
-MultiFormatReader::MultiFormatReader(const char* filename)
+MultiFormatReader::MultiFormatReader(const char* filename, bool sequential)
    : mpFid(NULL)
 {
-   mpFid = fopen(filename, "rb");
+   if (Map(filename, sequential))
+      return;
+
+   const auto name = wxString::FromUTF8(filename);
+   mpFid = wxFopen(name, wxT("rb"));
       
    if (mpFid == NULL)
    {
       throw std::runtime_error("Error opening file");
    }
+
+   // Seek() limits positions to the size
+   const auto size = wxFileName::GetSize(name);
+   if (size == wxInvalidSize)
+   {
+      fclose(mpFid);
+      throw std::runtime_error("Error opening file");
+   }
+   mSize = size.GetValue();
 }
 
 MultiFormatReader::~MultiFormatReader()
 {
+   Unmap();
    if (mpFid != NULL)
    {
       fclose(mpFid);
    }
 }
 
+bool MultiFormatReader::Map(const char* filename, bool sequential)
+{
+   const auto name = wxString::FromUTF8(filename);
+   const auto maxSize =
+      static_cast<uint64_t>(std::numeric_limits<size_t>::max());
+
+   // The mapping keeps the file open, so the handles are closed at once
+#ifdef _WIN32
+   const auto file = CreateFileW(name.wc_str(), GENERIC_READ,
+      FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+      sequential ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_FLAG_RANDOM_ACCESS,
+      nullptr);
+   if (file == INVALID_HANDLE_VALUE)
+      return false;
+   auto closeFile = finally([&]{ CloseHandle(file); });
+
+   LARGE_INTEGER size;
+   if (!GetFileSizeEx(file, &size) || size.QuadPart <= 0 ||
+       static_cast<uint64_t>(size.QuadPart) > maxSize)
+      return false;
+
+   const auto mapping =
+      CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+   if (!mapping)
+      return false;
+   auto closeMapping = finally([&]{ CloseHandle(mapping); });
+
+   const auto pData = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+   if (!pData)
+      return false;
+   mSize = size.QuadPart;
+#else
+   const auto fd = open(name.fn_str(), O_RDONLY);
+   if (fd < 0)
+      return false;
+   auto closeFile = finally([&]{ close(fd); });
+
+   struct stat st;
+   if (fstat(fd, &st) != 0 || st.st_size <= 0 ||
+       static_cast<uint64_t>(st.st_size) > maxSize)
+      return false;
+
+   const auto pData = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+   if (pData == MAP_FAILED)
+      return false;
+   mSize = st.st_size;
+   // Only a hint, so failure does not matter
+   madvise(pData, mSize, sequential ? MADV_SEQUENTIAL : MADV_RANDOM);
+#endif
+   mpData = static_cast<const uint8_t*>(pData);
+   mPosition = 0;
+   return true;
+}
+
+void MultiFormatReader::Unmap()
+{
+   if (!mpData)
+      return;
+#ifdef _WIN32
+   UnmapViewOfFile(mpData);
+#else
+   munmap(const_cast<uint8_t*>(mpData), mSize);
+#endif
+   mpData = nullptr;
+}
+
+size_t MultiFormatReader::SampleSize(FormatT format)
+{
+   switch(format)
+   {
+      case Int8:
+      case Uint8:
+         return 1;
+      case Int16:
+      case Uint16:
+         return 2;
+      case Int32:
+      case Uint32:
+      case Float:
+         return 4;
+      case Double:
+         return 8;
+      default:
+         return 1;
+   }
+}
+
 void MultiFormatReader::Reset()
 {
+   mPosition = 0;
    if (mpFid != NULL)
    {
       rewind(mpFid);
    }
 }
 
+bool MultiFormatReader::Seek(uint64_t offset)
+{
+   const auto position = std::min(offset, mSize);
+   if (mpFid != NULL &&
+       wxFseek(mpFid, static_cast<wxFileOffset>(position), SEEK_SET) != 0)
+      return false;
+   mPosition = position;
+   return true;
+}
+
+bool MultiFormatReader::Skip(uint64_t bytes)
+{
+   return Seek(mPosition + std::min(bytes, mSize - mPosition));
+}
+
 size_t MultiFormatReader::ReadSamples(void* buffer, size_t len,
                     MultiFormatReader::FormatT format,
                     MachineEndianness::EndiannessT end)
@@ -106,32 +240,177 @@ size_t MultiFormatReader::ReadSamples(void* buffer, size_t len, size_t stride,
    return actRead;
 }
 
+size_t MultiFormatReader::Available(
+   size_t size, size_t len, size_t stride) const
+{
+   const auto available = mSize - mPosition;
+   if (available < size)
+      return 0;
+   return std::min<uint64_t>(len, (available - size) / (size * stride) + 1);
+}
+
 size_t MultiFormatReader::Read(void* buffer, size_t size, size_t len, size_t stride)
 {
    size_t actRead = 0;
    uint8_t* pWork = (uint8_t*) buffer;
    
-   if (stride > 1)
+   if (mpData)
    {
-      // There are gaps between consecutive samples,
-      // so do a scattered read
-      for (size_t n = 0; n < len; n++)
+      actRead = Available(size, len, stride);
+      const auto pSrc = mpData + mPosition;
+      if (stride > 1)
+      {
+         for (size_t n = 0; n < actRead; n++)
+            memcpy(&(pWork[n*size]), &(pSrc[n*size*stride]), size);
+      }
+      else
       {
-         actRead += fread(&(pWork[n*size]), size, 1, mpFid);
-         // FIXME: TRAP_ERR fseek return in MultiFormatReader unchecked.
-         fseek(mpFid, (stride - 1) * size, SEEK_CUR);
+         memcpy(buffer, pSrc, actRead * size);
       }
+      mPosition = std::min<uint64_t>(mSize, mPosition + len * size * stride);
    }
    else
    {
-      // Just do a linear read
-      actRead = fread(buffer, size, len, mpFid);
+      if (stride > 1)
+      {
+         // There are gaps between consecutive samples,
+         // so do a scattered read
+         const auto gap = static_cast<wxFileOffset>((stride - 1) * size);
+         while (actRead < len &&
+            fread(&(pWork[actRead*size]), size, 1, mpFid) == 1)
+         {
+            ++actRead;
+            if (wxFseek(mpFid, gap, SEEK_CUR) != 0)
+               break;
+         }
+      }
+      else
+      {
+         // Just do a linear read
+         actRead = fread(buffer, size, len, mpFid);
+      }
+      // Where the file is now, as for a mapping
+      const auto position = wxFtell(mpFid);
+      if (position >= 0)
+         mPosition = std::min<uint64_t>(mSize, position);
+   }
+
+   return actRead;
+}
+
+namespace {
+template<typename T> T Load(const uint8_t* pSrc, bool swap)
+{
+   uint8_t bytes[sizeof(T)];
+   if (swap)
+      std::reverse_copy(pSrc, pSrc + sizeof(T), bytes);
+   else
+      memcpy(bytes, pSrc, sizeof(T));
+   T value;
+   memcpy(&value, bytes, sizeof(T));
+   return value;
+}
+
+// Scaled as sf_readf_float() and sf_readf_short() do
+inline float ToFloat(int8_t value) { return value / 128.0f; }
+inline float ToFloat(int16_t value) { return value / 32768.0f; }
+inline float ToFloat(int32_t value) { return value / 2147483648.0; }
+inline float ToFloat(uint8_t value) { return (value - 128) / 128.0f; }
+inline float ToFloat(uint16_t value) { return (value - 32768) / 32768.0f; }
+inline float ToFloat(uint32_t value)
+   { return (value - 2147483648.0) / 2147483648.0; }
+inline float ToFloat(float value) { return value; }
+inline float ToFloat(double value) { return value; }
+
+inline short ToShort(int8_t value) { return value * 256; }
+inline short ToShort(int16_t value) { return value; }
+inline short ToShort(int32_t value) { return value >> 16; }
+inline short ToShort(uint8_t value) { return (value - 128) * 256; }
+inline short ToShort(uint16_t value) { return value - 32768; }
+inline short ToShort(uint32_t value) { return (value >> 16) - 32768; }
+inline short ToShort(double value)
+{
+   return std::clamp(lrint(value * 32768.0), -32768L, 32767L);
+}
+inline short ToShort(float value) { return ToShort(double(value)); }
+
+template<typename T> void Convert(const uint8_t* pSrc, size_t step,
+   bool swap, samplePtr buffer, sampleFormat destFormat, size_t len)
+{
+   if (destFormat == int16Sample)
+   {
+      const auto pDest = reinterpret_cast<short*>(buffer);
+      for (size_t n = 0; n < len; n++)
+         pDest[n] = ToShort(Load<T>(pSrc + n * step, swap));
+   }
+   else
+   {
+      const auto pDest = reinterpret_cast<float*>(buffer);
+      for (size_t n = 0; n < len; n++)
+         pDest[n] = ToFloat(Load<T>(pSrc + n * step, swap));
+   }
+}
+}
+
+size_t MultiFormatReader::ReadConverted(samplePtr buffer,
+                    sampleFormat destFormat, size_t len, size_t stride,
+                    MultiFormatReader::FormatT format,
+                    MachineEndianness::EndiannessT end)
+{
+   const auto size = SampleSize(format);
+   const bool swapflag = (mEnd.Which() != end);
+
+   const uint8_t* pSrc;
+   size_t step;
+   size_t actRead;
+   if (mpData)
+   {
+      pSrc = mpData + mPosition;
+      step = size * stride;
+      actRead = Available(size, len, stride);
+      mPosition = std::min<uint64_t>(mSize, mPosition + len * step);
+   }
+   else
+   {
+      mCopyBuffer.resize(len * size);
+      pSrc = mCopyBuffer.data();
+      step = size;
+      actRead = Read(mCopyBuffer.data(), size, len, stride);
+   }
+
+   switch(format)
+   {
+      case Int8:
+         Convert<int8_t>(pSrc, step, swapflag, buffer, destFormat, actRead);
+         break;
+      case Int16:
+         Convert<int16_t>(pSrc, step, swapflag, buffer, destFormat, actRead);
+         break;
+      case Int32:
+         Convert<int32_t>(pSrc, step, swapflag, buffer, destFormat, actRead);
+         break;
+      case Uint8:
+         Convert<uint8_t>(pSrc, step, swapflag, buffer, destFormat, actRead);
+         break;
+      case Uint16:
+         Convert<uint16_t>(pSrc, step, swapflag, buffer, destFormat, actRead);
+         break;
+      case Uint32:
+         Convert<uint32_t>(pSrc, step, swapflag, buffer, destFormat, actRead);
+         break;
+      case Float:
+         Convert<float>(pSrc, step, swapflag, buffer, destFormat, actRead);
+         break;
+      case Double:
+         Convert<double>(pSrc, step, swapflag, buffer, destFormat, actRead);
+         break;
+      default:
+         break;
    }
 
    return actRead;
 }
 
-   
 void MultiFormatReader::SwapBytes(void* buffer, size_t size, size_t len)
 {
    uint8_t* pResBuffer = (uint8_t*) buffer;
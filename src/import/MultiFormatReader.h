@@ -13,6 +13,9 @@
 
 #include <stdio.h>
 #include <stdint.h>
+#include <vector>
+
+#include "SampleFormat.h"
 
 class MachineEndianness
 {
@@ -46,12 +49,25 @@ private:
     EndiannessT mFlag;
 };
 
+//! Reads samples of raw files, from a memory mapping of the whole file
+/*!
+ Only the pages read are loaded, so that guessing the format of a huge file is
+ cheap.  Falls back to buffered reading where the file cannot be mapped, as for
+ files larger than the address space.
+ */
 class MultiFormatReader
 {
    FILE* mpFid;   
    MachineEndianness mEnd;
    uint8_t mSwapBuffer[8];
 
+   //! Null if the file is not mapped
+   const uint8_t* mpData { nullptr };
+   uint64_t mSize { 0 };
+   uint64_t mPosition { 0 };
+   //! Holds samples for ReadConverted() when the file is not mapped
+   std::vector<uint8_t> mCopyBuffer;
+
 public:
    typedef enum
    {
@@ -65,18 +81,53 @@ public:
       Double
    } FormatT;
    
-   MultiFormatReader(const char* filename);
+   /*!
+    @param filename UTF-8
+    @param sequential whether the file is read from start to end, rather than
+    in a few places, so that the system may read ahead
+    */
+   MultiFormatReader(const char* filename, bool sequential = true);
+   MultiFormatReader(const MultiFormatReader&) = delete;
+   MultiFormatReader& operator=(const MultiFormatReader&) = delete;
    ~MultiFormatReader();
 
+   static size_t SampleSize(FormatT format);
+
+   uint64_t GetSize() const { return mSize; }
+   //! Whether the file is mapped, rather than read with stdio
+   bool IsMapped() const { return mpData != nullptr; }
+
    void Reset();
+   //! Move to a byte offset from the start of the file, at most its size
+   /*! @return false, without moving, if the file could not be repositioned */
+   bool Seek(uint64_t offset);
+   //! Move ahead some bytes without reading them, at most to the end
+   /*! @return false, without moving, if the file could not be repositioned */
+   bool Skip(uint64_t bytes);
+
    size_t ReadSamples(void* buffer, size_t len,
                     MultiFormatReader::FormatT format,
                     MachineEndianness::EndiannessT end);
    size_t ReadSamples(void* buffer, size_t len, size_t stride,
                     MultiFormatReader::FormatT format,
                     MachineEndianness::EndiannessT end);
+
+   //! Read as ReadSamples() does, and convert the samples as libsndfile does
+   /*!
+    Samples are converted straight from the mapping, without a copy
+
+    @param destFormat int16Sample or floatSample
+    */
+   size_t ReadConverted(samplePtr buffer, sampleFormat destFormat,
+                    size_t len, size_t stride,
+                    MultiFormatReader::FormatT format,
+                    MachineEndianness::EndiannessT end);
    
 private:
+   bool Map(const char* filename, bool sequential);
+   void Unmap();
+   //! How many samples, at most len, lie wholly in the mapping
+   size_t Available(size_t size, size_t len, size_t stride) const;
    size_t Read(void* buffer, size_t size, size_t len, size_t stride);
    void SwapBytes(void* buffer, size_t size, size_t len);
 };
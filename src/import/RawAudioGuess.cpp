@@ -17,13 +17,15 @@
 #include "RawAudioGuess.h"
 
 #include "AudacityException.h"
+#include "MultiFormatReader.h"
 
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
 
+#include <exception>
+
 #include <wx/defs.h>
-#include <wx/ffile.h>
 
 #define RAW_GUESS_DEBUG 0
 
@@ -1010,9 +1012,7 @@ int RawAudioGuess(const wxString &in_fname,
    size_t headerSkipSize = 64;
    size_t dataSize = 16384;
    int format = SF_FORMAT_RAW;
-   FILE *inf;
    size_t fileLen;
-   size_t read_data;
 
   #if RAW_GUESS_DEBUG
    FILE *af = fopen("raw.txt", "a");
@@ -1023,25 +1023,23 @@ int RawAudioGuess(const wxString &in_fname,
    *out_offset = 0;
    *out_channels = 1;
 
-   wxFFile in_wxFFile(in_fname, wxT("rb"));
-
-   // JKC FALSE changed to -1.
-   if (!in_wxFFile.IsOpened())
-      return -1;
-   inf = in_wxFFile.fp();
-
-   if (!inf) {
+   // Map the file, so that only the pages of the windows tested are read
+   std::unique_ptr<MultiFormatReader> pReader;
+   try {
+      pReader = std::make_unique<MultiFormatReader>(in_fname.utf8_str(), false);
+   }
+   catch (const std::exception&) {
      #if RAW_GUESS_DEBUG
       fclose(af);
       g_raw_debug_file = NULL;
      #endif
 
+      // JKC FALSE changed to -1.
       return -1;
    }
+   auto &reader = *pReader;
 
-   // FIXME: TRAP_ERR fseek return in RawAudioGuess unchecked.
-   fseek(inf, 0, SEEK_END);
-   fileLen = ftell(inf);
+   fileLen = reader.GetSize();
 
    if (fileLen < 8)
       return -1;
@@ -1058,22 +1056,26 @@ int RawAudioGuess(const wxString &in_fname,
    ArraysOf<char> rawData{ numTests, dataSize + 4 };
 
    for (unsigned test = 0; test < numTests; test++) {
-      int startPoint;
+      size_t startPoint;
 
       startPoint = (fileLen - dataSize) * (test + 1) / (numTests + 2);
 
       /* Make it a multiple of 16 (stereo double-precision) */
       startPoint = (startPoint/16)*16;
 
-      // FIXME: TRAP_ERR fseek return in MultiFormatReader unchecked.
-      fseek(inf, headerSkipSize + startPoint, SEEK_SET);
-      read_data = fread(rawData[test].get(), 1, dataSize, inf);
-      if (read_data != dataSize && ferror(inf)) {
-         perror("fread error in RawAudioGuess");
+      if (!reader.Seek(headerSkipSize + startPoint)) {
+        #if RAW_GUESS_DEBUG
+         fclose(af);
+         g_raw_debug_file = NULL;
+        #endif
+
+         return -1;
       }
+      reader.ReadSamples(rawData[test].get(), dataSize,
+         MultiFormatReader::Uint8, MachineEndianness::Little);
    }
 
-   in_wxFFile.Close();
+   pReader.reset();
 
    /*
     * The floating-point tests will only return a valid format
@@ -324,13 +324,16 @@ void OnPunchAndRoll(const CommandContext &context)
    for (const auto &wt : tracks)
       wt->Clear(t1, wt->GetEndTime());
 
+   const auto preRoll = std::max(0.0,
+      gPrefs->Read(AUDIO_PRE_ROLL_KEY, DEFAULT_PRE_ROLL_SECONDS));
+
    // Choose the tracks for playback.
    TransportSequences transportTracks;
    const auto duplex = ProjectAudioManager::UseDuplex();
    if (duplex)
       // play all
       transportTracks = MakeTransportTracks(
-         TrackList::Get( project ), false, true);
+         TrackList::Get( project ), t1 - preRoll, DBL_MAX, false, true);
    else
       // play recording tracks only
       for (auto &pTrack : tracks)
@@ -344,8 +347,7 @@ void OnPunchAndRoll(const CommandContext &context)
    // Try to start recording
    auto options = ProjectAudioIO::GetDefaultOptions(project);
    options.rate = rateOfSelected;
-   options.preRoll = std::max(0.0,
-      gPrefs->Read(AUDIO_PRE_ROLL_KEY, DEFAULT_PRE_ROLL_SECONDS));
+   options.preRoll = preRoll;
    options.pCrossfadeData = &crossfadeData;
    bool success = ProjectAudioManager::Get( project ).DoRecord(project,
       transportTracks,
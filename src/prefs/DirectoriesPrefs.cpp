@@ -30,6 +30,7 @@
 
 #include "Prefs.h"
 #include "ShuttleGui.h"
+#include "SpilledUndoStates.h"
 #include "TempDirectory.h"
 #include "AudacityMessageBox.h"
 #include "ReadOnlyText.h"
@@ -260,6 +261,19 @@ void DirectoriesPrefs::PopulateOrExchange(ShuttleGui &S)
    }
    S.EndStatic();
 
+   S.StartStatic(XO("Undo History"));
+   {
+      S.StartThreeColumn();
+      {
+         S.TieIntegerTextBox(XXO("XXO("&Memory for older states:")Memory limit:"),
+                             UndoMemoryBudget,
+                             9);
+         S.AddUnits(XO("MB (0 means no limit; the rest is kept in the project file)"));
+      }
+      S.EndThreeColumn();
+   }
+   S.EndStatic();
+
    S.EndScroller();
 }
 
@@ -23,6 +23,7 @@
 #include <wx/stattext.h>
 
 #include "NoteTrack.h"
+#include "OnDemandImport.h"
 #include "Prefs.h"
 #include "ShuttleGui.h"
 #include "WindowAccessible.h"
@@ -159,6 +160,14 @@ void ImportExportPrefs::PopulateOrExchange(ShuttleGui & S)
    }
    S.EndStatic();
 
+   S.StartStatic(XO("Compressed Imports"));
+   {
+      S.TieCheckBox(
+         XXO("&Decode MP3, Ogg and Opus files in the background"),
+         OnDemandImporting);
+   }
+   S.EndStatic();
+
    S.EndScroller();
 }
 
@@ -26,6 +26,7 @@
 
 #include "ShuttleGui.h"
 #include "Prefs.h"
+#include "WaveClip.h"
 
 PlaybackPrefs::PlaybackPrefs(wxWindow * parent, wxWindowID winid)
 :  PrefsPanel(parent, winid, XO("Playback"))
@@ -152,6 +153,8 @@ void PlaybackPrefs::PopulateOrExchange(ShuttleGui & S)
          S.TieCheckBox(XXO("Always scrub un&pinned"),
             {UnpinnedScrubbingPreferenceKey(),
              UnpinnedScrubbingPreferenceDefault()});
+         S.TieCheckBox(XXO("&Render stretched clips ahead of playback"),
+            RenderAheadStretchedClips);
       }
       S.EndVerticalLay();
    }
@@ -179,6 +182,7 @@ bool PlaybackPrefs::Commit()
 
    ShuttleGui S(this, eIsSavingToPrefs);
    PopulateOrExchange(S);
+   RenderAheadStretchedClips.Invalidate();
 
    return true;
 }